@@ -108,6 +108,16 @@ void ArithmeticNode::updateSlice(Attribute *attribute, unsigned int slice){
 	}
 }
 
+void ArithmeticNode::updateSlices(Attribute *attribute, unsigned int beginSlice, unsigned int endSlice){
+	if(_numericOperation.operationSelected()){
+		Numeric *in0 = _in0->value();
+		Numeric *in1 = _in1->value();
+		Numeric *out = _out->outValue();
+		
+		_numericOperation.executeSelectedOperation(in0, in1, out, beginSlice, endSlice);
+	}
+}
+
 AddNode::AddNode(const std::string &name, Node *parent) : ArithmeticNode(name, parent){
 	std::vector<std::string> specs;
 	specs.push_back("Int");
@@ -41,6 +41,7 @@ public:
 	ArithmeticNode(const std::string &name, Node *parent);
 
 	void updateSlice(Attribute *attribute, unsigned int slice);
+	void updateSlices(Attribute *attribute, unsigned int beginSlice, unsigned int endSlice);
 	void updateSpecializationLink(Attribute *attributeA, Attribute *attributeB, std::vector<std::string> &specializationA, std::vector<std::string> &specializationB);
 	void attributeSpecializationChanged(Attribute *attribute);
 
@@ -105,6 +105,9 @@ IfGreaterThan::IfGreaterThan(const std::string &name, Node *parent): Node(name,
 	setAttributeAffect(_in0, _out);
 	setAttributeAffect(_in1, _out);
 	
+	catchAttributeUnchanged(_out);
+	setEarlyCutoff();
+	
 	std::vector<std::string> numericSpecialization;
 	numericSpecialization.push_back("Int");
 	numericSpecialization.push_back("IntArray");
@@ -285,6 +288,9 @@ IfLessThan::IfLessThan(const std::string &name, Node *parent): Node(name, parent
 	setAttributeAffect(_in0, _out);
 	setAttributeAffect(_in1, _out);
 	
+	catchAttributeUnchanged(_out);
+	setEarlyCutoff();
+	
 	std::vector<std::string> numericSpecialization;
 	numericSpecialization.push_back("Int");
 	numericSpecialization.push_back("IntArray");
@@ -466,6 +472,9 @@ ConditionalValue::ConditionalValue(const std::string &name, Node *parent): Node(
 	setAttributeAffect(_ifTrue, _out);
 	setAttributeAffect(_ifFalse, _out);
 	
+	catchAttributeUnchanged(_out);
+	setEarlyCutoff();
+	
 	addAttributeSpecializationLink(_condition, _ifTrue);
 	addAttributeSpecializationLink(_ifTrue, _out);
 	addAttributeSpecializationLink(_ifTrue, _ifFalse);
@@ -508,61 +517,61 @@ void ConditionalValue::updateSpecializationLink(Attribute *attributeA, Attribute
 void ConditionalValue::transferValuesInt(Bool *condition, Numeric *ifTrue, Numeric *ifFalse, Numeric *out, unsigned int slice){
 	std::vector<int> outValues;
 	conditionalValueTransfer<int>(condition->boolValueAtSlice(slice, 0), ifTrue->intValuesSlice(slice), ifFalse->intValuesSlice(slice), outValues);
-	out->setIntValuesSlice(slice, outValues);
+	out->swapIntValuesSlice(slice, outValues);
 }
 
 void ConditionalValue::transferValuesFloat(Bool *condition, Numeric *ifTrue, Numeric *ifFalse, Numeric *out, unsigned int slice){
 	std::vector<float> outValues;
 	conditionalValueTransfer<float>(condition->boolValueAtSlice(slice, 0), ifTrue->floatValuesSlice(slice), ifFalse->floatValuesSlice(slice), outValues);
-	out->setFloatValuesSlice(slice, outValues);
+	out->swapFloatValuesSlice(slice, outValues);
 }
 
 void ConditionalValue::transferValuesVec3(Bool *condition, Numeric *ifTrue, Numeric *ifFalse, Numeric *out, unsigned int slice){
 	std::vector<Imath::V3f> outValues;
 	conditionalValueTransfer<Imath::V3f>(condition->boolValueAtSlice(slice, 0), ifTrue->vec3ValuesSlice(slice), ifFalse->vec3ValuesSlice(slice), outValues);
-	out->setVec3ValuesSlice(slice, outValues);
+	out->swapVec3ValuesSlice(slice, outValues);
 }
 
 void ConditionalValue::transferValuesCol4(Bool *condition, Numeric *ifTrue, Numeric *ifFalse, Numeric *out, unsigned int slice){
 	std::vector<Imath::Color4f> outValues;
 	conditionalValueTransfer<Imath::Color4f>(condition->boolValueAtSlice(slice, 0), ifTrue->col4ValuesSlice(slice), ifFalse->col4ValuesSlice(slice), outValues);
-	out->setCol4ValuesSlice(slice, outValues);
+	out->swapCol4ValuesSlice(slice, outValues);
 }
 
 void ConditionalValue::transferValuesMatrix44(Bool *condition, Numeric *ifTrue, Numeric *ifFalse, Numeric *out, unsigned int slice){
 	std::vector<Imath::M44f> outValues;
 	conditionalValueTransfer<Imath::M44f>(condition->boolValueAtSlice(slice, 0), ifTrue->matrix44ValuesSlice(slice), ifFalse->matrix44ValuesSlice(slice), outValues);
-	out->setMatrix44ValuesSlice(slice, outValues);
+	out->swapMatrix44ValuesSlice(slice, outValues);
 }
 
 void ConditionalValue::transferValuesIntBoolArray(Bool *condition, Numeric *ifTrue, Numeric *ifFalse, Numeric *out, unsigned int slice){
 	std::vector<int> outValues;
 	conditionalValueTransferBoolArray<int>(condition->boolValuesSlice(slice), ifTrue->intValuesSlice(slice), ifFalse->intValuesSlice(slice), outValues);
-	out->setIntValuesSlice(slice, outValues);
+	out->swapIntValuesSlice(slice, outValues);
 }
 
 void ConditionalValue::transferValuesFloatBoolArray(Bool *condition, Numeric *ifTrue, Numeric *ifFalse, Numeric *out, unsigned int slice){
 	std::vector<float> outValues;
 	conditionalValueTransferBoolArray<float>(condition->boolValuesSlice(slice), ifTrue->floatValuesSlice(slice), ifFalse->floatValuesSlice(slice), outValues);
-	out->setFloatValuesSlice(slice, outValues);
+	out->swapFloatValuesSlice(slice, outValues);
 }
 
 void ConditionalValue::transferValuesVec3BoolArray(Bool *condition, Numeric *ifTrue, Numeric *ifFalse, Numeric *out, unsigned int slice){
 	std::vector<Imath::V3f> outValues;
 	conditionalValueTransferBoolArray<Imath::V3f>(condition->boolValuesSlice(slice), ifTrue->vec3ValuesSlice(slice), ifFalse->vec3ValuesSlice(slice), outValues);
-	out->setVec3ValuesSlice(slice, outValues);
+	out->swapVec3ValuesSlice(slice, outValues);
 }
 
 void ConditionalValue::transferValuesCol4BoolArray(Bool *condition, Numeric *ifTrue, Numeric *ifFalse, Numeric *out, unsigned int slice){
 	std::vector<Imath::Color4f> outValues;
 	conditionalValueTransferBoolArray<Imath::Color4f>(condition->boolValuesSlice(slice), ifTrue->col4ValuesSlice(slice), ifFalse->col4ValuesSlice(slice), outValues);
-	out->setCol4ValuesSlice(slice, outValues);
+	out->swapCol4ValuesSlice(slice, outValues);
 }
 
 void ConditionalValue::transferValuesMatrix44BoolArray(Bool *condition, Numeric *ifTrue, Numeric *ifFalse, Numeric *out, unsigned int slice){
 	std::vector<Imath::M44f> outValues;
 	conditionalValueTransferBoolArray<Imath::M44f>(condition->boolValuesSlice(slice), ifTrue->matrix44ValuesSlice(slice), ifFalse->matrix44ValuesSlice(slice), outValues);
-	out->setMatrix44ValuesSlice(slice, outValues);
+	out->swapMatrix44ValuesSlice(slice, outValues);
 }
 
 void ConditionalValue::attributeSpecializationChanged(Attribute *attribute){
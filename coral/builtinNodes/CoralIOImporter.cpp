@@ -281,7 +281,7 @@ void ImportCIOTransforms::updateSlice(Attribute *attribute, unsigned int slice){
 			
 			std::vector<Imath::M44f> matrixValues;
 			interpolateMatrixValues(prevMatrixValues, nextMatrixValues, mod, matrixValues);
-			out->setMatrix44Values(matrixValues);
+			out->swapMatrix44ValuesSlice(0, matrixValues);
 		}
 		else{
 			out->setMatrix44Values(_cachedMatrixValues[timeIndex]);
@@ -324,9 +324,9 @@ void ImportCIOSkinWeights::updateSlice(Attribute *attribute, unsigned int slice)
 	
 	if(version == "1.0"){
 		if(type == "skinWeight"){
-			_vertices->outValue()->setIntValues(vertices);
-			_deformers->outValue()->setIntValues(deformers);
-			_weights->outValue()->setFloatValues(weights);
+			_vertices->outValue()->swapIntValuesSlice(0, vertices);
+			_deformers->outValue()->swapIntValuesSlice(0, deformers);
+			_weights->outValue()->swapFloatValuesSlice(0, weights);
 
 			setAttributeIsClean(_vertices, true);
 			setAttributeIsClean(_deformers, true);
@@ -1,11 +1,13 @@
 
-#include <map> 
 #include <vector>
+#include <algorithm>
 #include <ImathVec.h>
 #include <ImathMatrix.h>
 
 #include "DeformerNodes.h"
 #include "../src/Numeric.h"
+#include "../src/coreParallelAlgos.h"
+#include "numericOperationAlgos.h"
 
 using namespace coral;
 
@@ -26,7 +28,77 @@ namespace {
 		
 		return minorSize;
 	}
-
+	
+	struct SkinWeight{
+		int deformerId;
+		int index;
+		
+		bool operator<(const SkinWeight &other) const{
+			return deformerId < other.deformerId;
+		}
+	};
+	
+	// deforms the points of a chunk, each point only reads the weights grouped under its own vertex id.
+	class skinWeightBody{
+	public:
+		skinWeightBody(
+			const std::vector<int> &vertexOffsets, 
+			const std::vector<SkinWeight> &weights, 
+			const std::vector<float> &skinWeightValues, 
+			const std::vector<Imath::V3f> &points, 
+			const std::vector<Imath::M44f> &deformers, 
+			const std::vector<Imath::M44f> &bindPoseInverses, 
+			std::vector<Imath::V3f> &outPoints):
+			_vertexOffsets(vertexOffsets), 
+			_weights(weights), 
+			_skinWeightValues(skinWeightValues), 
+			_points(points), 
+			_deformers(deformers), 
+			_bindPoseInverses(bindPoseInverses), 
+			_outPoints(outPoints){
+		}
+		
+		void operator() (unsigned int begin, unsigned int end) const{
+			std::vector<SkinWeight> vertexWeights;
+			for(unsigned int vertexId = begin; vertexId < end; ++vertexId){
+				int weightsBegin = _vertexOffsets[vertexId];
+				int weightsEnd = _vertexOffsets[vertexId + 1];
+				if(weightsBegin == weightsEnd){
+					continue;
+				}
+				
+				// sum the contributions by increasing deformer id, the last weight listed for a deformer wins.
+				vertexWeights.assign(_weights.begin() + weightsBegin, _weights.begin() + weightsEnd);
+				std::stable_sort(vertexWeights.begin(), vertexWeights.end());
+				
+				const Imath::V3f &point = _points[vertexId];
+				Imath::V3f outPoint(0.0, 0.0, 0.0);
+				for(int i = 0; i < vertexWeights.size(); ++i){
+					const SkinWeight &weight = vertexWeights[i];
+					if(i + 1 < vertexWeights.size() && vertexWeights[i + 1].deformerId == weight.deformerId){
+						continue;
+					}
+					
+					Imath::V3f bindedPoint = point * _bindPoseInverses[weight.deformerId];
+					bindedPoint = bindedPoint * _deformers[weight.deformerId];
+					bindedPoint *= _skinWeightValues[weight.index];
+					
+					outPoint += bindedPoint;
+				}
+				
+				_outPoints[vertexId] = outPoint;
+			}
+		}
+	
+	private:
+		const std::vector<int> &_vertexOffsets;
+		const std::vector<SkinWeight> &_weights;
+		const std::vector<float> &_skinWeightValues;
+		const std::vector<Imath::V3f> &_points;
+		const std::vector<Imath::M44f> &_deformers;
+		const std::vector<Imath::M44f> &_bindPoseInverses;
+		std::vector<Imath::V3f> &_outPoints;
+	};
 }
 
 SkinWeightDeformer::SkinWeightDeformer(const std::string &name, Node *parent): Node(name, parent){
@@ -75,39 +147,48 @@ void SkinWeightDeformer::updateSlice(Attribute *attribute, unsigned int slice){
 	NumericAttribute *attrs[] = {_skinWeightVertices, _skinWeightDeformers, _skinWeightValues};
 	int minorSize = findMinorNumericSize(attrs, 3);
 	
-	std::map<int, std::map<int, Imath::V3f> > displaceMap;
-
 	int pointsSize = points.size();
 
 	NumericAttribute *deformerAttrs[] = {_deformers, _skinWeightValues};
 	int deformersSize = findMinorNumericSize(deformerAttrs, 2);
+	if(deformersSize > bindPoseDeformers.size()){
+		deformersSize = bindPoseDeformers.size();
+	}
+	
+	// the bind pose inverses are shared by all the weights of a deformer, compute them once.
+	std::vector<Imath::M44f> bindPoseInverses(deformersSize);
+	if(deformersSize){
+		parallelFor(deformersSize, numericOperation_matrix44InverseBody(&bindPoseDeformers[0], &bindPoseInverses[0]));
+	}
+	
+	// group the valid weights by vertex id, keeping their original order within each vertex.
+	std::vector<int> vertexOffsets(pointsSize + 1, 0);
 	for(int i = 0; i < minorSize; ++i){
 		int vertexId = skinWeightVertices[i];
 		int deformerId = skinWeightDeformers[i];
-
 		if(vertexId > -1 && vertexId < pointsSize && deformerId > -1 && deformerId < deformersSize){
-			const Imath::V3f &point = points[vertexId];
-			const Imath::M44f &deformer = deformers[deformerId];
-			const Imath::M44f &bindPoseDeformer = bindPoseDeformers[deformerId];
-			float weight = skinWeightValues[i];
-
-			Imath::V3f bindedPoint = point * bindPoseDeformer.inverse();
-			bindedPoint = bindedPoint * deformer;
-			bindedPoint *= weight;
-
-			displaceMap[vertexId][deformerId] = bindedPoint;
+			vertexOffsets[vertexId + 1]++;
 		}
 	}
-
-	std::vector<Imath::V3f> outPoints = points;
-	for(std::map<int, std::map<int, Imath::V3f> >::iterator it = displaceMap.begin(); it != displaceMap.end(); ++it){
-		Imath::V3f &outPoint = outPoints[it->first];
-		outPoint = Imath::V3f(0.0, 0.0, 0.0);
-		for(std::map<int, Imath::V3f>::iterator subit = it->second.begin(); subit != it->second.end(); ++subit){
-			Imath::V3f &displacedPoint = subit->second;
-			outPoint += displacedPoint;
+	
+	for(int i = 0; i < pointsSize; ++i){
+		vertexOffsets[i + 1] += vertexOffsets[i];
+	}
+	
+	std::vector<SkinWeight> weights(vertexOffsets[pointsSize]);
+	std::vector<int> vertexFill(vertexOffsets.begin(), vertexOffsets.end() - 1);
+	for(int i = 0; i < minorSize; ++i){
+		int vertexId = skinWeightVertices[i];
+		int deformerId = skinWeightDeformers[i];
+		if(vertexId > -1 && vertexId < pointsSize && deformerId > -1 && deformerId < deformersSize){
+			SkinWeight &weight = weights[vertexFill[vertexId]++];
+			weight.deformerId = deformerId;
+			weight.index = i;
 		}
 	}
+	
+	std::vector<Imath::V3f> outPoints = points;
+	parallelFor(pointsSize, skinWeightBody(vertexOffsets, weights, skinWeightValues, points, deformers, bindPoseInverses, outPoints));
 
-	_outPoints->outValue()->setVec3ValuesSlice(slice, outPoints);
+	_outPoints->outValue()->swapVec3ValuesSlice(slice, outPoints);
 }
@@ -0,0 +1,991 @@
+// <license>
+// Copyright (C) 2011 Andrea Interguglielmi, All rights reserved.
+// This file is part of the coral repository downloaded from http://code.google.com/p/coral-repo.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// 
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+// 
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+// IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// </license>
+
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+
+#include <ImathVec.h>
+#include <ImathColor.h>
+#include <ImathMatrix.h>
+
+#include "ExpressionNode.h"
+#include "../src/stringUtils.h"
+#include "../src/simdUtils.h"
+
+using namespace coral;
+
+namespace{
+	// block of values evaluated by each instruction before moving on to the next block, small enough for the scratch buffers to stay in cache.
+	const int blockSize = 128;
+	const int maxTypeSize = sizeof(Imath::M44f);
+	
+	struct ExpressionTerm{
+		char operation; // 0 for inputs and constants
+		int termA;
+		int termB;
+		std::string name; // empty for constants
+		bool isInt;
+		int intValue;
+		float floatValue;
+	};
+	
+	//! Recursive descent parser, terms are appended after their operands so the resulting vector is already in evaluation order.
+	class ExpressionParser{
+	public:
+		ExpressionParser(const std::string &expression, std::vector<ExpressionTerm> &terms):
+			_expression(expression),
+			_position(0),
+			_terms(terms){
+		}
+		
+		void parse(std::string &error){
+			parseSum(error);
+			
+			if(error.empty()){
+				skipSpaces();
+				if(_position < _expression.size()){
+					error = "unexpected '" + _expression.substr(_position, 1) + "'";
+				}
+			}
+		}
+		
+	private:
+		void skipSpaces(){
+			while(_position < _expression.size() && isspace(_expression[_position])){
+				_position++;
+			}
+		}
+		
+		char peek(){
+			skipSpaces();
+			if(_position < _expression.size()){
+				return _expression[_position];
+			}
+			
+			return 0;
+		}
+		
+		int addOperation(char operation, int termA, int termB){
+			ExpressionTerm term;
+			term.operation = operation;
+			term.termA = termA;
+			term.termB = termB;
+			term.isInt = false;
+			term.intValue = 0;
+			term.floatValue = 0.0;
+			
+			_terms.push_back(term);
+			return _terms.size() - 1;
+		}
+		
+		int addLeaf(const std::string &name, bool isInt, int intValue, float floatValue){
+			ExpressionTerm term;
+			term.operation = 0;
+			term.termA = -1;
+			term.termB = -1;
+			term.name = name;
+			term.isInt = isInt;
+			term.intValue = intValue;
+			term.floatValue = floatValue;
+			
+			_terms.push_back(term);
+			return _terms.size() - 1;
+		}
+		
+		int parseSum(std::string &error){
+			int term = parseProduct(error);
+			
+			char operation = peek();
+			while(error.empty() && (operation == '+' || operation == '-')){
+				_position++;
+				int termB = parseProduct(error);
+				term = addOperation(operation, term, termB);
+				
+				operation = peek();
+			}
+			
+			return term;
+		}
+		
+		int parseProduct(std::string &error){
+			int term = parseUnary(error);
+			
+			char operation = peek();
+			while(error.empty() && (operation == '*' || operation == '/')){
+				_position++;
+				int termB = parseUnary(error);
+				term = addOperation(operation, term, termB);
+				
+				operation = peek();
+			}
+			
+			return term;
+		}
+		
+		int parseUnary(std::string &error){
+			char character = peek();
+			if(character == '-'){
+				_position++;
+				int term = parseUnary(error);
+				if(!error.empty()){
+					return term;
+				}
+				
+				ExpressionTerm &operand = _terms[term];
+				if(operand.operation == 0 && operand.name.empty()){
+					operand.intValue = -operand.intValue;
+					operand.floatValue = -operand.floatValue;
+					return term;
+				}
+				
+				// multiplying by an int is allowed for every type that can be negated
+				int minusOne = addLeaf("", true, -1, -1.0);
+				return addOperation('*', term, minusOne);
+			}
+			else if(character == '+'){
+				_position++;
+				return parseUnary(error);
+			}
+			
+			return parsePrimary(error);
+		}
+		
+		int parsePrimary(std::string &error){
+			char character = peek();
+			
+			if(character == '('){
+				_position++;
+				int term = parseSum(error);
+				if(error.empty()){
+					if(peek() == ')'){
+						_position++;
+					}
+					else{
+						error = "missing ')'";
+					}
+				}
+				
+				return term;
+			}
+			else if(isdigit(character) || character == '.'){
+				return parseNumber(error);
+			}
+			else if(isalpha(character) || character == '_'){
+				unsigned int start = _position;
+				while(_position < _expression.size() && (isalnum(_expression[_position]) || _expression[_position] == '_')){
+					_position++;
+				}
+				
+				return addLeaf(_expression.substr(start, _position - start), false, 0, 0.0);
+			}
+			else if(character == 0){
+				error = "unexpected end of expression";
+			}
+			else{
+				error = "unexpected '" + std::string(1, character) + "'";
+			}
+			
+			return -1;
+		}
+		
+		int parseNumber(std::string &error){
+			unsigned int start = _position;
+			bool isInt = true;
+			
+			while(_position < _expression.size() && isdigit(_expression[_position])){
+				_position++;
+			}
+			
+			if(_position < _expression.size() && _expression[_position] == '.'){
+				isInt = false;
+				_position++;
+				while(_position < _expression.size() && isdigit(_expression[_position])){
+					_position++;
+				}
+			}
+			
+			if(_position < _expression.size() && (_expression[_position] == 'e' || _expression[_position] == 'E')){
+				isInt = false;
+				_position++;
+				if(_position < _expression.size() && (_expression[_position] == '+' || _expression[_position] == '-')){
+					_position++;
+				}
+				
+				if(_position >= _expression.size() || !isdigit(_expression[_position])){
+					error = "invalid number '" + _expression.substr(start, _position - start) + "'";
+					return -1;
+				}
+				
+				while(_position < _expression.size() && isdigit(_expression[_position])){
+					_position++;
+				}
+			}
+			
+			std::string number = _expression.substr(start, _position - start);
+			if(number == "."){
+				error = "invalid number '.'";
+				return -1;
+			}
+			
+			// scanned the same way as saved values, '.' is the decimal point whatever the locale
+			const char *numberStr = number.c_str();
+			if(isInt){
+				int intValue = 0;
+				if(!stringUtils::scanInt(numberStr, intValue)){
+					error = "int out of range '" + number + "'";
+					return -1;
+				}
+				
+				return addLeaf("", true, intValue, float(intValue));
+			}
+			
+			float floatValue = 0.0;
+			if(!stringUtils::scanFloat(numberStr, floatValue)){
+				error = "invalid number '" + number + "'";
+				return -1;
+			}
+			
+			return addLeaf("", false, 0, floatValue);
+		}
+		
+		const std::string &_expression;
+		unsigned int _position;
+		std::vector<ExpressionTerm> &_terms;
+	};
+	
+	Numeric::Type singleType(Numeric::Type type, bool &isArray){
+		isArray = true;
+		
+		if(type == Numeric::numericTypeIntArray){
+			return Numeric::numericTypeInt;
+		}
+		else if(type == Numeric::numericTypeFloatArray){
+			return Numeric::numericTypeFloat;
+		}
+		else if(type == Numeric::numericTypeVec3Array){
+			return Numeric::numericTypeVec3;
+		}
+		else if(type == Numeric::numericTypeCol4Array){
+			return Numeric::numericTypeCol4;
+		}
+		else if(type == Numeric::numericTypeQuatArray){
+			return Numeric::numericTypeQuat;
+		}
+		else if(type == Numeric::numericTypeMatrix44Array){
+			return Numeric::numericTypeMatrix44;
+		}
+		
+		isArray = false;
+		return type;
+	}
+	
+	std::string typeName(Numeric::Type type, bool isArray){
+		std::string name = "Any";
+		if(type == Numeric::numericTypeInt){
+			name = "Int";
+		}
+		else if(type == Numeric::numericTypeFloat){
+			name = "Float";
+		}
+		else if(type == Numeric::numericTypeVec3){
+			name = "Vec3";
+		}
+		else if(type == Numeric::numericTypeCol4){
+			name = "Col4";
+		}
+		else if(type == Numeric::numericTypeQuat){
+			name = "Quat";
+		}
+		else if(type == Numeric::numericTypeMatrix44){
+			name = "Matrix44";
+		}
+		
+		if(isArray){
+			name += "Array";
+		}
+		
+		return name;
+	}
+	
+	int typeSize(Numeric::Type type){
+		if(type == Numeric::numericTypeInt){
+			return sizeof(int);
+		}
+		else if(type == Numeric::numericTypeFloat){
+			return sizeof(float);
+		}
+		else if(type == Numeric::numericTypeVec3){
+			return sizeof(Imath::V3f);
+		}
+		else if(type == Numeric::numericTypeCol4){
+			return sizeof(Imath::Color4f);
+		}
+		else if(type == Numeric::numericTypeQuat){
+			return sizeof(Imath::Quatf);
+		}
+		else if(type == Numeric::numericTypeMatrix44){
+			return sizeof(Imath::M44f);
+		}
+		
+		return 0;
+	}
+	
+	template<class type>
+	const char *vectorValues(const std::vector<type> &values, int &size){
+		size = values.size();
+		if(size){
+			return reinterpret_cast<const char*>(&values[0]);
+		}
+		
+		return 0;
+	}
+	
+	template<class type>
+	char *resizedVectorValues(std::vector<type> &values, int size){
+		values.resize(size);
+		if(size){
+			return reinterpret_cast<char*>(&values[0]);
+		}
+		
+		return 0;
+	}
+	
+	const char *sliceValues(Numeric *numeric, Numeric::Type type, unsigned int slice, int &size){
+		size = 0;
+		
+		if(type == Numeric::numericTypeInt){
+			return vectorValues(numeric->intValuesSlice(slice), size);
+		}
+		else if(type == Numeric::numericTypeFloat){
+			return vectorValues(numeric->floatValuesSlice(slice), size);
+		}
+		else if(type == Numeric::numericTypeVec3){
+			return vectorValues(numeric->vec3ValuesSlice(slice), size);
+		}
+		else if(type == Numeric::numericTypeCol4){
+			return vectorValues(numeric->col4ValuesSlice(slice), size);
+		}
+		else if(type == Numeric::numericTypeQuat){
+			return vectorValues(numeric->quatValuesSlice(slice), size);
+		}
+		else if(type == Numeric::numericTypeMatrix44){
+			return vectorValues(numeric->matrix44ValuesSlice(slice), size);
+		}
+		
+		return 0;
+	}
+	
+	char *resizedSliceValues(Numeric *numeric, Numeric::Type type, unsigned int slice, int size){
+		if(type == Numeric::numericTypeInt){
+			return resizedVectorValues(numeric->mutableIntValuesSlice(slice), size);
+		}
+		else if(type == Numeric::numericTypeFloat){
+			return resizedVectorValues(numeric->mutableFloatValuesSlice(slice), size);
+		}
+		else if(type == Numeric::numericTypeVec3){
+			return resizedVectorValues(numeric->mutableVec3ValuesSlice(slice), size);
+		}
+		else if(type == Numeric::numericTypeCol4){
+			return resizedVectorValues(numeric->mutableCol4ValuesSlice(slice), size);
+		}
+		else if(type == Numeric::numericTypeQuat){
+			return resizedVectorValues(numeric->mutableQuatValuesSlice(slice), size);
+		}
+		else if(type == Numeric::numericTypeMatrix44){
+			return resizedVectorValues(numeric->mutableMatrix44ValuesSlice(slice), size);
+		}
+		
+		return 0;
+	}
+	
+	NumericOperation::Operation numericOperation(char operation){
+		if(operation == '+'){
+			return NumericOperation::numericOperationAdd;
+		}
+		else if(operation == '-'){
+			return NumericOperation::numericOperationSub;
+		}
+		else if(operation == '*'){
+			return NumericOperation::numericOperationMul;
+		}
+		
+		return NumericOperation::numericOperationDiv;
+	}
+	
+	// The operators are applied exactly like numericOperationAlgos.h does, the result is converted to the type of the first operand.
+	struct AddOperation{
+		static const simdUtils::Operation simdOperation = simdUtils::operationAdd;
+		
+		template<class TypeA, class TypeB>
+		static TypeA apply(const TypeA &valueA, const TypeB &valueB){
+			return valueA + valueB;
+		}
+	};
+	
+	struct SubOperation{
+		static const simdUtils::Operation simdOperation = simdUtils::operationSub;
+		
+		template<class TypeA, class TypeB>
+		static TypeA apply(const TypeA &valueA, const TypeB &valueB){
+			return valueA - valueB;
+		}
+	};
+	
+	struct MulOperation{
+		static const simdUtils::Operation simdOperation = simdUtils::operationMul;
+		
+		template<class TypeA, class TypeB>
+		static TypeA apply(const TypeA &valueA, const TypeB &valueB){
+			return valueA * valueB;
+		}
+	};
+	
+	struct DivOperation{
+		static const simdUtils::Operation simdOperation = simdUtils::operationDiv;
+		
+		template<class TypeA, class TypeB>
+		static TypeA apply(const TypeA &valueA, const TypeB &valueB){
+			return valueA / valueB;
+		}
+	};
+	
+	template<class TypeA, class TypeB>
+	struct IsSameType{
+		enum{value = 0};
+	};
+	
+	template<class Type>
+	struct IsSameType<Type, Type>{
+		enum{value = 1};
+	};
+	
+	// number of floats packed in the types the vectorized kernels can treat as flat float arrays.
+	template<class Type>
+	struct NumericTypeOf{
+	};
+	
+	template<>
+	struct NumericTypeOf<int>{
+		enum{type = Numeric::numericTypeInt};
+	};
+	
+	template<>
+	struct NumericTypeOf<float>{
+		enum{type = Numeric::numericTypeFloat};
+	};
+	
+	template<>
+	struct NumericTypeOf<Imath::V3f>{
+		enum{type = Numeric::numericTypeVec3};
+	};
+	
+	template<>
+	struct NumericTypeOf<Imath::Color4f>{
+		enum{type = Numeric::numericTypeCol4};
+	};
+	
+	template<>
+	struct NumericTypeOf<Imath::M44f>{
+		enum{type = Numeric::numericTypeMatrix44};
+	};
+	
+	template<class Type>
+	struct FloatComponents{
+		enum{count = 0};
+	};
+	
+	template<>
+	struct FloatComponents<float>{
+		enum{count = 1};
+	};
+	
+	template<>
+	struct FloatComponents<Imath::V3f>{
+		enum{count = 3};
+	};
+	
+	template<>
+	struct FloatComponents<Imath::Color4f>{
+		enum{count = 4};
+	};
+	
+	template<class TypeA, class TypeB, class Operation>
+	struct ExpressionKernel{
+		static void run(const char *valuesA, bool broadcastA, const char *valuesB, bool broadcastB, char *result, int size){
+			const TypeA *operandA = reinterpret_cast<const TypeA*>(valuesA);
+			const TypeB *operandB = reinterpret_cast<const TypeB*>(valuesB);
+			TypeA *resultValues = reinterpret_cast<TypeA*>(result);
+			
+			if(!broadcastA && !broadcastB){
+				if(IsSameType<TypeA, TypeB>::value && FloatComponents<TypeA>::count > 0){
+					simdUtils::floatArrays(Operation::simdOperation, reinterpret_cast<const float*>(valuesA), reinterpret_cast<const float*>(valuesB), reinterpret_cast<float*>(result), size * FloatComponents<TypeA>::count);
+				}
+				else if(IsSameType<TypeA, int>::value && IsSameType<TypeB, int>::value){
+					simdUtils::intArrays(Operation::simdOperation, reinterpret_cast<const int*>(valuesA), reinterpret_cast<const int*>(valuesB), reinterpret_cast<int*>(result), size);
+				}
+				else{
+					for(int i = 0; i < size; ++i){
+						resultValues[i] = Operation::apply(operandA[i], operandB[i]);
+					}
+				}
+			}
+			else if(!broadcastA){
+				if(IsSameType<TypeB, float>::value && FloatComponents<TypeA>::count > 0){
+					simdUtils::floatArrayScalar(Operation::simdOperation, reinterpret_cast<const float*>(valuesA), *reinterpret_cast<const float*>(valuesB), reinterpret_cast<float*>(result), size * FloatComponents<TypeA>::count);
+				}
+				else if(IsSameType<TypeA, int>::value && IsSameType<TypeB, int>::value){
+					simdUtils::intArrayScalar(Operation::simdOperation, reinterpret_cast<const int*>(valuesA), *reinterpret_cast<const int*>(valuesB), reinterpret_cast<int*>(result), size);
+				}
+				else{
+					const TypeB valueB = operandB[0];
+					for(int i = 0; i < size; ++i){
+						resultValues[i] = Operation::apply(operandA[i], valueB);
+					}
+				}
+			}
+			else if(!broadcastB){
+				const TypeA valueA = operandA[0];
+				for(int i = 0; i < size; ++i){
+					resultValues[i] = Operation::apply(valueA, operandB[i]);
+				}
+			}
+			else{
+				resultValues[0] = Operation::apply(operandA[0], operandB[0]);
+			}
+		}
+	};
+	
+	template<>
+	struct ExpressionKernel<Imath::V3f, Imath::M44f, MulOperation>{
+		static void run(const char *valuesA, bool broadcastA, const char *valuesB, bool broadcastB, char *result, int size){
+			const Imath::V3f *operandA = reinterpret_cast<const Imath::V3f*>(valuesA);
+			const Imath::M44f *operandB = reinterpret_cast<const Imath::M44f*>(valuesB);
+			Imath::V3f *resultValues = reinterpret_cast<Imath::V3f*>(result);
+			
+			if(broadcastB){
+				simdUtils::vec3MulMatrix44(operandA, operandB[0], resultValues, broadcastA ? 1 : size);
+				
+				for(int i = 1; broadcastA && i < size; ++i){
+					resultValues[i] = resultValues[0];
+				}
+			}
+			else{
+				for(int i = 0; i < size; ++i){
+					resultValues[i] = operandA[broadcastA ? 0 : i] * operandB[i];
+				}
+			}
+		}
+	};
+	
+	template<int operation>
+	struct OperationOf{
+	};
+	
+	template<>
+	struct OperationOf<NumericOperation::numericOperationAdd>{
+		typedef AddOperation Type;
+	};
+	
+	template<>
+	struct OperationOf<NumericOperation::numericOperationSub>{
+		typedef SubOperation Type;
+	};
+	
+	template<>
+	struct OperationOf<NumericOperation::numericOperationMul>{
+		typedef MulOperation Type;
+	};
+	
+	template<>
+	struct OperationOf<NumericOperation::numericOperationDiv>{
+		typedef DivOperation Type;
+	};
+	
+	const int numericTypes = Numeric::numericTypeMatrix44Array + 1;
+	const int numericOperations = NumericOperation::numericOperationDiv + 1;
+	
+	// filled from the pairs of the NumericOperation kernel table, so an expression accepts exactly what the arithmetic nodes do.
+	struct ExpressionKernels{
+		ExpressionNode::Kernel kernels[numericOperations][numericTypes][numericTypes];
+		
+		ExpressionKernels(){
+			for(int operation = 0; operation < numericOperations; ++operation){
+				for(int typeA = 0; typeA < numericTypes; ++typeA){
+					for(int typeB = 0; typeB < numericTypes; ++typeB){
+						kernels[operation][typeA][typeB] = 0;
+					}
+				}
+			}
+			
+			NumericOperation::visitSupportedPairs(*this);
+		}
+		
+		template<NumericOperation::Operation operation, class TypeA, class TypeB>
+		void visit(){
+			Numeric::Type typeA = Numeric::Type(NumericTypeOf<TypeA>::type);
+			Numeric::Type typeB = Numeric::Type(NumericTypeOf<TypeB>::type);
+			kernels[operation][typeA][typeB] = &ExpressionKernel<TypeA, TypeB, typename OperationOf<operation>::Type>::run;
+		}
+	};
+	
+	ExpressionKernels expressionKernels;
+	
+	// operand types are always single types here, the instructions keep track of arrays on their own.
+	ExpressionNode::Kernel selectKernel(NumericOperation::Operation operation, Numeric::Type typeA, Numeric::Type typeB){
+		if(typeA < 0 || typeA >= numericTypes || typeB < 0 || typeB >= numericTypes){
+			return 0;
+		}
+		
+		return expressionKernels.kernels[operation][typeA][typeB];
+	}
+	
+	std::vector<std::string> expressionSpecializations(){
+		std::vector<std::string> specs;
+		specs.push_back("Int");
+		specs.push_back("IntArray");
+		specs.push_back("Float");
+		specs.push_back("FloatArray");
+		specs.push_back("Vec3");
+		specs.push_back("Vec3Array");
+		specs.push_back("Col4");
+		specs.push_back("Col4Array");
+		specs.push_back("Matrix44");
+		specs.push_back("Matrix44Array");
+		
+		return specs;
+	}
+}
+
+ExpressionNode::ExpressionNode(const std::string &name, Node *parent): 
+	Node(name, parent),
+	_compiled(false){
+	setSliceable(true);
+	setAllowDynamicAttributes(true);
+	
+	_expression = new StringAttribute("expression", this);
+	_a = new NumericAttribute("a", this);
+	_out = new NumericAttribute("out", this);
+	
+	addInputAttribute(_expression);
+	addInputAttribute(_a);
+	addOutputAttribute(_out);
+	
+	setAttributeAffect(_expression, _out);
+	setAttributeAffect(_a, _out);
+	
+	std::vector<std::string> specs = expressionSpecializations();
+	setAttributeAllowedSpecializations(_a, specs);
+	setAttributeAllowedSpecializations(_out, specs);
+	setAttributeAllowedSpecialization(_expression, "String");
+	
+	addAttributeSpecializationLink(_a, _out);
+	
+	catchAttributeDirtied(_expression);
+	
+	std::string expression = "a";
+	_expression->outValue()->setStringValueAt(0, expression);
+}
+
+void ExpressionNode::addNumericAttribute(){
+	// inputs are named b, c, d... to be used straight away in the expression
+	int inputs = dynamicAttributes().size() + 1;
+	std::string name = "in" + stringUtils::intToString(inputs);
+	if(inputs < 26){
+		name = std::string(1, char('a' + inputs));
+	}
+	
+	NumericAttribute *attr = new NumericAttribute(name, this);
+	addInputAttribute(attr);
+	addDynamicAttribute(attr);
+	updateAttributeSpecialization(attr);
+}
+
+void ExpressionNode::addDynamicAttribute(Attribute *attribute){
+	Node::addDynamicAttribute(attribute);
+	
+	if(attribute->isInput() && dynamic_cast<NumericAttribute*>(attribute)){
+		setAttributeAffect(attribute, _out);
+		setAttributeAllowedSpecializations(attribute, expressionSpecializations());
+	}
+	
+	_compiled = false;
+}
+
+void ExpressionNode::removeDynamicAttribute(Attribute *attribute){
+	Node::removeDynamicAttribute(attribute);
+	
+	_compiled = false;
+	_operands.clear();
+	_instructions.clear();
+}
+
+void ExpressionNode::attributeDirtied(Attribute *attribute){
+	if(attribute == _expression){
+		_compiled = false;
+	}
+}
+
+void ExpressionNode::attributeSpecializationChanged(Attribute *attribute){
+	_compiled = false;
+}
+
+bool ExpressionNode::compile(std::string &error){
+	_operands.clear();
+	_instructions.clear();
+	
+	Numeric::Type outType = _out->outValue()->type();
+	if(outType == Numeric::numericTypeAny){
+		return false;
+	}
+	
+	std::string expression = _expression->value()->stringValueAt(0);
+	std::vector<ExpressionTerm> terms;
+	ExpressionParser(expression, terms).parse(error);
+	if(!error.empty()){
+		error = "expression: " + error;
+		return false;
+	}
+	
+	// inputs and constants come first, followed by the result of each operation.
+	std::vector<int> slots(terms.size());
+	for(int i = 0; i < terms.size(); ++i){
+		const ExpressionTerm &term = terms[i];
+		if(term.operation){
+			continue;
+		}
+		
+		Operand operand;
+		operand.attribute = 0;
+		operand.intValue = term.intValue;
+		operand.floatValue = term.floatValue;
+		operand.isArray = false;
+		
+		if(term.name.empty()){
+			operand.type = term.isInt ? Numeric::numericTypeInt : Numeric::numericTypeFloat;
+		}
+		else{
+			Attribute *attribute = findAttribute(term.name);
+			if(!attribute || !attribute->isInput() || !dynamic_cast<NumericAttribute*>(attribute)){
+				error = "expression: no numeric input named '" + term.name + "'";
+				return false;
+			}
+			
+			Numeric::Type type = ((Numeric*)attribute->value())->type();
+			if(type == Numeric::numericTypeAny){
+				error = "expression: input '" + term.name + "' is not connected";
+				return false;
+			}
+			
+			operand.attribute = attribute;
+			operand.type = singleType(type, operand.isArray);
+		}
+		
+		slots[i] = _operands.size();
+		_operands.push_back(operand);
+	}
+	
+	for(int i = 0; i < terms.size(); ++i){
+		const ExpressionTerm &term = terms[i];
+		if(!term.operation){
+			continue;
+		}
+		
+		int slotA = slots[term.termA];
+		int slotB = slots[term.termB];
+		
+		bool isArrayA, isArrayB;
+		Numeric::Type typeA, typeB;
+		if(slotA < _operands.size()){
+			typeA = _operands[slotA].type;
+			isArrayA = _operands[slotA].isArray;
+		}
+		else{
+			typeA = _instructions[slotA - _operands.size()].type;
+			isArrayA = _instructions[slotA - _operands.size()].isArray;
+		}
+		
+		if(slotB < _operands.size()){
+			typeB = _operands[slotB].type;
+			isArrayB = _operands[slotB].isArray;
+		}
+		else{
+			typeB = _instructions[slotB - _operands.size()].type;
+			isArrayB = _instructions[slotB - _operands.size()].isArray;
+		}
+		
+		NumericOperation::Operation operation = numericOperation(term.operation);
+		Kernel kernel = selectKernel(operation, typeA, typeB);
+		
+		if(!kernel){
+			error = "expression: can't apply '" + std::string(1, term.operation) + "' to " + typeName(typeA, isArrayA) + " and " + typeName(typeB, isArrayB);
+			return false;
+		}
+		
+		Instruction instruction;
+		instruction.type = typeA;
+		instruction.isArray = isArrayA || isArrayB;
+		instruction.operandA = slotA;
+		instruction.operandB = slotB;
+		instruction.kernel = kernel;
+		
+		slots[i] = _operands.size() + _instructions.size();
+		_instructions.push_back(instruction);
+	}
+	
+	Numeric::Type resultType;
+	bool resultIsArray;
+	if(_instructions.size()){
+		resultType = _instructions.back().type;
+		resultIsArray = _instructions.back().isArray;
+	}
+	else{
+		resultType = _operands.back().type;
+		resultIsArray = _operands.back().isArray;
+	}
+	
+	bool outIsArray;
+	Numeric::Type outSingleType = singleType(outType, outIsArray);
+	if(resultType != outSingleType || resultIsArray != outIsArray){
+		error = "expression: the result is " + typeName(resultType, resultIsArray) + " but input 'a' is " + typeName(outSingleType, outIsArray);
+		return false;
+	}
+	
+	return true;
+}
+
+void ExpressionNode::update(Attribute *attribute){
+	if(!_compiled){
+		std::string error;
+		_compiled = compile(error);
+		setIsInvalid(!error.empty(), error);
+	}
+	
+	Node::update(attribute);
+}
+
+void ExpressionNode::updateSlice(Attribute *attribute, unsigned int slice){
+	if(!_compiled){
+		return;
+	}
+	
+	Numeric *out = _out->outValue();
+	
+	if(_instructions.empty()){
+		const Operand &operand = _operands[0];
+		if(operand.attribute){
+			out->shareSlice(slice, (Numeric*)operand.attribute->value(), slice);
+		}
+		else{
+			const char *value = operand.type == Numeric::numericTypeInt ? (const char*)&operand.intValue : (const char*)&operand.floatValue;
+			memcpy(resizedSliceValues(out, operand.type, slice, 1), value, typeSize(operand.type));
+		}
+		
+		return;
+	}
+	
+	int operandsCount = _operands.size();
+	int instructionsCount = _instructions.size();
+	std::vector<const char*> values(operandsCount + instructionsCount);
+	std::vector<const char*> operandValues(operandsCount);
+	std::vector<char> broadcast(operandsCount + instructionsCount);
+	
+	// arrays are processed up to the shortest one and single values apply to every element.
+	int size = -1;
+	bool emptyOperand = false;
+	for(int i = 0; i < operandsCount; ++i){
+		const Operand &operand = _operands[i];
+		
+		if(operand.attribute){
+			int operandSize = 0;
+			operandValues[i] = sliceValues((Numeric*)operand.attribute->value(), operand.type, slice, operandSize);
+			
+			if(operand.isArray){
+				if(size == -1 || operandSize < size){
+					size = operandSize;
+				}
+			}
+			else if(operandSize == 0){
+				emptyOperand = true;
+			}
+		}
+		else if(operand.type == Numeric::numericTypeInt){
+			operandValues[i] = (const char*)&operand.intValue;
+		}
+		else{
+			operandValues[i] = (const char*)&operand.floatValue;
+		}
+		
+		values[i] = operandValues[i];
+		broadcast[i] = !operand.isArray;
+	}
+	
+	if(size == -1){
+		size = 1;
+	}
+	
+	if(emptyOperand){
+		size = 0;
+	}
+	
+	const Instruction &lastInstruction = _instructions.back();
+	int resultTypeSize = typeSize(lastInstruction.type);
+	char *result = resizedSliceValues(out, lastInstruction.type, slice, size);
+	
+	std::vector<char> scratch(instructionsCount * blockSize * maxTypeSize);
+	
+	for(int begin = 0; begin < size; begin += blockSize){
+		int count = size - begin;
+		if(count > blockSize){
+			count = blockSize;
+		}
+		
+		for(int i = 0; i < operandsCount; ++i){
+			if(!broadcast[i]){
+				values[i] = operandValues[i] + begin * typeSize(_operands[i].type);
+			}
+		}
+		
+		for(int i = 0; i < instructionsCount; ++i){
+			const Instruction &instruction = _instructions[i];
+			int slot = operandsCount + i;
+			
+			bool broadcastResult = broadcast[instruction.operandA] && broadcast[instruction.operandB];
+			
+			char *resultValues = &scratch[i * blockSize * maxTypeSize];
+			if(i == instructionsCount - 1){
+				resultValues = result + begin * resultTypeSize;
+			}
+			
+			instruction.kernel(values[instruction.operandA], broadcast[instruction.operandA], values[instruction.operandB], broadcast[instruction.operandB], resultValues, broadcastResult ? 1 : count);
+			
+			values[slot] = resultValues;
+			broadcast[slot] = broadcastResult;
+		}
+	}
+}
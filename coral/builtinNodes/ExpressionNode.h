@@ -0,0 +1,90 @@
+// <license>
+// Copyright (C) 2011 Andrea Interguglielmi, All rights reserved.
+// This file is part of the coral repository downloaded from http://code.google.com/p/coral-repo.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// 
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+// 
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+// IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// </license>
+
+#ifndef CORAL_EXPRESSIONNODE_H
+#define CORAL_EXPRESSIONNODE_H
+
+#include <string>
+#include <vector>
+
+#include "../src/Node.h"
+#include "../src/NumericAttribute.h"
+#include "../src/StringAttribute.h"
+#include "NumericOperation.h"
+
+namespace coral{
+
+//! Evaluates an arithmetic expression such as "a * b + c * 0.5" over its numeric inputs in a single pass.
+//! Inputs are referred to by name, "a" is always there and more inputs are added with addNumericAttribute().
+//! The expression supports + - * /, unary minus, parentheses and int or float constants,
+//! each operation is checked against the same rules used by the Add, Sub, Mul and Div nodes and the result must have the type of input "a".
+//! Values are processed in small blocks that stay in cache, no intermediate array is allocated for the sub expressions.
+//! Unlike the arithmetic nodes, a single value combined with an array applies to each element instead of accumulating the array.
+class ExpressionNode: public Node{
+public:
+	ExpressionNode(const std::string &name, Node *parent);
+	void addNumericAttribute();
+	void addDynamicAttribute(Attribute *attribute);
+	void removeDynamicAttribute(Attribute *attribute);
+	void attributeDirtied(Attribute *attribute);
+	void attributeSpecializationChanged(Attribute *attribute);
+	void update(Attribute *attribute);
+	void updateSlice(Attribute *attribute, unsigned int slice);
+	
+	typedef void (*Kernel)(const char *valuesA, bool broadcastA, const char *valuesB, bool broadcastB, char *result, int size);
+	
+private:
+	struct Operand{
+		Numeric::Type type; // always a single type, isArray tells the rest
+		bool isArray;
+		Attribute *attribute; // null for constants
+		int intValue;
+		float floatValue;
+	};
+	
+	struct Instruction{
+		Numeric::Type type;
+		bool isArray;
+		int operandA; // operands first, then the result of each instruction
+		int operandB;
+		Kernel kernel;
+	};
+	
+	bool compile(std::string &error);
+	
+	StringAttribute *_expression;
+	NumericAttribute *_a;
+	NumericAttribute *_out;
+	std::vector<Operand> _operands;
+	std::vector<Instruction> _instructions;
+	bool _compiled;
+};
+
+}
+
+#endif
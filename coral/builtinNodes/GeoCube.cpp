@@ -353,5 +353,5 @@ void GeoCube::updateSlice(Attribute *attribute, unsigned int slice){
 	otherSide = true;
 	buildDepthForHeightFaces(widthSubdivisions, depthSubdivisions, heightSubdivisions, totalPoints, otherSide, faces);
 	
-	_out->outValue()->build(points, faces);
+	_out->outValue()->swapBuild(points, faces);
 }
@@ -122,6 +122,6 @@ void GeoGrid::updateSlice(Attribute *attribute, unsigned int slice){
 		}
 	}
 
-	_out->outValue()->build(points, faces, uvs);
+	_out->outValue()->swapBuild(points, faces, uvs);
 }
 
@@ -28,10 +28,30 @@
 
 #include "GeoNodes.h"
 #include "../src/Numeric.h"
+#include "../src/GeoBvh.h"
 #include "../src/containerUtils.h"
 
 using namespace coral;
 
+namespace{
+	void splitHits(const std::vector<GeoBvhHit> &hits, std::vector<Imath::V3f> &points, std::vector<int> &faceIds, std::vector<Imath::V3f> &barycentrics, std::vector<int> &trianglePointsIds){
+		int hitsCount = hits.size();
+		points.resize(hitsCount);
+		faceIds.resize(hitsCount);
+		barycentrics.resize(hitsCount);
+		trianglePointsIds.resize(hitsCount * 3);
+		for(int i = 0; i < hitsCount; ++i){
+			const GeoBvhHit &hit = hits[i];
+			points[i] = hit.point;
+			faceIds[i] = hit.face;
+			barycentrics[i] = hit.barycentric;
+			trianglePointsIds[i * 3] = hit.trianglePoints[0];
+			trianglePointsIds[i * 3 + 1] = hit.trianglePoints[1];
+			trianglePointsIds[i * 3 + 2] = hit.trianglePoints[2];
+		}
+	}
+}
+
 void GetGeoElements::contextChanged(Node *parentNode, Enum *enum_){
 	GetGeoElements* self = (GetGeoElements*)parentNode;
 	int id = enum_->currentIndex();
@@ -106,7 +126,7 @@ void GetGeoElements::updateSlice(Attribute *attribute, unsigned int slice){
 		std::vector<int> elements;
 		(this->*_contextualUpdate)(geo, elements);
 		
-		_elements->outValue()->setIntValuesSlice(slice, elements);
+		_elements->outValue()->swapIntValuesSlice(slice, elements);
 	}
 }
 
@@ -211,7 +231,7 @@ void GetGeoSubElements::updateSlice(Attribute *attribute, unsigned int slice){
 		std::vector<int> subElements;
 		(this->*_contextualUpdate)(geo, index, subElements);
 		
-		_subElements->outValue()->setIntValuesSlice(slice, subElements);
+		_subElements->outValue()->swapIntValuesSlice(slice, subElements);
 	}
 }
 
@@ -318,8 +338,151 @@ void GeoNeighbourPoints::updateSlice(Attribute *attribute, unsigned int slice){
 			for(int i = 0; i < neighboursSize; ++i){
 				neighbourIds[i] = neighbourVertices[i]->id();
 			}
-			_neighbourVertices->outValue()->setIntValuesSlice(slice, neighbourIds);
+			_neighbourVertices->outValue()->swapIntValuesSlice(slice, neighbourIds);
 		}
 	}	
 }
 
+GeoClosestPoint::GeoClosestPoint(const std::string &name, Node *parent): Node(name, parent){
+	setSliceable(true);
+	
+	_geo = new GeoAttribute("geo", this);
+	_points = new NumericAttribute("points", this);
+	_closestPoint = new NumericAttribute("closestPoint", this);
+	_faceId = new NumericAttribute("faceId", this);
+	_barycentric = new NumericAttribute("barycentric", this);
+	_trianglePointsId = new NumericAttribute("trianglePointsId", this);
+	
+	addInputAttribute(_geo);
+	addInputAttribute(_points);
+	addOutputAttribute(_closestPoint);
+	addOutputAttribute(_faceId);
+	addOutputAttribute(_barycentric);
+	addOutputAttribute(_trianglePointsId);
+	
+	setAttributeAffect(_geo, _closestPoint);
+	setAttributeAffect(_geo, _faceId);
+	setAttributeAffect(_geo, _barycentric);
+	setAttributeAffect(_geo, _trianglePointsId);
+	setAttributeAffect(_points, _closestPoint);
+	setAttributeAffect(_points, _faceId);
+	setAttributeAffect(_points, _barycentric);
+	setAttributeAffect(_points, _trianglePointsId);
+	
+	setAttributeAllowedSpecialization(_points, "Vec3Array");
+	setAttributeAllowedSpecialization(_closestPoint, "Vec3Array");
+	setAttributeAllowedSpecialization(_faceId, "IntArray");
+	setAttributeAllowedSpecialization(_barycentric, "Vec3Array");
+	setAttributeAllowedSpecialization(_trianglePointsId, "IntArray");
+}
+
+void GeoClosestPoint::updateSlice(Attribute *attribute, unsigned int slice){
+	const GeoBvh &bvh = _geo->value()->bvh();
+	const std::vector<Imath::V3f> &points = _points->value()->vec3ValuesSlice(slice);
+	
+	std::vector<GeoBvhHit> hits(points.size());
+	if(points.size()){
+		bvh.closestPoints(&points[0], points.size(), &hits[0]);
+	}
+	
+	std::vector<Imath::V3f> closestPoint;
+	std::vector<int> faceId;
+	std::vector<Imath::V3f> barycentric;
+	std::vector<int> trianglePointsId;
+	splitHits(hits, closestPoint, faceId, barycentric, trianglePointsId);
+	
+	_closestPoint->outValue()->swapVec3ValuesSlice(slice, closestPoint);
+	_faceId->outValue()->swapIntValuesSlice(slice, faceId);
+	_barycentric->outValue()->swapVec3ValuesSlice(slice, barycentric);
+	_trianglePointsId->outValue()->swapIntValuesSlice(slice, trianglePointsId);
+	
+	setAttributeIsClean(_closestPoint, true);
+	setAttributeIsClean(_faceId, true);
+	setAttributeIsClean(_barycentric, true);
+	setAttributeIsClean(_trianglePointsId, true);
+}
+
+GeoRayIntersect::GeoRayIntersect(const std::string &name, Node *parent): Node(name, parent){
+	setSliceable(true);
+	
+	_geo = new GeoAttribute("geo", this);
+	_rayOrigin = new NumericAttribute("rayOrigin", this);
+	_rayDirection = new NumericAttribute("rayDirection", this);
+	_maxDistance = new NumericAttribute("maxDistance", this);
+	_hitPoint = new NumericAttribute("hitPoint", this);
+	_hitDistance = new NumericAttribute("hitDistance", this);
+	_faceId = new NumericAttribute("faceId", this);
+	_barycentric = new NumericAttribute("barycentric", this);
+	_trianglePointsId = new NumericAttribute("trianglePointsId", this);
+	
+	addInputAttribute(_geo);
+	addInputAttribute(_rayOrigin);
+	addInputAttribute(_rayDirection);
+	addInputAttribute(_maxDistance);
+	addOutputAttribute(_hitPoint);
+	addOutputAttribute(_hitDistance);
+	addOutputAttribute(_faceId);
+	addOutputAttribute(_barycentric);
+	addOutputAttribute(_trianglePointsId);
+	
+	std::vector<Attribute*> outputs;
+	outputs.push_back(_hitPoint);
+	outputs.push_back(_hitDistance);
+	outputs.push_back(_faceId);
+	outputs.push_back(_barycentric);
+	outputs.push_back(_trianglePointsId);
+	for(int i = 0; i < outputs.size(); ++i){
+		setAttributeAffect(_geo, outputs[i]);
+		setAttributeAffect(_rayOrigin, outputs[i]);
+		setAttributeAffect(_rayDirection, outputs[i]);
+		setAttributeAffect(_maxDistance, outputs[i]);
+	}
+	
+	std::vector<std::string> directionSpecializations;
+	directionSpecializations.push_back("Vec3");
+	directionSpecializations.push_back("Vec3Array");
+	
+	setAttributeAllowedSpecialization(_rayOrigin, "Vec3Array");
+	setAttributeAllowedSpecializations(_rayDirection, directionSpecializations);
+	setAttributeAllowedSpecialization(_maxDistance, "Float");
+	setAttributeAllowedSpecialization(_hitPoint, "Vec3Array");
+	setAttributeAllowedSpecialization(_hitDistance, "FloatArray");
+	setAttributeAllowedSpecialization(_faceId, "IntArray");
+	setAttributeAllowedSpecialization(_barycentric, "Vec3Array");
+	setAttributeAllowedSpecialization(_trianglePointsId, "IntArray");
+}
+
+void GeoRayIntersect::updateSlice(Attribute *attribute, unsigned int slice){
+	const GeoBvh &bvh = _geo->value()->bvh();
+	const std::vector<Imath::V3f> &rayOrigin = _rayOrigin->value()->vec3ValuesSlice(slice);
+	const std::vector<Imath::V3f> &rayDirection = _rayDirection->value()->vec3ValuesSlice(slice);
+	float maxDistance = _maxDistance->value()->floatValueAtSlice(slice, 0);
+	
+	std::vector<GeoBvhHit> hits(rayOrigin.size());
+	if(rayOrigin.size() && rayDirection.size()){
+		bvh.intersectRays(&rayOrigin[0], rayOrigin.size(), &rayDirection[0], rayDirection.size(), maxDistance, &hits[0]);
+	}
+	
+	std::vector<float> hitDistance(hits.size());
+	for(int i = 0; i < hits.size(); ++i){
+		hitDistance[i] = hits[i].distance;
+	}
+	
+	std::vector<Imath::V3f> hitPoint;
+	std::vector<int> faceId;
+	std::vector<Imath::V3f> barycentric;
+	std::vector<int> trianglePointsId;
+	splitHits(hits, hitPoint, faceId, barycentric, trianglePointsId);
+	
+	_hitPoint->outValue()->swapVec3ValuesSlice(slice, hitPoint);
+	_hitDistance->outValue()->swapFloatValuesSlice(slice, hitDistance);
+	_faceId->outValue()->swapIntValuesSlice(slice, faceId);
+	_barycentric->outValue()->swapVec3ValuesSlice(slice, barycentric);
+	_trianglePointsId->outValue()->swapIntValuesSlice(slice, trianglePointsId);
+	
+	setAttributeIsClean(_hitPoint, true);
+	setAttributeIsClean(_hitDistance, true);
+	setAttributeIsClean(_faceId, true);
+	setAttributeIsClean(_barycentric, true);
+	setAttributeIsClean(_trianglePointsId, true);
+}
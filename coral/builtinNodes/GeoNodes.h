@@ -124,6 +124,42 @@ private:
 	NumericAttribute *_neighbourVertices;
 };
 
+//! Finds the closest point on the surface of geo for each of the points, from the bvh cached by the Geo.
+//! barycentric weights the three trianglePointsId of the triangle where each closest point lies, 
+//! polygons are split in triangle fans around their first point.
+class GeoClosestPoint: public Node{
+public:
+	GeoClosestPoint(const std::string &name, Node *parent);
+	void updateSlice(Attribute *attribute, unsigned int slice);
+	
+private:
+	GeoAttribute *_geo;
+	NumericAttribute *_points;
+	NumericAttribute *_closestPoint;
+	NumericAttribute *_faceId;
+	NumericAttribute *_barycentric;
+	NumericAttribute *_trianglePointsId;
+};
+
+//! Intersects each of the rays with the surface of geo, rayDirection can be a single direction for all the rays.
+//! Rays that miss get a faceId of -1, the other outputs are laid out like the ones of GeoClosestPoint.
+class GeoRayIntersect: public Node{
+public:
+	GeoRayIntersect(const std::string &name, Node *parent);
+	void updateSlice(Attribute *attribute, unsigned int slice);
+	
+private:
+	GeoAttribute *_geo;
+	NumericAttribute *_rayOrigin;
+	NumericAttribute *_rayDirection;
+	NumericAttribute *_maxDistance;
+	NumericAttribute *_hitPoint;
+	NumericAttribute *_hitDistance;
+	NumericAttribute *_faceId;
+	NumericAttribute *_barycentric;
+	NumericAttribute *_trianglePointsId;
+};
+
 }
 
 #endif
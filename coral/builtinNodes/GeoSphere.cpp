@@ -146,5 +146,5 @@ void GeoSphere::updateSlice(Attribute *attribute, unsigned int slice){
 		}
 	}
 	
-	_out->outValue()->build(points, faces, uvs);
+	_out->outValue()->swapBuild(points, faces, uvs);
 }
@@ -0,0 +1,180 @@
+// <license>
+// Copyright (C) 2011 Andrea Interguglielmi, All rights reserved.
+// This file is part of the coral repository downloaded from http://code.google.com/p/coral-repo.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// 
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+// 
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+// IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// </license>
+
+#include "HashGridNodes.h"
+
+using namespace coral;
+
+namespace{
+	void splitOffsets(const std::vector<int> &offsets, std::vector<int> &sizes, std::vector<int> &starts){
+		unsigned int count = offsets.size() - 1;
+		sizes.resize(count);
+		starts.resize(count);
+		for(unsigned int i = 0; i < count; ++i){
+			starts[i] = offsets[i];
+			sizes[i] = offsets[i + 1] - offsets[i];
+		}
+	}
+}
+
+BuildHashGrid::BuildHashGrid(const std::string &name, Node *parent): Node(name, parent){
+	_points = new NumericAttribute("points", this);
+	_cellSize = new NumericAttribute("cellSize", this);
+	_hashGrid = new HashGridAttribute("hashGrid", this);
+	
+	addInputAttribute(_points);
+	addInputAttribute(_cellSize);
+	addOutputAttribute(_hashGrid);
+	
+	setAttributeAffect(_points, _hashGrid);
+	setAttributeAffect(_cellSize, _hashGrid);
+	
+	setAttributeAllowedSpecialization(_points, "Vec3Array");
+	setAttributeAllowedSpecialization(_cellSize, "Float");
+}
+
+void BuildHashGrid::update(Attribute *attribute){
+	float cellSize = _cellSize->value()->floatValueAt(0);
+	
+	// the same points leave the grid as it is and the query nodes downstream don't need to update
+	if(!_hashGrid->outValue()->build(_points->value()->vec3Values(), cellSize)){
+		setAttributeUnchanged(_hashGrid);
+	}
+}
+
+FindPointsInRadius::FindPointsInRadius(const std::string &name, Node *parent): Node(name, parent){
+	setSliceable(true);
+	
+	_hashGrid = new HashGridAttribute("hashGrid", this);
+	_queryPoints = new NumericAttribute("queryPoints", this);
+	_range = new NumericAttribute("range", this);
+	_pointsInRangeId = new NumericAttribute("pointsInRangeId", this);
+	_pointsInRangeSize = new NumericAttribute("pointsInRangeSize", this);
+	_pointsInRangeOffset = new NumericAttribute("pointsInRangeOffset", this);
+	
+	addInputAttribute(_hashGrid);
+	addInputAttribute(_queryPoints);
+	addInputAttribute(_range);
+	addOutputAttribute(_pointsInRangeId);
+	addOutputAttribute(_pointsInRangeSize);
+	addOutputAttribute(_pointsInRangeOffset);
+	
+	setAttributeAffect(_hashGrid, _pointsInRangeId);
+	setAttributeAffect(_hashGrid, _pointsInRangeSize);
+	setAttributeAffect(_hashGrid, _pointsInRangeOffset);
+	setAttributeAffect(_queryPoints, _pointsInRangeId);
+	setAttributeAffect(_queryPoints, _pointsInRangeSize);
+	setAttributeAffect(_queryPoints, _pointsInRangeOffset);
+	setAttributeAffect(_range, _pointsInRangeId);
+	setAttributeAffect(_range, _pointsInRangeSize);
+	setAttributeAffect(_range, _pointsInRangeOffset);
+	
+	std::vector<std::string> rangeSpecializations;
+	rangeSpecializations.push_back("Float");
+	rangeSpecializations.push_back("FloatArray");
+	
+	setAttributeAllowedSpecialization(_queryPoints, "Vec3Array");
+	setAttributeAllowedSpecializations(_range, rangeSpecializations);
+	setAttributeAllowedSpecialization(_pointsInRangeId, "IntArray");
+	setAttributeAllowedSpecialization(_pointsInRangeSize, "IntArray");
+	setAttributeAllowedSpecialization(_pointsInRangeOffset, "IntArray");
+}
+
+void FindPointsInRadius::updateSlice(Attribute *attribute, unsigned int slice){
+	const std::vector<Imath::V3f> &queryPoints = _queryPoints->value()->vec3ValuesSlice(slice);
+	const std::vector<float> &ranges = _range->value()->floatValuesSlice(slice);
+	
+	std::vector<int> offsets;
+	std::vector<int> pointsInRangeId;
+	if(queryPoints.size() && ranges.size()){
+		_hashGrid->value()->pointsInRange(&queryPoints[0], queryPoints.size(), &ranges[0], ranges.size(), offsets, pointsInRangeId);
+	}
+	else{
+		offsets.assign(queryPoints.size() + 1, 0);
+	}
+	
+	std::vector<int> pointsInRangeSize;
+	std::vector<int> pointsInRangeOffset;
+	splitOffsets(offsets, pointsInRangeSize, pointsInRangeOffset);
+	
+	_pointsInRangeId->outValue()->swapIntValuesSlice(slice, pointsInRangeId);
+	_pointsInRangeSize->outValue()->swapIntValuesSlice(slice, pointsInRangeSize);
+	_pointsInRangeOffset->outValue()->swapIntValuesSlice(slice, pointsInRangeOffset);
+	
+	setAttributeIsClean(_pointsInRangeId, true);
+	setAttributeIsClean(_pointsInRangeSize, true);
+	setAttributeIsClean(_pointsInRangeOffset, true);
+}
+
+FindPairsInRadius::FindPairsInRadius(const std::string &name, Node *parent): Node(name, parent){
+	setSliceable(true);
+	
+	_hashGrid = new HashGridAttribute("hashGrid", this);
+	_range = new NumericAttribute("range", this);
+	_pointsInRangeId = new NumericAttribute("pointsInRangeId", this);
+	_pointsInRangeSize = new NumericAttribute("pointsInRangeSize", this);
+	_pointsInRangeOffset = new NumericAttribute("pointsInRangeOffset", this);
+	
+	addInputAttribute(_hashGrid);
+	addInputAttribute(_range);
+	addOutputAttribute(_pointsInRangeId);
+	addOutputAttribute(_pointsInRangeSize);
+	addOutputAttribute(_pointsInRangeOffset);
+	
+	setAttributeAffect(_hashGrid, _pointsInRangeId);
+	setAttributeAffect(_hashGrid, _pointsInRangeSize);
+	setAttributeAffect(_hashGrid, _pointsInRangeOffset);
+	setAttributeAffect(_range, _pointsInRangeId);
+	setAttributeAffect(_range, _pointsInRangeSize);
+	setAttributeAffect(_range, _pointsInRangeOffset);
+	
+	setAttributeAllowedSpecialization(_range, "Float");
+	setAttributeAllowedSpecialization(_pointsInRangeId, "IntArray");
+	setAttributeAllowedSpecialization(_pointsInRangeSize, "IntArray");
+	setAttributeAllowedSpecialization(_pointsInRangeOffset, "IntArray");
+}
+
+void FindPairsInRadius::updateSlice(Attribute *attribute, unsigned int slice){
+	float range = _range->value()->floatValuesSlice(slice)[0];
+	
+	std::vector<int> offsets;
+	std::vector<int> pointsInRangeId;
+	_hashGrid->value()->pairsInRange(range, offsets, pointsInRangeId);
+	
+	std::vector<int> pointsInRangeSize;
+	std::vector<int> pointsInRangeOffset;
+	splitOffsets(offsets, pointsInRangeSize, pointsInRangeOffset);
+	
+	_pointsInRangeId->outValue()->swapIntValuesSlice(slice, pointsInRangeId);
+	_pointsInRangeSize->outValue()->swapIntValuesSlice(slice, pointsInRangeSize);
+	_pointsInRangeOffset->outValue()->swapIntValuesSlice(slice, pointsInRangeOffset);
+	
+	setAttributeIsClean(_pointsInRangeId, true);
+	setAttributeIsClean(_pointsInRangeSize, true);
+	setAttributeIsClean(_pointsInRangeOffset, true);
+}
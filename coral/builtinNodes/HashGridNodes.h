@@ -0,0 +1,88 @@
+// <license>
+// Copyright (C) 2011 Andrea Interguglielmi, All rights reserved.
+// This file is part of the coral repository downloaded from http://code.google.com/p/coral-repo.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// 
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+// 
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+// IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// </license>
+
+#ifndef CORAL_HASHGRIDNODES_H
+#define CORAL_HASHGRIDNODES_H
+
+#include <ImathVec.h>
+
+#include "../src/Node.h"
+#include "../src/NumericAttribute.h"
+#include "../src/Numeric.h"
+#include "../src/HashGridAttribute.h"
+
+namespace coral
+{
+
+//! Sorts a Vec3Array into a HashGrid of cellSize, cellSize should be about the range the grid will be queried with.
+class BuildHashGrid: public Node{
+public:
+	BuildHashGrid(const std::string &name, Node *parent);
+	void update(Attribute *attribute);
+	
+private:
+	NumericAttribute *_points;
+	NumericAttribute *_cellSize;
+	HashGridAttribute *_hashGrid;
+};
+
+//! Finds the points of hashGrid within range of each of the queryPoints, range can be a single value or one value per query.
+//! The ids of all the queries are laid out back to back in pointsInRangeId, 
+//! the ones of query i start at pointsInRangeOffset[i] and there are pointsInRangeSize[i] of them.
+class FindPointsInRadius: public Node{
+public:
+	FindPointsInRadius(const std::string &name, Node *parent);
+	void updateSlice(Attribute *attribute, unsigned int slice);
+	
+private:
+	HashGridAttribute *_hashGrid;
+	NumericAttribute *_queryPoints;
+	NumericAttribute *_range;
+	NumericAttribute *_pointsInRangeId;
+	NumericAttribute *_pointsInRangeSize;
+	NumericAttribute *_pointsInRangeOffset;
+};
+
+//! Finds, for each point of hashGrid, the other points of the grid within range of it.
+//! The results are laid out like the ones of FindPointsInRadius, with one block per point of the grid.
+class FindPairsInRadius: public Node{
+public:
+	FindPairsInRadius(const std::string &name, Node *parent);
+	void updateSlice(Attribute *attribute, unsigned int slice);
+	
+private:
+	HashGridAttribute *_hashGrid;
+	NumericAttribute *_range;
+	NumericAttribute *_pointsInRangeId;
+	NumericAttribute *_pointsInRangeSize;
+	NumericAttribute *_pointsInRangeOffset;
+};
+
+}
+
+#endif
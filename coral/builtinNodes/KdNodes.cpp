@@ -1,8 +1,28 @@
 
+#include <algorithm>
 #include "KdNodes.h"
 
 using namespace coral;
 
+BuildSpatialIndex::BuildSpatialIndex(const std::string &name, Node *parent): Node(name, parent){
+	_points = new NumericAttribute("points", this);
+	_spatialIndex = new SpatialIndexAttribute("spatialIndex", this);
+	
+	addInputAttribute(_points);
+	addOutputAttribute(_spatialIndex);
+	
+	setAttributeAffect(_points, _spatialIndex);
+	
+	setAttributeAllowedSpecialization(_points, "Vec3Array");
+}
+
+void BuildSpatialIndex::update(Attribute *attribute){
+	// the same points leave the tree as it is and the query nodes downstream don't need to update
+	if(!_spatialIndex->outValue()->build(_points->value()->vec3Values())){
+		setAttributeUnchanged(_spatialIndex);
+	}
+}
+
 FindPointsInRange::FindPointsInRange(const std::string &name, Node *parent): Node(name, parent){
 	setSliceable(true);
 	
@@ -12,10 +32,12 @@ FindPointsInRange::FindPointsInRange(const std::string &name, Node *parent): Nod
 	_pointsInRange = new NumericAttribute("pointsInRange", this);
 	_pointsInRangeId = new NumericAttribute("pointsInRangeId", this);
 	_pointsInRangeSize = new NumericAttribute("pointsInRangeSize", this);
+	_spatialIndex = new SpatialIndexAttribute("spatialIndex", this);
 
 	addInputAttribute(_point);
 	addInputAttribute(_range);
 	addInputAttribute(_points);
+	addInputAttribute(_spatialIndex);
 	addOutputAttribute(_pointsInRange);
 	addOutputAttribute(_pointsInRangeId);
 	addOutputAttribute(_pointsInRangeSize);
@@ -31,6 +53,10 @@ FindPointsInRange::FindPointsInRange(const std::string &name, Node *parent): Nod
 	setAttributeAffect(_points, _pointsInRange);
 	setAttributeAffect(_points, _pointsInRangeId);
 	setAttributeAffect(_points, _pointsInRangeSize);
+	
+	setAttributeAffect(_spatialIndex, _pointsInRange);
+	setAttributeAffect(_spatialIndex, _pointsInRangeId);
+	setAttributeAffect(_spatialIndex, _pointsInRangeSize);
 
 	setAttributeAllowedSpecialization(_point, "Vec3");
 	setAttributeAllowedSpecialization(_range, "Float");
@@ -47,46 +73,208 @@ void FindPointsInRange::updateSlice(Attribute *attribute, unsigned int slice){
 		range = 0.0;
 	}
 
-	const std::vector<Imath::V3f> &points = _points->value()->vec3ValuesSlice(slice);
+	std::vector<int> pointsInRangeId;
+	
+	// without a shared index the tree has to be built for this slice alone
+	SpatialIndex localIndex;
+	SpatialIndex *spatialIndex = _spatialIndex->value();
+	if(!_spatialIndex->input()){
+		localIndex.build(_points->value()->vec3ValuesSlice(slice));
+		spatialIndex = &localIndex;
+	}
+	
+	spatialIndex->pointsInRange(point, range, pointsInRangeId);
+	
+	const std::vector<Imath::V3f> &points = spatialIndex->points();
+	int resultSize = pointsInRangeId.size();
+	std::vector<Imath::V3f> pointsInRange(resultSize);
+	for(int i = 0; i < resultSize; ++i){
+		pointsInRange[i] = points[pointsInRangeId[i]];
+	}
+
+	_pointsInRange->outValue()->swapVec3ValuesSlice(slice, pointsInRange);
+	_pointsInRangeId->outValue()->swapIntValuesSlice(slice, pointsInRangeId);
+	_pointsInRangeSize->outValue()->setIntValueAtSlice(slice, 0, resultSize);
 
-	int dimentions = 3;
-	kdtree *tree = kd_create(dimentions);
+	setAttributeIsClean(_pointsInRange, true);
+	setAttributeIsClean(_pointsInRangeId, true);
+	setAttributeIsClean(_pointsInRangeSize, true);
+}
 
-	int pointsSize = points.size();
-	std::vector<int> indices(pointsSize);
+FindNearestPoint::FindNearestPoint(const std::string &name, Node *parent): Node(name, parent){
+	setSliceable(true);
+	
+	_spatialIndex = new SpatialIndexAttribute("spatialIndex", this);
+	_point = new NumericAttribute("point", this);
+	_nearestPoint = new NumericAttribute("nearestPoint", this);
+	_nearestPointId = new NumericAttribute("nearestPointId", this);
+	
+	addInputAttribute(_spatialIndex);
+	addInputAttribute(_point);
+	addOutputAttribute(_nearestPoint);
+	addOutputAttribute(_nearestPointId);
+	
+	setAttributeAffect(_spatialIndex, _nearestPoint);
+	setAttributeAffect(_spatialIndex, _nearestPointId);
+	setAttributeAffect(_point, _nearestPoint);
+	setAttributeAffect(_point, _nearestPointId);
+	
+	setAttributeAllowedSpecialization(_point, "Vec3");
+	setAttributeAllowedSpecialization(_nearestPoint, "Vec3");
+	setAttributeAllowedSpecialization(_nearestPointId, "Int");
+}
 
-	for(int i = 0; i < pointsSize; ++i){
-		indices[i] = i;
-		const Imath::V3f &currentPoint = points[i];
-		kd_insert3f(tree, currentPoint.x, currentPoint.y, currentPoint.z, (void*)&indices[i]);
+void FindNearestPoint::updateSlice(Attribute *attribute, unsigned int slice){
+	SpatialIndex *spatialIndex = _spatialIndex->value();
+	const Imath::V3f &point = _point->value()->vec3ValuesSlice(slice)[0];
+	
+	int nearestPointId = spatialIndex->nearestPoint(point);
+	
+	Imath::V3f nearestPoint(0.0, 0.0, 0.0);
+	if(nearestPointId != -1){
+		nearestPoint = spatialIndex->points()[nearestPointId];
 	}
 	
-	kdres *res = kd_nearest_range3f(tree, point.x, point.y, point.z, range);
+	_nearestPoint->outValue()->setVec3ValueAtSlice(slice, 0, nearestPoint);
+	_nearestPointId->outValue()->setIntValueAtSlice(slice, 0, nearestPointId);
+	
+	setAttributeIsClean(_nearestPoint, true);
+	setAttributeIsClean(_nearestPointId, true);
+}
 
-	int resultSize = kd_res_size(res);
-	std::vector<Imath::V3f> pointsInRange(resultSize);
-	std::vector<int> pointsInRangeId(resultSize);
 
-	int i = 0;
-	while(!kd_res_end(res)){
-		int pointIndex = *(int*)kd_res_item_data(res);
-		pointsInRange[i] = points[pointIndex];
-		pointsInRangeId[i] = pointIndex;
+FindKNearestPoints::FindKNearestPoints(const std::string &name, Node *parent): Node(name, parent){
+	setSliceable(true);
+	
+	_spatialIndex = new SpatialIndexAttribute("spatialIndex", this);
+	_queryPoints = new NumericAttribute("queryPoints", this);
+	_count = new NumericAttribute("count", this);
+	_nearestPointsId = new NumericAttribute("nearestPointsId", this);
+	_nearestPointsSize = new NumericAttribute("nearestPointsSize", this);
+	_nearestPointsOffset = new NumericAttribute("nearestPointsOffset", this);
+	
+	addInputAttribute(_spatialIndex);
+	addInputAttribute(_queryPoints);
+	addInputAttribute(_count);
+	addOutputAttribute(_nearestPointsId);
+	addOutputAttribute(_nearestPointsSize);
+	addOutputAttribute(_nearestPointsOffset);
+	
+	setAttributeAffect(_spatialIndex, _nearestPointsId);
+	setAttributeAffect(_spatialIndex, _nearestPointsSize);
+	setAttributeAffect(_spatialIndex, _nearestPointsOffset);
+	setAttributeAffect(_queryPoints, _nearestPointsId);
+	setAttributeAffect(_queryPoints, _nearestPointsSize);
+	setAttributeAffect(_queryPoints, _nearestPointsOffset);
+	setAttributeAffect(_count, _nearestPointsId);
+	setAttributeAffect(_count, _nearestPointsSize);
+	setAttributeAffect(_count, _nearestPointsOffset);
+	
+	setAttributeAllowedSpecialization(_queryPoints, "Vec3Array");
+	setAttributeAllowedSpecialization(_count, "Int");
+	setAttributeAllowedSpecialization(_nearestPointsId, "IntArray");
+	setAttributeAllowedSpecialization(_nearestPointsSize, "IntArray");
+	setAttributeAllowedSpecialization(_nearestPointsOffset, "IntArray");
+}
 
-		kd_res_next(res);
-		i += 1;
+void FindKNearestPoints::updateSlice(Attribute *attribute, unsigned int slice){
+	const FlatKdTree &tree = _spatialIndex->value()->tree();
+	const std::vector<Imath::V3f> &queryPoints = _queryPoints->value()->vec3ValuesSlice(slice);
+	
+	int count = _count->value()->intValuesSlice(slice)[0];
+	if(count < 0){
+		count = 0;
 	}
+	
+	unsigned int queriesCount = queryPoints.size();
+	unsigned int neighboursCount = std::min((unsigned int)count, tree.size());
+	
+	std::vector<int> nearestPointsId(queriesCount * neighboursCount);
+	std::vector<int> nearestPointsSize(queriesCount, neighboursCount);
+	std::vector<int> nearestPointsOffset(queriesCount);
+	for(unsigned int i = 0; i < queriesCount; ++i){
+		nearestPointsOffset[i] = i * neighboursCount;
+	}
+	
+	if(nearestPointsId.size()){
+		tree.nearestPoints(&queryPoints[0], queriesCount, neighboursCount, &nearestPointsId[0]);
+	}
+	
+	_nearestPointsId->outValue()->swapIntValuesSlice(slice, nearestPointsId);
+	_nearestPointsSize->outValue()->swapIntValuesSlice(slice, nearestPointsSize);
+	_nearestPointsOffset->outValue()->swapIntValuesSlice(slice, nearestPointsOffset);
+	
+	setAttributeIsClean(_nearestPointsId, true);
+	setAttributeIsClean(_nearestPointsSize, true);
+	setAttributeIsClean(_nearestPointsOffset, true);
+}
 
-	kd_res_free(res);
-	kd_free(tree);
-
-	_pointsInRange->outValue()->setVec3ValuesSlice(slice, pointsInRange);
-	_pointsInRangeId->outValue()->setIntValuesSlice(slice, pointsInRangeId);
-	_pointsInRangeSize->outValue()->setIntValueAtSlice(slice, 0, resultSize);
+FindPointsInRangeBatch::FindPointsInRangeBatch(const std::string &name, Node *parent): Node(name, parent){
+	setSliceable(true);
+	
+	_spatialIndex = new SpatialIndexAttribute("spatialIndex", this);
+	_queryPoints = new NumericAttribute("queryPoints", this);
+	_range = new NumericAttribute("range", this);
+	_pointsInRangeId = new NumericAttribute("pointsInRangeId", this);
+	_pointsInRangeSize = new NumericAttribute("pointsInRangeSize", this);
+	_pointsInRangeOffset = new NumericAttribute("pointsInRangeOffset", this);
+	
+	addInputAttribute(_spatialIndex);
+	addInputAttribute(_queryPoints);
+	addInputAttribute(_range);
+	addOutputAttribute(_pointsInRangeId);
+	addOutputAttribute(_pointsInRangeSize);
+	addOutputAttribute(_pointsInRangeOffset);
+	
+	setAttributeAffect(_spatialIndex, _pointsInRangeId);
+	setAttributeAffect(_spatialIndex, _pointsInRangeSize);
+	setAttributeAffect(_spatialIndex, _pointsInRangeOffset);
+	setAttributeAffect(_queryPoints, _pointsInRangeId);
+	setAttributeAffect(_queryPoints, _pointsInRangeSize);
+	setAttributeAffect(_queryPoints, _pointsInRangeOffset);
+	setAttributeAffect(_range, _pointsInRangeId);
+	setAttributeAffect(_range, _pointsInRangeSize);
+	setAttributeAffect(_range, _pointsInRangeOffset);
+	
+	std::vector<std::string> rangeSpecializations;
+	rangeSpecializations.push_back("Float");
+	rangeSpecializations.push_back("FloatArray");
+	
+	setAttributeAllowedSpecialization(_queryPoints, "Vec3Array");
+	setAttributeAllowedSpecializations(_range, rangeSpecializations);
+	setAttributeAllowedSpecialization(_pointsInRangeId, "IntArray");
+	setAttributeAllowedSpecialization(_pointsInRangeSize, "IntArray");
+	setAttributeAllowedSpecialization(_pointsInRangeOffset, "IntArray");
+}
 
-	setAttributeIsClean(_pointsInRange, true);
+void FindPointsInRangeBatch::updateSlice(Attribute *attribute, unsigned int slice){
+	const FlatKdTree &tree = _spatialIndex->value()->tree();
+	const std::vector<Imath::V3f> &queryPoints = _queryPoints->value()->vec3ValuesSlice(slice);
+	const std::vector<float> &ranges = _range->value()->floatValuesSlice(slice);
+	
+	unsigned int queriesCount = queryPoints.size();
+	
+	std::vector<int> offsets;
+	std::vector<int> pointsInRangeId;
+	if(queriesCount && ranges.size()){
+		tree.pointsInRange(&queryPoints[0], queriesCount, &ranges[0], ranges.size(), offsets, pointsInRangeId);
+	}
+	else{
+		offsets.assign(queriesCount + 1, 0);
+	}
+	
+	std::vector<int> pointsInRangeSize(queriesCount);
+	std::vector<int> pointsInRangeOffset(queriesCount);
+	for(unsigned int i = 0; i < queriesCount; ++i){
+		pointsInRangeOffset[i] = offsets[i];
+		pointsInRangeSize[i] = offsets[i + 1] - offsets[i];
+	}
+	
+	_pointsInRangeId->outValue()->swapIntValuesSlice(slice, pointsInRangeId);
+	_pointsInRangeSize->outValue()->swapIntValuesSlice(slice, pointsInRangeSize);
+	_pointsInRangeOffset->outValue()->swapIntValuesSlice(slice, pointsInRangeOffset);
+	
 	setAttributeIsClean(_pointsInRangeId, true);
 	setAttributeIsClean(_pointsInRangeSize, true);
+	setAttributeIsClean(_pointsInRangeOffset, true);
 }
-
-
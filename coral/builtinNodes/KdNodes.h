@@ -34,11 +34,23 @@
 #include "../src/Node.h"
 #include "../src/NumericAttribute.h"
 #include "../src/Numeric.h"
-#include "../src/kdtree.h"
+#include "../src/SpatialIndexAttribute.h"
 
 namespace coral
 {
 
+//! Indexes a Vec3Array once so that query nodes don't have to build their own tree for each update and slice.
+class BuildSpatialIndex: public Node{
+public:
+	BuildSpatialIndex(const std::string &name, Node *parent);
+	void update(Attribute *attribute);
+	
+private:
+	NumericAttribute *_points;
+	SpatialIndexAttribute *_spatialIndex;
+};
+
+//! Finds the points within range of point, from spatialIndex when it's connected or else from points.
 class FindPointsInRange: public Node{
 public:
 	FindPointsInRange(const std::string &name, Node *parent);
@@ -51,6 +63,52 @@ private:
 	NumericAttribute *_pointsInRange;
 	NumericAttribute *_pointsInRangeId;
 	NumericAttribute *_pointsInRangeSize;
+	SpatialIndexAttribute *_spatialIndex;
+};
+
+class FindNearestPoint: public Node{
+public:
+	FindNearestPoint(const std::string &name, Node *parent);
+	void updateSlice(Attribute *attribute, unsigned int slice);
+	
+private:
+	SpatialIndexAttribute *_spatialIndex;
+	NumericAttribute *_point;
+	NumericAttribute *_nearestPoint;
+	NumericAttribute *_nearestPointId;
+};
+
+//! Finds the count indexed points closest to each of the queryPoints at once, closest first.
+//! The ids of all the queries are laid out back to back in nearestPointsId, 
+//! the ones of query i start at nearestPointsOffset[i] and there are nearestPointsSize[i] of them.
+class FindKNearestPoints: public Node{
+public:
+	FindKNearestPoints(const std::string &name, Node *parent);
+	void updateSlice(Attribute *attribute, unsigned int slice);
+	
+private:
+	SpatialIndexAttribute *_spatialIndex;
+	NumericAttribute *_queryPoints;
+	NumericAttribute *_count;
+	NumericAttribute *_nearestPointsId;
+	NumericAttribute *_nearestPointsSize;
+	NumericAttribute *_nearestPointsOffset;
+};
+
+//! Finds the indexed points within range of each of the queryPoints at once, range can be a single value or one value per query.
+//! The results are laid out like the ones of FindKNearestPoints.
+class FindPointsInRangeBatch: public Node{
+public:
+	FindPointsInRangeBatch(const std::string &name, Node *parent);
+	void updateSlice(Attribute *attribute, unsigned int slice);
+	
+private:
+	SpatialIndexAttribute *_spatialIndex;
+	NumericAttribute *_queryPoints;
+	NumericAttribute *_range;
+	NumericAttribute *_pointsInRangeId;
+	NumericAttribute *_pointsInRangeSize;
+	NumericAttribute *_pointsInRangeOffset;
 };
 
 }
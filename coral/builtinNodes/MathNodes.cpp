@@ -30,6 +30,9 @@
 #include "../src/Numeric.h"
 #include "../src/containerUtils.h"
 #include "../src/mathUtils.h"
+#include "../src/simdUtils.h"
+#include "../src/coreParallelAlgos.h"
+#include "numericOperationAlgos.h"
 
 #include <ImathVec.h>
 #include <ImathMatrix.h>
@@ -39,6 +42,67 @@
 
 using namespace coral;
 
+namespace{
+	// parallelFor bodies running the vec3 kernels on a chunk of the arrays
+	class vec3LengthBody{
+	public:
+		vec3LengthBody(const Imath::V3f *values, float *result): _values(values), _result(result){
+		}
+		
+		void operator() (unsigned int begin, unsigned int end) const{
+			simdUtils::vec3Length(_values + begin, _result + begin, end - begin);
+		}
+	
+	private:
+		const Imath::V3f *_values;
+		float *_result;
+	};
+	
+	class vec3NormalizeBody{
+	public:
+		vec3NormalizeBody(const Imath::V3f *values, Imath::V3f *result): _values(values), _result(result){
+		}
+		
+		void operator() (unsigned int begin, unsigned int end) const{
+			simdUtils::vec3Normalize(_values + begin, _result + begin, end - begin);
+		}
+	
+	private:
+		const Imath::V3f *_values;
+		Imath::V3f *_result;
+	};
+	
+	class vec3DotBody{
+	public:
+		vec3DotBody(const Imath::V3f *valuesA, const Imath::V3f *valuesB, float *result): _valuesA(valuesA), _valuesB(valuesB), _result(result){
+		}
+		
+		void operator() (unsigned int begin, unsigned int end) const{
+			simdUtils::vec3Dot(_valuesA + begin, _valuesB + begin, _result + begin, end - begin);
+		}
+	
+	private:
+		const Imath::V3f *_valuesA;
+		const Imath::V3f *_valuesB;
+		float *_result;
+	};
+	
+	class vec3CrossBody{
+	public:
+		vec3CrossBody(const Imath::V3f *valuesA, const Imath::V3f *valuesB, Imath::V3f *result): _valuesA(valuesA), _valuesB(valuesB), _result(result){
+		}
+		
+		void operator() (unsigned int begin, unsigned int end) const{
+			simdUtils::vec3Cross(_valuesA + begin, _valuesB + begin, _result + begin, end - begin);
+		}
+	
+	private:
+		const Imath::V3f *_valuesA;
+		const Imath::V3f *_valuesB;
+		Imath::V3f *_result;
+	};
+}
+
 Length::Length(const std::string &name, Node *parent): 
 Node(name, parent),
 _selectedOperation(0){
@@ -109,12 +173,11 @@ void Length::updateVec3(Numeric *element, Numeric *length, unsigned int slice){
 	unsigned int size = elementValues.size();
 
 	std::vector<float> lengthValues(size);
-	for(int i = 0; i < size; ++i){
-		float lengthValue = elementValues[i].length();
-		lengthValues[i] = lengthValue;
+	if(size){
+		parallelFor(size, vec3LengthBody(&elementValues[0], &lengthValues[0]));
 	}
 
-	length->setFloatValuesSlice(slice, lengthValues);
+	length->swapFloatValuesSlice(slice, lengthValues);
 }
 
 void Length::updateQuat(Numeric *element, Numeric *length, unsigned int slice){
@@ -127,7 +190,7 @@ void Length::updateQuat(Numeric *element, Numeric *length, unsigned int slice){
 		lengthValues[i] = lengthValue;
 	}
 
-	length->setFloatValuesSlice(slice, lengthValues);
+	length->swapFloatValuesSlice(slice, lengthValues);
 }
 
 void Length::updateSlice(Attribute *attribute, unsigned int slice){
@@ -175,15 +238,15 @@ void Inverse::attributeSpecializationChanged(Attribute *attribute){
 }
 
 void Inverse::updateMatrix44(Numeric *element, Numeric *inverse, unsigned int slice){
-	std::vector<Imath::M44f> elementValues = element->matrix44ValuesSlice(slice);
+	const std::vector<Imath::M44f> &elementValues = element->matrix44ValuesSlice(slice);
 
 	unsigned int size = elementValues.size();
 	std::vector<Imath::M44f> inverseValues(size);
-	for(int i = 0; i < size ;++i){
-		inverseValues[i] = elementValues[i].inverse();
+	if(size){
+		parallelFor(size, numericOperation_matrix44InverseBody(&elementValues[0], &inverseValues[0]));
 	}
 	
-	inverse->setMatrix44ValuesSlice(slice, inverseValues);
+	inverse->swapMatrix44ValuesSlice(slice, inverseValues);
 }
 
 void Inverse::updateQuat(Numeric *element, Numeric *inverse, unsigned int slice){
@@ -195,7 +258,7 @@ void Inverse::updateQuat(Numeric *element, Numeric *inverse, unsigned int slice)
 		inverseValues[i] = elementValues[i].inverse();
 	}
 	
-	inverse->setQuatValuesSlice(slice, inverseValues);
+	inverse->swapQuatValuesSlice(slice, inverseValues);
 }
 
 void Inverse::updateSlice(Attribute *attribute, unsigned int slice){
@@ -250,7 +313,7 @@ void Abs::abs_int(Numeric *inNumber, Numeric *outNumber, unsigned int slice){
 		outValues[i] = abs(inValues[i]);
 	}
 	
-	outNumber->setIntValuesSlice(slice, outValues);
+	outNumber->swapIntValuesSlice(slice, outValues);
 }
 
 void Abs::abs_float(Numeric *inNumber, Numeric *outNumber, unsigned int slice){
@@ -261,7 +324,7 @@ void Abs::abs_float(Numeric *inNumber, Numeric *outNumber, unsigned int slice){
 		outValues[i] = fabs(inValues[i]);
 	}
 	
-	outNumber->setFloatValuesSlice(slice, outValues);
+	outNumber->swapFloatValuesSlice(slice, outValues);
 }
 
 void Abs::updateSlice(Attribute *attribute, unsigned int slice){
@@ -304,17 +367,16 @@ void CrossProduct::updateSlice(Attribute *attribute, unsigned int slice){
 	int size1 = vectorValues1.size();
 	
 	int minSize = size0;
-	if(size0 < size1){
+	if(size1 < size0){
 		minSize = size1;
 	}
 	
 	std::vector<Imath::V3f> crossedValues(minSize);
-	
-	for(int i = 0; i < minSize; ++i){
-		crossedValues[i] = vectorValues0[i].cross(vectorValues1[i]);
+	if(minSize){
+		parallelFor(minSize, vec3CrossBody(&vectorValues0[0], &vectorValues1[0], &crossedValues[0]));
 	}
 	
-	_crossProduct->outValue()->setVec3ValuesSlice(slice, crossedValues);
+	_crossProduct->outValue()->swapVec3ValuesSlice(slice, crossedValues);
 }
 
 DotProduct::DotProduct(const std::string &name, Node *parent): 
@@ -372,17 +434,16 @@ void DotProduct::updateVec3(Numeric *element0, Numeric *element1, Numeric *dotPr
 	int size1 = elementValues1.size();
 
 	int minSize = size0;
-	if(size0 < size1){
+	if(size1 < size0){
 		minSize = size1;
 	}
 
 	std::vector<float> dotValues(minSize);
-
-	for(int i = 0; i < minSize; ++i){
-		dotValues[i] = elementValues0[i].dot(elementValues1[i]);
+	if(minSize){
+		parallelFor(minSize, vec3DotBody(&elementValues0[0], &elementValues1[0], &dotValues[0]));
 	}
 
-	dotProduct->setFloatValuesSlice(slice, dotValues);
+	dotProduct->swapFloatValuesSlice(slice, dotValues);
 }
 
 void DotProduct::updateQuat(Numeric *element0, Numeric *element1, Numeric *dotProduct, unsigned int slice){
@@ -393,7 +454,7 @@ void DotProduct::updateQuat(Numeric *element0, Numeric *element1, Numeric *dotPr
 	int size1 = elementValues1.size();
 
 	int minSize = size0;
-	if(size0 < size1){
+	if(size1 < size0){
 		minSize = size1;
 	}
 
@@ -403,7 +464,7 @@ void DotProduct::updateQuat(Numeric *element0, Numeric *element1, Numeric *dotPr
 		dotValues[i] = elementValues0[i] ^ elementValues1[i];
 	}
 
-	dotProduct->setFloatValuesSlice(slice, dotValues);
+	dotProduct->swapFloatValuesSlice(slice, dotValues);
 }
 
 void DotProduct::updateSpecializationLink(Attribute *attributeA, Attribute *attributeB, std::vector<std::string> &specializationA, std::vector<std::string> &specializationB){
@@ -472,11 +533,11 @@ void Normalize::updateVec3(Numeric *element, Numeric *normalized, unsigned int s
 	int size = elementValues.size();
 	
 	std::vector<Imath::V3f> normalizedValues(size);
-	for(int i = 0; i < size; ++i){
-		normalizedValues[i] = elementValues[i].normalized();
+	if(size){
+		parallelFor(size, vec3NormalizeBody(&elementValues[0], &normalizedValues[0]));
 	}
 	
-	normalized->setVec3ValuesSlice(slice, normalizedValues);
+	normalized->swapVec3ValuesSlice(slice, normalizedValues);
 }
 
 void Normalize::updateQuat(Numeric *element, Numeric *normalized, unsigned int slice){
@@ -488,7 +549,7 @@ void Normalize::updateQuat(Numeric *element, Numeric *normalized, unsigned int s
 		normalizedValues[i] = elementValues[i].normalized();
 	}
 	
-	normalized->setQuatValuesSlice(slice, normalizedValues);
+	normalized->swapQuatValuesSlice(slice, normalizedValues);
 }
 
 void Normalize::updateSlice(Attribute *attribute, unsigned int slice){
@@ -573,7 +634,7 @@ void TrigonometricFunctions::updateSlice(Attribute *attribute, unsigned int slic
 		}
 	}
 
-	_outNumber->outValue()->setFloatValuesSlice(slice, outValues);
+	_outNumber->outValue()->swapFloatValuesSlice(slice, outValues);
 }
 
 Radians::Radians(const std::string &name, Node *parent): Node(name, parent){
@@ -605,7 +666,7 @@ void Radians::updateSlice(Attribute *attribute, unsigned int slice){
 		outValues[i] = in[i]*M_PI/180.0f;
 	}
 
-	_outNumber->outValue()->setFloatValuesSlice(slice, outValues);
+	_outNumber->outValue()->swapFloatValuesSlice(slice, outValues);
 }
 
 Degrees::Degrees(const std::string &name, Node *parent): Node(name, parent){
@@ -637,7 +698,7 @@ void Degrees::updateSlice(Attribute *attribute, unsigned int slice){
 		outValues[i] = in[i]*180.0f/float(M_PI);
 	}
 
-	_outNumber->outValue()->setFloatValuesSlice(slice, outValues);
+	_outNumber->outValue()->swapFloatValuesSlice(slice, outValues);
 }
 
 Floor::Floor(const std::string &name, Node *parent): Node(name, parent){
@@ -669,7 +730,7 @@ void Floor::updateSlice(Attribute *attribute, unsigned int slice){
 		outValues[i] = std::floor(in[i]);
 	}
 
-	_outNumber->outValue()->setFloatValuesSlice(slice, outValues);
+	_outNumber->outValue()->swapFloatValuesSlice(slice, outValues);
 }
 
 Ceil::Ceil(const std::string &name, Node *parent): Node(name, parent){
@@ -701,7 +762,7 @@ void Ceil::updateSlice(Attribute *attribute, unsigned int slice){
 		outValues[i] = std::ceil(in[i]);
 	}
 
-	_outNumber->outValue()->setFloatValuesSlice(slice, outValues);
+	_outNumber->outValue()->swapFloatValuesSlice(slice, outValues);
 }
 
 Round::Round(const std::string &name, Node *parent): Node(name, parent){
@@ -733,7 +794,7 @@ void Round::updateSlice(Attribute *attribute, unsigned int slice){
 		outValues[i] = std::floor(in[i]+0.5);
 	}
 
-	_outNumber->outValue()->setFloatValuesSlice(slice, outValues);
+	_outNumber->outValue()->swapFloatValuesSlice(slice, outValues);
 }
 
 Exp::Exp(const std::string &name, Node *parent): Node(name, parent){
@@ -765,7 +826,7 @@ void Exp::updateSlice(Attribute *attribute, unsigned int slice){
 		outValues[i] = std::exp(in[i]);
 	}
 
-	_outNumber->outValue()->setFloatValuesSlice(slice, outValues);
+	_outNumber->outValue()->swapFloatValuesSlice(slice, outValues);
 }
 
 Log::Log(const std::string &name, Node *parent): Node(name, parent){
@@ -797,7 +858,7 @@ void Log::updateSlice(Attribute *attribute, unsigned int slice){
 		outValues[i] = std::log(in[i]);
 	}
 
-	_outNumber->outValue()->setFloatValuesSlice(slice, outValues);
+	_outNumber->outValue()->swapFloatValuesSlice(slice, outValues);
 }
 
 Pow::Pow(const std::string &name, Node *parent): Node(name, parent){
@@ -835,7 +896,7 @@ void Pow::updateSlice(Attribute *attribute, unsigned int slice){
 		outValues[i] = std::pow(base[i],exponent[i]);
 	}
 
-	_outNumber->outValue()->setFloatValuesSlice(slice, outValues);
+	_outNumber->outValue()->swapFloatValuesSlice(slice, outValues);
 }
 
 Sqrt::Sqrt(const std::string &name, Node *parent): Node(name, parent){
@@ -867,7 +928,7 @@ void Sqrt::updateSlice(Attribute *attribute, unsigned int slice){
 		outValues[i] = std::sqrt(in[i]);
 	}
 
-	_outNumber->outValue()->setFloatValuesSlice(slice, outValues);
+	_outNumber->outValue()->swapFloatValuesSlice(slice, outValues);
 }
 
 Atan2::Atan2(const std::string &name, Node *parent): Node(name, parent){
@@ -905,7 +966,7 @@ void Atan2::updateSlice(Attribute *attribute, unsigned int slice){
 		outValues[i] = std::atan2(y[i],x[i]);
 	}
 
-	_outNumber->outValue()->setFloatValuesSlice(slice, outValues);
+	_outNumber->outValue()->swapFloatValuesSlice(slice, outValues);
 }
 
 Min::Min(const std::string &name, Node *parent):
@@ -958,7 +1019,7 @@ void Min::min_int(Numeric *inNumber, Numeric *outNumber, unsigned int slice){
 	}
 	outValues[0] = min;
 
-	outNumber->setIntValuesSlice(slice, outValues);
+	outNumber->swapIntValuesSlice(slice, outValues);
 }
 
 void Min::min_float(Numeric *inNumber, Numeric *outNumber, unsigned int slice){
@@ -971,7 +1032,7 @@ void Min::min_float(Numeric *inNumber, Numeric *outNumber, unsigned int slice){
 	}
 	outValue[0] = min;
 
-	outNumber->setFloatValuesSlice(slice, outValue);
+	outNumber->swapFloatValuesSlice(slice, outValue);
 }
 
 void Min::updateSlice(Attribute *attribute, unsigned int slice){
@@ -1058,7 +1119,7 @@ void Max::max_int(Numeric *inNumber, Numeric *outNumber, unsigned int slice){
 	}
 	outValues[0] = max;
 
-	outNumber->setIntValuesSlice(slice, outValues);
+	outNumber->swapIntValuesSlice(slice, outValues);
 }
 
 void Max::max_float(Numeric *inNumber, Numeric *outNumber, unsigned int slice){
@@ -1071,7 +1132,7 @@ void Max::max_float(Numeric *inNumber, Numeric *outNumber, unsigned int slice){
 	}
 	outValue[0] = max;
 
-	outNumber->setFloatValuesSlice(slice, outValue);
+	outNumber->swapFloatValuesSlice(slice, outValue);
 }
 
 void Max::updateSlice(Attribute *attribute, unsigned int slice){
@@ -1163,7 +1224,7 @@ void Average::average_int(Numeric *inNumber, Numeric *outNumber, unsigned int sl
 	}
 	outValues[0] = int(av/inValues.size());
 
-	outNumber->setIntValuesSlice(slice, outValues);
+	outNumber->swapIntValuesSlice(slice, outValues);
 }
 
 void Average::average_float(Numeric *inNumber, Numeric *outNumber, unsigned int slice){
@@ -1176,7 +1237,7 @@ void Average::average_float(Numeric *inNumber, Numeric *outNumber, unsigned int
 	}
 	outValue[0] = av/inValues.size();
 
-	outNumber->setFloatValuesSlice(slice, outValue);
+	outNumber->swapFloatValuesSlice(slice, outValue);
 }
 
 void Average::average_vec3(Numeric *inNumber, Numeric *outNumber, unsigned int slice){
@@ -1189,7 +1250,7 @@ void Average::average_vec3(Numeric *inNumber, Numeric *outNumber, unsigned int s
 	}
 	outValue[0] = av/float(inValues.size());
 
-	outNumber->setVec3ValuesSlice(slice, outValue);
+	outNumber->swapVec3ValuesSlice(slice, outValue);
 }
 
 void Average::updateSlice(Attribute *attribute, unsigned int slice){
@@ -1358,7 +1419,7 @@ void Slerp::updateSlice(Attribute *attribute, unsigned int slice){
 		outValues[i] = slerp(q1[i],q2[i],t[i]);
 	}
 
-	_outNumber->outValue()->setQuatValues(outValues);
+	_outNumber->outValue()->swapQuatValuesSlice(0, outValues);
 }
 
 QuatMultiply::QuatMultiply(const std::string &name, Node *parent): Node(name, parent){
@@ -1394,7 +1455,7 @@ void QuatMultiply::updateSlice(Attribute *attribute, unsigned int slice){
 	int size1 = q1.size();
 
 	int minSize = size0;
-	if(size0 < size1){
+	if(size1 < size0){
 		minSize = size1;
 	}
 
@@ -1404,7 +1465,7 @@ void QuatMultiply::updateSlice(Attribute *attribute, unsigned int slice){
 		outValues[i] = q1[i]*q0[i]*(~q1[i]);
 	}
 
-	_outQuat->outValue()->setQuatValues(outValues);
+	_outQuat->outValue()->swapQuatValuesSlice(0, outValues);
 }
 
 Negate::Negate(const std::string &name, Node *parent): 
@@ -1454,7 +1515,7 @@ void Negate::updateVec3(Numeric *element, Numeric *negated, unsigned int slice){
 		negatedValues[i] = elementValues[i].negate();
 	}
 	
-	negated->setVec3ValuesSlice(slice, negatedValues);
+	negated->swapVec3ValuesSlice(slice, negatedValues);
 }
 
 void Negate::updateMatrix44(Numeric *element, Numeric *negated, unsigned int slice){
@@ -1466,7 +1527,7 @@ void Negate::updateMatrix44(Numeric *element, Numeric *negated, unsigned int sli
 		negatedValues[i] = elementValues[i].negate();
 	}
 	
-	negated->setMatrix44ValuesSlice(slice, negatedValues);
+	negated->swapMatrix44ValuesSlice(slice, negatedValues);
 }
 
 void Negate::updateSlice(Attribute *attribute, unsigned int slice){
@@ -192,7 +192,7 @@ void Vec3Node::updateSlice(Attribute *attribute, unsigned int slice){
 		vec->z = z->floatValueAtSlice(slice, i);
 	}
 	
-	_vector->outValue()->setVec3ValuesSlice(slice, outArray);
+	_vector->outValue()->swapVec3ValuesSlice(slice, outArray);
 }
 
 Vec3ToFloats::Vec3ToFloats(const std::string &name, Node* parent): Node(name, parent){
@@ -271,9 +271,9 @@ void Vec3ToFloats::updateSlice(Attribute *attribute, unsigned int slice){
 		zValues[i] = vec.z;
 	}
 	
-	_x->outValue()->setFloatValuesSlice(slice, xValues);
-	_y->outValue()->setFloatValuesSlice(slice, yValues);
-	_z->outValue()->setFloatValuesSlice(slice, zValues);
+	_x->outValue()->swapFloatValuesSlice(slice, xValues);
+	_y->outValue()->swapFloatValuesSlice(slice, yValues);
+	_z->outValue()->swapFloatValuesSlice(slice, zValues);
 	
 	setAttributeIsClean(_x, true);
 	setAttributeIsClean(_y, true);
@@ -390,7 +390,7 @@ void Col4Node::updateSlice(Attribute *attribute, unsigned int slice){
 		col->a = a->floatValueAtSlice(slice, i);
 	}
 
-	_color->outValue()->setCol4ValuesSlice(slice, outArray);
+	_color->outValue()->swapCol4ValuesSlice(slice, outArray);
 }
 
 Col4ToFloats::Col4ToFloats(const std::string &name, Node* parent): Node(name, parent){
@@ -481,10 +481,10 @@ void Col4ToFloats::updateSlice(Attribute *attribute, unsigned int slice){
 		aValues[i] = col.a;
 	}
 
-	_r->outValue()->setFloatValuesSlice(slice, rValues);
-	_g->outValue()->setFloatValuesSlice(slice, gValues);
-	_b->outValue()->setFloatValuesSlice(slice, bValues);
-	_a->outValue()->setFloatValuesSlice(slice, aValues);
+	_r->outValue()->swapFloatValuesSlice(slice, rValues);
+	_g->outValue()->swapFloatValuesSlice(slice, gValues);
+	_b->outValue()->swapFloatValuesSlice(slice, bValues);
+	_a->outValue()->swapFloatValuesSlice(slice, aValues);
 
 	setAttributeIsClean(_r, true);
 	setAttributeIsClean(_g, true);
@@ -559,7 +559,7 @@ void Col4Reverse::updateSlice(Attribute *attribute, unsigned int slice){
 		outCol4Values[i].a = inCol4.a;
 	}
 
-	_outColor->outValue()->setCol4ValuesSlice(slice, outCol4Values);
+	_outColor->outValue()->swapCol4ValuesSlice(slice, outCol4Values);
 
 	setAttributeIsClean(_outColor, true);
 }
@@ -657,7 +657,7 @@ void QuatNode::updateSlice(Attribute *attribute, unsigned int slice){
 		vec->v.z = z->floatValueAtSlice(slice, i);
 	}
 
-	_quat->outValue()->setQuatValuesSlice(slice, outArray);
+	_quat->outValue()->swapQuatValuesSlice(slice, outArray);
 }
 
 QuatToFloats::QuatToFloats(const std::string &name, Node* parent): Node(name, parent){
@@ -750,10 +750,10 @@ void QuatToFloats::updateSlice(Attribute *attribute, unsigned int slice){
 		zValues[i] = vec.v.z;
 	}
 
-	_r->outValue()->setFloatValuesSlice(slice, rValues);
-	_x->outValue()->setFloatValuesSlice(slice, xValues);
-	_y->outValue()->setFloatValuesSlice(slice, yValues);
-	_z->outValue()->setFloatValuesSlice(slice, zValues);
+	_r->outValue()->swapFloatValuesSlice(slice, rValues);
+	_x->outValue()->swapFloatValuesSlice(slice, xValues);
+	_y->outValue()->swapFloatValuesSlice(slice, yValues);
+	_z->outValue()->swapFloatValuesSlice(slice, zValues);
 
 	setAttributeIsClean(_r, true);
 	setAttributeIsClean(_x, true);
@@ -920,7 +920,7 @@ void Matrix44Node::updateSlice(Attribute *attribute, unsigned int slice){
 		newMatrixValues[i] = matrix;
 	}
 	
-	_matrix->outValue()->setMatrix44ValuesSlice(slice, newMatrixValues);
+	_matrix->outValue()->swapMatrix44ValuesSlice(slice, newMatrixValues);
 }
 
 ConstantArray::ConstantArray(const std::string &name, Node *parent): Node(name, parent){
@@ -995,7 +995,7 @@ void ConstantArray::updateSlice(Attribute *attribute, unsigned int slice){
 			for(int i = 0; i < size; ++i){
 				values[i] = constantValue;
 			}
-			array->setIntValuesSlice(slice, values);
+			array->swapIntValuesSlice(slice, values);
 		}
 		else if(constant->type() == Numeric::numericTypeFloat){
 			float constantValue = constant->floatValueAtSlice(slice, 0);
@@ -1003,7 +1003,7 @@ void ConstantArray::updateSlice(Attribute *attribute, unsigned int slice){
 			for(int i = 0; i < size; ++i){
 				values[i] = constantValue;
 			}
-			array->setFloatValuesSlice(slice, values);
+			array->swapFloatValuesSlice(slice, values);
 		}
 		else if(constant->type() == Numeric::numericTypeVec3){
 			Imath::V3f constantValue = constant->vec3ValueAtSlice(slice, 0);
@@ -1011,7 +1011,7 @@ void ConstantArray::updateSlice(Attribute *attribute, unsigned int slice){
 			for(int i = 0; i < size; ++i){
 				values[i] = constantValue;
 			}
-			array->setVec3ValuesSlice(slice, values);
+			array->swapVec3ValuesSlice(slice, values);
 		}
 		else if(constant->type() == Numeric::numericTypeCol4){
 			Imath::Color4f constantValue = constant->col4ValueAtSlice(slice, 0);
@@ -1019,7 +1019,7 @@ void ConstantArray::updateSlice(Attribute *attribute, unsigned int slice){
 			for(int i = 0; i < size; ++i){
 				values[i] = constantValue;
 			}
-			array->setCol4ValuesSlice(slice, values);
+			array->swapCol4ValuesSlice(slice, values);
 		}
 		else if(constant->type() == Numeric::numericTypeMatrix44){
 			Imath::M44f constantValue = constant->matrix44ValueAtSlice(slice, 0);
@@ -1027,7 +1027,7 @@ void ConstantArray::updateSlice(Attribute *attribute, unsigned int slice){
 			for(int i = 0; i < size; ++i){
 				values[i] = constantValue;
 			}
-			array->setMatrix44ValuesSlice(slice, values);
+			array->swapMatrix44ValuesSlice(slice, values);
 		}
 	}
 	else{
@@ -1046,6 +1046,10 @@ ArraySize::ArraySize(const std::string &name, Node *parent): Node(name, parent){
 	
 	setAttributeAffect(_array, _size);
 	
+	// resizing an array often leaves its size untouched, no need to recompute what depends on it.
+	catchAttributeUnchanged(_size);
+	setEarlyCutoff();
+	
 	std::vector<std::string> arraySpecializations;
 	arraySpecializations.push_back("IntArray");
 	arraySpecializations.push_back("FloatArray");
@@ -1147,7 +1151,7 @@ void BuildArray::updateInt(const std::vector<Attribute*> &inAttrs, int arraySize
 		arrayValues[i] = inNum->intValueAtSlice(slice, 0);
 	}
 	
-	array->setIntValuesSlice(slice, arrayValues);
+	array->swapIntValuesSlice(slice, arrayValues);
 }
 
 void BuildArray::updateFloat(const std::vector<Attribute*> &inAttrs, int arraySize, Numeric *array, unsigned int slice){
@@ -1157,7 +1161,7 @@ void BuildArray::updateFloat(const std::vector<Attribute*> &inAttrs, int arraySi
 		arrayValues[i] = inNum->floatValueAtSlice(slice, 0);
 	}
 	
-	array->setFloatValuesSlice(slice, arrayValues);
+	array->swapFloatValuesSlice(slice, arrayValues);
 }
 
 void BuildArray::updateVec3(const std::vector<Attribute*> &inAttrs, int arraySize, Numeric *array, unsigned int slice){
@@ -1167,7 +1171,7 @@ void BuildArray::updateVec3(const std::vector<Attribute*> &inAttrs, int arraySiz
 		arrayValues[i] = inNum->vec3ValueAtSlice(slice, 0);
 	}
 	
-	array->setVec3ValuesSlice(slice, arrayValues);
+	array->swapVec3ValuesSlice(slice, arrayValues);
 }
 
 void BuildArray::updateCol4(const std::vector<Attribute*> &inAttrs, int arraySize, Numeric *array, unsigned int slice){
@@ -1177,7 +1181,7 @@ void BuildArray::updateCol4(const std::vector<Attribute*> &inAttrs, int arraySiz
 		arrayValues[i] = inNum->col4ValueAtSlice(slice, 0);
 	}
 
-	array->setCol4ValuesSlice(slice, arrayValues);
+	array->swapCol4ValuesSlice(slice, arrayValues);
 }
 
 void BuildArray::updateMatrix44(const std::vector<Attribute*> &inAttrs, int arraySize, Numeric *array, unsigned int slice){
@@ -1187,7 +1191,7 @@ void BuildArray::updateMatrix44(const std::vector<Attribute*> &inAttrs, int arra
 		arrayValues[i] = inNum->matrix44ValueAtSlice(slice, 0);
 	}
 	
-	array->setMatrix44ValuesSlice(slice, arrayValues);
+	array->swapMatrix44ValuesSlice(slice, arrayValues);
 }
 
 void BuildArray::updateSlice(Attribute *attribute, unsigned int slice){
@@ -1282,7 +1286,7 @@ void RangeArray::updateInt(Numeric *start, Numeric *end, int steps, Numeric *arr
 		currentStep += incrStep;
 	}
 	
-	array->setIntValuesSlice(slice, arrayValues);
+	array->swapIntValuesSlice(slice, arrayValues);
 }
 
 void RangeArray::updateFloat(Numeric *start, Numeric *end, int steps, Numeric *array, unsigned int slice){
@@ -1300,7 +1304,7 @@ void RangeArray::updateFloat(Numeric *start, Numeric *end, int steps, Numeric *a
 		currentStep += incrStep;
 	}
 	
-	array->setFloatValuesSlice(slice, arrayValues);
+	array->swapFloatValuesSlice(slice, arrayValues);
 }
 
 void RangeArray::updateSlice(Attribute *attribute, unsigned int slice){
@@ -1370,7 +1374,7 @@ void Matrix44Translation::updateSlice(Attribute *attribute, unsigned int slice){
 		translationValue.z = m[3][2];
 	}
 	
-	_translation->outValue()->setVec3ValuesSlice(slice, translationValues);
+	_translation->outValue()->swapVec3ValuesSlice(slice, translationValues);
 }
 
 Matrix44RotationAxis::Matrix44RotationAxis(const std::string &name, Node* parent): Node(name, parent){	
@@ -1434,9 +1438,9 @@ void Matrix44RotationAxis::updateSlice(Attribute *attribute, unsigned int slice)
 		axisZValues[i] = Imath::V3f(mat[2][0], mat[2][1], mat[2][2]);
 	}
 	
-	_axisX->outValue()->setVec3ValuesSlice(slice, axisXValues);
-	_axisY->outValue()->setVec3ValuesSlice(slice, axisYValues);
-	_axisZ->outValue()->setVec3ValuesSlice(slice, axisZValues);
+	_axisX->outValue()->swapVec3ValuesSlice(slice, axisXValues);
+	_axisY->outValue()->swapVec3ValuesSlice(slice, axisYValues);
+	_axisZ->outValue()->swapVec3ValuesSlice(slice, axisZValues);
 	
 	setAttributeIsClean(_axisX, true);
 	setAttributeIsClean(_axisY, true);
@@ -1534,7 +1538,7 @@ void Matrix44FromVectors::updateSlice(Attribute *attribute, unsigned int slice){
 			translationValue.x, translationValue.y, translationValue.z, 1.0);
 	}
 	
-	_matrix->outValue()->setMatrix44ValuesSlice(slice, matrixValues);
+	_matrix->outValue()->swapMatrix44ValuesSlice(slice, matrixValues);
 }
 
 Matrix44EulerRotation::Matrix44EulerRotation(const std::string &name, Node* parent): Node(name, parent){	
@@ -1593,7 +1597,7 @@ void Matrix44EulerRotation::updateSlice(Attribute *attribute, unsigned int slice
 		currentValue.z = euler.z * degree;
 	}
 	
-	_eulerAngles->outValue()->setVec3ValuesSlice(slice, eulerAngles);
+	_eulerAngles->outValue()->swapVec3ValuesSlice(slice, eulerAngles);
 }
 
 RangeLoop::RangeLoop(const std::string &name, Node* parent): 
@@ -1656,7 +1660,7 @@ void RangeLoop::updateFloatArray(Numeric *start, Numeric *end, Numeric *step, Nu
 		outVals[i] = fmod((stepVal + startVal), endVal);
 	}
 	
-	out->setFloatValuesSlice(slice, outVals);
+	out->swapFloatValuesSlice(slice, outVals);
 }
 
 void RangeLoop::updateInt(Numeric *start, Numeric *end, Numeric *step, Numeric *out, unsigned int slice){
@@ -1693,7 +1697,7 @@ void RangeLoop::updateIntArray(Numeric *start, Numeric *end, Numeric *step, Nume
 		outVals[i] = outVal;
 	}
 	
-	out->setIntValuesSlice(slice, outVals);
+	out->swapIntValuesSlice(slice, outVals);
 }
 
 void RangeLoop::attributeSpecializationChanged(Attribute *attribute){
@@ -1816,7 +1820,7 @@ void RandomNumber::updateFloatArray(Numeric *min, Numeric *max, Numeric *out, un
 		outVals[i] =  ((float(rand()) / float(RAND_MAX)) * (maxVal - minVal)) + minVal;
 	}
 	
-	out->setFloatValuesSlice(slice, outVals);
+	out->swapFloatValuesSlice(slice, outVals);
 }
 
 void RandomNumber::updateInt(Numeric *min, Numeric *max, Numeric *out, unsigned int slice){
@@ -1849,7 +1853,7 @@ void RandomNumber::updateIntArray(Numeric *min, Numeric *max, Numeric *out, unsi
 		outVals[i] = minVal + (int) (maxVal - minVal + 1)*(rand() / (RAND_MAX + 1.0));
 	}
 	
-	out->setIntValuesSlice(slice, outVals);
+	out->swapIntValuesSlice(slice, outVals);
 }
 
 void RandomNumber::updateSlice(Attribute *attribute, unsigned int slice){
@@ -1892,7 +1896,7 @@ void ArrayIndices::updateSlice(Attribute *attribute, unsigned int slice){
 		indices[i] = i;
 	}
 	
-	_indices->outValue()->setIntValuesSlice(slice, indices);
+	_indices->outValue()->swapIntValuesSlice(slice, indices);
 }
 
 GetArrayElement::GetArrayElement(const std::string &name, Node *parent): 
@@ -2209,7 +2213,7 @@ void SetArrayElement::updateInt(Numeric *array, const std::vector<int> &index, N
 		}
 	}
 
-	outArray->setIntValuesSlice(slice, values);
+	outArray->swapIntValuesSlice(slice, values);
 }
 
 void SetArrayElement::updateFloat(Numeric *array, const std::vector<int> &index, Numeric *element, Numeric *outArray, unsigned int slice){
@@ -2222,7 +2226,7 @@ void SetArrayElement::updateFloat(Numeric *array, const std::vector<int> &index,
 		}
 	}
 
-	outArray->setFloatValuesSlice(slice, values);
+	outArray->swapFloatValuesSlice(slice, values);
 }
 
 void SetArrayElement::updateVec3(Numeric *array, const std::vector<int> &index, Numeric *element, Numeric *outArray, unsigned int slice){
@@ -2235,7 +2239,7 @@ void SetArrayElement::updateVec3(Numeric *array, const std::vector<int> &index,
 		}
 	}
 
-	outArray->setVec3ValuesSlice(slice, values);
+	outArray->swapVec3ValuesSlice(slice, values);
 }
 
 void SetArrayElement::updateCol4(Numeric *array, const std::vector<int> &index, Numeric *element, Numeric *outArray, unsigned int slice){
@@ -2248,7 +2252,7 @@ void SetArrayElement::updateCol4(Numeric *array, const std::vector<int> &index,
 		}
 	}
 
-	outArray->setCol4ValuesSlice(slice, values);
+	outArray->swapCol4ValuesSlice(slice, values);
 }
 
 void SetArrayElement::updateMatrix44(Numeric *array, const std::vector<int> &index, Numeric *element, Numeric *outArray, unsigned int slice){
@@ -2261,7 +2265,7 @@ void SetArrayElement::updateMatrix44(Numeric *array, const std::vector<int> &ind
 		}
 	}
 
-	outArray->setMatrix44ValuesSlice(slice, values);
+	outArray->swapMatrix44ValuesSlice(slice, values);
 }
 
 void SetArrayElement::updateSlice(Attribute *attribute, unsigned int slice){
@@ -2323,33 +2327,33 @@ void SetSimulationStep::attributeSpecializationChanged(Attribute *attribute){
 }
 
 void SetSimulationStep::updateInt(const std::string &storageKey, Numeric *data, Numeric *result, unsigned int slice){
-	_globalNumericStorage[storageKey].setIntValuesSlice(slice, data->intValuesSlice(slice));
-	result->setIntValuesSlice(slice, data->intValuesSlice(slice));
+	_globalNumericStorage[storageKey].shareSlice(slice, data, slice);
+	result->shareSlice(slice, data, slice);
 }
 
 void SetSimulationStep::updateFloat(const std::string &storageKey, Numeric *data, Numeric *result, unsigned int slice){
-	_globalNumericStorage[storageKey].setFloatValuesSlice(slice, data->floatValuesSlice(slice));
-	result->setFloatValuesSlice(slice, data->floatValuesSlice(slice));
+	_globalNumericStorage[storageKey].shareSlice(slice, data, slice);
+	result->shareSlice(slice, data, slice);
 }
 
 void SetSimulationStep::updateVec3(const std::string &storageKey, Numeric *data, Numeric *result, unsigned int slice){
-	_globalNumericStorage[storageKey].setVec3ValuesSlice(slice, data->vec3ValuesSlice(slice));
-	result->setVec3ValuesSlice(slice, data->vec3ValuesSlice(slice));
+	_globalNumericStorage[storageKey].shareSlice(slice, data, slice);
+	result->shareSlice(slice, data, slice);
 }
 
 void SetSimulationStep::updateCol4(const std::string &storageKey, Numeric *data, Numeric *result, unsigned int slice){
-	_globalNumericStorage[storageKey].setCol4ValuesSlice(slice, data->col4ValuesSlice(slice));
-	result->setCol4ValuesSlice(slice, data->col4ValuesSlice(slice));
+	_globalNumericStorage[storageKey].shareSlice(slice, data, slice);
+	result->shareSlice(slice, data, slice);
 }
 
 void SetSimulationStep::updateMatrix44(const std::string &storageKey, Numeric *data, Numeric *result, unsigned int slice){
-	_globalNumericStorage[storageKey].setMatrix44ValuesSlice(slice, data->matrix44ValuesSlice(slice));
-	result->setMatrix44ValuesSlice(slice, data->matrix44ValuesSlice(slice));
+	_globalNumericStorage[storageKey].shareSlice(slice, data, slice);
+	result->shareSlice(slice, data, slice);
 }
 
 void SetSimulationStep::updateQuat(const std::string &storageKey, Numeric *data, Numeric *result, unsigned int slice){
-	_globalNumericStorage[storageKey].setQuatValuesSlice(slice, data->quatValuesSlice(slice));
-	result->setQuatValuesSlice(slice, data->quatValuesSlice(slice));
+	_globalNumericStorage[storageKey].shareSlice(slice, data, slice);
+	result->shareSlice(slice, data, slice);
 }
 
 void SetSimulationStep::resizedSlices(unsigned int slices){
@@ -2423,55 +2427,55 @@ void GetSimulationStep::attributeSpecializationChanged(Attribute *attribute){
 
 void GetSimulationStep::updateInt(const std::string &storageKey, int step, Numeric *source, Numeric *data, unsigned int slice){
 	if(step <= 0 || _globalNumericStorage.find(storageKey) == _globalNumericStorage.end()){
-		data->setIntValuesSlice(slice, source->intValuesSlice(slice));
+		data->shareSlice(slice, source, slice);
 	}
 	else{
-		data->setIntValuesSlice(slice, _globalNumericStorage[storageKey].intValuesSlice(slice));
+		data->shareSlice(slice, &_globalNumericStorage[storageKey], slice);
 	}
 }
 
 void GetSimulationStep::updateFloat(const std::string &storageKey, int step, Numeric *source, Numeric *data, unsigned int slice){
 	if(step <= 0 || _globalNumericStorage.find(storageKey) == _globalNumericStorage.end()){
-		data->setFloatValuesSlice(slice, source->floatValuesSlice(slice));
+		data->shareSlice(slice, source, slice);
 	}
 	else{
-		data->setFloatValuesSlice(slice, _globalNumericStorage[storageKey].floatValuesSlice(slice));
+		data->shareSlice(slice, &_globalNumericStorage[storageKey], slice);
 	}
 }
 
 void GetSimulationStep::updateVec3(const std::string &storageKey, int step, Numeric *source, Numeric *data, unsigned int slice){
 	if(step <= 0 || _globalNumericStorage.find(storageKey) == _globalNumericStorage.end()){
-		data->setVec3ValuesSlice(slice, source->vec3ValuesSlice(slice));
+		data->shareSlice(slice, source, slice);
 	}
 	else{
-		data->setVec3ValuesSlice(slice, _globalNumericStorage[storageKey].vec3ValuesSlice(slice));
+		data->shareSlice(slice, &_globalNumericStorage[storageKey], slice);
 	}
 }
 
 void GetSimulationStep::updateCol4(const std::string &storageKey, int step, Numeric *source, Numeric *data, unsigned int slice){
 	if(step <= 0 || _globalNumericStorage.find(storageKey) == _globalNumericStorage.end()){
-		data->setCol4ValuesSlice(slice, source->col4ValuesSlice(slice));
+		data->shareSlice(slice, source, slice);
 	}
 	else{
-		data->setCol4ValuesSlice(slice, _globalNumericStorage[storageKey].col4ValuesSlice(slice));
+		data->shareSlice(slice, &_globalNumericStorage[storageKey], slice);
 	}
 }
 
 void GetSimulationStep::updateMatrix44(const std::string &storageKey, int step, Numeric *source, Numeric *data, unsigned int slice){
 	if(step <= 0 || _globalNumericStorage.find(storageKey) == _globalNumericStorage.end()){
-		data->setMatrix44ValuesSlice(slice, source->matrix44ValuesSlice(slice));
+		data->shareSlice(slice, source, slice);
 	}
 	else{
-		data->setMatrix44ValuesSlice(slice, _globalNumericStorage[storageKey].matrix44ValuesSlice(slice));
+		data->shareSlice(slice, &_globalNumericStorage[storageKey], slice);
 	}
 }
 
 void GetSimulationStep::updateQuat(const std::string &storageKey, int step, Numeric *source, Numeric *data, unsigned int slice){
 	if(step <= 0 || _globalNumericStorage.find(storageKey) == _globalNumericStorage.end()){
-		data->setQuatValuesSlice(slice, source->quatValuesSlice(slice));
+		data->shareSlice(slice, source, slice);
 	}
 	else{
-		data->setQuatValuesSlice(slice, _globalNumericStorage[storageKey].quatValuesSlice(slice));
+		data->shareSlice(slice, &_globalNumericStorage[storageKey], slice);
 	}
 }
 
@@ -2564,8 +2568,8 @@ void QuatToAxisAngle::updateSlice(Attribute *attribute, unsigned int slice)
 		angleValues[i] =quat.angle();
 	}
 
-	_axis->outValue()->setVec3ValuesSlice(slice, axisValues);
-	_angle->outValue()->setFloatValuesSlice(slice, angleValues);
+	_axis->outValue()->swapVec3ValuesSlice(slice, axisValues);
+	_angle->outValue()->swapFloatValuesSlice(slice, angleValues);
 
 	setAttributeIsClean(_axis, true);
 	setAttributeIsClean(_angle, true);
@@ -2643,7 +2647,7 @@ void QuatToEulerRotation::updateSlice(Attribute *attribute, unsigned int slice)
 		eulerValues[i].z = euler.z * degree;
 	}
 
-	_euler->outValue()->setVec3ValuesSlice(slice, eulerValues);
+	_euler->outValue()->swapVec3ValuesSlice(slice, eulerValues);
 
 	setAttributeIsClean(_euler, true);
 }
@@ -2709,7 +2713,7 @@ void QuatToMatrix44::updateSlice(Attribute *attribute, unsigned int slice){
 		matrixValues[i] = quat.toMatrix44();
 	}
 
-	_matrix->outValue()->setMatrix44ValuesSlice(slice, matrixValues);
+	_matrix->outValue()->swapMatrix44ValuesSlice(slice, matrixValues);
 
 	setAttributeIsClean(_matrix, true);
 }
@@ -2807,7 +2811,7 @@ void Matrix44ToQuat::updateSlice(Attribute *attribute, unsigned int slice){
 		}
 	}
 
-	_quat->outValue()->setQuatValuesSlice(slice, quatValues);
+	_quat->outValue()->swapQuatValuesSlice(slice, quatValues);
 
 	setAttributeIsClean(_quat, true);
 }
@@ -26,233 +26,316 @@
 // SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // </license>
 
+#include <algorithm>
+
 #include "NumericOperation.h"
 #include "numericOperationAlgos.h"
+#include "../src/ChunkedArray.h"
 
 using namespace coral;
 
-
 namespace{
-	Numeric::Type numeric_type_int = Numeric::numericTypeInt;
-	Numeric::Type numeric_type_int_array = Numeric::numericTypeIntArray;
-	Numeric::Type numeric_type_float = Numeric::numericTypeFloat;
-	Numeric::Type numeric_type_float_array = Numeric::numericTypeFloatArray;
-	Numeric::Type numeric_type_vec3 = Numeric::numericTypeVec3;
-	Numeric::Type numeric_type_vec3_array = Numeric::numericTypeVec3Array;
-	Numeric::Type numeric_type_col4 = Numeric::numericTypeCol4;
-	Numeric::Type numeric_type_col4_array = Numeric::numericTypeCol4Array;
-	Numeric::Type numeric_type_matrix44 = Numeric::numericTypeMatrix44;
-	Numeric::Type numeric_type_matrix44_array = Numeric::numericTypeMatrix44Array;
+	const int numericTypes = Numeric::numericTypeMatrix44Array + 1;
+	const int numericOperations = NumericOperation::numericOperationDiv + 1;
+	
+	// slicing modes, see NumericOperation::selectKernel for how they map to the operand types
+	struct ArrayToArray{
+		enum{singleB = false};
+	};
+	
+	struct SingleToArray{
+	};
+	
+	struct ArrayToSingle{
+		enum{singleB = true};
+	};
+	
+	template<int operation>
+	struct OperationOf{
+	};
+	
+	#define NUMERIC_OPERATION_KERNELS(operationName, operationEnum) \
+		struct operationName##Operation; \
+		template<> \
+		struct OperationOf<NumericOperation::operationEnum>{ \
+			typedef operationName##Operation Type; \
+		}; \
+		struct operationName##Operation{ \
+			static NumericOperation::Operation operation(){ \
+				return NumericOperation::operationEnum; \
+			} \
+			template<class TypeA, class TypeB> \
+			static void run(ArrayToArray, const std::vector<TypeA> &a, const std::vector<TypeB> &b, std::vector<TypeA> &result){ \
+				numericOperation_##operationName##ArrayToArray<TypeA, TypeB>(a, b, result); \
+			} \
+			template<class TypeA, class TypeB> \
+			static void run(SingleToArray, const std::vector<TypeA> &a, const std::vector<TypeB> &b, std::vector<TypeA> &result){ \
+				numericOperation_##operationName##SingleToArray<TypeA, TypeB>(a, b, result); \
+			} \
+			template<class TypeA, class TypeB> \
+			static void run(ArrayToSingle, const std::vector<TypeA> &a, const std::vector<TypeB> &b, std::vector<TypeA> &result){ \
+				numericOperation_##operationName##ArrayToSingle<TypeA, TypeB>(a, b, result); \
+			} \
+		};
+	
+	NUMERIC_OPERATION_KERNELS(add, numericOperationAdd)
+	NUMERIC_OPERATION_KERNELS(sub, numericOperationSub)
+	NUMERIC_OPERATION_KERNELS(mul, numericOperationMul)
+	NUMERIC_OPERATION_KERNELS(div, numericOperationDiv)
+	
+	// copies the elements [begin, begin + count) of values without materializing them when they are chunked
+	template<class T>
+	void readValues(const SharedVector<T> &values, unsigned int begin, unsigned int count, std::vector<T> &result){
+		result.resize(count);
+		if(count){
+			if(values.chunked()){
+				values.chunked()->read(begin, count, (char*)&result[0]);
+			}
+			else{
+				const std::vector<T> &contiguousValues = values.read();
+				std::copy(contiguousValues.begin() + begin, contiguousValues.begin() + begin + count, result.begin());
+			}
+		}
+	}
+	
+	// evaluates an operation one chunk at a time when its array operand is backed by a ChunkedArray,
+	// the operands are held as shared copies so later edits of the inputs don't leak into the result.
+	template<class Operation, class Mode, class TypeA, class TypeB>
+	class ChunkedOperationSource: public GeneratedChunkSource{
+	public:
+		ChunkedOperationSource(const SharedVector<TypeA> &operandA, const SharedVector<TypeB> &operandB):
+			_operandA(operandA),
+			_operandB(operandB){
+		}
+	
+	protected:
+		void fillChunk(unsigned int begin, unsigned int count, char *values){
+			std::vector<TypeA> valuesA;
+			std::vector<TypeB> valuesB;
+			std::vector<TypeA> result;
+			
+			readValues(_operandA, begin, count, valuesA);
+			readValues(_operandB, Mode::singleB ? 0 : begin, Mode::singleB ? 1 : count, valuesB);
+			
+			Operation::template run<TypeA, TypeB>(Mode(), valuesA, valuesB, result);
+			std::copy(result.begin(), result.end(), (TypeA*)values);
+		}
+	
+	private:
+		SharedVector<TypeA> _operandA;
+		SharedVector<TypeB> _operandB;
+	};
+}
 
+namespace coral{
+
+// Holds the dispatch table and the batched kernels, it's nested in NumericOperation to reach the sliced values of Numeric.
+struct NumericOperation::Kernels{
+	Kernel operations[numericOperations][numericTypes][numericTypes];
+	Kernel passThrough[numericTypes];
+	
+	// filled once at static initialization, before any node can select an operation
+	static Kernels table;
+	
+	Kernels();
+	
+	template<class type>
+	static std::vector<SharedVector<type> > &slicedValues(Numeric *numeric);
+	
+	template<class type>
+	static Numeric::Type singleType();
+	
 	template<class type>
-	unsigned int getSliceInBounds(std::vector<std::vector<type> > &vec, unsigned int slice){
-		unsigned int size = vec.size();
-		if(slice >= size){
-			return size - 1;
+	static Numeric::Type arrayType(){
+		return Numeric::Type(singleType<type>() + 1);
+	}
+	
+	// one indirect call evaluates the whole range of slices, the per-type kernel is inlined in the loop.
+	template<class Operation, class Mode, class TypeA, class TypeB>
+	static void run(Numeric *operandA, Numeric *operandB, Numeric *result, unsigned int beginSlice, unsigned int endSlice){
+		std::vector<SharedVector<TypeA> > &slicesA = slicedValues<TypeA>(operandA);
+		std::vector<SharedVector<TypeB> > &slicesB = slicedValues<TypeB>(operandB);
+		std::vector<SharedVector<TypeA> > &resultSlices = slicedValues<TypeA>(result);
+		
+		unsigned int lastSliceA = slicesA.size() - 1;
+		unsigned int lastSliceB = slicesB.size() - 1;
+		for(unsigned int slice = beginSlice; slice < endSlice; ++slice){
+			unsigned int sliceA = slice < lastSliceA ? slice : lastSliceA;
+			unsigned int sliceB = slice < lastSliceB ? slice : lastSliceB;
+			
+			if(!runChunked<Operation, TypeA, TypeB>(Mode(), slicesA[sliceA], slicesB[sliceB], resultSlices[slice])){
+				Operation::template run<TypeA, TypeB>(Mode(), slicesA[sliceA].read(), slicesB[sliceB].read(), resultSlices[slice].write());
+			}
 		}
-
-		return slice;
 	}
-}
+	
+	// Chunked operands are never materialized: array results become lazily evaluated ChunkedArrays 
+	// and accumulations stream over the chunks in order, these return false when no operand is chunked.
+	template<class Operation, class TypeA, class TypeB>
+	static bool runChunked(ArrayToArray, const SharedVector<TypeA> &operandA, const SharedVector<TypeB> &operandB, SharedVector<TypeA> &result){
+		boost::shared_ptr<ChunkedArray> chunked = operandA.chunked() ? operandA.chunked() : operandB.chunked();
+		if(!chunked){
+			return false;
+		}
+		
+		unsigned int size = std::min(operandA.size(), operandB.size());
+		boost::shared_ptr<ChunkSource> source(new ChunkedOperationSource<Operation, ArrayToArray, TypeA, TypeB>(operandA, operandB));
+		result.setChunked(boost::shared_ptr<ChunkedArray>(new ChunkedArray(source, size, sizeof(TypeA), chunked->chunkSize())));
+		
+		return true;
+	}
+	
+	template<class Operation, class TypeA, class TypeB>
+	static bool runChunked(ArrayToSingle, const SharedVector<TypeA> &operandA, const SharedVector<TypeB> &operandB, SharedVector<TypeA> &result){
+		boost::shared_ptr<ChunkedArray> chunked = operandA.chunked();
+		if(!chunked || operandB.size() == 0){
+			return false;
+		}
+		
+		boost::shared_ptr<ChunkSource> source(new ChunkedOperationSource<Operation, ArrayToSingle, TypeA, TypeB>(operandA, operandB));
+		result.setChunked(boost::shared_ptr<ChunkedArray>(new ChunkedArray(source, operandA.size(), sizeof(TypeA), chunked->chunkSize())));
+		
+		return true;
+	}
+	
+	template<class Operation, class TypeA, class TypeB>
+	static bool runChunked(SingleToArray, const SharedVector<TypeA> &operandA, const SharedVector<TypeB> &operandB, SharedVector<TypeA> &result){
+		boost::shared_ptr<ChunkedArray> chunked = operandB.chunked();
+		if(!chunked || operandA.size() == 0){
+			return false;
+		}
+		
+		std::vector<TypeA> value;
+		readValues(operandA, 0, 1, value);
+		
+		std::vector<TypeA> accumulated;
+		std::vector<TypeB> valuesB;
+		for(unsigned int i = 0; i < chunked->chunks(); ++i){
+			readValues(operandB, chunked->chunkBegin(i), chunked->chunkCount(i), valuesB);
+			Operation::template run<TypeA, TypeB>(SingleToArray(), value, valuesB, accumulated);
+			value.swap(accumulated);
+		}
+		
+		result.set(value);
+		
+		return true;
+	}
+	
+	template<class type>
+	static void runPassThrough(Numeric *operandA, Numeric *operandB, Numeric *result, unsigned int beginSlice, unsigned int endSlice){
+		std::vector<SharedVector<type> > &slicesA = slicedValues<type>(operandA);
+		std::vector<SharedVector<type> > &resultSlices = slicedValues<type>(result);
+		
+		unsigned int lastSliceA = slicesA.size() - 1;
+		for(unsigned int slice = beginSlice; slice < endSlice; ++slice){
+			resultSlices[slice] = slicesA[slice < lastSliceA ? slice : lastSliceA];
+		}
+	}
+	
+	template<class Operation, class TypeA, class TypeB>
+	void registerPair(){
+		Kernel (&kernels)[numericTypes][numericTypes] = operations[Operation::operation()];
+		Numeric::Type singleA = singleType<TypeA>();
+		Numeric::Type singleB = singleType<TypeB>();
+		Numeric::Type arrayA = arrayType<TypeA>();
+		Numeric::Type arrayB = arrayType<TypeB>();
+		
+		kernels[singleA][singleB] = &run<Operation, ArrayToSingle, TypeA, TypeB>;
+		kernels[arrayA][singleB] = &run<Operation, ArrayToSingle, TypeA, TypeB>;
+		kernels[arrayA][arrayB] = &run<Operation, ArrayToArray, TypeA, TypeB>;
+		kernels[singleA][arrayB] = &run<Operation, SingleToArray, TypeA, TypeB>;
+	}
+	
+	// called back by NumericOperation::visitSupportedPairs
+	template<Operation operation, class TypeA, class TypeB>
+	void visit(){
+		registerPair<typename OperationOf<operation>::Type, TypeA, TypeB>();
+	}
+	
+	template<class type>
+	void registerPassThrough(){
+		passThrough[singleType<type>()] = &runPassThrough<type>;
+		passThrough[arrayType<type>()] = &runPassThrough<type>;
+	}
+};
 
-#define DEFINE_NUMERIC_OPERATION(operation, typeA, typeB) \
-	void NumericOperation::operation_##operation##_##typeA##_##typeB##_array_to_array(Numeric *operandA, Numeric *operandB, Numeric *result, unsigned int slice){ \
-		unsigned int sliceA = getSliceInBounds<typeA>(operandA->_##typeA##ValuesSliced, slice); \
-		unsigned int sliceB = getSliceInBounds<typeB>(operandB->_##typeB##ValuesSliced, slice); \
-		numericOperation_##operation##ArrayToArray<typeA, typeB>(operandA->_##typeA##ValuesSliced[sliceA], operandB->_##typeB##ValuesSliced[sliceB], result->_##typeA##ValuesSliced[slice]); \
-	} \
-	void NumericOperation::operation_##operation##_##typeA##_##typeB##_single_to_array(Numeric *operandA, Numeric *operandB, Numeric *result, unsigned int slice){ \
-		unsigned int sliceA = getSliceInBounds<typeA>(operandA->_##typeA##ValuesSliced, slice); \
-		unsigned int sliceB = getSliceInBounds<typeB>(operandB->_##typeB##ValuesSliced, slice); \
-		numericOperation_##operation##SingleToArray<typeA, typeB>(operandA->_##typeA##ValuesSliced[sliceA], operandB->_##typeB##ValuesSliced[sliceB], result->_##typeA##ValuesSliced[slice]); \
-	} \
-	void NumericOperation::operation_##operation##_##typeA##_##typeB##_array_to_single(Numeric *operandA, Numeric *operandB, Numeric *result, unsigned int slice){ \
-		unsigned int sliceA = getSliceInBounds<typeA>(operandA->_##typeA##ValuesSliced, slice); \
-		unsigned int sliceB = getSliceInBounds<typeB>(operandB->_##typeB##ValuesSliced, slice); \
-		numericOperation_##operation##ArrayToSingle<typeA, typeB>(operandA->_##typeA##ValuesSliced[sliceA], operandB->_##typeB##ValuesSliced[sliceB], result->_##typeA##ValuesSliced[slice]); \
+#define NUMERIC_OPERATION_VALUE_TYPE(type, typeName, numericType) \
+	template<> \
+	std::vector<SharedVector<type> > &NumericOperation::Kernels::slicedValues<type>(Numeric *numeric){ \
+		return numeric->_##typeName##ValuesSliced; \
 	} \
+	template<> \
+	Numeric::Type NumericOperation::Kernels::singleType<type>(){ \
+		return Numeric::numericType; \
+	}
 
-#define DEFINE_PASSTRHOUGH_OPERATION(type) \
-	void NumericOperation::operation_##type##_passThrough(Numeric *operandA, Numeric *operandB, Numeric *result, unsigned int slice){ \
-		unsigned int sliceA = getSliceInBounds<type>(operandA->_##type##ValuesSliced, slice); \
-		numericOperation_passThrough<type>(operandA->_##type##ValuesSliced[sliceA], result->_##type##ValuesSliced[slice]); \
-	} \
+NUMERIC_OPERATION_VALUE_TYPE(int, int, numericTypeInt)
+NUMERIC_OPERATION_VALUE_TYPE(float, float, numericTypeFloat)
+NUMERIC_OPERATION_VALUE_TYPE(vec3, vec3, numericTypeVec3)
+NUMERIC_OPERATION_VALUE_TYPE(col4, col4, numericTypeCol4)
+NUMERIC_OPERATION_VALUE_TYPE(matrix44, matrix44, numericTypeMatrix44)
 
-#define SELECT_NUMERIC_OPERATION(operation, typeNameA, typeNameB) \
-	if(typeA == numeric_type_##typeNameA && typeB == numeric_type_##typeNameB){ \
-		_selectedOperation = &NumericOperation::operation_##operation##_##typeNameA##_##typeNameB##_array_to_single; return;} \
-	if(typeA == numeric_type_##typeNameA##_array && typeB == numeric_type_##typeNameB){ \
-		_selectedOperation = &NumericOperation::operation_##operation##_##typeNameA##_##typeNameB##_array_to_single; return;} \
-	if(typeA == numeric_type_##typeNameA##_array && typeB == numeric_type_##typeNameB##_array){ \
-		_selectedOperation = &NumericOperation::operation_##operation##_##typeNameA##_##typeNameB##_array_to_array; return;} \
-	if(typeA == numeric_type_##typeNameA && typeB == numeric_type_##typeNameB##_array){ \
-		_selectedOperation = &NumericOperation::operation_##operation##_##typeNameA##_##typeNameB##_single_to_array; return;} \
+NumericOperation::Kernels::Kernels(){
+	for(int op = 0; op < numericOperations; ++op){
+		for(int typeA = 0; typeA < numericTypes; ++typeA){
+			passThrough[typeA] = 0;
+			
+			for(int typeB = 0; typeB < numericTypes; ++typeB){
+				operations[op][typeA][typeB] = 0;
+			}
+		}
+	}
+	
+	// adding an operation or a type pair only takes a new line in NumericOperation::visitSupportedPairs
+	visitSupportedPairs(*this);
+	
+	registerPassThrough<int>();
+	registerPassThrough<float>();
+	registerPassThrough<vec3>();
+	registerPassThrough<col4>();
+	registerPassThrough<matrix44>();
+}
 
-#define SELECT_PASSTRHOUGH_OPERATION(type) \
-	if(typeA == numeric_type_##type || typeA == numeric_type_##type##_array){ \
-		_selectedOperation = &NumericOperation::operation_##type##_passThrough; return;} \
+NumericOperation::Kernels NumericOperation::Kernels::table;
 
-#define ALLOW_NUMERIC_OPERATION(typeNameA, typeNameB) \
-	if(typeA == numeric_type_##typeNameA && typeB == numeric_type_##typeNameB) \
-		return true; \
-	if(typeA == numeric_type_##typeNameA##_array && typeB == numeric_type_##typeNameB) \
-		return true; \
-	if(typeA == numeric_type_##typeNameA##_array && typeB == numeric_type_##typeNameB##_array) \
-		return true; \
-	if(typeA == numeric_type_##typeNameA && typeB == numeric_type_##typeNameB##_array) \
-		return true; \
+}
 
 NumericOperation::NumericOperation():
-	_selectedOperation(0){
+	_selectedOperation(0),
+	_operation(numericOperationAdd){
 }
 
-bool NumericOperation::allowOperation(Operation operation, Numeric::Type typeA, Numeric::Type typeB){	
-	if(operation == numericOperationAdd){
-		ALLOW_NUMERIC_OPERATION(int, int);
-		ALLOW_NUMERIC_OPERATION(int, float);
-		ALLOW_NUMERIC_OPERATION(float, float);
-		ALLOW_NUMERIC_OPERATION(float, int);
-		ALLOW_NUMERIC_OPERATION(vec3, vec3);
-		ALLOW_NUMERIC_OPERATION(col4, col4);
-	}
-	else if(operation == numericOperationSub){
-		ALLOW_NUMERIC_OPERATION(int, int);
-		ALLOW_NUMERIC_OPERATION(int, float);
-		ALLOW_NUMERIC_OPERATION(float, float);
-		ALLOW_NUMERIC_OPERATION(float, int);
-		ALLOW_NUMERIC_OPERATION(vec3, vec3);
-		ALLOW_NUMERIC_OPERATION(col4, col4);
-	}
-	else if(operation == numericOperationMul){
-		ALLOW_NUMERIC_OPERATION(int, int);
-		ALLOW_NUMERIC_OPERATION(int, float);
-		ALLOW_NUMERIC_OPERATION(float, float);
-		ALLOW_NUMERIC_OPERATION(float, int);
-		ALLOW_NUMERIC_OPERATION(vec3, vec3);
-		ALLOW_NUMERIC_OPERATION(vec3, float);
-		ALLOW_NUMERIC_OPERATION(vec3, int);
-		ALLOW_NUMERIC_OPERATION(vec3, matrix44);
-		ALLOW_NUMERIC_OPERATION(col4, col4);
-		ALLOW_NUMERIC_OPERATION(col4, float);
-		ALLOW_NUMERIC_OPERATION(col4, int);
-		ALLOW_NUMERIC_OPERATION(matrix44, matrix44);
-	}
-	else if(operation == numericOperationDiv){
-		ALLOW_NUMERIC_OPERATION(int, int);
-		ALLOW_NUMERIC_OPERATION(int, float);
-		ALLOW_NUMERIC_OPERATION(float, float);
-		ALLOW_NUMERIC_OPERATION(float, int);
-		ALLOW_NUMERIC_OPERATION(vec3, vec3);
-		ALLOW_NUMERIC_OPERATION(vec3, float);
-		ALLOW_NUMERIC_OPERATION(vec3, int);
-		ALLOW_NUMERIC_OPERATION(col4, col4);
-		ALLOW_NUMERIC_OPERATION(col4, float);
-		ALLOW_NUMERIC_OPERATION(col4, int);
+NumericOperation::Kernel NumericOperation::selectKernel(Operation operation, Numeric::Type typeA, Numeric::Type typeB){
+	if(operation < 0 || operation >= numericOperations || typeA < 0 || typeA >= numericTypes || typeB < 0 || typeB >= numericTypes){
+		return 0;
 	}
 	
-	return false;
+	return Kernels::table.operations[operation][typeA][typeB];
+}
+
+bool NumericOperation::allowOperation(Operation operation, Numeric::Type typeA, Numeric::Type typeB){
+	return selectKernel(operation, typeA, typeB) != 0;
 }
 
 void NumericOperation::selectOperands(Numeric::Type typeA, Numeric::Type typeB){
 	if(typeA != Numeric::numericTypeAny){
 		if(typeB == Numeric::numericTypeAny){
-			SELECT_PASSTRHOUGH_OPERATION(int);
-			SELECT_PASSTRHOUGH_OPERATION(float);
-			SELECT_PASSTRHOUGH_OPERATION(vec3);
-			SELECT_PASSTRHOUGH_OPERATION(col4);
-			SELECT_PASSTRHOUGH_OPERATION(matrix44);
-		}
-		else if(_operation == NumericOperation::numericOperationAdd){
-			SELECT_NUMERIC_OPERATION(add, int, int);
-			SELECT_NUMERIC_OPERATION(add, int, float);
-			SELECT_NUMERIC_OPERATION(add, float, float);
-			SELECT_NUMERIC_OPERATION(add, float, int);
-			SELECT_NUMERIC_OPERATION(add, vec3, vec3);
-			SELECT_NUMERIC_OPERATION(add, col4, col4);
+			_selectedOperation = Kernels::table.passThrough[typeA];
 		}
-		else if(_operation == NumericOperation::numericOperationSub){
-			SELECT_NUMERIC_OPERATION(sub, int, int);
-			SELECT_NUMERIC_OPERATION(sub, int, float);
-			SELECT_NUMERIC_OPERATION(sub, float, float);
-			SELECT_NUMERIC_OPERATION(sub, float, int);
-			SELECT_NUMERIC_OPERATION(sub, vec3, vec3);
-			SELECT_NUMERIC_OPERATION(sub, col4, col4);
-		}
-		else if(_operation == NumericOperation::numericOperationMul){
-			SELECT_NUMERIC_OPERATION(mul, int, int);
-			SELECT_NUMERIC_OPERATION(mul, int, float);
-			SELECT_NUMERIC_OPERATION(mul, float, float);
-			SELECT_NUMERIC_OPERATION(mul, float, int);
-			SELECT_NUMERIC_OPERATION(mul, vec3, vec3);
-			SELECT_NUMERIC_OPERATION(mul, vec3, float);
-			SELECT_NUMERIC_OPERATION(mul, vec3, int);
-			SELECT_NUMERIC_OPERATION(mul, vec3, matrix44);
-			SELECT_NUMERIC_OPERATION(mul, col4, col4);
-			SELECT_NUMERIC_OPERATION(mul, col4, float);
-			SELECT_NUMERIC_OPERATION(mul, col4, int);
-			SELECT_NUMERIC_OPERATION(mul, matrix44, matrix44);
-		}
-		else if(_operation == NumericOperation::numericOperationDiv){
-			SELECT_NUMERIC_OPERATION(div, int, int);
-			SELECT_NUMERIC_OPERATION(div, int, float);
-			SELECT_NUMERIC_OPERATION(div, float, float);
-			SELECT_NUMERIC_OPERATION(div, float, int);
-			SELECT_NUMERIC_OPERATION(div, vec3, vec3);
-			SELECT_NUMERIC_OPERATION(div, vec3, float);
-			SELECT_NUMERIC_OPERATION(div, vec3, int);
-			SELECT_NUMERIC_OPERATION(div, col4, col4);
-			SELECT_NUMERIC_OPERATION(div, col4, float);
-			SELECT_NUMERIC_OPERATION(div, col4, int);
+		else{
+			_selectedOperation = selectKernel(_operation, typeA, typeB);
 		}
 	}
 }
 
 void NumericOperation::executeSelectedOperation(Numeric *operandA, Numeric *operandB, Numeric *out, unsigned int slice){
 	if(_selectedOperation){
-		(this->*_selectedOperation)(operandA, operandB, out, slice);
+		_selectedOperation(operandA, operandB, out, slice, slice + 1);
 	}
 }
 
-DEFINE_NUMERIC_OPERATION(add, int, int);
-DEFINE_NUMERIC_OPERATION(add, int, float);
-DEFINE_NUMERIC_OPERATION(add, float, float);
-DEFINE_NUMERIC_OPERATION(add, float, int);
-DEFINE_NUMERIC_OPERATION(add, vec3, vec3);
-DEFINE_NUMERIC_OPERATION(add, col4, col4);
-
-DEFINE_NUMERIC_OPERATION(sub, int, int);
-DEFINE_NUMERIC_OPERATION(sub, int, float);
-DEFINE_NUMERIC_OPERATION(sub, float, float);
-DEFINE_NUMERIC_OPERATION(sub, float, int);
-DEFINE_NUMERIC_OPERATION(sub, vec3, vec3);
-DEFINE_NUMERIC_OPERATION(sub, col4, col4);
-
-DEFINE_NUMERIC_OPERATION(mul, int, int);
-DEFINE_NUMERIC_OPERATION(mul, int, float);
-DEFINE_NUMERIC_OPERATION(mul, float, float);
-DEFINE_NUMERIC_OPERATION(mul, float, int);
-DEFINE_NUMERIC_OPERATION(mul, vec3, vec3);
-DEFINE_NUMERIC_OPERATION(mul, vec3, float);
-DEFINE_NUMERIC_OPERATION(mul, vec3, int);
-DEFINE_NUMERIC_OPERATION(mul, vec3, matrix44);
-DEFINE_NUMERIC_OPERATION(mul, col4, col4);
-DEFINE_NUMERIC_OPERATION(mul, col4, float);
-DEFINE_NUMERIC_OPERATION(mul, col4, int);
-DEFINE_NUMERIC_OPERATION(mul, matrix44, matrix44);
-
-DEFINE_NUMERIC_OPERATION(div, int, int);
-DEFINE_NUMERIC_OPERATION(div, int, float);
-DEFINE_NUMERIC_OPERATION(div, float, float);
-DEFINE_NUMERIC_OPERATION(div, float, int);
-DEFINE_NUMERIC_OPERATION(div, vec3, vec3);
-DEFINE_NUMERIC_OPERATION(div, vec3, float);
-DEFINE_NUMERIC_OPERATION(div, vec3, int);
-DEFINE_NUMERIC_OPERATION(div, col4, col4);
-DEFINE_NUMERIC_OPERATION(div, col4, float);
-DEFINE_NUMERIC_OPERATION(div, col4, int);
-
-DEFINE_PASSTRHOUGH_OPERATION(int);
-DEFINE_PASSTRHOUGH_OPERATION(float);
-DEFINE_PASSTRHOUGH_OPERATION(vec3);
-DEFINE_PASSTRHOUGH_OPERATION(col4);
-DEFINE_PASSTRHOUGH_OPERATION(matrix44);
+void NumericOperation::executeSelectedOperation(Numeric *operandA, Numeric *operandB, Numeric *out, unsigned int beginSlice, unsigned int endSlice){
+	if(_selectedOperation){
+		_selectedOperation(operandA, operandB, out, beginSlice, endSlice);
+	}
+}
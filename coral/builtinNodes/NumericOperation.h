@@ -32,14 +32,6 @@
 #include <vector>
 #include "../src/Numeric.h"
 
-#define DECLARE_NUMERIC_OPERATION(operation, typeA, typeB) \
-	void operation_##operation##_##typeA##_##typeB##_array_to_array(Numeric *operandA, Numeric *operandB, Numeric *result, unsigned int slice); \
-	void operation_##operation##_##typeA##_##typeB##_single_to_array(Numeric *operandA, Numeric *operandB, Numeric *result, unsigned int slice); \
-	void operation_##operation##_##typeA##_##typeB##_array_to_single(Numeric *operandA, Numeric *operandB, Numeric *result, unsigned int slice) \
-
-#define DECLARE_PASSTRHOUGH_OPERATION(type) \
-	void operation_##type##_passThrough(Numeric *operandA, Numeric *operandB, Numeric *result, unsigned int slice); \
-
 namespace coral{
 
 class NumericOperation{
@@ -51,10 +43,16 @@ public:
 		numericOperationDiv,
 	};
 	
+	//! Evaluates the selected operation for every slice in the range [beginSlice, endSlice) in a single call.
+	typedef void(*Kernel)(Numeric *operandA, Numeric *operandB, Numeric *result, unsigned int beginSlice, unsigned int endSlice);
+	
 	NumericOperation();
 	void selectOperands(Numeric::Type typeA, Numeric::Type typeB);
 	void executeSelectedOperation(Numeric *operandA, Numeric *operandB, Numeric *out, unsigned int slice);
 	
+	//! Batched version of executeSelectedOperation, runs all the slices in [beginSlice, endSlice) with one dispatch.
+	void executeSelectedOperation(Numeric *operandA, Numeric *operandB, Numeric *out, unsigned int beginSlice, unsigned int endSlice);
+	
 	void clearSelectedOperation(){
 		_selectedOperation = 0;
 	}
@@ -78,53 +76,61 @@ public:
 	
 	static bool allowOperation(Operation operation, Numeric::Type typeA, Numeric::Type typeB);
 	
+	//! Returns the kernel registered for the given operation and operand types, or NULL if the operation is not allowed.
+	//! The kernels live in a table indexed by (operation, typeA, typeB) that is filled once from the list of supported type pairs.
+	static Kernel selectKernel(Operation operation, Numeric::Type typeA, Numeric::Type typeB);
+	
+	//! Calls visitor.visit<operation, TypeA, TypeB>() for every operation and pair of single value types the kernel table is filled from,
+	//! arrays of those types are supported as well. Other kernel tables, such as the Expression node's, are built from the same pairs.
+	template<class Visitor>
+	static void visitSupportedPairs(Visitor &visitor){
+		visitPairs<numericOperationAdd>(visitor, ArithmeticPairs());
+		visitPairs<numericOperationSub>(visitor, ArithmeticPairs());
+		visitPairs<numericOperationMul>(visitor, ArithmeticPairs());
+		visitPairs<numericOperationMul>(visitor, ScalingPairs());
+		visitPairs<numericOperationMul>(visitor, TransformPairs());
+		visitPairs<numericOperationDiv>(visitor, ArithmeticPairs());
+		visitPairs<numericOperationDiv>(visitor, ScalingPairs());
+	}
+	
 private:
-	void(NumericOperation::*_selectedOperation)(Numeric*, Numeric*, Numeric*, unsigned int);
-	Operation _operation;
+	struct Kernels;
+	
+	// type list of the (TypeA, TypeB) operand pairs an operation supports
+	struct TypeListEnd{
+	};
 	
-	DECLARE_NUMERIC_OPERATION(add, int, int);
-	DECLARE_NUMERIC_OPERATION(add, int, float);
-	DECLARE_NUMERIC_OPERATION(add, float, float);
-	DECLARE_NUMERIC_OPERATION(add, float, int);
-	DECLARE_NUMERIC_OPERATION(add, vec3, vec3);
-	DECLARE_NUMERIC_OPERATION(add, col4, col4);
-	
-	DECLARE_NUMERIC_OPERATION(sub, int, int);
-	DECLARE_NUMERIC_OPERATION(sub, int, float);
-	DECLARE_NUMERIC_OPERATION(sub, float, float);
-	DECLARE_NUMERIC_OPERATION(sub, float, int);
-	DECLARE_NUMERIC_OPERATION(sub, vec3, vec3);
-	DECLARE_NUMERIC_OPERATION(sub, col4, col4);
-	
-	DECLARE_NUMERIC_OPERATION(mul, int, int);
-	DECLARE_NUMERIC_OPERATION(mul, int, float);
-	DECLARE_NUMERIC_OPERATION(mul, float, float);
-	DECLARE_NUMERIC_OPERATION(mul, float, int);
-	DECLARE_NUMERIC_OPERATION(mul, vec3, vec3);
-	DECLARE_NUMERIC_OPERATION(mul, vec3, float);
-	DECLARE_NUMERIC_OPERATION(mul, vec3, int);
-	DECLARE_NUMERIC_OPERATION(mul, vec3, matrix44);
-	DECLARE_NUMERIC_OPERATION(mul, col4, col4);
-	DECLARE_NUMERIC_OPERATION(mul, col4, float);
-	DECLARE_NUMERIC_OPERATION(mul, col4, int);
-	DECLARE_NUMERIC_OPERATION(mul, matrix44, matrix44);
-	
-	DECLARE_NUMERIC_OPERATION(div, int, int);
-	DECLARE_NUMERIC_OPERATION(div, int, float);
-	DECLARE_NUMERIC_OPERATION(div, float, float);
-	DECLARE_NUMERIC_OPERATION(div, float, int);
-	DECLARE_NUMERIC_OPERATION(div, vec3, vec3);
-	DECLARE_NUMERIC_OPERATION(div, vec3, float);
-	DECLARE_NUMERIC_OPERATION(div, vec3, int);
-	DECLARE_NUMERIC_OPERATION(div, col4, col4);
-	DECLARE_NUMERIC_OPERATION(div, col4, float);
-	DECLARE_NUMERIC_OPERATION(div, col4, int);
-	
-	DECLARE_PASSTRHOUGH_OPERATION(int);
-	DECLARE_PASSTRHOUGH_OPERATION(float);
-	DECLARE_PASSTRHOUGH_OPERATION(vec3);
-	DECLARE_PASSTRHOUGH_OPERATION(col4);
-	DECLARE_PASSTRHOUGH_OPERATION(matrix44);
+	template<class TypeA, class TypeB, class Next = TypeListEnd>
+	struct TypePair{
+	};
+	
+	typedef TypePair<int, int, 
+		TypePair<int, float, 
+		TypePair<float, float, 
+		TypePair<float, int, 
+		TypePair<Imath::V3f, Imath::V3f, 
+		TypePair<Imath::Color4f, Imath::Color4f> > > > > > ArithmeticPairs;
+	
+	typedef TypePair<Imath::V3f, float, 
+		TypePair<Imath::V3f, int, 
+		TypePair<Imath::Color4f, float, 
+		TypePair<Imath::Color4f, int> > > > ScalingPairs;
+	
+	typedef TypePair<Imath::V3f, Imath::M44f, 
+		TypePair<Imath::M44f, Imath::M44f> > TransformPairs;
+	
+	template<Operation operation, class Visitor>
+	static void visitPairs(Visitor &visitor, TypeListEnd){
+	}
+	
+	template<Operation operation, class Visitor, class TypeA, class TypeB, class Next>
+	static void visitPairs(Visitor &visitor, TypePair<TypeA, TypeB, Next>){
+		visitor.template visit<operation, TypeA, TypeB>();
+		visitPairs<operation>(visitor, Next());
+	}
+	
+	Kernel _selectedOperation;
+	Operation _operation;
 };
 
 }
@@ -231,7 +231,7 @@ void ObjImporter::updateSlice(Attribute *attribute, unsigned int slice){
 	while(readLine(stream, vertices, normals, uvs, faces));
 	stream.close();
 	
-	_geo->outValue()->build(vertices, faces, uvs);
+	_geo->outValue()->swapBuild(vertices, faces, uvs);
 	if(normals.size()){
 		_geo->outValue()->setVerticesNormals(normals);
 	}
@@ -247,7 +247,7 @@ void SplinePoint::updateArray(){
 		}
 	}
 
-	_pointOnCurve->outValue()->setVec3Values(pointsOnCurve);
+	_pointOnCurve->outValue()->swapVec3ValuesSlice(0, pointsOnCurve);
 }
 
 void SplinePoint::updateSingle(){
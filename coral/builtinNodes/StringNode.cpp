@@ -76,7 +76,7 @@ void AddStringNode::updateString(String *in0, String *in1, String *out, unsigned
 		strValue += in1vals[i];
 		outVals[i] = strValue;
 	}
-	out->setStringValuesSlice(slice, outVals);
+	out->swapStringValuesSlice(slice, outVals);
 }
 
 void AddStringNode::updatePath(String *in0, String *in1, String *out, unsigned int slice)
@@ -96,7 +96,7 @@ void AddStringNode::updatePath(String *in0, String *in1, String *out, unsigned i
 		strValue += osSep + in1vals[i];
 		outVals[i] = strValue;
 	}
-	out->setPathValuesSlice(slice, outVals);
+	out->swapStringValuesSlice(slice, outVals);
 }
 
 
@@ -173,7 +173,7 @@ void BuildArrayStringNode::updateString(const std::vector<Attribute*> &inAttrs,
 		String *inStr = (String*)inAttrs[i]->value();
 		arrayValues[i] = inStr->stringValueAtSlice(slice, 0);
 	}
-	array->setStringValuesSlice(slice, arrayValues);
+	array->swapStringValuesSlice(slice, arrayValues);
 }
 
 void BuildArrayStringNode::updatePath(const std::vector<Attribute*> &inAttrs, int arraySize, String *array, unsigned int slice){
@@ -182,7 +182,7 @@ void BuildArrayStringNode::updatePath(const std::vector<Attribute*> &inAttrs, in
 		String *inStr = (String*)inAttrs[i]->value();
 		arrayValues[i] = inStr->pathValueAtSlice(slice, 0);
 	}
-	array->setPathValuesSlice(slice, arrayValues);
+	array->swapStringValuesSlice(slice, arrayValues);
 }
 
 void BuildArrayStringNode::updateSlice(Attribute *attr, unsigned int slice){
@@ -225,7 +225,7 @@ void StringArrayIndices::updateSlice(Attribute *attribute, unsigned int slice)
 		indices[i] = i;
 	}
 
-	_indices->outValue()->setIntValuesSlice(slice, indices);
+	_indices->outValue()->swapIntValuesSlice(slice, indices);
 }
 
 GetStringArrayElement::GetStringArrayElement(const std::string &name, Node *parent):
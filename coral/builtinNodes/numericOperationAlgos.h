@@ -30,6 +30,8 @@
 #define CORAL_NUMERICOPERATIONS_H
 
 #include "../src/Numeric.h"
+#include "../src/simdUtils.h"
+#include "../src/coreParallelAlgos.h"
 
 typedef Imath::V3f vec3;
 typedef Imath::Color4f col4;
@@ -42,20 +44,87 @@ void numericOperation_passThrough(const std::vector<type> &containerA, std::vect
 	resultContainer = containerA;
 }
 
-template <class TypeA, class TypeB>
-void numericOperation_addArrayToSingle(const std::vector<TypeA> &containerA, const std::vector<TypeB> &containerB, std::vector<TypeA> &resultContainer){
+// element wise operators used by the parallel bodies below, the result is converted to TypeA as the plain assignments would do.
+struct numericOperation_add{
+	template <class TypeA, class TypeB>
+	static TypeA apply(const TypeA &valueA, const TypeB &valueB){
+		return valueA + valueB;
+	}
+};
+
+struct numericOperation_sub{
+	template <class TypeA, class TypeB>
+	static TypeA apply(const TypeA &valueA, const TypeB &valueB){
+		return valueA - valueB;
+	}
+};
+
+struct numericOperation_mul{
+	template <class TypeA, class TypeB>
+	static TypeA apply(const TypeA &valueA, const TypeB &valueB){
+		return valueA * valueB;
+	}
+};
+
+struct numericOperation_div{
+	template <class TypeA, class TypeB>
+	static TypeA apply(const TypeA &valueA, const TypeB &valueB){
+		return valueA / valueB;
+	}
+};
+
+// parallelFor bodies, each chunk only writes its own range of the already resized result.
+template <class Operation, class TypeA, class TypeB>
+class numericOperation_arrayToSingleBody{
+public:
+	numericOperation_arrayToSingleBody(const TypeA *valuesA, const TypeB &valueB, TypeA *result): 
+		_valuesA(valuesA), _valueB(valueB), _result(result){
+	}
+	
+	void operator() (unsigned int begin, unsigned int end) const{
+		for(unsigned int i = begin; i < end; ++i){
+			_result[i] = Operation::apply(_valuesA[i], _valueB);
+		}
+	}
+
+private:
+	const TypeA *_valuesA;
+	const TypeB &_valueB;
+	TypeA *_result;
+};
+
+template <class Operation, class TypeA, class TypeB>
+class numericOperation_arrayToArrayBody{
+public:
+	numericOperation_arrayToArrayBody(const TypeA *valuesA, const TypeB *valuesB, TypeA *result): 
+		_valuesA(valuesA), _valuesB(valuesB), _result(result){
+	}
+	
+	void operator() (unsigned int begin, unsigned int end) const{
+		for(unsigned int i = begin; i < end; ++i){
+			_result[i] = Operation::apply(_valuesA[i], _valuesB[i]);
+		}
+	}
+
+private:
+	const TypeA *_valuesA;
+	const TypeB *_valuesB;
+	TypeA *_result;
+};
+
+template <class Operation, class TypeA, class TypeB>
+void numericOperation_parallelArrayToSingle(const std::vector<TypeA> &containerA, const std::vector<TypeB> &containerB, std::vector<TypeA> &resultContainer){
 	if(containerB.size()){
 		resultContainer.resize(containerA.size());
-
-		const TypeB &valueB = containerB[0];
-		for(int i = 0; i < containerA.size(); ++i){
-			resultContainer[i] = containerA[i] + valueB;
+		
+		if(containerA.size()){
+			parallelFor(containerA.size(), numericOperation_arrayToSingleBody<Operation, TypeA, TypeB>(&containerA[0], containerB[0], &resultContainer[0]));
 		}
 	}
 }
 
-template <class TypeA, class TypeB>
-void numericOperation_addArrayToArray(const std::vector<TypeA> &containerA, const std::vector<TypeB> &containerB, std::vector<TypeA> &resultContainer){
+template <class Operation, class TypeA, class TypeB>
+void numericOperation_parallelArrayToArray(const std::vector<TypeA> &containerA, const std::vector<TypeB> &containerB, std::vector<TypeA> &resultContainer){
 	int sizeA = containerA.size();
 	int sizeB = containerB.size();
 	
@@ -65,12 +134,22 @@ void numericOperation_addArrayToArray(const std::vector<TypeA> &containerA, cons
 	}
 	
 	resultContainer.resize(minorSize);
-
-	for(int i = 0; i < minorSize; ++i){
-		resultContainer[i] = containerA[i] + containerB[i];
+	
+	if(minorSize){
+		parallelFor(minorSize, numericOperation_arrayToArrayBody<Operation, TypeA, TypeB>(&containerA[0], &containerB[0], &resultContainer[0]));
 	}
 }
 
+template <class TypeA, class TypeB>
+void numericOperation_addArrayToSingle(const std::vector<TypeA> &containerA, const std::vector<TypeB> &containerB, std::vector<TypeA> &resultContainer){
+	numericOperation_parallelArrayToSingle<numericOperation_add>(containerA, containerB, resultContainer);
+}
+
+template <class TypeA, class TypeB>
+void numericOperation_addArrayToArray(const std::vector<TypeA> &containerA, const std::vector<TypeB> &containerB, std::vector<TypeA> &resultContainer){
+	numericOperation_parallelArrayToArray<numericOperation_add>(containerA, containerB, resultContainer);
+}
+
 template <class TypeA, class TypeB>
 void numericOperation_addSingleToArray(const std::vector<TypeA> &containerA, const std::vector<TypeB> &containerB, std::vector<TypeA> &resultContainer){
 	if(containerA.size()){
@@ -87,14 +166,7 @@ void numericOperation_addSingleToArray(const std::vector<TypeA> &containerA, con
 
 template <class TypeA, class TypeB>
 void numericOperation_subArrayToSingle(const std::vector<TypeA> &containerA, const std::vector<TypeB> &containerB, std::vector<TypeA> &resultContainer){
-	if(containerB.size()){
-		resultContainer.resize(containerA.size());
-
-		const TypeB &valueB = containerB[0];
-		for(int i = 0; i < containerA.size(); ++i){
-			resultContainer[i] = containerA[i] - valueB;
-		}
-	}
+	numericOperation_parallelArrayToSingle<numericOperation_sub>(containerA, containerB, resultContainer);
 }
 
 template <class TypeA, class TypeB>
@@ -113,31 +185,12 @@ void numericOperation_subSingleToArray(const std::vector<TypeA> &containerA, con
 
 template <class TypeA, class TypeB>
 void numericOperation_subArrayToArray(const std::vector<TypeA> &containerA, const std::vector<TypeB> &containerB, std::vector<TypeA> &resultContainer){
-	int sizeA = containerA.size();
-	int sizeB = containerB.size();
-	
-	int minorSize = sizeA;
-	if(sizeB < sizeA){
-		minorSize = sizeB;
-	}
-	
-	resultContainer.resize(minorSize);
-	
-	for(int i = 0; i < minorSize; ++i){
-		resultContainer[i] = containerA[i] - containerB[i];
-	}
+	numericOperation_parallelArrayToArray<numericOperation_sub>(containerA, containerB, resultContainer);
 }
 
 template <class TypeA, class TypeB>
 void numericOperation_mulArrayToSingle(const std::vector<TypeA> &containerA, const std::vector<TypeB> &containerB, std::vector<TypeA> &resultContainer){
-	if(containerB.size()){
-		resultContainer.resize(containerA.size());
-		
-		const TypeB &valueB = containerB[0];
-		for(int i = 0; i < containerA.size(); ++i){
-			resultContainer[i] = containerA[i] * valueB;
-		}
-	}
+	numericOperation_parallelArrayToSingle<numericOperation_mul>(containerA, containerB, resultContainer);
 }
 
 template <class TypeA, class TypeB>
@@ -156,31 +209,12 @@ void numericOperation_mulSingleToArray(const std::vector<TypeA> &containerA, con
 
 template <class TypeA, class TypeB>
 void numericOperation_mulArrayToArray(const std::vector<TypeA> &containerA, const std::vector<TypeB> &containerB, std::vector<TypeA> &resultContainer){
-	int sizeA = containerA.size();
-	int sizeB = containerB.size();
-	
-	int minorSize = sizeA;
-	if(sizeB < sizeA){
-		minorSize = sizeB;
-	}
-	
-	resultContainer.resize(minorSize);
-	
-	for(int i = 0; i < minorSize; ++i){
-		resultContainer[i] = containerA[i] * containerB[i];
-	}
+	numericOperation_parallelArrayToArray<numericOperation_mul>(containerA, containerB, resultContainer);
 }
 
 template <class TypeA, class TypeB>
 void numericOperation_divArrayToSingle(const std::vector<TypeA> &containerA, const std::vector<TypeB> &containerB, std::vector<TypeA> &resultContainer){
-	if(containerB.size()){
-		resultContainer.resize(containerA.size());
-		
-		const TypeB &valueB = containerB[0];
-		for(int i = 0; i < containerA.size(); ++i){
-			resultContainer[i] = containerA[i] / valueB;
-		}
-	}
+	numericOperation_parallelArrayToSingle<numericOperation_div>(containerA, containerB, resultContainer);
 }
 
 template <class TypeA, class TypeB>
@@ -199,20 +233,165 @@ void numericOperation_divSingleToArray(const std::vector<TypeA> &containerA, con
 
 template <class TypeA, class TypeB>
 void numericOperation_divArrayToArray(const std::vector<TypeA> &containerA, const std::vector<TypeB> &containerB, std::vector<TypeA> &resultContainer){
-	int sizeA = containerA.size();
-	int sizeB = containerB.size();
+	numericOperation_parallelArrayToArray<numericOperation_div>(containerA, containerB, resultContainer);
+}
+
+// Specializations running element wise operations on float and int based types through the runtime dispatched kernels in simdUtils,
+// vec3 and col4 values are processed as flat float arrays. They follow the same sizing rules as the generic versions above.
+// SingleToArray accumulates into a single value and stays scalar, a vectorized sum would change the order of the additions.
+// Large arrays are split by parallelFor on element boundaries, every chunk produces the same values the whole array would.
+inline void numericOperation_simdArrays(simdUtils::Operation operation, const float *valuesA, const float *valuesB, float *result, int size){
+	simdUtils::floatArrays(operation, valuesA, valuesB, result, size);
+}
+
+inline void numericOperation_simdArrays(simdUtils::Operation operation, const int *valuesA, const int *valuesB, int *result, int size){
+	simdUtils::intArrays(operation, valuesA, valuesB, result, size);
+}
+
+inline void numericOperation_simdArrayScalar(simdUtils::Operation operation, const float *values, float scalar, float *result, int size){
+	simdUtils::floatArrayScalar(operation, values, scalar, result, size);
+}
+
+inline void numericOperation_simdArrayScalar(simdUtils::Operation operation, const int *values, int scalar, int *result, int size){
+	simdUtils::intArrayScalar(operation, values, scalar, result, size);
+}
+
+template <class BaseType>
+class numericOperation_simdArraysBody{
+public:
+	numericOperation_simdArraysBody(simdUtils::Operation operation, const BaseType *valuesA, const BaseType *valuesB, BaseType *result, int components): 
+		_operation(operation), _valuesA(valuesA), _valuesB(valuesB), _result(result), _components(components){
+	}
 	
-	int minorSize = sizeA;
-	if(sizeB < sizeA){
-		minorSize = sizeB;
+	void operator() (unsigned int begin, unsigned int end) const{
+		unsigned int offset = begin * _components;
+		numericOperation_simdArrays(_operation, _valuesA + offset, _valuesB + offset, _result + offset, (end - begin) * _components);
+	}
+
+private:
+	simdUtils::Operation _operation;
+	const BaseType *_valuesA;
+	const BaseType *_valuesB;
+	BaseType *_result;
+	int _components;
+};
+
+template <class BaseType>
+class numericOperation_simdArrayScalarBody{
+public:
+	numericOperation_simdArrayScalarBody(simdUtils::Operation operation, const BaseType *values, BaseType scalar, BaseType *result, int components): 
+		_operation(operation), _values(values), _scalar(scalar), _result(result), _components(components){
 	}
 	
-	resultContainer.resize(minorSize);
+	void operator() (unsigned int begin, unsigned int end) const{
+		unsigned int offset = begin * _components;
+		numericOperation_simdArrayScalar(_operation, _values + offset, _scalar, _result + offset, (end - begin) * _components);
+	}
+
+private:
+	simdUtils::Operation _operation;
+	const BaseType *_values;
+	BaseType _scalar;
+	BaseType *_result;
+	int _components;
+};
+
+// shared by the Inverse node and the bind poses of the skin deformer.
+class numericOperation_matrix44InverseBody{
+public:
+	numericOperation_matrix44InverseBody(const matrix44 *values, matrix44 *result): _values(values), _result(result){
+	}
 	
-	for(int i = 0; i < minorSize; ++i){
-		resultContainer[i] = containerA[i] / containerB[i];
+	void operator() (unsigned int begin, unsigned int end) const{
+		for(unsigned int i = begin; i < end; ++i){
+			_result[i] = _values[i].inverse();
+		}
+	}
+
+private:
+	const matrix44 *_values;
+	matrix44 *_result;
+};
+
+#define NUMERIC_OPERATION_SIMD_ARRAY_TO_ARRAY(operation, simdOperation, TypeA, TypeB, BaseType, components) \
+	template <> \
+	inline void numericOperation_##operation##ArrayToArray<TypeA, TypeB>(const std::vector<TypeA> &containerA, const std::vector<TypeB> &containerB, std::vector<TypeA> &resultContainer){ \
+		int minorSize = containerA.size(); \
+		if(int(containerB.size()) < minorSize){ \
+			minorSize = containerB.size(); \
+		} \
+		\
+		resultContainer.resize(minorSize); \
+		\
+		if(minorSize){ \
+			parallelFor(minorSize, numericOperation_simdArraysBody<BaseType>(simdUtils::simdOperation, \
+				reinterpret_cast<const BaseType*>(&containerA[0]), reinterpret_cast<const BaseType*>(&containerB[0]), \
+				reinterpret_cast<BaseType*>(&resultContainer[0]), components)); \
+		} \
+	}
+
+#define NUMERIC_OPERATION_SIMD_ARRAY_TO_SINGLE(operation, simdOperation, TypeA, TypeB, BaseType, components) \
+	template <> \
+	inline void numericOperation_##operation##ArrayToSingle<TypeA, TypeB>(const std::vector<TypeA> &containerA, const std::vector<TypeB> &containerB, std::vector<TypeA> &resultContainer){ \
+		if(containerB.size()){ \
+			resultContainer.resize(containerA.size()); \
+			\
+			if(containerA.size()){ \
+				parallelFor(containerA.size(), numericOperation_simdArrayScalarBody<BaseType>(simdUtils::simdOperation, \
+					reinterpret_cast<const BaseType*>(&containerA[0]), BaseType(containerB[0]), \
+					reinterpret_cast<BaseType*>(&resultContainer[0]), components)); \
+			} \
+		} \
+	}
+
+#define NUMERIC_OPERATION_SIMD(operation, simdOperation) \
+	NUMERIC_OPERATION_SIMD_ARRAY_TO_ARRAY(operation, simdOperation, int, int, int, 1) \
+	NUMERIC_OPERATION_SIMD_ARRAY_TO_SINGLE(operation, simdOperation, int, int, int, 1) \
+	NUMERIC_OPERATION_SIMD_ARRAY_TO_ARRAY(operation, simdOperation, float, float, float, 1) \
+	NUMERIC_OPERATION_SIMD_ARRAY_TO_SINGLE(operation, simdOperation, float, float, float, 1) \
+	NUMERIC_OPERATION_SIMD_ARRAY_TO_ARRAY(operation, simdOperation, vec3, vec3, float, 3) \
+	NUMERIC_OPERATION_SIMD_ARRAY_TO_ARRAY(operation, simdOperation, col4, col4, float, 4)
+
+NUMERIC_OPERATION_SIMD(add, operationAdd)
+NUMERIC_OPERATION_SIMD(sub, operationSub)
+NUMERIC_OPERATION_SIMD(mul, operationMul)
+NUMERIC_OPERATION_SIMD(div, operationDiv)
+
+// scaling vec3 and col4 values, ints are converted to float exactly as the Imath operators do.
+NUMERIC_OPERATION_SIMD_ARRAY_TO_SINGLE(mul, operationMul, vec3, float, float, 3)
+NUMERIC_OPERATION_SIMD_ARRAY_TO_SINGLE(mul, operationMul, vec3, int, float, 3)
+NUMERIC_OPERATION_SIMD_ARRAY_TO_SINGLE(mul, operationMul, col4, float, float, 4)
+NUMERIC_OPERATION_SIMD_ARRAY_TO_SINGLE(mul, operationMul, col4, int, float, 4)
+NUMERIC_OPERATION_SIMD_ARRAY_TO_SINGLE(div, operationDiv, vec3, float, float, 3)
+NUMERIC_OPERATION_SIMD_ARRAY_TO_SINGLE(div, operationDiv, vec3, int, float, 3)
+NUMERIC_OPERATION_SIMD_ARRAY_TO_SINGLE(div, operationDiv, col4, float, float, 4)
+NUMERIC_OPERATION_SIMD_ARRAY_TO_SINGLE(div, operationDiv, col4, int, float, 4)
+
+class numericOperation_vec3MulMatrix44Body{
+public:
+	numericOperation_vec3MulMatrix44Body(const vec3 *values, const matrix44 &matrix, vec3 *result): 
+		_values(values), _matrix(matrix), _result(result){
+	}
+	
+	void operator() (unsigned int begin, unsigned int end) const{
+		simdUtils::vec3MulMatrix44(_values + begin, _matrix, _result + begin, end - begin);
+	}
+
+private:
+	const vec3 *_values;
+	const matrix44 &_matrix;
+	vec3 *_result;
+};
+
+template <>
+inline void numericOperation_mulArrayToSingle<vec3, matrix44>(const std::vector<vec3> &containerA, const std::vector<matrix44> &containerB, std::vector<vec3> &resultContainer){
+	if(containerB.size()){
+		resultContainer.resize(containerA.size());
+		
+		if(containerA.size()){
+			parallelFor(containerA.size(), numericOperation_vec3MulMatrix44Body(&containerA[0], containerB[0], &resultContainer[0]));
+		}
 	}
 }
 
 #endif
-
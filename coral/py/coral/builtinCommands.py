@@ -26,8 +26,11 @@
 # SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 # </license>
 
+import  os
+
 from    _coral  import  Command
 from    _coral  import  NetworkManager
+from    _coral  import  NetworkBlobs
 from    _coral  import  ErrorObject
 
 import  coralApp
@@ -295,6 +298,33 @@ class SetAttributeValue(Command):
                 attribute.valueChanged()
 
 
+class SetAttributeBlob(Command):
+    def __init__(self):
+        Command.__init__(self)
+        
+        self.setArgString("attribute", "")
+        self.setArgString("file", "")
+        self.setArgString("fileId", "")
+        self.setArgString("blob", "")
+    
+    def doIt(self):
+        attribute = coralApp.findAttribute(self.argAsString("attribute"))
+        
+        # the blob file sits next to the network file being loaded, whatever the current directory
+        networkFilename = coralApp.CoralAppData.currentNetworkDir
+        if networkFilename:
+            filename = os.path.join(os.path.dirname(networkFilename), self.argAsString("file"))
+        else:
+            filename = NetworkManager.resolveFilename(self.argAsString("file"))
+        
+        if attribute and attribute.outValue():
+            fileId = self.argAsString("fileId")
+            if filename and fileId and NetworkBlobs.fileId(filename) == fileId and attribute.outValue().readBlob(filename, self.argAsString("blob")):
+                attribute.valueChanged()
+            else:
+                coralApp.logError("could not load the value of " + attribute.fullName() + " from blob file " + self.argAsString("file") + ", the file is missing, damaged or from another network")
+
+
 def loadPlugin():
     plugin = Plugin("builtinCommands")
 
@@ -306,6 +336,7 @@ def loadPlugin():
     plugin.registerCommand(CollapseNodes)
     plugin.registerCommand(ExplodeCollapsedNode)
     plugin.registerCommand(SetAttributeValue)
+    plugin.registerCommand(SetAttributeBlob)
     plugin.registerCommand(SetupDynamicAttribute)
     plugin.registerCommand(CollapseExecutableNodes)
 
@@ -67,12 +67,24 @@ def loadPlugin():
     plugin.registerNode("SetArrayElement", _coral.SetArrayElement, tags = ["numeric"], description = "Set a single element of an array.")
     plugin.registerNode("GetSimulationStep", _coral.GetSimulationStep, tags = ["numeric", "simulation"], description = "Get the values stored by SetSimulationStep and reuse them in the simulation step.\nWhen the step attribute is set to 0 the simulation is reset and the data is taken from the source.")
     plugin.registerNode("SetSimulationStep", _coral.SetSimulationStep, tags = ["numeric", "simulation"], description = "Set some numeric values and make them available to a GetSimulationStep node connected to the same source.\n")
-    plugin.registerNode("FindPointsInRange", _coral.FindPointsInRange, tags = ["numeric"])
+    plugin.registerNode("FindPointsInRange", _coral.FindPointsInRange, tags = ["numeric"], description = "Find the points within range of a point.\nConnect a spatialIndex to avoid building a new tree at each update.")
+    
+    plugin.registerAttribute("SpatialIndexAttribute", _coral.SpatialIndexAttribute)
+    plugin.registerNode("BuildSpatialIndex", _coral.BuildSpatialIndex, tags = ["numeric"], description = "Index an array of points for fast neighbour queries.\nThe index is only rebuilt when the points change and can be shared by any number of query nodes.")
+    plugin.registerNode("FindNearestPoint", _coral.FindNearestPoint, tags = ["numeric"], description = "Find the indexed point closest to a point.")
+    plugin.registerNode("FindKNearestPoints", _coral.FindKNearestPoints, tags = ["numeric"], description = "Find the count indexed points closest to each query point.\nIds are flattened, nearestPointsOffset and nearestPointsSize locate the ids of each query.")
+    plugin.registerNode("FindPointsInRangeBatch", _coral.FindPointsInRangeBatch, tags = ["numeric"], description = "Find the indexed points within range of each query point.\nIds are flattened, pointsInRangeOffset and pointsInRangeSize locate the ids of each query.")
+    
+    plugin.registerAttribute("HashGridAttribute", _coral.HashGridAttribute)
+    plugin.registerNode("BuildHashGrid", _coral.BuildHashGrid, tags = ["numeric"], description = "Sort an array of points into a uniform grid for fast fixed radius queries.\nUse a cellSize close to the range the grid will be queried with.")
+    plugin.registerNode("FindPointsInRadius", _coral.FindPointsInRadius, tags = ["numeric"], description = "Find the points of a hashGrid within range of each query point.\nIds are flattened, pointsInRangeOffset and pointsInRangeSize locate the ids of each query.")
+    plugin.registerNode("FindPairsInRadius", _coral.FindPairsInRadius, tags = ["numeric"], description = "Find, for each point of a hashGrid, the other points of the grid within range of it.\nIds are flattened, pointsInRangeOffset and pointsInRangeSize locate the ids of each point.")
 
     plugin.registerNode("Add", _coral.AddNode, tags = ["math"])
     plugin.registerNode("Sub", _coral.SubNode, tags = ["math"])
     plugin.registerNode("Mul", _coral.MulNode, tags = ["math"])
     plugin.registerNode("Div", _coral.DivNode, tags = ["math"])
+    plugin.registerNode("Expression", _coral.ExpressionNode, tags = ["math"], description = "Evaluate an arithmetic expression such as a * b + c * 0.5 over the inputs in a single pass.\nInputs are added with the Add Input button and named b, c, d...\nThe result has the same type as input a.")
     plugin.registerNode("Abs", _coral.Abs, tags = ["math"])
     plugin.registerNode("Atan2", _coral.Atan2, tags = ["math"])
     plugin.registerNode("Sqrt", _coral.Sqrt, tags = ["math"])
@@ -110,6 +122,8 @@ def loadPlugin():
     plugin.registerNode("GeoSphere", _coral.GeoSphere, tags = ["geometry"])
     plugin.registerNode("GeoCube", _coral.GeoCube, tags = ["geometry"])
     plugin.registerNode("GeoNeighbourPoints", _coral.GeoNeighbourPoints, tags = ["geometry"])
+    plugin.registerNode("GeoClosestPoint", _coral.GeoClosestPoint, tags = ["geometry"], description = "Find the closest point on the surface of a geo for each point.\nbarycentric weights the trianglePointsId of the triangle the closest point lies on.")
+    plugin.registerNode("GeoRayIntersect", _coral.GeoRayIntersect, tags = ["geometry"], description = "Intersect rays with the surface of a geo, faceId is -1 for the rays that miss.\nA maxDistance of 0 means no limit.")
     plugin.registerNode("GetGeoElements", _coral.GetGeoElements, tags = ["geometry"])
     plugin.registerNode("GetGeoSubElements", _coral.GetGeoSubElements, tags = ["geometry"])
     plugin.registerNode("GeoInstanceGenerator", _coral.GeoInstanceGenerator, tags = ["geometry"])
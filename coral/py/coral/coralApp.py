@@ -31,6 +31,7 @@
 import copy 
 import logging
 import os
+import re
 import sys
 import traceback
 import weakref
@@ -814,6 +815,11 @@ def _parseNetworkScript(saveScript):
     
     return locals() # this builtin function returns the vars in this function (and those collected executing the saveScript
 
+def _commitBatch():
+    if not _coral.NetworkManager.commitBatch():
+        for sourceAttribute, destinationAttribute in _coral.NetworkManager.failedBatchConnections():
+            logError("failed to specialize connection " + sourceAttribute.fullName() + " -> " + destinationAttribute.fullName())
+
 def _loadNetworkScript(networkScript, topNode = ""):
     _notifyNetworkLoadingObservers()
 
@@ -823,8 +829,12 @@ def _loadNetworkScript(networkScript, topNode = ""):
         return;
     
     CoralAppData.loadingNetwork = True
-    networkScriptData["runScript"](topNode)
-    CoralAppData.loadingNetwork = False
+    _coral.NetworkManager.beginBatch()
+    try:
+        networkScriptData["runScript"](topNode)
+    finally:
+        _commitBatch()
+        CoralAppData.loadingNetwork = False
     
     _notifyNetworkLoadedObservers(topNode)
 
@@ -883,17 +893,53 @@ def _generateNetworkScript(topNode, saveTopNode = False):
     
     return saveScript
 
-def saveNetworkFile(filename):
+def saveNetworkFile(filename, saveBlobs = True):
     if filename:
-        saveScript = _generateNetworkScript(topNode = CoralAppData.rootNode)
+        # large values go to a binary sidecar file that is memory mapped back at load time
+        blobsFilename = os.path.splitext(filename)[0] + ".blobs"
+        if saveBlobs:
+            if not _coral.NetworkBlobs.beginSave(blobsFilename):
+                logError("could not write blob file " + blobsFilename + ", the network was not saved")
+                return False
+        
+        blobsSaved = True
+        try:
+            saveScript = _generateNetworkScript(topNode = CoralAppData.rootNode)
+        finally:
+            if saveBlobs:
+                blobsSaved = _coral.NetworkBlobs.endSave()
+        
+        # the script would reference blobs that were never written
+        if not blobsSaved:
+            logError("could not write blob file " + blobsFilename + ", the network was not saved")
+            return False
         
         file = open(filename, "w")
         file.write(saveScript)
         file.close()
+        
+        _removeStaleBlobFiles(filename, keep = _coral.NetworkBlobs.blobFilename() if saveBlobs else "")
 
         CoralAppData.currentNetworkDir = filename        
         if CoralAppData.shouldLogInfos:
             logInfo("saved network file: " + filename)
+        
+        return True
+    
+    return False
+
+def _removeStaleBlobFiles(filename, keep = ""):
+    # every save writes its blobs to a new file, the ones the script no longer references are removed once it's written.
+    # A file still mapped by a loaded value can't be removed on Windows, it's left for the next save.
+    directory, name = os.path.split(filename)
+    pattern = re.compile(re.escape(os.path.splitext(name)[0]) + r"\.[0-9a-f]{16}\.blobs$")
+    
+    for entry in os.listdir(directory or os.curdir):
+        if entry != keep and pattern.match(entry):
+            try:
+                os.remove(os.path.join(directory, entry))
+            except OSError:
+                pass
 
 def newNetwork():
     _notifyInitializingNewNetworkObservers()
@@ -978,7 +1024,11 @@ def importCollapsedNodeFile(filename, topNode):
                 logError("not a CollapsedNode file")
                 return
             
-        saveScriptData["runScript"](topNode = topNode.fullName())
+        _coral.NetworkManager.beginBatch()
+        try:
+            saveScriptData["runScript"](topNode = topNode.fullName())
+        finally:
+            _commitBatch()
     
         if CoralAppData.shouldLogInfos:
             logInfo("loaded netowrk file: " + filename)
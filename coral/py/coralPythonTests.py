@@ -28,6 +28,9 @@
 
 
 import sys
+import os
+import array
+import tempfile
 from coral import _coral
 from coral import coralApp
 import Imath
@@ -357,6 +360,720 @@ def testSpecializingPass():
     
     coralApp.finalize()
 
+def testBatchLoading():
+    coralApp.init()
+    
+    float1 = coralApp.createNode("Float", "float1", coralApp.rootNode())
+    add = coralApp.createNode("Add", "add", coralApp.rootNode())
+    
+    _coral.NetworkManager.beginBatch()
+    assert _coral.NetworkManager.isBatching()
+    
+    _coral.NetworkManager.connect(float1.outputAttributeAt(0), add.inputAttributeAt(0))
+    
+    print "testing specialization is deferred until the batch is committed"
+    assert add.outputAttributeAt(0).specialization() != ["Float"]
+    
+    assert _coral.NetworkManager.commitBatch()
+    assert not _coral.NetworkManager.isBatching()
+    assert _coral.NetworkManager.failedBatchConnections() == []
+    
+    assert add.inputAttributeAt(0).specialization() == ["Float"]
+    assert add.outputAttributeAt(0).specialization() == ["Float"]
+    
+    coralApp.finalize()
+
+def testProfiler():
+    coralApp.init()
+    
+    float1 = coralApp.createNode("Float", "float1", coralApp.rootNode())
+    add = coralApp.createNode("Add", "add", coralApp.rootNode())
+    _coral.NetworkManager.connect(float1.outputAttributeAt(0), add.inputAttributeAt(0))
+    
+    _coral.Profiler.setEnabled(True)
+    add.outputAttributeAt(0).value()
+    _coral.Profiler.setEnabled(False)
+    
+    print "testing node updates are recorded while the profiler is enabled"
+    assert _coral.Profiler.eventCount() > 0
+    assert "root.add" in _coral.Profiler.chromeTrace()
+    assert "root.add" in _coral.Profiler.aggregateTable()
+    
+    _coral.Profiler.clear()
+    assert _coral.Profiler.eventCount() == 0
+    
+    coralApp.finalize()
+
+def testMemoizedNode():
+    coralApp.init()
+    
+    float1 = coralApp.createNode("Float", "float1", coralApp.rootNode())
+    add = coralApp.createNode("Add", "add", coralApp.rootNode())
+    _coral.NetworkManager.connect(float1.outputAttributeAt(0), add.inputAttributeAt(0))
+    add.setMemoized(True)
+    
+    in1 = add.inputAttributeAt(1)
+    in1.outValue().setFloatValueAt(0, 2.0)
+    in1.valueChanged()
+    add.outputAttributeAt(0).value()
+    
+    _coral.Profiler.setEnabled(True)
+    
+    print "testing a memoized node skips updates when its inputs hash the same"
+    in1.outValue().setFloatValueAt(0, 2.0)
+    in1.valueChanged()
+    add.outputAttributeAt(0).value()
+    assert "root.add" not in _coral.Profiler.chromeTrace()
+    
+    in1.outValue().setFloatValueAt(0, 3.0)
+    in1.valueChanged()
+    add.outputAttributeAt(0).value()
+    assert "root.add" in _coral.Profiler.chromeTrace()
+    
+    _coral.Profiler.setEnabled(False)
+    
+    coralApp.finalize()
+
+def testEarlyCutoff():
+    coralApp.init()
+    
+    root = coralApp.rootNode()
+    float1 = coralApp.createNode("Float", "float1", root)
+    float2 = coralApp.createNode("Float", "float2", root)
+    ifGreater = coralApp.createNode("IfGreaterThan", "ifGreater", root)
+    conditional = coralApp.createNode("ConditionalValue", "conditional", root)
+    add = coralApp.createNode("Add", "add", root)
+    
+    _coral.NetworkManager.connect(float1.outputAttributeAt(0), ifGreater.inputAttributeAt(0))
+    _coral.NetworkManager.connect(ifGreater.outputAttributeAt(0), conditional.inputAttributeAt(0))
+    _coral.NetworkManager.connect(float2.outputAttributeAt(0), conditional.inputAttributeAt(1))
+    _coral.NetworkManager.connect(float2.outputAttributeAt(0), conditional.inputAttributeAt(2))
+    _coral.NetworkManager.connect(conditional.outputAttributeAt(0), add.inputAttributeAt(0))
+    _coral.NetworkManager.connect(float2.outputAttributeAt(0), add.inputAttributeAt(1))
+    
+    assert conditional.earlyCutoff()
+    assert not add.earlyCutoff()
+    
+    ifGreater.inputAttributeAt(1).outValue().setFloatValueAt(0, 10.0)
+    ifGreater.inputAttributeAt(1).valueChanged()
+    
+    out = float1.outputAttributeAt(0)
+    out.outValue().setFloatValueAt(0, 1.0)
+    out.valueChanged()
+    add.outputAttributeAt(0).value()
+    
+    _coral.Profiler.setEnabled(True)
+    
+    print "testing nodes downstream of an unchanged output are not updated"
+    out.outValue().setFloatValueAt(0, 2.0)
+    out.valueChanged()
+    add.outputAttributeAt(0).value()
+    trace = _coral.Profiler.chromeTrace()
+    assert "root.ifGreater" in trace
+    assert "root.conditional" not in trace
+    
+    print "testing nodes not declared for early cutoff are still updated"
+    assert "root.add" in trace
+    
+    print "testing nodes downstream of a changed output are updated"
+    _coral.Profiler.clear()
+    out.outValue().setFloatValueAt(0, 20.0)
+    out.valueChanged()
+    conditional.outputAttributeAt(0).value()
+    assert "root.conditional" in _coral.Profiler.chromeTrace()
+    
+    _coral.Profiler.setEnabled(False)
+    
+    coralApp.finalize()
+
+def testCopyOnWriteNumeric():
+    source = _coral.Numeric.createUnwrapped()
+    source.setFloatValues([1.0, 2.0, 3.0])
+    
+    copied = _coral.Numeric.createUnwrapped()
+    copied.copy(source)
+    
+    print "testing a copied numeric is not affected by edits to its source"
+    source.setFloatValueAt(1, 5.0)
+    assert copied.floatValueAt(1) == 2.0
+    assert source.floatValueAt(1) == 5.0
+    
+    print "testing edits to a copy don't reach its source"
+    copied.setFloatValueAt(0, 7.0)
+    assert source.floatValueAt(0) == 1.0
+    assert copied.floatValueAt(0) == 7.0
+    
+    del source
+    del copied
+
+def testNumericOperations():
+    coralApp.init()
+    
+    root = coralApp.rootNode()
+    array = coralApp.createNode("Float", "array", root)
+    scalar = coralApp.createNode("Float", "scalar", root)
+    
+    references = {
+        "Add": lambda a, b: a + b, 
+        "Sub": lambda a, b: a - b, 
+        "Mul": lambda a, b: a * b, 
+        "Div": lambda a, b: a / b}
+    
+    # each operation runs once on the whole array and once per element nested in a ForLoop
+    nodes = {}
+    for operation in references:
+        node = coralApp.createNode(operation, operation.lower(), root)
+        _coral.NetworkManager.connect(array.outputAttributeAt(0), node.inputAttributeAt(0))
+        _coral.NetworkManager.connect(scalar.outputAttributeAt(0), node.inputAttributeAt(1))
+        
+        forLoop = coralApp.createNode("ForLoop", "forLoop" + operation, root)
+        loopInput = coralApp.createNode("LoopInput", "loopInput", forLoop)
+        slicedNode = coralApp.createNode(operation, operation.lower(), forLoop)
+        loopOutput = coralApp.createNode("LoopOutput", "loopOutput", forLoop)
+        _coral.NetworkManager.connect(array.outputAttributeAt(0), forLoop.inputAttributeAt(0))
+        _coral.NetworkManager.connect(forLoop.inputAttributeAt(0), loopInput.inputAttributeAt(0))
+        _coral.NetworkManager.connect(loopInput.outputAttributeAt(1), slicedNode.inputAttributeAt(0))
+        _coral.NetworkManager.connect(scalar.outputAttributeAt(0), slicedNode.inputAttributeAt(1))
+        _coral.NetworkManager.connect(slicedNode.outputAttributeAt(0), loopOutput.inputAttributeAt(0))
+        
+        nodes[operation] = (node, loopOutput)
+    
+    scalar.outputAttributeAt(0).outValue().setFloatValueAt(0, 1.1)
+    scalar.outputAttributeAt(0).valueChanged()
+    
+    supported = _coral.simdSupportedInstructionSet()
+    threshold = _coral.parallelThreshold()
+    grainSize = _coral.parallelGrainSize()
+    
+    # (name, instruction set, parallel threshold, grain size), the first one is plain scalar and serial
+    configurations = [
+        ("scalar", _coral.SimdInstructionSet.instructionSetScalar, threshold, grainSize), 
+        ("vectorized", supported, threshold, grainSize), 
+        ("parallel", supported, 0, 7)]
+    
+    print "testing numeric operations match a scalar reference for every size, operation and configuration"
+    for size in [3, 37, 5000]:
+        array.outputAttributeAt(0).outValue().setFloatValues([i * 0.37 - 5.0 for i in range(size)])
+        array.outputAttributeAt(0).valueChanged()
+        values = array.outputAttributeAt(0).outValue().floatValues()
+        
+        for operation, reference in references.items():
+            expected = [reference(value, scalar.outputAttributeAt(0).outValue().floatValueAt(0)) for value in values]
+            
+            firstResult = None
+            for name, instructionSet, parallelThreshold, parallelGrainSize in configurations:
+                _coral.setSimdInstructionSet(instructionSet)
+                _coral.setParallelThreshold(parallelThreshold)
+                _coral.setParallelGrainSize(parallelGrainSize)
+                array.outputAttributeAt(0).valueChanged()
+                
+                node, loopOutput = nodes[operation]
+                for result in [node.outputAttributeAt(0).value().floatValues(), loopOutput.outputAttributeAt(0).value().floatValues()]:
+                    assert len(result) == size, (operation, name, size)
+                    for i in range(size):
+                        assert abs(result[i] - expected[i]) <= 0.00001 * max(1.0, abs(expected[i])), (operation, name, size, i)
+                    
+                    # element wise operations round the same way whatever the path, the results must match bit for bit.
+                    if firstResult is None:
+                        firstResult = result
+                    assert result == firstResult, (operation, name, size)
+    
+    print "testing instruction sets above the supported one are clamped"
+    _coral.setSimdInstructionSet(_coral.SimdInstructionSet.instructionSetAVX512)
+    assert _coral.simdInstructionSet() == supported
+    
+    print "testing the grain size is never zero"
+    _coral.setParallelGrainSize(0)
+    assert _coral.parallelGrainSize() == 1
+    
+    _coral.setSimdInstructionSet(supported)
+    _coral.setParallelThreshold(threshold)
+    _coral.setParallelGrainSize(grainSize)
+    
+    coralApp.finalize()
+
+def testExpressionNode():
+    coralApp.init()
+    
+    root = coralApp.rootNode()
+    float1 = coralApp.createNode("Float", "float1", root)
+    float2 = coralApp.createNode("Float", "float2", root)
+    expression = coralApp.createNode("Expression", "expression", root)
+    expression.addNumericAttribute()
+    
+    _coral.NetworkManager.connect(float1.outputAttributeAt(0), expression.findAttribute("a"))
+    _coral.NetworkManager.connect(float2.outputAttributeAt(0), expression.findAttribute("b"))
+    
+    float1.outputAttributeAt(0).outValue().setFloatValueAt(0, 2.0)
+    float1.outputAttributeAt(0).valueChanged()
+    float2.outputAttributeAt(0).outValue().setFloatValueAt(0, 3.0)
+    float2.outputAttributeAt(0).valueChanged()
+    
+    expressionAttr = expression.findAttribute("expression")
+    out = expression.findAttribute("out")
+    
+    print "testing an expression is evaluated over the inputs"
+    expressionAttr.outValue().setStringValueAt(0, "a * b + a * 0.5 - -(b - 1)")
+    expressionAttr.valueChanged()
+    assert out.value().floatValueAt(0) == 9.0
+    assert expression.isInvalid() == False
+    
+    print "testing a result that doesn't match the type of input 'a' is rejected"
+    expressionAttr.outValue().setStringValueAt(0, "2 * a")
+    expressionAttr.valueChanged()
+    out.value()
+    assert expression.isInvalid()
+    assert "the result is Int" in expression.invalidityMessage()
+    
+    print "testing syntax errors are reported"
+    expressionAttr.outValue().setStringValueAt(0, "a * (b + ")
+    expressionAttr.valueChanged()
+    out.value()
+    assert expression.isInvalid()
+    
+    print "testing int constants that don't fit an int are rejected"
+    expressionAttr.outValue().setStringValueAt(0, "a + 99999999999")
+    expressionAttr.valueChanged()
+    out.value()
+    assert expression.isInvalid()
+    assert "out of range" in expression.invalidityMessage()
+    
+    coralApp.finalize()
+
+def testChunkedNumeric():
+    coralApp.init()
+    
+    root = coralApp.rootNode()
+    float1 = coralApp.createNode("Float", "float1", root)
+    float2 = coralApp.createNode("Float", "float2", root)
+    add = coralApp.createNode("Add", "add", root)
+    _coral.NetworkManager.connect(float1.outputAttributeAt(0), add.inputAttributeAt(0))
+    _coral.NetworkManager.connect(float2.outputAttributeAt(0), add.inputAttributeAt(1))
+    
+    values = array.array("f", [i * 0.25 - 7.0 for i in range(20000)])
+    fileHandle, filename = tempfile.mkstemp()
+    os.write(fileHandle, values.tostring())
+    os.close(fileHandle)
+    
+    budget = _coral.chunkedMemoryBudget()
+    _coral.setChunkedMemoryBudget(4000 * 4)
+    
+    print "testing a file mapped array is evaluated lazily chunk by chunk"
+    out = float1.outputAttributeAt(0)
+    assert out.outValue().mapFileValues(filename, 1000)
+    assert out.outValue().isChunked()
+    assert out.outValue().size() == len(values)
+    out.valueChanged()
+    float2.outputAttributeAt(0).outValue().setFloatValueAt(0, 0.5)
+    float2.outputAttributeAt(0).valueChanged()
+    
+    result = add.outputAttributeAt(0).value()
+    assert result.isChunked()
+    assert result.size() == len(values)
+    
+    expected = array.array("f", [value + 0.5 for value in values])
+    
+    print "testing elements are read from a chunked array without loading it whole"
+    assert result.floatValueAt(12345) == expected[12345]
+    assert result.floatValueAt(len(values) + 10) == expected[-1]
+    assert _coral.chunkedResidentBytes() <= 4000 * 4
+    
+    print "testing the contiguous accessors materialize chunked arrays"
+    assert result.floatValues() == expected.tolist()
+    
+    print "testing the contiguous copy counts against the memory budget"
+    assert _coral.chunkedResidentBytes() >= len(values) * 4
+    
+    _coral.setChunkedMemoryBudget(budget)
+    
+    coralApp.finalize()
+    os.remove(filename)
+
+def testBinaryNetworkBlobs():
+    coralApp.init()
+    
+    root = coralApp.rootNode()
+    float1 = coralApp.createNode("Float", "float1", root)
+    values = [i * 0.5 for i in range(5000)]
+    float1.outputAttributeAt(0).outValue().setFloatValues(values)
+    float1.outputAttributeAt(0).valueChanged()
+    
+    directory = tempfile.mkdtemp()
+    filename = os.path.join(directory, "blobsNetwork.py")
+    
+    print "testing large values are saved as binary blobs by default"
+    assert coralApp.saveNetworkFile(filename)
+    assert not _coral.NetworkBlobs.isSaving()
+    blobsFilename = os.path.join(directory, _coral.NetworkBlobs.blobFilename())
+    assert _coral.NetworkBlobs.blobFilename() == "blobsNetwork." + _coral.NetworkBlobs.saveId() + ".blobs"
+    assert os.path.exists(blobsFilename)
+    assert os.path.getsize(blobsFilename) == 64 + len(values) * 4
+    assert open(blobsFilename, "rb").read(8) == "CORALBLB"
+    assert _coral.NetworkBlobs.fileId(blobsFilename) == _coral.NetworkBlobs.saveId()
+    
+    script = open(filename).read()
+    assert "SetAttributeBlob" in script
+    assert _coral.NetworkBlobs.saveId() in script
+    
+    print "testing blobs are memory mapped back on load"
+    coralApp.openNetworkFile(filename)
+    loadedValue = coralApp.findNode("root.float1").outputAttributeAt(0).value()
+    assert loadedValue.isChunked()
+    assert loadedValue.floatValues() == values
+    
+    print "testing saving over a loaded network writes a new blob file and removes the previous one"
+    assert coralApp.saveNetworkFile(filename)
+    previousBlobsFilename = blobsFilename
+    blobsFilename = os.path.join(directory, _coral.NetworkBlobs.blobFilename())
+    assert blobsFilename != previousBlobsFilename
+    assert os.path.exists(blobsFilename)
+    if sys.platform != "win32":
+        assert not os.path.exists(previousBlobsFilename)
+    assert loadedValue.floatValues() == values
+    
+    print "testing blobs saved by another network are rejected"
+    assert _coral.NetworkBlobs.beginSave(os.path.join(directory, "truncated.blobs"))
+    description = loadedValue.writeBlob()
+    assert _coral.NetworkBlobs.endSave()
+    truncatedFilename = os.path.join(directory, _coral.NetworkBlobs.blobFilename())
+    
+    attribute = coralApp.findNode("root.float1").outputAttributeAt(0)
+    attribute.outValue().setFloatValues([1.0])
+    attribute.valueChanged()
+    coralApp.executeCommand("SetAttributeBlob", attribute = attribute.fullName(), file = _coral.NetworkBlobs.blobFilename(), fileId = "0" * 16, blob = description)
+    assert attribute.value().floatValues() == [1.0]
+    coralApp.executeCommand("SetAttributeBlob", attribute = attribute.fullName(), file = _coral.NetworkBlobs.blobFilename(), fileId = _coral.NetworkBlobs.saveId(), blob = description)
+    assert attribute.value().isChunked()
+    
+    print "testing truncated blob files are rejected"
+    truncatedFile = open(truncatedFilename, "r+b")
+    truncatedFile.truncate(1000)
+    truncatedFile.close()
+    assert not loadedValue.readBlob(truncatedFilename, description)
+    assert not loadedValue.readBlob(filename, description)
+    os.remove(truncatedFilename)
+    
+    print "testing networks without large values don't get a blob file"
+    coralApp.newNetwork()
+    coralApp.createNode("Float", "float1", coralApp.rootNode())
+    assert coralApp.saveNetworkFile(filename)
+    assert not os.path.exists(os.path.join(directory, _coral.NetworkBlobs.blobFilename()))
+    
+    coralApp.finalize()
+    
+    for entry in os.listdir(directory):
+        os.remove(os.path.join(directory, entry))
+    os.rmdir(directory)
+
+def testNumericStringRoundTrip():
+    coralApp.init()
+    
+    root = coralApp.rootNode()
+    float1 = coralApp.createNode("Float", "float1", root)
+    float2 = coralApp.createNode("Float", "float2", root)
+    
+    values = array.array("f", [0.1, 1.0 / 3.0, -2.5e30, 1e-40, 16777216.0, -0.0, 100.0] + [i * 0.001 for i in range(100)]).tolist()
+    source = float1.outputAttributeAt(0).outValue()
+    source.setFloatValues(values)
+    
+    print "testing floats are saved with enough digits to be restored exactly"
+    string = source.asString()
+    assert "0.1," in string
+    assert "100," in string
+    
+    destination = float2.outputAttributeAt(0).outValue()
+    destination.setFromString(string)
+    assert destination.floatValues() == values
+    assert destination.asString() == string
+    
+    print "testing malformed values are skipped"
+    destination.setFromString("[1.5,abc,2.5\n,3] 3")
+    assert destination.floatValues() == [1.5, 2.5, 3.0]
+    
+    print "testing ints out of range are skipped"
+    int1 = coralApp.createNode("Int", "int1", root)
+    intValue = int1.outputAttributeAt(0).outValue()
+    intValue.setFromString("[-2147483648,2147483648,2147483647] 1")
+    assert intValue.intValues() == [-2147483648, 2147483647]
+    
+    print "testing a comma decimal locale doesn't change the saved values"
+    import locale
+    previousLocale = locale.setlocale(locale.LC_ALL)
+    for name in ["de_DE.UTF-8", "de_DE", "fr_FR.UTF-8", "fr_FR", "German", "French"]:
+        try:
+            locale.setlocale(locale.LC_ALL, name)
+            break
+        except locale.Error:
+            pass
+    
+    try:
+        assert source.asString() == string
+        destination.setFromString(string)
+        assert destination.floatValues() == values
+    finally:
+        locale.setlocale(locale.LC_ALL, previousLocale)
+    
+    coralApp.finalize()
+
+def testBufferProtocol():
+    import struct
+    import ctypes
+    
+    coralApp.init()
+    
+    root = coralApp.rootNode()
+    float1 = coralApp.createNode("Float", "float1", root)
+    
+    numeric = float1.outputAttributeAt(0).outValue()
+    numeric.setFloatValues([1.0, 2.0, 3.0, 4.0])
+    
+    print "testing a read only view shares the values of a Numeric"
+    view = numeric.valuesBuffer()
+    assert view.readonly
+    assert view.format == "f"
+    assert view.shape == (4,)
+    assert list(struct.unpack("4f", view.tobytes())) == [1.0, 2.0, 3.0, 4.0]
+    
+    print "testing a view outlives the values it was taken from"
+    numeric.setFloatValueAt(0, 10.0)
+    assert struct.unpack("4f", view.tobytes())[0] == 1.0
+    
+    print "testing views can't be written, the values may be shared with other Numerics"
+    try:
+        view[0] = struct.pack("f", 20.0)
+        assert False
+    except TypeError:
+        pass
+    
+    float2 = coralApp.createNode("Float", "float2", root)
+    copied = float2.outputAttributeAt(0).outValue()
+    copied.copy(numeric)
+    copiedView = copied.valuesBuffer()
+    numeric.setValuesFromBuffer(array.array("f", [1.0]))
+    assert struct.unpack("4f", copiedView.tobytes()) == (10.0, 2.0, 3.0, 4.0)
+    assert copied.floatValues() == [10.0, 2.0, 3.0, 4.0]
+    
+    print "testing values are set from any contiguous buffer"
+    numeric.setValuesFromBuffer(array.array("f", [0.5, 1.5]))
+    assert numeric.floatValues() == [0.5, 1.5]
+    numeric.setValuesFromBuffer((ctypes.c_float * 3)(5.0, 6.0, 7.0))
+    assert numeric.floatValues() == [5.0, 6.0, 7.0]
+    
+    try:
+        numeric.setValuesFromBuffer((ctypes.c_double * 2)(1.0, 2.0))
+        assert False
+    except TypeError:
+        pass
+    
+    print "testing Geo arrays are exposed as read only snapshots"
+    cube = coralApp.createNode("GeoCube", "cube", root)
+    geo = cube.outputAttributeAt(0).value()
+    points = geo.pointsBuffer()
+    assert points.readonly
+    assert points.shape == (geo.pointsCount(), 3)
+    assert points.strides == (12, 4)
+    assert len(geo.rawIndicesBuffer().tobytes()) > 0
+    assert geo.verticesNormalsBuffer().shape[1] == 3
+    
+    coordinates = array.array("f", points.tobytes())
+    geo.setPointsFromBuffer(array.array("f", [coordinate * 2.0 for coordinate in coordinates]))
+    assert array.array("f", points.tobytes()) == coordinates
+    assert array.array("f", geo.pointsBuffer().tobytes())[0] == coordinates[0] * 2.0
+    
+    coralApp.finalize()
+
+def testSpatialIndex():
+    coralApp.init()
+    
+    root = coralApp.rootNode()
+    build = coralApp.createNode("BuildSpatialIndex", "build", root)
+    inRange = coralApp.createNode("FindPointsInRange", "inRange", root)
+    nearest = coralApp.createNode("FindNearestPoint", "nearest", root)
+    
+    points = [Imath.V3f(float(x), float(y), 0.0) for x in range(10) for y in range(10)]
+    build.findObject("points").outValue().setVec3Values(points)
+    build.findObject("points").valueChanged()
+    
+    _coral.NetworkManager.connect(build.findObject("spatialIndex"), inRange.findObject("spatialIndex"))
+    _coral.NetworkManager.connect(build.findObject("spatialIndex"), nearest.findObject("spatialIndex"))
+    
+    print "testing range queries read the shared index and include points right at the range"
+    inRange.findObject("point").outValue().setVec3ValueAt(0, Imath.V3f(4.0, 4.0, 0.0))
+    inRange.findObject("range").outValue().setFloatValueAt(0, 1.0)
+    inRange.findObject("point").valueChanged()
+    
+    ids = inRange.findObject("pointsInRangeId").value().intValues()
+    assert sorted(ids) == [34, 43, 44, 45, 54]
+    assert inRange.findObject("pointsInRangeSize").value().intValueAt(0) == 5
+    
+    print "testing nearest point queries"
+    nearest.findObject("point").outValue().setVec3ValueAt(0, Imath.V3f(2.2, 6.9, 0.3))
+    nearest.findObject("point").valueChanged()
+    assert nearest.findObject("nearestPointId").value().intValueAt(0) == 27
+    
+    print "testing the index is not rebuilt for the same points"
+    index = build.findObject("spatialIndex").value()
+    assert index.size() == len(points)
+    assert not index.build(points)
+    assert index.nearestPoint(Imath.V3f(9.0, 9.0, 5.0)) == 99
+    
+    coralApp.finalize()
+
+def testBatchedSpatialQueries():
+    coralApp.init()
+    
+    root = coralApp.rootNode()
+    build = coralApp.createNode("BuildSpatialIndex", "build", root)
+    kNearest = coralApp.createNode("FindKNearestPoints", "kNearest", root)
+    inRange = coralApp.createNode("FindPointsInRangeBatch", "inRange", root)
+    
+    points = [Imath.V3f(float(x), float(y), 0.0) for x in range(10) for y in range(10)]
+    build.findObject("points").outValue().setVec3Values(points)
+    build.findObject("points").valueChanged()
+    
+    _coral.NetworkManager.connect(build.findObject("spatialIndex"), kNearest.findObject("spatialIndex"))
+    _coral.NetworkManager.connect(build.findObject("spatialIndex"), inRange.findObject("spatialIndex"))
+    
+    queries = [Imath.V3f(0.1, 0.0, 0.0), Imath.V3f(4.0, 4.0, 0.0), Imath.V3f(9.0, 9.2, 0.0)]
+    
+    print "testing k nearest queries come back closest first, one block per query"
+    kNearest.findObject("queryPoints").outValue().setVec3Values(queries)
+    kNearest.findObject("count").outValue().setIntValueAt(0, 2)
+    kNearest.findObject("queryPoints").valueChanged()
+    
+    assert kNearest.findObject("nearestPointsId").value().intValues() == [0, 10, 44, 34, 99, 89]
+    assert kNearest.findObject("nearestPointsSize").value().intValues() == [2, 2, 2]
+    assert kNearest.findObject("nearestPointsOffset").value().intValues() == [0, 2, 4]
+    
+    print "testing batched range queries with one range per query"
+    inRange.findObject("queryPoints").outValue().setVec3Values(queries)
+    inRange.findObject("range").outValue().setFloatValues([0.5, 1.0, 0.0])
+    inRange.findObject("queryPoints").valueChanged()
+    
+    ids = inRange.findObject("pointsInRangeId").value().intValues()
+    sizes = inRange.findObject("pointsInRangeSize").value().intValues()
+    offsets = inRange.findObject("pointsInRangeOffset").value().intValues()
+    assert sizes == [1, 5, 0]
+    assert offsets == [0, 1, 6]
+    assert ids[0] == 0
+    assert sorted(ids[offsets[1]:offsets[1] + sizes[1]]) == [34, 43, 44, 45, 54]
+    
+    coralApp.finalize()
+
+def testHashGrid():
+    coralApp.init()
+    
+    root = coralApp.rootNode()
+    build = coralApp.createNode("BuildHashGrid", "build", root)
+    inRadius = coralApp.createNode("FindPointsInRadius", "inRadius", root)
+    pairs = coralApp.createNode("FindPairsInRadius", "pairs", root)
+    
+    points = [Imath.V3f(float(x), float(y), 0.0) for x in range(10) for y in range(10)]
+    build.findObject("points").outValue().setVec3Values(points)
+    build.findObject("cellSize").outValue().setFloatValueAt(0, 1.0)
+    build.findObject("points").valueChanged()
+    
+    _coral.NetworkManager.connect(build.findObject("hashGrid"), inRadius.findObject("hashGrid"))
+    _coral.NetworkManager.connect(build.findObject("hashGrid"), pairs.findObject("hashGrid"))
+    
+    print "testing radius queries across cell boundaries, including points right at the range"
+    inRadius.findObject("queryPoints").outValue().setVec3Values([Imath.V3f(4.0, 4.0, 0.0), Imath.V3f(-5.0, 0.0, 0.0)])
+    inRadius.findObject("range").outValue().setFloatValueAt(0, 1.0)
+    inRadius.findObject("queryPoints").valueChanged()
+    
+    assert sorted(inRadius.findObject("pointsInRangeId").value().intValues()) == [34, 43, 44, 45, 54]
+    assert inRadius.findObject("pointsInRangeSize").value().intValues() == [5, 0]
+    assert inRadius.findObject("pointsInRangeOffset").value().intValues() == [0, 5]
+    
+    print "testing all pairs within radius leave each point out of its own neighbours"
+    pairs.findObject("range").outValue().setFloatValueAt(0, 1.0)
+    pairs.findObject("range").valueChanged()
+    
+    ids = pairs.findObject("pointsInRangeId").value().intValues()
+    sizes = pairs.findObject("pointsInRangeSize").value().intValues()
+    offsets = pairs.findObject("pointsInRangeOffset").value().intValues()
+    assert len(sizes) == len(points)
+    assert sizes[0] == 2 and sorted(ids[offsets[0]:offsets[0] + sizes[0]]) == [1, 10]
+    assert sizes[44] == 4 and sorted(ids[offsets[44]:offsets[44] + sizes[44]]) == [34, 43, 45, 54]
+    assert len(ids) == sum(sizes)
+    
+    print "testing the grid is not rebuilt for the same points and cell size"
+    grid = build.findObject("hashGrid").value()
+    assert grid.size() == len(points)
+    assert grid.cellSize() == 1.0
+    assert not grid.build(points, 1.0)
+    assert grid.build(points, 2.0)
+    assert sorted(grid.pointsInRange(Imath.V3f(0.0, 0.0, 0.0), 1.5)) == [0, 1, 10, 11]
+    
+    print "testing far away points are still found when the cell size is too small for them"
+    farPoints = points + [Imath.V3f(3.0e9, 0.0, 0.0), Imath.V3f(3.0e9 + 512.0, 0.0, 0.0), Imath.V3f(-1.0e30, 0.0, 0.0)]
+    assert grid.build(farPoints, 1.0)
+    assert grid.cellSize() > 1.0
+    assert sorted(grid.pointsInRange(Imath.V3f(3.0e9, 0.0, 0.0), 600.0)) == [100, 101]
+    assert sorted(grid.pointsInRange(Imath.V3f(0.0, 0.0, 0.0), 1.5)) == [0, 1, 10, 11]
+    assert grid.pointsInRange(Imath.V3f(-1.0e30, 0.0, 0.0), 1.0) == [102]
+    assert grid.pointsInRange(Imath.V3f(1.0e35, 0.0, 0.0), 1.0) == []
+    
+    coralApp.finalize()
+
+def testGeoQueries():
+    coralApp.init()
+    
+    root = coralApp.rootNode()
+    cube = coralApp.createNode("GeoCube", "cube", root)
+    setPoints = coralApp.createNode("SetGeoPoints", "setPoints", root)
+    closest = coralApp.createNode("GeoClosestPoint", "closest", root)
+    ray = coralApp.createNode("GeoRayIntersect", "ray", root)
+    
+    _coral.NetworkManager.connect(cube.findObject("out"), setPoints.findObject("inGeo"))
+    _coral.NetworkManager.connect(setPoints.findObject("outGeo"), closest.findObject("geo"))
+    _coral.NetworkManager.connect(setPoints.findObject("outGeo"), ray.findObject("geo"))
+    
+    geo = cube.findObject("out").value()
+    points = array.array("f", geo.pointsBuffer().tobytes())
+    setPoints.findObject("points").outValue().setVec3Values([Imath.V3f(points[i], points[i + 1], points[i + 2]) for i in range(0, len(points), 3)])
+    setPoints.findObject("points").valueChanged()
+    
+    print "testing closest points on the surface of the default 15x20x10 cube"
+    closest.findObject("points").outValue().setVec3Values([Imath.V3f(0.0, 100.0, 0.0), Imath.V3f(1.0, 2.0, 3.0)])
+    closest.findObject("points").valueChanged()
+    
+    closestPoints = closest.findObject("closestPoint").value().vec3Values()
+    assert (closestPoints[0] - Imath.V3f(0.0, 10.0, 0.0)).length() < 0.0001
+    assert (closestPoints[1] - Imath.V3f(1.0, 2.0, 5.0)).length() < 0.0001
+    
+    faceIds = closest.findObject("faceId").value().intValues()
+    assert min(faceIds) >= 0 and max(faceIds) < geo.facesCount()
+    
+    print "testing barycentric coordinates rebuild the closest point from the triangle points"
+    barycentric = closest.findObject("barycentric").value().vec3Values()[1]
+    trianglePoints = closest.findObject("trianglePointsId").value().intValues()[3:6]
+    assert len(closest.findObject("trianglePointsId").value().intValues()) == 6
+    rebuilt = Imath.V3f(0.0, 0.0, 0.0)
+    for weight, pointId in zip([barycentric.x, barycentric.y, barycentric.z], trianglePoints):
+        rebuilt += Imath.V3f(points[pointId * 3], points[pointId * 3 + 1], points[pointId * 3 + 2]) * weight
+    assert (rebuilt - closestPoints[1]).length() < 0.0001
+    
+    print "testing ray intersections, misses and the distance limit"
+    ray.findObject("rayOrigin").outValue().setVec3Values([Imath.V3f(0.0, 0.0, 100.0), Imath.V3f(100.0, 100.0, 100.0)])
+    ray.findObject("rayDirection").outValue().setVec3ValueAt(0, Imath.V3f(0.0, 0.0, -1.0))
+    ray.findObject("rayOrigin").valueChanged()
+    
+    assert (ray.findObject("hitPoint").value().vec3Values()[0] - Imath.V3f(0.0, 0.0, 5.0)).length() < 0.0001
+    assert abs(ray.findObject("hitDistance").value().floatValues()[0] - 95.0) < 0.0001
+    assert ray.findObject("faceId").value().intValues()[1] == -1
+    
+    ray.findObject("maxDistance").outValue().setFloatValueAt(0, 50.0)
+    ray.findObject("maxDistance").valueChanged()
+    assert ray.findObject("faceId").value().intValues()[0] == -1
+    
+    print "testing queries follow the points when they move"
+    setPoints.findObject("points").outValue().setVec3Values([Imath.V3f(points[i], points[i + 1] + 10.0, points[i + 2]) for i in range(0, len(points), 3)])
+    setPoints.findObject("points").valueChanged()
+    assert (closest.findObject("closestPoint").value().vec3Values()[0] - Imath.V3f(0.0, 20.0, 0.0)).length() < 0.0001
+    
+    coralApp.finalize()
+
 def runTest(function):
     print "* running", function.__name__
 
@@ -380,5 +1097,20 @@ if __name__ == "__main__":
     runTest(testCollapsingBug1)
     runTest(testSpecializingPass)
     runTest(testSpecializationBug1)
+    runTest(testBatchLoading)
+    runTest(testProfiler)
+    runTest(testMemoizedNode)
+    runTest(testEarlyCutoff)
+    runTest(testCopyOnWriteNumeric)
+    runTest(testNumericOperations)
+    runTest(testExpressionNode)
+    runTest(testChunkedNumeric)
+    runTest(testBinaryNetworkBlobs)
+    runTest(testNumericStringRoundTrip)
+    runTest(testBufferProtocol)
+    runTest(testSpatialIndex)
+    runTest(testBatchedSpatialQueries)
+    runTest(testHashGrid)
+    runTest(testGeoQueries)
     
     # _coral.runTests()
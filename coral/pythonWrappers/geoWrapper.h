@@ -37,11 +37,57 @@
 #include "../src/GeoInstanceArrayAttribute.h"
 #include "../builtinNodes/GeoArrayInstanceNodes.h"
 
+// The arrays of a Geo are reallocated whenever it's rebuilt or copied into, 
+// views hold their own copy instead so that they can outlive any change to the Geo.
+template<class T>
+boost::python::object geo_snapshotBuffer(const std::vector<T> &values, unsigned int columns, const char *format, Py_ssize_t scalarSize){
+	boost::shared_ptr<std::vector<T> > snapshot(new std::vector<T>(values));
+	const void *data = snapshot->empty() ? 0 : &(*snapshot)[0];
+	
+	return pythonWrapperUtils::bufferView(data, snapshot->size(), 1, columns, format, scalarSize, snapshot);
+}
+
+boost::python::object geo_pointsBuffer(Geo &self){
+	return geo_snapshotBuffer(self.points(), 3, "f", sizeof(float));
+}
+
+boost::python::object geo_rawIndicesBuffer(Geo &self){
+	return geo_snapshotBuffer(self.rawIndices(), 1, "i", sizeof(int));
+}
+
+boost::python::object geo_verticesNormalsBuffer(Geo &self){
+	return geo_snapshotBuffer(self.verticesNormals(), 3, "f", sizeof(float));
+}
+
+void geo_setPointsFromBuffer(Geo &self, boost::python::object buffer){
+	pythonWrapperUtils::ContiguousBuffer contiguousBuffer(buffer);
+	contiguousBuffer.check('f', sizeof(float), sizeof(Imath::V3f));
+	
+	unsigned int size = contiguousBuffer.size() / sizeof(Imath::V3f);
+	if(size != self.pointsCount()){
+		PyErr_SetString(PyExc_ValueError, "buffer size doesn't match the number of points of the Geo");
+		boost::python::throw_error_already_set();
+	}
+	
+	std::vector<Imath::V3f> points(size);
+	if(size){
+		memcpy(&points[0], contiguousBuffer.data(), contiguousBuffer.size());
+	}
+	
+	self.setPoints(points);
+}
+
 void geoWrapper(){
 	boost::python::class_<Geo, boost::shared_ptr<Geo>, boost::python::bases<Value>, boost::noncopyable>("Geo", boost::python::no_init)
 		.def("__init__", pythonWrapperUtils::__init__<Geo>)
 		.def("createUnwrapped", pythonWrapperUtils::createUnwrapped<Geo>)
 		.staticmethod("createUnwrapped")
+		.def("pointsCount", &Geo::pointsCount)
+		.def("facesCount", &Geo::facesCount)
+		.def("pointsBuffer", geo_pointsBuffer)
+		.def("rawIndicesBuffer", geo_rawIndicesBuffer)
+		.def("verticesNormalsBuffer", geo_verticesNormalsBuffer)
+		.def("setPointsFromBuffer", geo_setPointsFromBuffer)
 	;
 
 	pythonWrapperUtils::pythonWrapper<GeoAttribute, Attribute>("GeoAttribute");
@@ -49,6 +95,8 @@ void geoWrapper(){
 	pythonWrapperUtils::pythonWrapper<SetGeoPoints, Node>("SetGeoPoints");
 	pythonWrapperUtils::pythonWrapper<GetGeoNormals, Node>("GetGeoNormals");
 	pythonWrapperUtils::pythonWrapper<GeoNeighbourPoints, Node>("GeoNeighbourPoints");
+	pythonWrapperUtils::pythonWrapper<GeoClosestPoint, Node>("GeoClosestPoint");
+	pythonWrapperUtils::pythonWrapper<GeoRayIntersect, Node>("GeoRayIntersect");
 	
 	pythonWrapperUtils::pythonWrapper<GetGeoElements, Node>("GetGeoElements");
 	pythonWrapperUtils::pythonWrapper<GetGeoSubElements, Node>("GetGeoSubElements");
@@ -0,0 +1,68 @@
+// <license>
+// Copyright (C) 2011 Andrea Interguglielmi, All rights reserved.
+// This file is part of the coral repository downloaded from http://code.google.com/p/coral-repo.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// 
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+// 
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+// IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// </license>
+
+#ifndef CORAL_HASHGRIDWRAPPER_H
+#define CORAL_HASHGRIDWRAPPER_H
+
+#include <boost/python.hpp>
+
+#include "../src/HashGrid.h"
+#include "../src/HashGridAttribute.h"
+#include "../builtinNodes/HashGridNodes.h"
+#include "../src/pythonWrapperUtils.h"
+
+std::vector<Imath::V3f> hashGrid_points(HashGrid &self){
+	return self.points();
+}
+
+std::vector<int> hashGrid_pointsInRange(HashGrid &self, const Imath::V3f &point, float range){
+	std::vector<int> indices;
+	self.pointsInRange(point, range, indices);
+	
+	return indices;
+}
+
+void hashGridWrapper(){
+	boost::python::class_<HashGrid, boost::shared_ptr<HashGrid>, boost::python::bases<Value>, boost::noncopyable>("HashGrid", boost::python::no_init)
+		.def("__init__", pythonWrapperUtils::__init__<HashGrid>)
+		.def("createUnwrapped", pythonWrapperUtils::createUnwrapped<HashGrid>)
+		.staticmethod("createUnwrapped")
+		.def("build", &HashGrid::build)
+		.def("points", hashGrid_points)
+		.def("size", &HashGrid::size)
+		.def("cellSize", &HashGrid::cellSize)
+		.def("pointsInRange", hashGrid_pointsInRange)
+	;
+	
+	pythonWrapperUtils::pythonWrapper<HashGridAttribute, Attribute>("HashGridAttribute");
+	pythonWrapperUtils::pythonWrapper<BuildHashGrid, Node>("BuildHashGrid");
+	pythonWrapperUtils::pythonWrapper<FindPointsInRadius, Node>("FindPointsInRadius");
+	pythonWrapperUtils::pythonWrapper<FindPairsInRadius, Node>("FindPairsInRadius");
+}
+
+#endif
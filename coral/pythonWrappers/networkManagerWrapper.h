@@ -40,6 +40,19 @@ boost::python::object nodeManager_findObjectById(int id){
 	return PythonDataCollector::findPyObject(id);
 }
 
+boost::python::list networkManager_failedBatchConnections(){
+	boost::python::list connections;
+	
+	const std::vector<std::pair<int, int> > &failedConnections = NetworkManager::failedBatchConnections();
+	for(int i = 0; i < failedConnections.size(); ++i){
+		connections.append(boost::python::make_tuple(
+			PythonDataCollector::findPyObject(failedConnections[i].first), 
+			PythonDataCollector::findPyObject(failedConnections[i].second)));
+	}
+	
+	return connections;
+}
+
 void networkManagerWrapper(){
 	boost::python::class_<NetworkManager>("NetworkManager")
 		.def("objectCount", &NetworkManager::objectCount)
@@ -58,6 +71,14 @@ void networkManagerWrapper(){
 		.staticmethod("addSearchPath")
 		.def("removeSearchPath", &NetworkManager::removeSearchPath)
 		.staticmethod("removeSearchPath")
+		.def("beginBatch", &NetworkManager::beginBatch)
+		.staticmethod("beginBatch")
+		.def("commitBatch", &NetworkManager::commitBatch)
+		.staticmethod("commitBatch")
+		.def("isBatching", &NetworkManager::isBatching)
+		.staticmethod("isBatching")
+		.def("failedBatchConnections", networkManager_failedBatchConnections)
+		.staticmethod("failedBatchConnections")
 	;
 }
 
@@ -383,6 +383,18 @@ void node_catchAttributeDirtied(Node &self, Attribute *attribute, bool value){
 	NodeAccessor::_catchAttributeDirtied(self, attribute, value);
 }
 
+void node_setAttributeUnchanged(Node &self, Attribute *attribute){
+	NodeAccessor::_setAttributeUnchanged(self, attribute);
+}
+
+void node_catchAttributeUnchanged(Node &self, Attribute *attribute, bool value){
+	NodeAccessor::_catchAttributeUnchanged(self, attribute, value);
+}
+
+void node_setEarlyCutoff(Node &self, bool value){
+	NodeAccessor::_setEarlyCutoff(self, value);
+}
+
 void node_setSliceable(Node &self, bool value){
 	NodeAccessor::_setSliceable(self, value);
 }
@@ -459,6 +471,8 @@ void nodeWrapper(){
 		.def("isValid", &Node::isValid)
 		.def("updateEnabled", &Node::updateEnabled)
 		.def("_setUpdateEnabled", node_setUpdateEnabled)
+		.def("memoized", &Node::memoized)
+		.def("setMemoized", &Node::setMemoized)
 		.def("debugInfo", &Node::debugInfo)
 		.def("computeTimeTicks", &Node::computeTimeTicks)
 		.def("computeTimeMilliseconds", &Node::computeTimeMilliseconds)
@@ -474,6 +488,10 @@ void nodeWrapper(){
 		.def("enableSpecializationPreset", &Node::enableSpecializationPreset)
 		.def("enabledSpecializationPreset", &Node::enabledSpecializationPreset)
 		.def("_catchAttributeDirtied", node_catchAttributeDirtied)
+		.def("_setAttributeUnchanged", node_setAttributeUnchanged)
+		.def("_catchAttributeUnchanged", node_catchAttributeUnchanged)
+		.def("_setEarlyCutoff", node_setEarlyCutoff)
+		.def("earlyCutoff", &Node::earlyCutoff)
 		.def("attributeDirtied", &Node::attributeDirtied, &NodeWrapper::attributeDirtied_default)
 		.def("attributeSpecializationPreset", &Node::attributeSpecializationPreset)
 		.def("sliceable", &Node::sliceable)
@@ -36,6 +36,7 @@
 #include "../src/NumericAttribute.h"
 #include "../src/Numeric.h"
 #include "../builtinNodes/ArithmeticNodes.h"
+#include "../builtinNodes/ExpressionNode.h"
 #include "../builtinNodes/MathNodes.h"
 #include "../src/pythonWrapperUtils.h"
 
@@ -117,6 +118,75 @@ std::vector<float> numeric_floatValues(Numeric &self){
 	return self.floatValues();
 }
 
+bool numeric_mapFileValues(Numeric &self, const std::string &filename, unsigned int chunkSize){
+	return self.mapFileValuesSlice(0, filename, chunkSize);
+}
+
+bool numeric_isChunked(Numeric &self){
+	return bool(self.chunkedValuesSlice(0));
+}
+
+// layout of one element of a Numeric as struct format, scalar size and rows x columns scalars
+void numeric_elementLayout(Numeric &self, const char *&format, Py_ssize_t &scalarSize, unsigned int &rows, unsigned int &columns){
+	Numeric::Type type = self.type();
+	
+	format = "f";
+	scalarSize = sizeof(float);
+	rows = 1;
+	columns = 1;
+	
+	if(type == Numeric::numericTypeInt || type == Numeric::numericTypeIntArray){
+		format = "i";
+		scalarSize = sizeof(int);
+	}
+	else if(type == Numeric::numericTypeVec3 || type == Numeric::numericTypeVec3Array){
+		columns = 3;
+	}
+	else if(type == Numeric::numericTypeCol4 || type == Numeric::numericTypeCol4Array || type == Numeric::numericTypeQuat || type == Numeric::numericTypeQuatArray){
+		columns = 4;
+	}
+	else if(type == Numeric::numericTypeMatrix44 || type == Numeric::numericTypeMatrix44Array){
+		rows = 4;
+		columns = 4;
+	}
+}
+
+boost::python::object numeric_valuesBuffer(Numeric &self, unsigned int slice){
+	if(self.type() == Numeric::numericTypeAny){
+		PyErr_SetString(PyExc_TypeError, "Numeric has no type yet");
+		boost::python::throw_error_already_set();
+	}
+	
+	const char *format;
+	Py_ssize_t scalarSize;
+	unsigned int rows, columns;
+	numeric_elementLayout(self, format, scalarSize, rows, columns);
+	
+	boost::shared_ptr<void> handle;
+	const void *data = self.sliceData(slice, handle);
+	
+	return pythonWrapperUtils::bufferView(data, self.sizeSlice(slice), rows, columns, format, scalarSize, handle);
+}
+
+void numeric_setValuesFromBuffer(Numeric &self, boost::python::object buffer, unsigned int slice){
+	if(self.type() == Numeric::numericTypeAny){
+		PyErr_SetString(PyExc_TypeError, "Numeric has no type yet");
+		boost::python::throw_error_already_set();
+	}
+	
+	const char *format;
+	Py_ssize_t scalarSize;
+	unsigned int rows, columns;
+	numeric_elementLayout(self, format, scalarSize, rows, columns);
+	
+	Py_ssize_t elementSize = scalarSize * rows * columns;
+	
+	pythonWrapperUtils::ContiguousBuffer contiguousBuffer(buffer);
+	contiguousBuffer.check(format[0], scalarSize, elementSize);
+	
+	self.setSliceData(slice, contiguousBuffer.data(), contiguousBuffer.size() / elementSize);
+}
+
 void numeric_setFloatValues(Numeric &self, boost::python::list pyList){
 	std::vector<float> convertedList;
 	for(int i = 0; i < boost::python::len(pyList); ++i){
@@ -182,6 +252,10 @@ void numericNodesWrapper(){
 		.def("setVec3Values", &Numeric::setVec3Values)
 		.def("setCol4Values", &Numeric::setCol4Values)
 		.def("setMatrix44Values", &Numeric::setMatrix44Values)
+		.def("mapFileValues", numeric_mapFileValues, (boost::python::arg("filename"), boost::python::arg("chunkSize") = int(ChunkedArray::defaultChunkSize)))
+		.def("isChunked", numeric_isChunked)
+		.def("valuesBuffer", numeric_valuesBuffer, (boost::python::arg("slice") = 0))
+		.def("setValuesFromBuffer", numeric_setValuesFromBuffer, (boost::python::arg("buffer"), boost::python::arg("slice") = 0))
 		.add_static_property("numericTypeAny", numeric_numericTypeAny)
 		.add_static_property("numericTypeInt", numeric_numericTypeInt)
 		.add_static_property("numericTypeIntArray", numeric_numericTypeIntArray)
@@ -207,6 +281,8 @@ void numericNodesWrapper(){
 	pythonWrapperUtils::pythonWrapper<SubNode, ArithmeticNode>("SubNode");
 	pythonWrapperUtils::pythonWrapper<MulNode, ArithmeticNode>("MulNode");
 	pythonWrapperUtils::pythonWrapper<DivNode, ArithmeticNode>("DivNode");
+	pythonWrapperUtils::pythonWrapper<ExpressionNode, Node>("ExpressionNode")
+		.def("addNumericAttribute", &ExpressionNode::addNumericAttribute);
 	pythonWrapperUtils::pythonWrapper<Vec3Node, Node>("Vec3Node");
 	pythonWrapperUtils::pythonWrapper<Vec3ToFloats, Node>("Vec3ToFloats");
 	pythonWrapperUtils::pythonWrapper<Col4Node, Node>("Col4Node");
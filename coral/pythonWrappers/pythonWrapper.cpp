@@ -63,7 +63,13 @@
 #include "enumWrapper.h"
 #include "processSimulationNodeWrapper.h"
 #include "deformerNodesWrapper.h"
-#include "../builtinNodes/KdNodes.h"
+#include "profilerWrapper.h"
+#include "simdUtilsWrapper.h"
+#include "coreParallelAlgosWrapper.h"
+#include "chunkedArrayWrapper.h"
+#include "networkBlobsWrapper.h"
+#include "spatialIndexWrapper.h"
+#include "hashGridWrapper.h"
 
 using namespace coral;
 
@@ -121,7 +127,13 @@ BOOST_PYTHON_MODULE(_coral)
 	enumWrapper();
 	processSimulationNodeWrapper();
 	deformerNodesWrapper();
-	pythonWrapperUtils::pythonWrapper<FindPointsInRange, Node>("FindPointsInRange");
+	profilerWrapper();
+	simdUtilsWrapper();
+	coreParallelAlgosWrapper();
+	chunkedArrayWrapper();
+	networkBlobsWrapper();
+	spatialIndexWrapper();
+	hashGridWrapper();
 	
 	boost::python::to_python_converter<std::vector<std::string>, pythonWrapperUtils::stdVectorToPythonList<std::string> >();
 	boost::python::to_python_converter<std::vector<Node*>, ObjectVectorToPythonList<Node> >();
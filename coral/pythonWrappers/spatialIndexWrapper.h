@@ -0,0 +1,70 @@
+// <license>
+// Copyright (C) 2011 Andrea Interguglielmi, All rights reserved.
+// This file is part of the coral repository downloaded from http://code.google.com/p/coral-repo.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// 
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+// 
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+// IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// </license>
+
+#ifndef CORAL_SPATIALINDEXWRAPPER_H
+#define CORAL_SPATIALINDEXWRAPPER_H
+
+#include <boost/python.hpp>
+
+#include "../src/SpatialIndex.h"
+#include "../src/SpatialIndexAttribute.h"
+#include "../builtinNodes/KdNodes.h"
+#include "../src/pythonWrapperUtils.h"
+
+std::vector<Imath::V3f> spatialIndex_points(SpatialIndex &self){
+	return self.points();
+}
+
+std::vector<int> spatialIndex_pointsInRange(SpatialIndex &self, const Imath::V3f &point, float range){
+	std::vector<int> indices;
+	self.pointsInRange(point, range, indices);
+	
+	return indices;
+}
+
+void spatialIndexWrapper(){
+	boost::python::class_<SpatialIndex, boost::shared_ptr<SpatialIndex>, boost::python::bases<Value>, boost::noncopyable>("SpatialIndex", boost::python::no_init)
+		.def("__init__", pythonWrapperUtils::__init__<SpatialIndex>)
+		.def("createUnwrapped", pythonWrapperUtils::createUnwrapped<SpatialIndex>)
+		.staticmethod("createUnwrapped")
+		.def("build", &SpatialIndex::build)
+		.def("points", spatialIndex_points)
+		.def("size", &SpatialIndex::size)
+		.def("pointsInRange", spatialIndex_pointsInRange)
+		.def("nearestPoint", &SpatialIndex::nearestPoint)
+	;
+	
+	pythonWrapperUtils::pythonWrapper<SpatialIndexAttribute, Attribute>("SpatialIndexAttribute");
+	pythonWrapperUtils::pythonWrapper<BuildSpatialIndex, Node>("BuildSpatialIndex");
+	pythonWrapperUtils::pythonWrapper<FindPointsInRange, Node>("FindPointsInRange");
+	pythonWrapperUtils::pythonWrapper<FindNearestPoint, Node>("FindNearestPoint");
+	pythonWrapperUtils::pythonWrapper<FindKNearestPoints, Node>("FindKNearestPoints");
+	pythonWrapperUtils::pythonWrapper<FindPointsInRangeBatch, Node>("FindPointsInRangeBatch");
+}
+
+#endif
@@ -52,6 +52,9 @@ void valueWrapper(){
 		.staticmethod("createUnwrapped")
 		.def("setFromString", &Value::setFromString)
 		.def("asString()", &Value::asString)
+		.def("asString", &Value::asString)
+		.def("writeBlob", &Value::writeBlob)
+		.def("readBlob", &Value::readBlob)
 	;
 }
 
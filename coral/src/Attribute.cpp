@@ -27,9 +27,8 @@
 // </license>
 
 #ifdef CORAL_PARALLEL_TBB
-	#include <tbb/parallel_for.h>
 	#include <tbb/mutex.h>
-	#include "coreParallelAlgos.h"
+	#include <tbb/tbb_thread.h>
 #endif
 
 #include <boost/date_time/posix_time/posix_time.hpp>
@@ -41,14 +40,35 @@
 #include "Attribute.h"
 #include "Node.h"
 #include "NetworkManager.h"
+#include "NetworkBlobs.h"
 #include "Value.h"
 #include "containerUtils.h"
 #include "Command.h"
 #include "ErrorObject.h"
 #include "stringUtils.h"
+#include "EvaluationContext.h"
+#include "coreParallelAlgos.h"
 
 using namespace coral;
 
+namespace{
+	// releases the claim on an attribute however its update ends, 
+	// an update that throws leaves the attribute dirty and unclaimed so that the next thread pulling it evaluates it again.
+	template<class EvaluatingThread>
+	class EvaluatingThreadRelease{
+	public:
+		EvaluatingThreadRelease(EvaluatingThread &evaluatingThread): _evaluatingThread(evaluatingThread){
+		}
+		
+		~EvaluatingThreadRelease(){
+			_evaluatingThread = 0;
+		}
+	
+	private:
+		EvaluatingThread &_evaluatingThread;
+	};
+}
+
 void(*Attribute::_connectToCallback)(Attribute *self, Attribute *other) = 0;
 void(*Attribute::_disconnectInputCallback)(Attribute *self) = 0;
 void(*Attribute::_disconnectOutputCallback)(Attribute *self, Attribute *other) = 0;
@@ -57,7 +77,6 @@ void(*Attribute::_specializationCallBack)(Attribute *self) = 0;
 void(*Attribute::_valueChangedCallback)(Attribute *self) = 0;
 
 std::vector<void(*)(Attribute *)> _dirtyingDoneCallbackQueue;
-bool _cleaningLocked = false;
 
 namespace {
 	std::vector<std::string> intersectedSpecialization(const std::vector<std::string> &specialization1, const std::vector<std::string> &specialization2){
@@ -74,6 +93,7 @@ namespace {
 
 	#ifdef CORAL_PARALLEL_TBB
 		tbb::mutex _globalMutex;
+		tbb::mutex _chainsMutex;
 	#endif
 }
 
@@ -82,15 +102,25 @@ Attribute::Attribute(const std::string &name, Node *parent):
 	_value(0),
 	_inputValue(0),
 	_input(0),
-	_isClean(false),
 	_isOutput(false),
 	_isInput(false),
 	_passThrough(false),
 	// _valueObserved(0),
 	_computeTimeSeconds(0),
 	_computeTimeMilliseconds(0),
-	_notifyParentNodeOnDirty(false){
-		
+	_notifyParentNodeOnDirty(false),
+	_inputHashesValid(false),
+	_inputVersionsValid(false),
+	_valueUnchanged(false),
+	_catchUnchanged(false),
+	_valueHash(0),
+	_valueHashValid(false){
+	
+	_isClean = false;
+	_evaluatingThread = 0;
+	_dirtyChainStale = false;
+	_cleanChainStale = false;
+	_inputsToCleanStale = true;
 	_dirtyChain.push_back(this);
 }
 
@@ -170,7 +200,6 @@ void Attribute::disconnectInput(){
 			ErrorObject *error = new ErrorObject();
 			
 			resetInputValuesInChain();
-			cacheEvaluationChain();
 			
 			bool resetBranchSpecialization = true;
 			updateBranchSpecializations(resetBranchSpecialization);
@@ -201,8 +230,6 @@ void Attribute::disconnectOutput(Attribute *attribute){
 		if(!isDeleted()){
 			ErrorObject *error = new ErrorObject();
 			
-			cacheEvaluationChain();
-			
 			bool resetBranchSpecialization = true;
 			updateBranchSpecializations(resetBranchSpecialization);
 			
@@ -269,8 +296,6 @@ void Attribute::addAffect(Attribute *attribute){
 			}
 			
 			NetworkManager::addEdge(this, attribute);
-			
-			cacheEvaluationChain();
 		}
 	}
 }
@@ -302,53 +327,198 @@ Value *Attribute::outValue(){
 }
 
 void Attribute::clean(){
-	if(!_cleaningLocked){
-		if(_isClean == false){
-			if(_isInput && _input == 0){
-				_isClean = true;
-			}
-
-			_cleaningLocked = true;
+	EvaluationContext *currentContext = EvaluationContext::current();
+	
+	if(currentContext == 0 && NetworkManager::isBatching()){
+		// values requested halfway through a batch must reflect the edits recorded so far.
+		NetworkManager::flushBatch();
+	}
+	
+	if(_isClean == false){
+		if(_isInput && _input == 0){
+			_isClean = true;
+		}
+		
+		std::vector<CleanTask> &cleanChain = this->cleanChain();
+		
+		if(currentContext){
+			// pulled from within a node's update, join the evaluation already running on this thread.
+			NetworkManager::runCleanChain(cleanChain, currentContext);
+		}
+		else{
+			EvaluationContext context;
 			
 			boost::posix_time::ptime startTime = boost::posix_time::microsec_clock::universal_time();
 			
-			for(std::map<int, std::vector<Attribute*> >::iterator i = _cleanChain.begin(); i != _cleanChain.end(); ++i){
-				std::vector<Attribute*> &outputAttributes = i->second;
-
-				#ifdef CORAL_PARALLEL_TBB
-					tbb::parallel_for(tbb::blocked_range<size_t>(0, outputAttributes.size()), attribute_parallelClean(&outputAttributes));
-				#else
-					for(int j = 0; j < outputAttributes.size(); ++j){
-						outputAttributes[j]->cleanSelf();
-					}
-				#endif
-			}
+			NetworkManager::runCleanChain(cleanChain, &context);
 			
 			boost::posix_time::ptime endTime = boost::posix_time::microsec_clock::universal_time();
 			_computeTimeSeconds = boost::posix_time::time_period(startTime, endTime).length().total_seconds();
 			_computeTimeMilliseconds = boost::posix_time::time_period(startTime, endTime).length().total_milliseconds() % 1000;
-			
-			_cleaningLocked = false;
 		}
 	}
 }
 
 void Attribute::cleanSelf(){
-	if(_isClean == false){
-		_isClean = true;
+	if(_isClean){
+		return;
+	}
+	
+	void *thread = EvaluationContext::thread();
+	if(_evaluatingThread == thread){
+		return; // pulled again from its own update, the node is reading the value it's computing.
+	}
+	
+	#ifdef CORAL_PARALLEL_TBB
+		// the first thread to claim the attribute computes it, 
+		// any other thread waits for it to be flagged clean rather than computing it twice or reading incomplete data.
+		// A claim released while the attribute is still dirty means its update threw, the waiters then claim it in turn.
+		while(_evaluatingThread.compare_and_swap(thread, 0) != 0){
+			while(_isClean == false && _evaluatingThread != 0){
+				tbb::this_tbb_thread::yield();
+			}
+			
+			if(_isClean){
+				return;
+			}
+		}
+		
+		EvaluatingThreadRelease<tbb::atomic<void*> > release(_evaluatingThread);
+		
+		if(_isClean){ // the previous owner finished between the check and the claim.
+			return;
+		}
+	#else
+		_evaluatingThread = thread;
+		EvaluatingThreadRelease<void*> release(_evaluatingThread);
+	#endif
+	
+	Node *parentNode = parent();
+	if(parentNode){
+		if(_inputsToCleanStale){
+			_inputsToClean.clear();
+			NetworkManager::collectParentNodeConnectedInputs(this, parentNode, _inputsToClean);
+			_inputsToCleanStale = false;
+			_inputHashesValid = false;
+			_inputVersionsValid = false;
+		}
+		
+		for(int i = 0; i < _inputsToClean.size(); ++i){
+			_inputsToClean[i]->_isClean = true;
+		}	
+		
+		if(parentNode->updateEnabled()){
+			// early cutoff: when none of the inputs got a new version, whatever dirtied this attribute upstream ended up producing the same values.
+			// the versions are kept up to date on every node, but only nodes declared free of side inputs can rely on them.
+			bool inputsMoved = inputVersionsChanged();
+			if((inputsMoved || parentNode->earlyCutoff() == false) && (parentNode->_memoized == false || inputsChanged())){
+				_valueUnchanged = false;
+				
+				#ifdef CORAL_PARALLEL_TBB
+					// while the update waits on its own parallel work this thread must not pick up unrelated tasks, 
+					// one of them could be waiting on this very attribute.
+					tbb::this_task_arena::isolate(node_isolatedUpdate(parentNode, this));
+				#else
+					parentNode->doUpdate(this);
+				#endif
+				
+				if((_catchUnchanged || parentNode->_memoized) && _value->isHashable()){
+					hashUtils::Hash valueHash = _value->hash();
+					if(_valueHashValid && valueHash == _valueHash){
+						_valueUnchanged = true;
+					}
+					
+					_valueHash = valueHash;
+					_valueHashValid = true;
+				}
+				
+				if(!_valueUnchanged){
+					_value->incrementVersion();
+				}
+			}
+		}
+	}
+	
+	// flagged only once the value is complete, threads waiting on this attribute can read it from here on.
+	_isClean = true;
+}
 
-		Node *parentNode = parent();
-		if(parentNode){
-			std::vector<Attribute*> inputsToClean = _inputsCleanChain[id()];
-			for(int i = 0; i < inputsToClean.size(); ++i){
-				inputsToClean[i]->_isClean = true;
-			}	
+bool Attribute::inputVersionsChanged(){
+	// attributes with no inputs or nested in a slicer may depend on more than their inputs, they're always updated.
+	bool changed = !_inputVersionsValid || _inputsToClean.empty() || parent()->_slicer != 0;
+	
+	std::vector<std::pair<int, unsigned int> > inputVersions(_inputsToClean.size());
+	for(int i = 0; i < _inputsToClean.size(); ++i){
+		Value *value = _inputsToClean[i]->_inputValue;
+		if(value){
+			// the id catches inputs that got connected to a different value.
+			inputVersions[i] = std::make_pair(value->id(), value->version());
+		}
+		else{
+			inputVersions[i] = std::make_pair(0, 0u);
+		}
+		
+		if(!changed && inputVersions[i] != _inputVersions[i]){
+			changed = true;
+		}
+	}
+	
+	_inputVersions.swap(inputVersions);
+	_inputVersionsValid = true;
+	
+	return changed;
+}
+
+void Attribute::markEdited(){
+	// dirtying starts here because this attribute was edited or has to be recomputed, 
+	// whoever reads it must not take it as unchanged and its own update can't be skipped.
+	_inputVersionsValid = false;
+	if(_inputValue){
+		_inputValue->incrementVersion();
+	}
+}
+
+void Attribute::setCatchUnchanged(bool value){
+	_catchUnchanged = value;
+	_valueHashValid = false;
+}
+
+bool Attribute::inputsChanged(){
+	// the inputs are clean by now, if they hold what they held when this attribute was last updated its value is still valid.
+	// An input holds the same when it's the same value object and either its version didn't move or its content hashes the same,
+	// so only inputs that got a new version are hashed again.
+	bool changed = !_inputHashesValid || parent()->_slicer != 0;
+	bool hashable = true;
+	
+	std::vector<InputHash> inputHashes(_inputsToClean.size());
+	for(int i = 0; i < _inputsToClean.size(); ++i){
+		Value *value = _inputsToClean[i]->_inputValue;
+		if(value && value->isHashable()){
+			InputHash &inputHash = inputHashes[i];
+			inputHash.valueId = value->id();
+			inputHash.version = value->version();
 			
-			if(parentNode->updateEnabled()){
-				parentNode->doUpdate(this);
+			const InputHash *previous = _inputHashesValid ? &_inputHashes[i] : 0;
+			if(previous && previous->valueId == inputHash.valueId && previous->version == inputHash.version){
+				inputHash.hash = previous->hash;
+			}
+			else{
+				inputHash.hash = value->hash();
+				if(previous == 0 || previous->valueId != inputHash.valueId || previous->hash != inputHash.hash){
+					changed = true;
+				}
 			}
 		}
+		else{
+			hashable = false;
+			changed = true;
+		}
 	}
+	
+	_inputHashes.swap(inputHashes);
+	_inputHashesValid = hashable;
+	
+	return changed;
 }
 
 void Attribute::setNotifyParentNodeOnDirty(bool value){
@@ -356,27 +526,34 @@ void Attribute::setNotifyParentNodeOnDirty(bool value){
 }
 
 void Attribute::dirty(bool force){
-	if(!_cleaningLocked){
+	if(!EvaluationContext::current()){ // nodes dirtying their attributes while updating must not invalidate the ongoing evaluation
 		if(_isClean || force){
-			for(int i = 0; i < _dirtyChain.size(); ++i){
-				Attribute* attr = _dirtyChain[i];
-				attr->_isClean = false;
-				attr->onDirtied();
-				
-				if(attr->_notifyParentNodeOnDirty){
-					Node *parentNode = attr->parent();
-					if(parentNode){
-						parentNode->attributeDirtied(attr);
-					}
-				}
+			if(NetworkManager::isBatching()){
+				NetworkManager::batchDirty(this);
+				return;
+			}
+			
+			markEdited();
+			
+			const std::vector<Attribute*> &dirtyChain = this->dirtyChain();
+			for(int i = 0; i < dirtyChain.size(); ++i){
+				dirtyChain[i]->dirtySelf();
 			}
 
 			processDirtyingDoneCallbackQueue();
 		}
 	}
+}
+
+void Attribute::dirtySelf(){
+	_isClean = false;
+	onDirtied();
 	
-	for(int i = 0; i < _dirtyChain.size(); ++i){
-		Attribute* attr = _dirtyChain[i];
+	if(_notifyParentNodeOnDirty){
+		Node *parentNode = parent();
+		if(parentNode){
+			parentNode->attributeDirtied(this);
+		}
 	}
 }
 
@@ -457,8 +634,6 @@ bool Attribute::connectTo(Attribute *attribute, ErrorObject *errorObject){
 	_outputs.push_back(attribute);
 	attribute->setInput(this);
 	
-	cacheEvaluationChain();
-	
 	bool resetBranchSpecialization = false;
 	bool success = updateBranchSpecializations(resetBranchSpecialization);
 	
@@ -547,6 +722,21 @@ std::string Attribute::asScript(){
 	std::string script;
 	
 	if(_value && connectedInputNonPassThrough(this) == 0 && _affectedBy.size() == 0){
+		if(NetworkBlobs::isSaving() && _value->sizeInBytes() >= NetworkBlobs::blobThreshold()){
+			std::string blob = _value->writeBlob();
+			if(blob.empty() == false){
+				Command setAttributeBlobCmd;
+				setAttributeBlobCmd.setName("SetAttributeBlob");
+				setAttributeBlobCmd.setArgString("attribute", fullName());
+				setAttributeBlobCmd.setArgString("file", NetworkBlobs::blobFilename());
+				setAttributeBlobCmd.setArgString("fileId", NetworkBlobs::saveId());
+				setAttributeBlobCmd.setArgString("blob", blob);
+				script += setAttributeBlobCmd.asScript() += "\n";
+				
+				return script;
+			}
+		}
+		
 		std::string valueSaveScript = _value->asString();
 		if(valueSaveScript.empty() == false){
 			Command setAttributeValueCmd;
@@ -696,7 +886,13 @@ bool Attribute::updateSpecialization(std::vector<std::pair<Attribute*, Attribute
 	return complete;
 }
 
-bool Attribute::updateBranchSpecializations(bool reset){
+bool Attribute::updateBranchSpecializations(bool reset, std::set<int> *branchIds){
+	if(NetworkManager::isBatching()){
+		// solved once for the whole branch when the batch is committed.
+		NetworkManager::batchSpecializationUpdate(this, reset);
+		return true;
+	}
+	
 	bool success = true;
 
 	// collect
@@ -731,6 +927,10 @@ bool Attribute::updateBranchSpecializations(bool reset){
 			Attribute *attribute = (Attribute*)object;
 			attribute->setSpecialization(newSpec);
 		}
+		
+		if(branchIds){
+			branchIds->insert(id);
+		}
 	}
 
 	return success;
@@ -742,6 +942,8 @@ void Attribute::onSettingSpecialization(const std::vector<std::string> &speciali
 void Attribute::setSpecialization(const std::vector<std::string> &specialization){
 	if(specialization != _specialization && !isDeleted()){
 		_specialization = specialization;
+		_inputHashesValid = false;
+		_valueHashValid = false;
 		
 		onSettingSpecialization(specialization);
 		
@@ -823,46 +1025,61 @@ std::string Attribute::debugInfo(){
 	
 	info += "last cleaning took: secs:" + stringUtils::intToString(_computeTimeSeconds) + ", millisecs: " + stringUtils::intToString(_computeTimeMilliseconds) + "\n";
 	
+	const std::vector<Attribute*> &dirtyChain = this->dirtyChain();
 	info += "dirty chain: [";
-	for(int i = 0; i < _dirtyChain.size(); ++i){
-		info += _dirtyChain[i]->fullName() + ", ";
+	for(int i = 0; i < dirtyChain.size(); ++i){
+		info += dirtyChain[i]->fullName() + ", ";
 	}
 	info += "]\n";
 	
+	std::vector<CleanTask> &cleanChain = this->cleanChain();
 	info += "clean chain: [";
-	for(std::map<int, std::vector<Attribute*> >::iterator i = _cleanChain.begin(); i != _cleanChain.end(); ++i){
-		std::vector<Attribute*> &outputAttributes = i->second;
-		info += "[";
-		for(int j = 0; j < outputAttributes.size(); ++j){
-			Node *parentNode = outputAttributes[j]->parent();
-			info += parentNode->fullName() + ", ";
+	for(int i = 0; i < cleanChain.size(); ++i){
+		CleanTask &task = cleanChain[i];
+		info += task.attribute->fullName() + " -> [";
+		for(int j = 0; j < task.successors.size(); ++j){
+			info += cleanChain[task.successors[j]].attribute->fullName() + ", ";
 		}
-		info += "] -> ";
+		info += "], ";
 	}
 	info += "]\n";
 	
 	return info;
 }
 
-void Attribute::cacheDirtyChainUpstream(){
-	std::vector<Attribute*> attributes;
-	NetworkManager::getUpstreamChain(this, attributes);
-	for(int i = 0; i < attributes.size(); ++i){
-		NetworkManager::getDownstreamChain(attributes[i], attributes[i]->_dirtyChain);
+const std::vector<Attribute*> &Attribute::dirtyChain(){
+	NetworkManager::flushBatchedEdges();
+	
+	// the flags are atomic, reading one as false (acquire) guarantees the chain written before it was cleared (release) is visible.
+	if(_dirtyChainStale){
+		#ifdef CORAL_PARALLEL_TBB
+			tbb::mutex::scoped_lock lock(_chainsMutex);
+		#endif
+		
+		if(_dirtyChainStale){
+			NetworkManager::getDownstreamChain(this, _dirtyChain);
+			_dirtyChainStale = false;
+		}
 	}
+	
+	return _dirtyChain;
 }
 
-void Attribute::cacheCleanChainDownstream(){
-	std::vector<Attribute*> attributes;
-	NetworkManager::getDownstreamChain(this, attributes);
-	for(int i = 0; i < attributes.size(); ++i){
-		NetworkManager::getCleanChain(attributes[i], attributes[i]->_cleanChain, attributes[i]->_inputsCleanChain);
+std::vector<CleanTask> &Attribute::cleanChain(){
+	NetworkManager::flushBatchedEdges();
+	
+	if(_cleanChainStale){
+		#ifdef CORAL_PARALLEL_TBB
+			tbb::mutex::scoped_lock lock(_chainsMutex);
+		#endif
+		
+		if(_cleanChainStale){
+			NetworkManager::getCleanChain(this, _cleanChain);
+			_cleanChainStale = false;
+		}
 	}
-}
-
-void Attribute::cacheEvaluationChain(){
-	cacheDirtyChainUpstream();
-	cacheCleanChainDownstream();
+	
+	return _cleanChain;
 }
 
 std::vector<Attribute*> Attribute::specializationLinkedTo(){
@@ -898,8 +1115,9 @@ Attribute *Attribute::connectedNonPassThrough(){
     	}
     }
 
-	for(int i = 0; i < _dirtyChain.size(); ++i){
-		Attribute *outAttr = _dirtyChain[i];
+	const std::vector<Attribute*> &dirtyChain = this->dirtyChain();
+	for(int i = 0; i < dirtyChain.size(); ++i){
+		Attribute *outAttr = dirtyChain[i];
 		if(!outAttr->_passThrough){
 			return  outAttr;
 		}
@@ -30,12 +30,19 @@
 #ifndef CORAL_ATTRIBUTE_H
 #define CORAL_ATTRIBUTE_H
 
+#ifdef CORAL_PARALLEL_TBB
+	#include <tbb/mutex.h>
+	#include <tbb/atomic.h>
+#endif
+
 #include <vector>
 #include <map>
+#include <set>
 #include <time.h>
 #include <iostream>
 
 #include "NestedObject.h"
+#include "hashUtils.h"
 
 namespace coral{
 class Node;
@@ -44,7 +51,7 @@ class AttributeAccessor;
 class NetworkManager;
 class SpecializationLink;
 class ErrorObject;
-class attribute_parallelClean;
+class attribute_cleanTask;
 class Attribute;
 
 struct SpecializationLink{
@@ -53,6 +60,15 @@ struct SpecializationLink{
 	Attribute *attributeB;
 };
 
+struct CleanTask{
+	// Helper struct to hold an output attribute waiting to be cleaned, not exposed to public API.
+	// dependencies is the number of tasks that need to complete before this one can run,
+	// successors are the indices of the tasks waiting on this one.
+	Attribute *attribute;
+	int dependencies;
+	std::vector<int> successors;
+};
+
 //! The base class for customized attributes.
 //
 //! Internally it stores a pointer to a Value, 
@@ -139,8 +155,14 @@ protected:
 	void setAllowedSpecialization(const std::vector<std::string> &specialization);
 
 private:
+	struct InputHash{
+		int valueId;
+		unsigned int version;
+		hashUtils::Hash hash;
+	};
+	
 	friend class AttributeAccessor;
-	friend class attribute_parallelClean;
+	friend class attribute_cleanTask;
 	friend class Node;
 	friend class NetworkManager;
 
@@ -156,14 +178,18 @@ private:
 	void setParent(Node *parent);
 	void resetInputValuesInChain();
 	void removeSpecializationLink(SpecializationLink *specializationLink);
-	bool updateBranchSpecializations(bool reset);
+	bool updateBranchSpecializations(bool reset, std::set<int> *branchIds = 0);
 	void setSpecialization(const std::vector<std::string> &specialization);
 	bool specializationContainedOne(const std::vector<std::string> &specialization1, const std::vector<std::string> &specialization2);
 	void linkSpecializationTo(Attribute *attribute);
-	void cacheEvaluationChain();
-	void cacheDirtyChainUpstream();
-	void cacheCleanChainDownstream();
+	const std::vector<Attribute*> &dirtyChain();
+	std::vector<CleanTask> &cleanChain();
 	void cleanSelf();
+	void dirtySelf();
+	bool inputsChanged();
+	bool inputVersionsChanged();
+	void markEdited();
+	void setCatchUnchanged(bool value);
 	void processDirtyingDoneCallbackQueue();
 	Attribute *findFirstOutputNotPassThrough();
 	void initValueFromPassThroughFirstOutput(Attribute *attribute);
@@ -175,7 +201,6 @@ private:
 	std::vector<Attribute*> _outputs;
 	std::vector<Attribute*> _affect;
 	std::vector<Attribute*> _affectedBy;
-	bool _isClean;
 	bool _isOutput;
 	bool _isInput;
 	bool _passThrough;
@@ -190,8 +215,30 @@ private:
 	int _computeTimeSeconds;
 	int _computeTimeMilliseconds;
 	std::vector<Attribute*> _dirtyChain;
-	std::map<int, std::vector<Attribute*> > _cleanChain;
-	std::map<int, std::vector<Attribute*> > _inputsCleanChain;
+	std::vector<CleanTask> _cleanChain;
+	std::vector<Attribute*> _inputsToClean;
+	std::vector<InputHash> _inputHashes;
+	bool _inputHashesValid;
+	std::vector<std::pair<int, unsigned int> > _inputVersions;
+	bool _inputVersionsValid;
+	bool _valueUnchanged;
+	bool _catchUnchanged;
+	hashUtils::Hash _valueHash;
+	bool _valueHashValid;
+	
+	#ifdef CORAL_PARALLEL_TBB
+		tbb::atomic<bool> _isClean;
+		tbb::atomic<void*> _evaluatingThread;
+		tbb::atomic<bool> _dirtyChainStale;
+		tbb::atomic<bool> _cleanChainStale;
+		tbb::atomic<bool> _inputsToCleanStale;
+	#else
+		bool _isClean;
+		void *_evaluatingThread;
+		bool _dirtyChainStale;
+		bool _cleanChainStale;
+		bool _inputsToCleanStale;
+	#endif
 	
 	Attribute();
 	Attribute(const Attribute &other);
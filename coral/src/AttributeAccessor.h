@@ -30,6 +30,7 @@
 #define ATTRIBUTEACCESSOR_H
 
 #include "Attribute.h"
+#include "EvaluationContext.h"
 
 namespace coral{
 	
@@ -56,7 +57,14 @@ public:
 	}
 	
 	static void _cleanSelf(Attribute &self){
-		self.cleanSelf();
+		EvaluationContext *context = EvaluationContext::current();
+		if(context){
+			self.cleanSelf();
+		}
+		else{
+			EvaluationContext newContext;
+			self.cleanSelf();
+		}
 	}
 	
 	static void _setIsClean(Attribute &self, bool value){
@@ -27,6 +27,7 @@
 // </license>
 #include "BoolAttribute.h"
 #include "stringUtils.h"
+#include "hashUtils.h"
 
 using namespace coral;
 
@@ -292,3 +293,20 @@ std::string BoolAttribute::shortDebugInfo(){
 
 	return info;
 }
+
+bool Bool::isHashable(){
+	return true;
+}
+
+hashUtils::Hash Bool::hash(){
+	hashUtils::Hash hash = hashUtils::hashValue(_isArray);
+	for(int i = 0; i < _boolValuesSliced.size(); ++i){
+		const std::vector<bool> &values = _boolValuesSliced[i];
+		hash = hashUtils::hashValue((unsigned int)values.size(), hash);
+		for(int j = 0; j < values.size(); ++j){
+			hash = hashUtils::hashValue((bool)values[j], hash);
+		}
+	}
+	
+	return hash;
+}
@@ -50,6 +50,8 @@ public:
 	std::string asString();
 	std::string sliceAsString(unsigned int slice);
 	void setFromString(const std::string &value);
+	bool isHashable();
+	hashUtils::Hash hash();
 
 	void setBoolValueAt(unsigned int id, bool value);
 	bool boolValueAt(unsigned int id);
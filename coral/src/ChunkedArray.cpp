@@ -0,0 +1,400 @@
+// <license>
+// Copyright (C) 2011 Andrea Interguglielmi, All rights reserved.
+// This file is part of the coral repository downloaded from http://code.google.com/p/coral-repo.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// 
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+// 
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+// IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// </license>
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#ifdef _WIN32
+	#include <windows.h>
+#else
+	#include <sys/stat.h>
+#endif
+
+#ifdef CORAL_PARALLEL_TBB
+	#include <tbb/mutex.h>
+#endif
+
+#include "ChunkedArray.h"
+#include "hashUtils.h"
+
+using namespace coral;
+
+namespace{
+	std::size_t _memoryBudget = 1024 * 1024 * 1024;
+	std::size_t _residentBytes = 0;
+	std::list<std::pair<ChunkedArray*, unsigned int> > _leastRecentlyUsed;
+	
+	#ifdef CORAL_PARALLEL_TBB
+		tbb::mutex _residentMutex;
+	#endif
+	
+	class BufferChunk: public Chunk{
+	public:
+		BufferChunk(std::size_t bytes): _buffer(bytes, 0){
+			if(bytes){
+				_data = &_buffer[0];
+			}
+		}
+		
+		char *buffer(){
+			return _buffer.empty() ? 0 : &_buffer[0];
+		}
+	
+	private:
+		std::vector<char> _buffer;
+	};
+	
+	class MappedChunk: public Chunk{
+	public:
+		MappedChunk(const boost::interprocess::file_mapping &mapping, std::size_t offset, std::size_t bytes):
+			_region(mapping, boost::interprocess::read_only, offset, bytes){
+			_data = (const char*)_region.get_address();
+		}
+	
+	private:
+		boost::interprocess::mapped_region _region;
+	};
+	
+	// size of the file behind the mapping right now, it may have been truncated since it was opened.
+	// Touching pages past the end of a mapped file raises SIGBUS rather than an error we could report.
+	std::size_t mappedFileSize(const boost::interprocess::file_mapping &mapping){
+		boost::interprocess::mapping_handle_t handle = mapping.get_mapping_handle();
+		
+		#ifdef _WIN32
+			LARGE_INTEGER size;
+			if(GetFileSizeEx(handle.handle, &size) == 0){
+				return 0;
+			}
+			return std::size_t(size.QuadPart);
+		#else
+			struct stat status;
+			if(fstat(handle.handle, &status) != 0){
+				return 0;
+			}
+			return std::size_t(status.st_size);
+		#endif
+	}
+}
+
+boost::shared_ptr<Chunk> GeneratedChunkSource::loadChunk(unsigned int begin, unsigned int count, unsigned int elementSize){
+	BufferChunk *chunk = new BufferChunk(std::size_t(count) * elementSize);
+	if(count){
+		fillChunk(begin, count, chunk->buffer());
+	}
+	
+	return boost::shared_ptr<Chunk>(chunk);
+}
+
+MappedFileChunkSource::MappedFileChunkSource(const std::string &filename, std::size_t offset):
+	_filename(filename),
+	_offset(offset),
+	_fileSize(0){
+	
+	std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary | std::ios::ate);
+	if(file.is_open()){
+		_fileSize = file.tellg();
+		file.close();
+		
+		try{
+			_mapping.reset(new boost::interprocess::file_mapping(filename.c_str(), boost::interprocess::read_only));
+		}
+		catch(boost::interprocess::interprocess_exception&){
+			_fileSize = 0;
+		}
+	}
+}
+
+std::size_t MappedFileChunkSource::fileSize(){
+	return _fileSize;
+}
+
+boost::shared_ptr<Chunk> MappedFileChunkSource::loadChunk(unsigned int begin, unsigned int count, unsigned int elementSize){
+	std::size_t bytes = std::size_t(count) * elementSize;
+	std::size_t offset = _offset + std::size_t(begin) * elementSize;
+	
+	boost::shared_ptr<Chunk> chunk = mapBytes(offset, bytes);
+	if(!chunk){
+		// the file was removed or truncated after the array was created, zeros would silently stand in for the values.
+		std::ostringstream message;
+		message << "coral: can't read " << bytes << " bytes at offset " << offset << " of " << _filename << ", the file is missing or too short.";
+		throw std::runtime_error(message.str());
+	}
+	
+	return chunk;
+}
+
+boost::shared_ptr<Chunk> MappedFileChunkSource::mapBytes(std::size_t offset, std::size_t bytes){
+	if(!_mapping){
+		return boost::shared_ptr<Chunk>();
+	}
+	
+	boost::interprocess::file_mapping *mapping = static_cast<boost::interprocess::file_mapping*>(_mapping.get());
+	
+	// the handle still refers to the file we opened even if it was removed or replaced since.
+	std::size_t fileSize = mappedFileSize(*mapping);
+	if(offset > fileSize || bytes > fileSize - offset){
+		return boost::shared_ptr<Chunk>();
+	}
+	
+	// an empty region would map the whole file
+	if(bytes == 0){
+		return boost::shared_ptr<Chunk>(new BufferChunk(0));
+	}
+	
+	return boost::shared_ptr<Chunk>(new MappedChunk(*mapping, offset, bytes));
+}
+
+ChunkedArray::ChunkedArray(boost::shared_ptr<ChunkSource> source, unsigned int size, unsigned int elementSize, unsigned int chunkSize):
+	_source(source),
+	_size(size),
+	_elementSize(elementSize),
+	_chunkSize(chunkSize){
+	
+	if(_chunkSize == 0){
+		_chunkSize = defaultChunkSize;
+	}
+	
+	// chunks spanning whole words hash the same as the contiguous values, see hashUtils.
+	while((_chunkSize * _elementSize) % sizeof(hashUtils::Hash)){
+		_chunkSize += 1;
+	}
+	
+	_chunks.resize((_size + _chunkSize - 1) / _chunkSize);
+}
+
+ChunkedArray::~ChunkedArray(){
+	evict();
+}
+
+unsigned int ChunkedArray::chunkCount(unsigned int chunk) const{
+	unsigned int begin = chunkBegin(chunk);
+	if(begin >= _size){
+		return 0;
+	}
+	
+	unsigned int count = _size - begin;
+	if(count > _chunkSize){
+		count = _chunkSize;
+	}
+	
+	return count;
+}
+
+boost::shared_ptr<Chunk> ChunkedArray::chunk(unsigned int chunk){
+	{
+		#ifdef CORAL_PARALLEL_TBB
+			tbb::mutex::scoped_lock lock(_residentMutex);
+		#endif
+		
+		ResidentChunk &resident = _chunks[chunk];
+		if(resident.chunk){
+			_leastRecentlyUsed.splice(_leastRecentlyUsed.end(), _leastRecentlyUsed, resident.lruEntry);
+			return resident.chunk;
+		}
+	}
+	
+	// loading happens outside of the lock so that different chunks can be loaded concurrently
+	boost::shared_ptr<Chunk> loadedChunk = _source->loadChunk(chunkBegin(chunk), chunkCount(chunk), _elementSize);
+	
+	#ifdef CORAL_PARALLEL_TBB
+		tbb::mutex::scoped_lock lock(_residentMutex);
+	#endif
+	
+	ResidentChunk &resident = _chunks[chunk];
+	if(!resident.chunk){
+		resident.chunk = loadedChunk;
+		resident.lruEntry = _leastRecentlyUsed.insert(_leastRecentlyUsed.end(), std::make_pair(this, chunk));
+		_residentBytes += std::size_t(chunkCount(chunk)) * _elementSize;
+		
+		enforceBudget(this, chunk);
+	}
+	
+	return resident.chunk;
+}
+
+void ChunkedArray::read(unsigned int begin, unsigned int count, char *values){
+	if(begin >= _size){
+		return;
+	}
+	
+	if(count > _size - begin){
+		count = _size - begin;
+	}
+	
+	while(count){
+		unsigned int chunkId = begin / _chunkSize;
+		unsigned int chunkOffset = begin - chunkBegin(chunkId);
+		unsigned int chunkCopied = chunkCount(chunkId) - chunkOffset;
+		if(chunkCopied > count){
+			chunkCopied = count;
+		}
+		
+		boost::shared_ptr<Chunk> currentChunk = chunk(chunkId);
+		std::memcpy(values, currentChunk->data() + std::size_t(chunkOffset) * _elementSize, std::size_t(chunkCopied) * _elementSize);
+		
+		values += std::size_t(chunkCopied) * _elementSize;
+		begin += chunkCopied;
+		count -= chunkCopied;
+	}
+}
+
+void *ChunkedArray::materialized(boost::shared_ptr<void> &holder, boost::shared_ptr<void>(*create)(unsigned int, char**)){
+	// the holders of every SharedVector sharing this array are only touched under this lock, concurrent readers can't race on them.
+	#ifdef CORAL_PARALLEL_TBB
+		tbb::mutex::scoped_lock lock(_materializeMutex);
+	#endif
+	
+	if(holder){
+		return holder.get();
+	}
+	
+	{
+		#ifdef CORAL_PARALLEL_TBB
+			tbb::mutex::scoped_lock residentLock(_residentMutex);
+		#endif
+		
+		if(_materialized){
+			_leastRecentlyUsed.splice(_leastRecentlyUsed.end(), _leastRecentlyUsed, _materializedLruEntry);
+			holder = _materialized;
+			
+			return holder.get();
+		}
+	}
+	
+	// built outside of the resident lock, reading the chunks takes it
+	char *data = 0;
+	holder = create(_size, &data);
+	read(0, _size, data);
+	
+	#ifdef CORAL_PARALLEL_TBB
+		tbb::mutex::scoped_lock residentLock(_residentMutex);
+	#endif
+	
+	_materialized = holder;
+	_materializedLruEntry = _leastRecentlyUsed.insert(_leastRecentlyUsed.end(), std::make_pair(this, materializedId()));
+	_residentBytes += std::size_t(_size) * _elementSize;
+	
+	enforceBudget(this, materializedId());
+	
+	return holder.get();
+}
+
+hashUtils::Hash ChunkedArray::hash(hashUtils::Hash hash){
+	hash = hashUtils::hashValue(_size, hash);
+	for(unsigned int i = 0; i < _chunks.size(); ++i){
+		boost::shared_ptr<Chunk> currentChunk = chunk(i);
+		hash = hashUtils::hashBytes(currentChunk->data(), std::size_t(chunkCount(i)) * _elementSize, hash);
+	}
+	
+	return hash;
+}
+
+std::size_t ChunkedArray::residentBytes(){
+	#ifdef CORAL_PARALLEL_TBB
+		tbb::mutex::scoped_lock lock(_residentMutex);
+	#endif
+	
+	std::size_t bytes = 0;
+	for(unsigned int i = 0; i < _chunks.size(); ++i){
+		if(_chunks[i].chunk){
+			bytes += std::size_t(chunkCount(i)) * _elementSize;
+		}
+	}
+	
+	if(_materialized){
+		bytes += std::size_t(_size) * _elementSize;
+	}
+	
+	return bytes;
+}
+
+void ChunkedArray::evict(){
+	#ifdef CORAL_PARALLEL_TBB
+		tbb::mutex::scoped_lock lock(_residentMutex);
+	#endif
+	
+	for(unsigned int i = 0; i < _chunks.size(); ++i){
+		if(_chunks[i].chunk){
+			evictChunk(i);
+		}
+	}
+	
+	if(_materialized){
+		evictChunk(materializedId());
+	}
+}
+
+void ChunkedArray::evictChunk(unsigned int chunk){
+	if(chunk == materializedId()){
+		_materialized.reset();
+		_leastRecentlyUsed.erase(_materializedLruEntry);
+		_residentBytes -= std::size_t(_size) * _elementSize;
+		
+		return;
+	}
+	
+	ResidentChunk &resident = _chunks[chunk];
+	resident.chunk.reset();
+	_leastRecentlyUsed.erase(resident.lruEntry);
+	_residentBytes -= std::size_t(chunkCount(chunk)) * _elementSize;
+}
+
+void ChunkedArray::enforceBudget(ChunkedArray *keepArray, unsigned int keepChunk){
+	while(_memoryBudget && _residentBytes > _memoryBudget && !_leastRecentlyUsed.empty()){
+		std::pair<ChunkedArray*, unsigned int> oldest = _leastRecentlyUsed.front();
+		if(oldest.first == keepArray && oldest.second == keepChunk){
+			break;
+		}
+		
+		oldest.first->evictChunk(oldest.second);
+	}
+}
+
+std::size_t ChunkedArray::memoryBudget(){
+	return _memoryBudget;
+}
+
+void ChunkedArray::setMemoryBudget(std::size_t bytes){
+	#ifdef CORAL_PARALLEL_TBB
+		tbb::mutex::scoped_lock lock(_residentMutex);
+	#endif
+	
+	_memoryBudget = bytes;
+	if(!_leastRecentlyUsed.empty()){
+		std::pair<ChunkedArray*, unsigned int> newest = _leastRecentlyUsed.back();
+		enforceBudget(newest.first, newest.second);
+	}
+}
+
+std::size_t ChunkedArray::totalResidentBytes(){
+	return _residentBytes;
+}
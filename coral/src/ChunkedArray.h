@@ -0,0 +1,220 @@
+// <license>
+// Copyright (C) 2011 Andrea Interguglielmi, All rights reserved.
+// This file is part of the coral repository downloaded from http://code.google.com/p/coral-repo.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// 
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+// 
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+// IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// </license>
+
+#ifndef CORAL_CHUNKEDARRAY_H
+#define CORAL_CHUNKEDARRAY_H
+
+#include <list>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <boost/shared_ptr.hpp>
+
+#ifdef CORAL_PARALLEL_TBB
+	#include <tbb/mutex.h>
+#endif
+
+#include "coralDefinitions.h"
+#include "hashUtils.h"
+
+namespace coral{
+
+//! A block of contiguous elements of a ChunkedArray, the memory stays valid as long as the Chunk is referenced.
+class CORAL_EXPORT Chunk{
+public:
+	virtual ~Chunk(){}
+	
+	const char *data() const{
+		return _data;
+	}
+
+protected:
+	Chunk(): _data(0){
+	}
+	
+	const char *_data;
+};
+
+//! Produces the chunks of a ChunkedArray on request.
+//! Sources are only asked for chunks that are not resident, a chunk might be requested again after it was evicted.
+//! loadChunk can be called concurrently from several threads.
+class CORAL_EXPORT ChunkSource{
+public:
+	virtual ~ChunkSource(){}
+	
+	//! Returns the elements [begin, begin + count) of the array, each element being elementSize bytes.
+	virtual boost::shared_ptr<Chunk> loadChunk(unsigned int begin, unsigned int count, unsigned int elementSize) = 0;
+};
+
+//! Base class for sources computing their values lazily, fillChunk writes count elements into a buffer owned by the chunk.
+class CORAL_EXPORT GeneratedChunkSource: public ChunkSource{
+public:
+	boost::shared_ptr<Chunk> loadChunk(unsigned int begin, unsigned int count, unsigned int elementSize);
+
+protected:
+	virtual void fillChunk(unsigned int begin, unsigned int count, char *values) = 0;
+};
+
+//! Memory maps the chunks of a raw binary file holding the elements back to back, starting at the given byte offset.
+//! Only the pages of the resident chunks are mapped, the file is never read as a whole.
+//! loadChunk throws std::runtime_error if the file is missing or too short, rather than handing out made up values.
+class CORAL_EXPORT MappedFileChunkSource: public ChunkSource{
+public:
+	MappedFileChunkSource(const std::string &filename, std::size_t offset = 0);
+	boost::shared_ptr<Chunk> loadChunk(unsigned int begin, unsigned int count, unsigned int elementSize);
+	
+	//! Maps bytes of the file starting at offset, counted from the start of the file. Returns NULL if the range is not in the file.
+	boost::shared_ptr<Chunk> mapBytes(std::size_t offset, std::size_t bytes);
+	
+	//! Size of the file in bytes, 0 if the file could not be opened.
+	std::size_t fileSize();
+
+private:
+	std::string _filename;
+	std::size_t _offset;
+	std::size_t _fileSize;
+	boost::shared_ptr<void> _mapping;
+};
+
+//! Read only array of fixed size elements stored as fixed size chunks produced by a ChunkSource.
+//! Chunks are loaded when first accessed and the least recently used chunks of all the ChunkedArrays are evicted 
+//! whenever the resident bytes exceed memoryBudget(), so arrays much bigger than the available memory can be streamed.
+//! Numeric slices can be backed by a ChunkedArray, see Numeric::setChunkedValuesSlice.
+class CORAL_EXPORT ChunkedArray{
+public:
+	enum{
+		defaultChunkSize = 65536
+	};
+	
+	ChunkedArray(boost::shared_ptr<ChunkSource> source, unsigned int size, unsigned int elementSize, unsigned int chunkSize = defaultChunkSize);
+	~ChunkedArray();
+	
+	unsigned int size() const{
+		return _size;
+	}
+	
+	unsigned int elementSize() const{
+		return _elementSize;
+	}
+	
+	unsigned int chunkSize() const{
+		return _chunkSize;
+	}
+	
+	unsigned int chunks() const{
+		return _chunks.size();
+	}
+	
+	//! Index of the first element held by the given chunk.
+	unsigned int chunkBegin(unsigned int chunk) const{
+		return chunk * _chunkSize;
+	}
+	
+	//! Number of elements held by the given chunk, only the last chunk can be smaller than chunkSize().
+	unsigned int chunkCount(unsigned int chunk) const;
+	
+	//! Returns the given chunk, loading it from the source if it's not resident.
+	//! Hold on to the returned Chunk for as long as its data is used, eviction only releases the reference kept by this array.
+	boost::shared_ptr<Chunk> chunk(unsigned int chunk);
+	
+	//! Copies the elements [begin, begin + count) into values, loading the chunks as needed.
+	void read(unsigned int begin, unsigned int count, char *values);
+	
+	template<class T>
+	T valueAt(unsigned int id){
+		T value;
+		read(id, 1, (char*)&value);
+		
+		return value;
+	}
+	
+	//! The whole array as one contiguous vector, kept alive by holder. An empty holder is filled with the copy cached by this array,
+	//! which is built on first request and counts against memoryBudget() like the chunks, evicting it only drops the reference kept here.
+	//! This is what the contiguous accessors of Numeric fall back to, chunk aware code should iterate chunk() instead.
+	template<class T>
+	const std::vector<T> &values(boost::shared_ptr<void> &holder){
+		return *static_cast<const std::vector<T>*>(materialized(holder, &ChunkedArray::createValues<T>));
+	}
+	
+	//! Hashes the content the same way hashUtils::hashVector would hash the contiguous values.
+	hashUtils::Hash hash(hashUtils::Hash hash);
+	
+	//! Bytes currently held in memory by this array, resident chunks plus the contiguous copy if any.
+	std::size_t residentBytes();
+	
+	//! Drops the resident chunks and the contiguous copy of this array.
+	void evict();
+	
+	//! The budget is shared by all the ChunkedArrays, a value of 0 disables eviction.
+	static std::size_t memoryBudget();
+	static void setMemoryBudget(std::size_t bytes);
+	static std::size_t totalResidentBytes();
+
+private:
+	struct ResidentChunk{
+		boost::shared_ptr<Chunk> chunk;
+		std::list<std::pair<ChunkedArray*, unsigned int> >::iterator lruEntry;
+	};
+	
+	boost::shared_ptr<ChunkSource> _source;
+	unsigned int _size;
+	unsigned int _elementSize;
+	unsigned int _chunkSize;
+	std::vector<ResidentChunk> _chunks;
+	boost::shared_ptr<void> _materialized;
+	std::list<std::pair<ChunkedArray*, unsigned int> >::iterator _materializedLruEntry;
+	
+	#ifdef CORAL_PARALLEL_TBB
+		tbb::mutex _materializeMutex;
+	#endif
+	
+	template<class T>
+	static boost::shared_ptr<void> createValues(unsigned int size, char **data){
+		std::vector<T> *values = new std::vector<T>(size);
+		*data = size ? (char*)&(*values)[0] : 0;
+		
+		return boost::shared_ptr<void>(values);
+	}
+	
+	ChunkedArray(const ChunkedArray &other);
+	ChunkedArray &operator=(const ChunkedArray &other);
+	
+	void *materialized(boost::shared_ptr<void> &holder, boost::shared_ptr<void>(*create)(unsigned int, char**));
+	
+	//! Id standing for the contiguous copy in the least recently used list, one past the last chunk.
+	unsigned int materializedId() const{
+		return _chunks.size();
+	}
+
+	void evictChunk(unsigned int chunk);
+	static void enforceBudget(ChunkedArray *keepArray, unsigned int keepChunk);
+};
+
+}
+
+#endif
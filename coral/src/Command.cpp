@@ -27,6 +27,7 @@
 // </license>
 
 #include "Command.h"
+#include "stringUtils.h"
 
 using namespace coral;
 
@@ -161,16 +162,13 @@ std::string Command::argToString(CommandValue &arg){
 		}
 	}
 	else if(argType == CommandValue::intType){
-		char buffer[sizeof(int)];
-		sprintf(buffer, "%i", arg.asInt());
-		
-		argString = buffer;
+		argString.clear();
+		stringUtils::appendInt(argString, arg.asInt());
 	}
 	else if(argType == CommandValue::floatType){
-		char buffer[sizeof(float)];
-		sprintf(buffer, "%f", arg.asFloat());
-		
-		argString = buffer;
+		// written as a python literal, '.' is the decimal point whatever the locale
+		argString.clear();
+		stringUtils::appendFloat(argString, arg.asFloat());
 	}
 	else if(argType == CommandValue::stringType){
 		argString = "'" + arg.asString() + "'";
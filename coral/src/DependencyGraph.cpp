@@ -0,0 +1,316 @@
+// <license>
+// Copyright (C) 2011 Andrea Interguglielmi, All rights reserved.
+// This file is part of the coral repository downloaded from http://code.google.com/p/coral-repo.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// 
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+// 
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+// IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// </license>
+
+#include <algorithm>
+#include <set>
+
+#ifdef CORAL_PARALLEL_TBB
+	#include <tbb/enumerable_thread_specific.h>
+#endif
+
+#include "DependencyGraph.h"
+
+using namespace coral;
+
+namespace {
+	// visited flags are kept per thread and reset after each walk, so that walking the graph doesn't allocate them every time.
+	#ifdef CORAL_PARALLEL_TBB
+		tbb::enumerable_thread_specific<std::vector<unsigned int> > _visitedBits;
+	#else
+		std::vector<unsigned int> _visitedBits;
+	#endif
+	
+	std::vector<unsigned int> &localVisitedBits(int vertexCount){
+		#ifdef CORAL_PARALLEL_TBB
+			std::vector<unsigned int> &visitedBits = _visitedBits.local();
+		#else
+			std::vector<unsigned int> &visitedBits = _visitedBits;
+		#endif
+		
+		int wordCount = (vertexCount + 31) / 32;
+		if(visitedBits.size() < wordCount){
+			visitedBits.resize(wordCount, 0);
+		}
+		
+		return visitedBits;
+	}
+	
+	// returns true if the vertex was already visited.
+	inline bool visit(std::vector<unsigned int> &visitedBits, int vertex){
+		unsigned int &word = visitedBits[vertex >> 5];
+		unsigned int mask = 1u << (vertex & 31);
+		bool visited = (word & mask) != 0;
+		word |= mask;
+		
+		return visited;
+	}
+	
+	inline void unvisit(std::vector<unsigned int> &visitedBits, int vertex){
+		visitedBits[vertex >> 5] &= ~(1u << (vertex & 31));
+	}
+	
+	const int minRowCapacity = 2;
+	const int minGarbageToCompact = 1024;
+}
+
+DependencyGraphRows::DependencyGraphRows():
+	_garbage(0){
+}
+
+void DependencyGraphRows::grow(Row &row){
+	if(_garbage > minGarbageToCompact && _garbage > _slots.size() / 2){
+		compact();
+	}
+	
+	int capacity = std::max(minRowCapacity, row.capacity * 2);
+	
+	if(row.offset + row.capacity == _slots.size()){
+		// already the last row, it grows in place.
+		_slots.resize(row.offset + capacity);
+	}
+	else{
+		int offset = _slots.size();
+		_slots.resize(offset + capacity);
+		std::copy(_slots.begin() + row.offset, _slots.begin() + row.offset + row.size, _slots.begin() + offset);
+		
+		_garbage += row.capacity;
+		row.offset = offset;
+	}
+	
+	row.capacity = capacity;
+}
+
+void DependencyGraphRows::compact(){
+	// rows are packed in their current order with no spare room, the next edit of a row moves it to the end again.
+	std::vector<int> slots;
+	slots.reserve(_slots.size() - _garbage);
+	for(int i = 0; i < _rows.size(); ++i){
+		Row &row = _rows[i];
+		
+		int offset = slots.size();
+		slots.insert(slots.end(), _slots.begin() + row.offset, _slots.begin() + row.offset + row.size);
+		row.offset = offset;
+		row.capacity = row.size;
+	}
+	
+	_slots.swap(slots);
+	_garbage = 0;
+}
+
+void DependencyGraphRows::add(int slot, int adjacentSlot){
+	// adjacent slots get a row too, walks index their flags by slot without checking.
+	int slotCount = std::max(slot, adjacentSlot) + 1;
+	if(slotCount > _rows.size()){
+		Row emptyRow;
+		emptyRow.offset = _slots.size();
+		emptyRow.size = 0;
+		emptyRow.capacity = 0;
+		_rows.resize(slotCount, emptyRow);
+	}
+	
+	Row &row = _rows[slot];
+	if(row.size == row.capacity){
+		grow(row);
+	}
+	
+	_slots[row.offset + row.size] = adjacentSlot;
+	row.size += 1;
+}
+
+bool DependencyGraphRows::remove(int slot, int adjacentSlot){
+	if(slot >= _rows.size() || _rows[slot].size == 0){
+		return false;
+	}
+	
+	Row &row = _rows[slot];
+	int *begin = &_slots[0] + row.offset;
+	int *end = begin + row.size;
+	int *found = std::find(begin, end, adjacentSlot);
+	if(found == end){
+		return false;
+	}
+	
+	*found = *(end - 1);
+	row.size -= 1;
+	
+	return true;
+}
+
+void DependencyGraphRows::clear(int slot){
+	if(slot < _rows.size()){
+		Row &row = _rows[slot];
+		_garbage += row.capacity;
+		row.size = 0;
+		row.capacity = 0;
+	}
+}
+
+DependencyGraph::DependencyGraph():
+	_edgeCount(0){
+}
+
+void DependencyGraph::addEdge(int sourceSlot, int destinationSlot){
+	_outEdges.add(sourceSlot, destinationSlot);
+	_inEdges.add(destinationSlot, sourceSlot);
+	
+	_edgeCount += 1;
+}
+
+void DependencyGraph::removeEdge(int sourceSlot, int destinationSlot){
+	if(_outEdges.remove(sourceSlot, destinationSlot)){
+		_inEdges.remove(destinationSlot, sourceSlot);
+		
+		_edgeCount -= 1;
+	}
+}
+
+void DependencyGraph::clearVertex(int slot){
+	int outSize = _outEdges.size(slot);
+	if(outSize){
+		const int *destinations = _outEdges.row(slot);
+		for(int i = 0; i < outSize; ++i){
+			_inEdges.remove(destinations[i], slot);
+		}
+		
+		_outEdges.clear(slot);
+		_edgeCount -= outSize;
+	}
+	
+	int inSize = _inEdges.size(slot);
+	if(inSize){
+		const int *sources = _inEdges.row(slot);
+		for(int i = 0; i < inSize; ++i){
+			_outEdges.remove(sources[i], slot);
+		}
+		
+		_inEdges.clear(slot);
+		_edgeCount -= inSize;
+	}
+}
+
+int DependencyGraph::edgeCount(){
+	return _edgeCount;
+}
+
+void DependencyGraph::collectDownstream(const std::vector<int> &slots, std::vector<int> &collectedSlots){
+	collectedSlots.clear();
+	
+	int slotCount = _outEdges.slotCount();
+	std::vector<unsigned int> &visitedBits = localVisitedBits(slotCount);
+	std::vector<int> stack;
+	std::set<int> unconnectedSlots;
+	
+	for(int i = 0; i < slots.size(); ++i){
+		int slot = slots[i];
+		if(slot >= slotCount){
+			if(unconnectedSlots.insert(slot).second){
+				collectedSlots.push_back(slot);
+			}
+		}
+		else if(!visit(visitedBits, slot)){
+			stack.push_back(slot);
+			
+			while(!stack.empty()){
+				int currentSlot = stack.back();
+				stack.pop_back();
+				
+				collectedSlots.push_back(currentSlot);
+				
+				int size = _outEdges.size(currentSlot);
+				if(size){
+					const int *nextSlots = _outEdges.row(currentSlot);
+					for(int j = 0; j < size; ++j){
+						if(!visit(visitedBits, nextSlots[j])){
+							stack.push_back(nextSlots[j]);
+						}
+					}
+				}
+			}
+		}
+	}
+	
+	for(int i = 0; i < collectedSlots.size(); ++i){
+		if(collectedSlots[i] < slotCount){
+			unvisit(visitedBits, collectedSlots[i]);
+		}
+	}
+}
+
+void DependencyGraph::collectUpstream(const std::vector<int> &slots, std::vector<int> &collectedSlots){
+	collectedSlots.clear();
+	
+	int slotCount = _inEdges.slotCount();
+	std::vector<unsigned int> &visitedBits = localVisitedBits(slotCount);
+	std::vector<std::pair<int, int> > stack; // slot and next in edge to follow
+	std::set<int> unconnectedSlots;
+	
+	for(int i = 0; i < slots.size(); ++i){
+		int slot = slots[i];
+		if(slot >= slotCount){
+			if(unconnectedSlots.insert(slot).second){
+				collectedSlots.push_back(slot);
+			}
+		}
+		else if(!visit(visitedBits, slot)){
+			stack.push_back(std::make_pair(slot, 0));
+			
+			while(!stack.empty()){
+				std::pair<int, int> &current = stack.back();
+				if(current.second < _inEdges.size(current.first)){
+					int nextSlot = _inEdges.row(current.first)[current.second];
+					current.second += 1;
+					
+					if(!visit(visitedBits, nextSlot)){
+						stack.push_back(std::make_pair(nextSlot, 0));
+					}
+				}
+				else{
+					// a slot is collected once everything feeding it has been.
+					collectedSlots.push_back(current.first);
+					stack.pop_back();
+				}
+			}
+		}
+	}
+	
+	for(int i = 0; i < collectedSlots.size(); ++i){
+		if(collectedSlots[i] < slotCount){
+			unvisit(visitedBits, collectedSlots[i]);
+		}
+	}
+}
+
+void DependencyGraph::collectSources(int slot, std::vector<int> &sourceSlots){
+	sourceSlots.clear();
+	
+	int size = _inEdges.size(slot);
+	if(size){
+		const int *sources = _inEdges.row(slot);
+		sourceSlots.assign(sources, sources + size);
+	}
+}
@@ -0,0 +1,121 @@
+// <license>
+// Copyright (C) 2011 Andrea Interguglielmi, All rights reserved.
+// This file is part of the coral repository downloaded from http://code.google.com/p/coral-repo.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// 
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+// 
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+// IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// </license>
+
+#ifndef CORAL_DEPENDENCYGRAPH_H
+#define CORAL_DEPENDENCYGRAPH_H
+
+#include <vector>
+
+#include "coralDefinitions.h"
+
+namespace coral{
+
+//! The edges of a DependencyGraph in one direction, one row of adjacent slots per slot.
+//
+//! Rows are stored back to back in a single array, each with some spare room,
+//! so that adding or removing an edge only touches its own row and a full row is moved to the end of the array.
+//! The space left behind by moved and cleared rows is reclaimed once it outgrows the live edges.
+class DependencyGraphRows{
+public:
+	DependencyGraphRows();
+	
+	void add(int slot, int adjacentSlot);
+	
+	//! Removes one occurrence of adjacentSlot from the row of slot, returns false if there was none.
+	bool remove(int slot, int adjacentSlot);
+	
+	//! Empties the row of slot and gives its room back.
+	void clear(int slot);
+	
+	int slotCount() const{
+		return _rows.size();
+	}
+	
+	int size(int slot) const{
+		return slot < _rows.size() ? _rows[slot].size : 0;
+	}
+	
+	const int *row(int slot) const{
+		return &_slots[0] + _rows[slot].offset;
+	}
+
+private:
+	struct Row{
+		int offset;
+		int size;
+		int capacity;
+	};
+	
+	void grow(Row &row);
+	void compact();
+	
+	std::vector<Row> _rows;
+	std::vector<int> _slots;
+	int _garbage;
+};
+
+//! Directed graph of the connections and affects between attributes, used by NetworkManager to walk the network.
+//
+//! Vertices are identified by object slots, edges are kept as compressed rows in both directions and edited in place,
+//! so that an edit costs as much as the rows it touches and walks never wait on a rebuild.
+//! The same edge can be added more than once, each removal takes away a single copy.
+//! Traversals can run from several threads at once, but edits must not happen concurrently with them.
+class CORAL_EXPORT DependencyGraph{
+public:
+	DependencyGraph();
+	
+	void addEdge(int sourceSlot, int destinationSlot);
+	void removeEdge(int sourceSlot, int destinationSlot);
+	
+	//! Removes every edge entering or leaving slot.
+	void clearVertex(int slot);
+	
+	//! Collects the slots reachable from the given ones following edges forward, start slots included, each slot is collected once.
+	void collectDownstream(const std::vector<int> &slots, std::vector<int> &collectedSlots);
+	
+	//! Collects the slots reaching the given ones, start slots included.
+	//! Slots come sorted upstream first, so that each one is preceded by every slot it depends on.
+	void collectUpstream(const std::vector<int> &slots, std::vector<int> &collectedSlots);
+	
+	//! Collects the slots with an edge going into slot, once per edge.
+	void collectSources(int slot, std::vector<int> &sourceSlots);
+	
+	int edgeCount();
+
+private:
+	DependencyGraphRows _outEdges;
+	DependencyGraphRows _inEdges;
+	int _edgeCount;
+	
+	DependencyGraph(const DependencyGraph &other);
+	DependencyGraph &operator =(const DependencyGraph &other);
+};
+
+}
+
+#endif
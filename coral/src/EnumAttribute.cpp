@@ -1,4 +1,5 @@
 #include "EnumAttribute.h"
+#include "hashUtils.h"
 
 using namespace coral;
 
@@ -36,6 +37,14 @@ std::vector<std::string> Enum::entries(){
 	return vals;
 }
 
+bool Enum::isHashable(){
+	return true;
+}
+
+hashUtils::Hash Enum::hash(){
+	return hashUtils::hashString(asString());
+}
+
 std::string Enum::asString(){
 	std::string value = "[{";
 	for(std::map<int, std::string>::iterator i = _enum.begin(); i != _enum.end(); ++i){
@@ -50,6 +50,8 @@ public:
 	int currentIndex();
 	std::string asString();
 	void setFromString(const std::string &value);
+	bool isHashable();
+	hashUtils::Hash hash();
 	void setCurrentIndexChangedCallback(Node * parentNode, void(*callback)(Node *, Enum *));
 	std::string currentText(int id);
 	void clear();
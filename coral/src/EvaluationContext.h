@@ -0,0 +1,67 @@
+// <license>
+// Copyright (C) 2011 Andrea Interguglielmi, All rights reserved.
+// This file is part of the coral repository downloaded from http://code.google.com/p/coral-repo.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// 
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+// 
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+// IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// </license>
+
+
+#ifndef CORAL_EVALUATIONCONTEXT_H
+#define CORAL_EVALUATIONCONTEXT_H
+
+#include "coralDefinitions.h"
+
+namespace coral{
+
+//! Carries the state of a single evaluation started by pulling a dirty Attribute.
+//
+//! Every thread pulling a dirty attribute runs its clean chain under its own context, 
+//! nested pulls coming from a node's update join the context already running on that thread.
+//! While an output attribute is being computed it's tagged with the thread in charge of it,
+//! other threads reaching the same attribute wait until it's done instead of computing it twice or reading incomplete data.
+class CORAL_EXPORT EvaluationContext{
+public:
+	//! Starts a new evaluation and makes it current for the calling thread.
+	EvaluationContext();
+	~EvaluationContext();
+	
+	//! Returns a token unique to the calling thread.
+	static void *thread();
+	
+	//! Returns the context evaluating on the calling thread, 0 if the thread is not evaluating anything.
+	static EvaluationContext *current();
+	
+	//! Sets the context evaluating on the calling thread and returns the previous one so that it can be restored.
+	static EvaluationContext *setCurrent(EvaluationContext *context);
+
+private:
+	EvaluationContext *_previous;
+	
+	EvaluationContext(const EvaluationContext &other);
+	EvaluationContext &operator =(const EvaluationContext &other);
+};
+
+}
+
+#endif
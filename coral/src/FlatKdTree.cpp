@@ -0,0 +1,554 @@
+// <license>
+// Copyright (C) 2011 Andrea Interguglielmi, All rights reserved.
+// This file is part of the coral repository downloaded from http://code.google.com/p/coral-repo.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// 
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+// 
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+// IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// </license>
+
+#include <algorithm>
+#include <limits>
+
+#include "FlatKdTree.h"
+#include "coreParallelAlgos.h"
+#include "spatialQueryUtils.h"
+
+#ifdef CORAL_PARALLEL_TBB
+	#include <tbb/task_group.h>
+#endif
+
+using namespace coral;
+using namespace spatialQueryUtils;
+
+namespace{
+	// ranges this small are scanned rather than split further
+	const int leafSize = 8;
+	
+	// subtrees with more points than this are built as separate tasks
+	const int parallelBuildSize = 32768;
+	
+	// deep enough for the implicit tree of any range of int indices
+	const int maxStackSize = 128;
+	
+	struct Entry{
+		Imath::V3f point;
+		int index;
+	};
+	
+	class EntryLess{
+	public:
+		EntryLess(int axis): _axis(axis){
+		}
+		
+		bool operator() (const Entry &a, const Entry &b) const{
+			return a.point[_axis] < b.point[_axis];
+		}
+		
+	private:
+		int _axis;
+	};
+	
+	int largestAxis(const Entry *entries, int begin, int end){
+		Imath::V3f min = entries[begin].point;
+		Imath::V3f max = min;
+		for(int i = begin + 1; i < end; ++i){
+			const Imath::V3f &point = entries[i].point;
+			for(int axis = 0; axis < 3; ++axis){
+				if(point[axis] < min[axis]){
+					min[axis] = point[axis];
+				}
+				else if(point[axis] > max[axis]){
+					max[axis] = point[axis];
+				}
+			}
+		}
+		
+		Imath::V3f extent = max - min;
+		if(extent.x >= extent.y && extent.x >= extent.z){
+			return 0;
+		}
+		
+		return extent.y >= extent.z ? 1 : 2;
+	}
+	
+	void buildRange(Entry *entries, unsigned char *axes, int begin, int end);
+	
+	#ifdef CORAL_PARALLEL_TBB
+	
+	class BuildRangeTask{
+	public:
+		BuildRangeTask(Entry *entries, unsigned char *axes, int begin, int end): 
+			_entries(entries), _axes(axes), _begin(begin), _end(end){
+		}
+		
+		void operator() () const{
+			buildRange(_entries, _axes, _begin, _end);
+		}
+	
+	private:
+		Entry *_entries;
+		unsigned char *_axes;
+		int _begin;
+		int _end;
+	};
+	
+	#endif // tbb
+	
+	void buildRange(Entry *entries, unsigned char *axes, int begin, int end){
+		if(end - begin <= leafSize){
+			return;
+		}
+		
+		int axis = largestAxis(entries, begin, end);
+		int middle = begin + (end - begin) / 2;
+		std::nth_element(entries + begin, entries + middle, entries + end, EntryLess(axis));
+		axes[middle] = axis;
+		
+		#ifdef CORAL_PARALLEL_TBB
+			if(end - begin > parallelBuildSize){
+				tbb::task_group taskGroup;
+				taskGroup.run(BuildRangeTask(entries, axes, begin, middle));
+				buildRange(entries, axes, middle + 1, end);
+				taskGroup.wait();
+				
+				return;
+			}
+		#endif
+		
+		buildRange(entries, axes, begin, middle);
+		buildRange(entries, axes, middle + 1, end);
+	}
+	
+	// calls visitor(i) for each point i within range, i being the position of the point in the tree.
+	template<class Visitor>
+	void visitPointsInRange(const Imath::V3f *points, const unsigned char *axes, int size, const Imath::V3f &point, float range, Visitor &visitor){
+		float range2 = range * range;
+		
+		int stack[maxStackSize];
+		int stackSize = 0;
+		if(size){
+			stack[stackSize++] = 0;
+			stack[stackSize++] = size;
+		}
+		
+		while(stackSize){
+			int end = stack[--stackSize];
+			int begin = stack[--stackSize];
+			
+			if(end - begin <= leafSize){
+				for(int i = begin; i < end; ++i){
+					if((points[i] - point).length2() <= range2){
+						visitor(i);
+					}
+				}
+				
+				continue;
+			}
+			
+			int middle = begin + (end - begin) / 2;
+			if((points[middle] - point).length2() <= range2){
+				visitor(middle);
+			}
+			
+			float distance = point[axes[middle]] - points[middle][axes[middle]];
+			if(distance <= range){
+				stack[stackSize++] = begin;
+				stack[stackSize++] = middle;
+			}
+			
+			if(distance >= -range){
+				stack[stackSize++] = middle + 1;
+				stack[stackSize++] = end;
+			}
+		}
+	}
+	
+	// squared distance and index of a point found by a k nearest search, ordered so that ties go to the lowest index
+	typedef std::pair<float, int> Neighbour;
+	
+	unsigned int findNearestPoints(const Imath::V3f *points, const unsigned char *axes, const int *indices, int size, const Imath::V3f &point, unsigned int count, std::vector<Neighbour> &heap, int *results){
+		// heap is a max heap of the best neighbours found so far, its front is the one to be replaced next
+		heap.clear();
+		if(size == 0 || count == 0){
+			return 0;
+		}
+		
+		int ranges[maxStackSize];
+		float bounds[maxStackSize / 2];
+		int stackSize = 0;
+		
+		ranges[0] = 0;
+		ranges[1] = size;
+		bounds[0] = 0.0;
+		stackSize = 1;
+		
+		while(stackSize){
+			stackSize--;
+			int begin = ranges[stackSize * 2];
+			int end = ranges[stackSize * 2 + 1];
+			float bound = bounds[stackSize];
+			if(heap.size() == count && bound > heap.front().first){
+				continue;
+			}
+			
+			bool isLeaf = end - begin <= leafSize;
+			int middle = begin + (end - begin) / 2;
+			int scanBegin = isLeaf ? begin : middle;
+			int scanEnd = isLeaf ? end : middle + 1;
+			
+			for(int i = scanBegin; i < scanEnd; ++i){
+				Neighbour neighbour((points[i] - point).length2(), indices[i]);
+				if(heap.size() < count){
+					heap.push_back(neighbour);
+					std::push_heap(heap.begin(), heap.end());
+				}
+				else if(neighbour < heap.front()){
+					std::pop_heap(heap.begin(), heap.end());
+					heap.back() = neighbour;
+					std::push_heap(heap.begin(), heap.end());
+				}
+			}
+			
+			if(isLeaf){
+				continue;
+			}
+			
+			float distance = point[axes[middle]] - points[middle][axes[middle]];
+			
+			int nearBegin = begin;
+			int nearEnd = middle;
+			int farBegin = middle + 1;
+			int farEnd = end;
+			if(distance > 0.0){
+				nearBegin = middle + 1;
+				nearEnd = end;
+				farBegin = begin;
+				farEnd = middle;
+			}
+			
+			ranges[stackSize * 2] = farBegin;
+			ranges[stackSize * 2 + 1] = farEnd;
+			bounds[stackSize] = std::max(bound, distance * distance);
+			stackSize++;
+			
+			ranges[stackSize * 2] = nearBegin;
+			ranges[stackSize * 2 + 1] = nearEnd;
+			bounds[stackSize] = bound;
+			stackSize++;
+		}
+		
+		std::sort_heap(heap.begin(), heap.end());
+		for(unsigned int i = 0; i < heap.size(); ++i){
+			results[i] = heap[i].second;
+		}
+		
+		return heap.size();
+	}
+	
+	class NearestPointsBody{
+	public:
+		NearestPointsBody(const FlatKdTree &tree, const Imath::V3f *queries, int *results): 
+			_tree(tree), _queries(queries), _results(results){
+		}
+		
+		void operator() (unsigned int begin, unsigned int end) const{
+			for(unsigned int i = begin; i < end; ++i){
+				_results[i] = _tree.nearestPoint(_queries[i]);
+			}
+		}
+		
+	private:
+		const FlatKdTree &_tree;
+		const Imath::V3f *_queries;
+		int *_results;
+	};
+	
+	class KNearestPointsBody{
+	public:
+		KNearestPointsBody(const Imath::V3f *points, const unsigned char *axes, const int *indices, int size, const Imath::V3f *queries, unsigned int count, int *results): 
+			_points(points), _axes(axes), _indices(indices), _size(size), _queries(queries), _count(count), _results(results){
+		}
+		
+		void operator() (unsigned int begin, unsigned int end) const{
+			// one heap for the whole chunk of queries
+			std::vector<Neighbour> heap;
+			heap.reserve(_count);
+			
+			for(unsigned int i = begin; i < end; ++i){
+				findNearestPoints(_points, _axes, _indices, _size, _queries[i], _count, heap, _results + i * _count);
+			}
+		}
+		
+	private:
+		const Imath::V3f *_points;
+		const unsigned char *_axes;
+		const int *_indices;
+		int _size;
+		const Imath::V3f *_queries;
+		unsigned int _count;
+		int *_results;
+	};
+	
+	class CountPointsInRangeBody{
+	public:
+		CountPointsInRangeBody(const FlatKdTree &tree, const Imath::V3f *queries, const float *ranges, unsigned int rangesCount, int *counts): 
+			_tree(tree), _queries(queries), _ranges(ranges), _rangesCount(rangesCount), _counts(counts){
+		}
+		
+		void operator() (unsigned int begin, unsigned int end) const{
+			for(unsigned int i = begin; i < end; ++i){
+				_counts[i] = _tree.countPointsInRange(_queries[i], queryRange(_ranges, _rangesCount, i));
+			}
+		}
+		
+	private:
+		const FlatKdTree &_tree;
+		const Imath::V3f *_queries;
+		const float *_ranges;
+		unsigned int _rangesCount;
+		int *_counts;
+	};
+	
+	class PointsInRangeBody{
+	public:
+		PointsInRangeBody(const FlatKdTree &tree, const Imath::V3f *queries, const float *ranges, unsigned int rangesCount, const int *offsets, int *results): 
+			_tree(tree), _queries(queries), _ranges(ranges), _rangesCount(rangesCount), _offsets(offsets), _results(results){
+		}
+		
+		void operator() (unsigned int begin, unsigned int end) const{
+			for(unsigned int i = begin; i < end; ++i){
+				_tree.pointsInRange(_queries[i], queryRange(_ranges, _rangesCount, i), _results + _offsets[i]);
+			}
+		}
+		
+	private:
+		const FlatKdTree &_tree;
+		const Imath::V3f *_queries;
+		const float *_ranges;
+		unsigned int _rangesCount;
+		const int *_offsets;
+		int *_results;
+	};
+}
+
+FlatKdTree::FlatKdTree(){
+}
+
+void FlatKdTree::build(const std::vector<Imath::V3f> &points){
+	int size = points.size();
+	
+	std::vector<Entry> entries(size);
+	for(int i = 0; i < size; ++i){
+		entries[i].point = points[i];
+		entries[i].index = i;
+	}
+	
+	std::vector<unsigned char> axes(size, 0);
+	if(size){
+		buildRange(&entries[0], &axes[0], 0, size);
+	}
+	
+	_points.resize(size);
+	_indices.resize(size);
+	for(int i = 0; i < size; ++i){
+		_points[i] = entries[i].point;
+		_indices[i] = entries[i].index;
+	}
+	
+	_axes.swap(axes);
+}
+
+unsigned int FlatKdTree::size() const{
+	return _points.size();
+}
+
+size_t FlatKdTree::sizeInBytes() const{
+	return _points.size() * sizeof(Imath::V3f) + _indices.size() * sizeof(int) + _axes.size();
+}
+
+int FlatKdTree::nearestPoint(const Imath::V3f &point) const{
+	int size = _points.size();
+	if(size == 0){
+		return -1;
+	}
+	
+	const Imath::V3f *points = &_points[0];
+	const unsigned char *axes = &_axes[0];
+	const int *indices = &_indices[0];
+	
+	int nearest = -1;
+	float nearestDistance2 = std::numeric_limits<float>::max();
+	
+	// each entry is a range of the tree along with the squared distance from point to the region of that range
+	int ranges[maxStackSize];
+	float bounds[maxStackSize / 2];
+	int stackSize = 0;
+	
+	ranges[0] = 0;
+	ranges[1] = size;
+	bounds[0] = 0.0;
+	stackSize = 1;
+	
+	while(stackSize){
+		stackSize--;
+		int begin = ranges[stackSize * 2];
+		int end = ranges[stackSize * 2 + 1];
+		float bound = bounds[stackSize];
+		if(bound > nearestDistance2){
+			continue;
+		}
+		
+		if(end - begin <= leafSize){
+			for(int i = begin; i < end; ++i){
+				float distance2 = (points[i] - point).length2();
+				
+				// ties go to the lowest index so that the result doesn't depend on the layout of the tree
+				if(nearest == -1 || distance2 < nearestDistance2 || (distance2 == nearestDistance2 && indices[i] < indices[nearest])){
+					nearest = i;
+					nearestDistance2 = distance2;
+				}
+			}
+			
+			continue;
+		}
+		
+		int middle = begin + (end - begin) / 2;
+		float distance2 = (points[middle] - point).length2();
+		if(nearest == -1 || distance2 < nearestDistance2 || (distance2 == nearestDistance2 && indices[middle] < indices[nearest])){
+			nearest = middle;
+			nearestDistance2 = distance2;
+		}
+		
+		float distance = point[axes[middle]] - points[middle][axes[middle]];
+		
+		int nearBegin = begin;
+		int nearEnd = middle;
+		int farBegin = middle + 1;
+		int farEnd = end;
+		if(distance > 0.0){
+			nearBegin = middle + 1;
+			nearEnd = end;
+			farBegin = begin;
+			farEnd = middle;
+		}
+		
+		// the far side goes on the stack first so that the near side is searched first
+		ranges[stackSize * 2] = farBegin;
+		ranges[stackSize * 2 + 1] = farEnd;
+		bounds[stackSize] = std::max(bound, distance * distance);
+		stackSize++;
+		
+		ranges[stackSize * 2] = nearBegin;
+		ranges[stackSize * 2 + 1] = nearEnd;
+		bounds[stackSize] = bound;
+		stackSize++;
+	}
+	
+	return indices[nearest];
+}
+
+unsigned int FlatKdTree::nearestPoints(const Imath::V3f &point, unsigned int count, int *results) const{
+	if(_points.empty()){
+		return 0;
+	}
+	
+	std::vector<Neighbour> heap;
+	return findNearestPoints(&_points[0], &_axes[0], &_indices[0], _points.size(), point, count, heap, results);
+}
+
+unsigned int FlatKdTree::countPointsInRange(const Imath::V3f &point, float range) const{
+	if(_points.empty()){
+		return 0;
+	}
+	
+	CountVisitor visitor;
+	visitPointsInRange(&_points[0], &_axes[0], _points.size(), point, range, visitor);
+	
+	return visitor.count;
+}
+
+unsigned int FlatKdTree::pointsInRange(const Imath::V3f &point, float range, int *results) const{
+	if(_points.empty()){
+		return 0;
+	}
+	
+	WriteVisitor visitor(&_indices[0], results);
+	visitPointsInRange(&_points[0], &_axes[0], _points.size(), point, range, visitor);
+	
+	return visitor.count;
+}
+
+void FlatKdTree::pointsInRange(const Imath::V3f &point, float range, std::vector<int> &results) const{
+	results.clear();
+	if(_points.empty()){
+		return;
+	}
+	
+	AppendVisitor visitor(&_indices[0], results);
+	visitPointsInRange(&_points[0], &_axes[0], _points.size(), point, range, visitor);
+}
+
+void FlatKdTree::nearestPoints(const Imath::V3f *queries, unsigned int queriesCount, int *results) const{
+	parallelFor(queriesCount, queriesGrainSize, NearestPointsBody(*this, queries, results));
+}
+
+void FlatKdTree::nearestPoints(const Imath::V3f *queries, unsigned int queriesCount, unsigned int count, int *results) const{
+	count = std::min(count, size());
+	if(count == 0){
+		return;
+	}
+	
+	parallelFor(queriesCount, queriesGrainSize, KNearestPointsBody(&_points[0], &_axes[0], &_indices[0], _points.size(), queries, count, results));
+}
+
+void FlatKdTree::countPointsInRange(const Imath::V3f *queries, unsigned int queriesCount, const float *ranges, unsigned int rangesCount, int *counts) const{
+	if(rangesCount == 0){
+		return;
+	}
+	
+	parallelFor(queriesCount, queriesGrainSize, CountPointsInRangeBody(*this, queries, ranges, rangesCount, counts));
+}
+
+void FlatKdTree::pointsInRange(const Imath::V3f *queries, unsigned int queriesCount, const float *ranges, unsigned int rangesCount, const int *offsets, int *results) const{
+	if(rangesCount == 0){
+		return;
+	}
+	
+	parallelFor(queriesCount, queriesGrainSize, PointsInRangeBody(*this, queries, ranges, rangesCount, offsets, results));
+}
+
+void FlatKdTree::pointsInRange(const Imath::V3f *queries, unsigned int queriesCount, const float *ranges, unsigned int rangesCount, std::vector<int> &offsets, std::vector<int> &results) const{
+	offsets.assign(queriesCount + 1, 0);
+	results.clear();
+	if(queriesCount == 0 || rangesCount == 0){
+		return;
+	}
+	
+	countPointsInRange(queries, queriesCount, ranges, rangesCount, &offsets[1]);
+	accumulateOffsets(offsets);
+	
+	results.resize(offsets[queriesCount]);
+	if(results.size()){
+		pointsInRange(queries, queriesCount, ranges, rangesCount, &offsets[0], &results[0]);
+	}
+}
@@ -0,0 +1,90 @@
+// <license>
+// Copyright (C) 2011 Andrea Interguglielmi, All rights reserved.
+// This file is part of the coral repository downloaded from http://code.google.com/p/coral-repo.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// 
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+// 
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+// IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// </license>
+
+#ifndef CORAL_FLATKDTREE_H
+#define CORAL_FLATKDTREE_H
+
+#include <vector>
+#include <ImathVec.h>
+#include "coralDefinitions.h"
+
+namespace coral{
+
+//! Kd-tree over 3d points stored as flat arrays, with no per node allocation and no pointers to chase.
+//! The tree is implicit: the node splitting the range of points [begin, end) is the point at the middle of the range,
+//! points on its left are below it on its split axis and points on its right above, small ranges are scanned as leaves.
+//! Queries never modify the tree and can run from any number of threads at once.
+//! Results are the indices of the points in the array the tree was built from.
+class CORAL_EXPORT FlatKdTree{
+public:
+	FlatKdTree();
+	
+	//! Builds the tree with median partitioning in O(n log n), large subtrees are built in parallel.
+	void build(const std::vector<Imath::V3f> &points);
+	unsigned int size() const;
+	size_t sizeInBytes() const;
+	
+	//! Index of the point closest to point, -1 if the tree is empty.
+	int nearestPoint(const Imath::V3f &point) const;
+	
+	//! Writes the count points closest to point to results, closest first, or all the points when the tree has fewer.
+	//! Returns the number of points written.
+	unsigned int nearestPoints(const Imath::V3f &point, unsigned int count, int *results) const;
+	
+	unsigned int countPointsInRange(const Imath::V3f &point, float range) const;
+	
+	//! Writes the points within range of point to results, which must have room for countPointsInRange() elements.
+	//! Returns the number of points written.
+	unsigned int pointsInRange(const Imath::V3f &point, float range, int *results) const;
+	void pointsInRange(const Imath::V3f &point, float range, std::vector<int> &results) const;
+	
+	// batched queries, they run in parallel and write to caller provided arrays of one element per query.
+	// ranges holds one range per query, or fewer in which case the last range is used for the remaining queries.
+	void nearestPoints(const Imath::V3f *queries, unsigned int queriesCount, int *results) const;
+	
+	//! Writes the count points closest to each query starting at results[query * min(count, size())], closest first.
+	void nearestPoints(const Imath::V3f *queries, unsigned int queriesCount, unsigned int count, int *results) const;
+	
+	void countPointsInRange(const Imath::V3f *queries, unsigned int queriesCount, const float *ranges, unsigned int rangesCount, int *counts) const;
+	
+	//! Writes the points within range of each query starting at results[offsets[query]].
+	void pointsInRange(const Imath::V3f *queries, unsigned int queriesCount, const float *ranges, unsigned int rangesCount, const int *offsets, int *results) const;
+	
+	//! Runs both passes and lays the results out as compressed rows: 
+	//! the points in range of query i are results[offsets[i]] to results[offsets[i + 1] - 1], offsets has queriesCount + 1 elements.
+	void pointsInRange(const Imath::V3f *queries, unsigned int queriesCount, const float *ranges, unsigned int rangesCount, std::vector<int> &offsets, std::vector<int> &results) const;
+	
+private:
+	std::vector<Imath::V3f> _points;
+	std::vector<int> _indices;
+	std::vector<unsigned char> _axes;
+};
+
+}
+
+#endif
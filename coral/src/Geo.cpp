@@ -29,8 +29,14 @@
 
 
 #include "Geo.h"
+#include "GeoBvh.h"
 #include <assert.h>
+#include <cstring>
+#include <sstream>
 #include "containerUtils.h"
+#include "hashUtils.h"
+#include "NetworkBlobs.h"
+#include "ChunkedArray.h"
 
 using namespace coral;
 using namespace containerUtils;
@@ -40,10 +46,30 @@ _faceNormalsDirty(true),
 _verticesNormalsDirty(true),
 _topologyStructuresDirty(true),
 _alignmentDataDirty(true),
-_overrideVerticesNormals(false){
+_overrideVerticesNormals(false),
+_bvhDirty(true),
+_bvhPointsDirty(false){
 }
 
 void Geo::copy(const Geo *other){
+	// a bvh of the same faces only needs a refit, which is much cheaper than building a new one
+	boost::shared_ptr<GeoBvh> bvh;
+	bool bvhPointsDirty = true;
+	{
+		#ifdef CORAL_PARALLEL_TBB
+			tbb::mutex::scoped_lock lock(const_cast<Geo*>(other)->_localMutex);
+		#endif
+		
+		if(other->_bvh && !other->_bvhDirty){
+			bvh = other->_bvh;
+			bvhPointsDirty = other->_bvhPointsDirty;
+		}
+	}
+	
+	if(!bvh && _bvh && !_bvhDirty && _rawFaces == other->_rawFaces){
+		bvh = _bvh;
+	}
+	
 	clear();
 	
 	_points = other->_points;
@@ -52,6 +78,12 @@ void Geo::copy(const Geo *other){
 		_verticesNormals = other->_verticesNormals;
 		_overrideVerticesNormals = true;
 	}
+	
+	if(bvh){
+		_bvh = bvh;
+		_bvhDirty = false;
+		_bvhPointsDirty = bvhPointsDirty;
+	}
 }
 
 void Geo::setVerticesNormals(const std::vector<Imath::V3f> &normals){
@@ -116,6 +148,7 @@ void Geo::setPoints(const std::vector<Imath::V3f> &points){
 		_faceNormalsDirty = true;
 		_verticesNormalsDirty = true;
 		_overrideVerticesNormals = false;
+		_bvhPointsDirty = true;
 	}
 }
 
@@ -139,6 +172,7 @@ void Geo::displacePoints(const std::vector<Imath::V3f> &displacedPoints){
 	_faceNormalsDirty = true;
 	_verticesNormalsDirty = true;
 	_overrideVerticesNormals = false;
+	_bvhPointsDirty = true;
 }
 
 void Geo::clear(){
@@ -158,6 +192,8 @@ void Geo::clear(){
 	_verticesNormalsDirty = true;
 	_topologyStructuresDirty = true;
 	_alignmentDataDirty = true;
+	_bvhDirty = true;
+	_bvh.reset();
 }
 
 void Geo::build(const std::vector<Imath::V3f> &points, const std::vector<std::vector<int> > &faces){
@@ -175,6 +211,21 @@ void Geo::build(const std::vector<Imath::V3f> &points, const std::vector<std::ve
 	_rawUvs = uvs;
 }
 
+void Geo::swapBuild(std::vector<Imath::V3f> &points, std::vector<std::vector<int> > &faces){
+	clear();
+	
+	_points.swap(points);
+	_rawFaces.swap(faces);
+}
+
+void Geo::swapBuild(std::vector<Imath::V3f> &points, std::vector<std::vector<int> > &faces, std::vector<Imath::V2f> &uvs){
+	clear();
+
+	_points.swap(points);
+	_rawFaces.swap(faces);
+	_rawUvs.swap(uvs);
+}
+
 void Geo::computeVertexPerFaceNormals(std::vector<Imath::V3f> &vertexPerFaceNormals){
 	int nFaces = _rawFaces.size();
 	if(nFaces){
@@ -464,3 +515,159 @@ const std::vector<Face*> &Geo::faces(){
 	
 	return _facesPtr;
 }
+
+const GeoBvh &Geo::bvh(){
+	#ifdef CORAL_PARALLEL_TBB
+		tbb::mutex::scoped_lock lock(_localMutex);
+	#endif
+	
+	if(_bvhDirty || !_bvh){
+		_bvh.reset(new GeoBvh());
+		_bvh->build(_points, _rawFaces);
+		_bvhDirty = false;
+		_bvhPointsDirty = false;
+	}
+	else if(_bvhPointsDirty){
+		// other copies of this Geo might still be querying the shared bvh
+		if(!_bvh.unique()){
+			_bvh.reset(new GeoBvh(*_bvh));
+		}
+		
+		_bvh->refit(_points);
+		_bvhPointsDirty = false;
+	}
+	
+	return *_bvh;
+}
+
+size_t Geo::sizeInBytes(){
+	size_t bytes = (_points.size() + _faceNormals.size() + _verticesNormals.size()) * sizeof(Imath::V3f);
+	bytes += _rawUvs.size() * sizeof(Imath::V2f);
+	bytes += (_rawIndices.size() + _rawIndexCounts.size()) * sizeof(int);
+	for(int i = 0; i < _rawFaces.size(); ++i){
+		bytes += _rawFaces[i].size() * sizeof(int);
+	}
+	
+	if(_bvh){
+		bytes += _bvh->sizeInBytes();
+	}
+	
+	return bytes;
+}
+
+// the blob holds the points, the vertex count of each face, the vertex indices and the uvs back to back
+std::string Geo::writeBlob(){
+	if(!NetworkBlobs::isSaving()){
+		return "";
+	}
+	
+	std::vector<int> faceCounts(_rawFaces.size());
+	std::size_t indicesCount = 0;
+	for(int i = 0; i < _rawFaces.size(); ++i){
+		faceCounts[i] = _rawFaces[i].size();
+		indicesCount += _rawFaces[i].size();
+	}
+	
+	std::size_t offset = NetworkBlobs::beginBlob();
+	if(_points.size()){
+		NetworkBlobs::write(&_points[0], _points.size() * sizeof(Imath::V3f));
+	}
+	
+	if(faceCounts.size()){
+		NetworkBlobs::write(&faceCounts[0], faceCounts.size() * sizeof(int));
+	}
+	
+	for(int i = 0; i < _rawFaces.size(); ++i){
+		if(_rawFaces[i].size()){
+			NetworkBlobs::write(&_rawFaces[i][0], _rawFaces[i].size() * sizeof(int));
+		}
+	}
+	
+	if(_rawUvs.size()){
+		NetworkBlobs::write(&_rawUvs[0], _rawUvs.size() * sizeof(Imath::V2f));
+	}
+	
+	std::ostringstream description;
+	description << offset << " " << _points.size() << " " << _rawFaces.size() << " " << indicesCount << " " << _rawUvs.size();
+	
+	return description.str();
+}
+
+bool Geo::readBlob(const std::string &filename, const std::string &description){
+	std::istringstream fields(description);
+	std::size_t offset = 0;
+	std::size_t pointsCount = 0;
+	std::size_t facesCount = 0;
+	std::size_t indicesCount = 0;
+	std::size_t uvsCount = 0;
+	fields >> offset >> pointsCount >> facesCount >> indicesCount >> uvsCount;
+	if(fields.fail()){
+		return false;
+	}
+	
+	std::size_t pointsBytes = pointsCount * sizeof(Imath::V3f);
+	std::size_t countsBytes = facesCount * sizeof(int);
+	std::size_t indicesBytes = indicesCount * sizeof(int);
+	std::size_t uvsBytes = uvsCount * sizeof(Imath::V2f);
+	boost::shared_ptr<Chunk> blob = NetworkBlobs::map(filename, offset, pointsBytes + countsBytes + indicesBytes + uvsBytes);
+	if(!blob){
+		return false;
+	}
+	
+	const char *data = blob->data();
+	
+	std::vector<Imath::V3f> points(pointsCount);
+	if(pointsCount){
+		std::memcpy(&points[0], data, pointsBytes);
+	}
+	
+	std::vector<int> faceCounts(facesCount);
+	if(facesCount){
+		std::memcpy(&faceCounts[0], data + pointsBytes, countsBytes);
+	}
+	
+	std::vector<std::vector<int> > faces(facesCount);
+	const char *indices = data + pointsBytes + countsBytes;
+	std::size_t consumed = 0;
+	for(int i = 0; i < facesCount; ++i){
+		std::size_t count = faceCounts[i];
+		if(consumed + count > indicesCount){
+			break;
+		}
+		
+		faces[i].resize(count);
+		if(count){
+			std::memcpy(&faces[i][0], indices + consumed * sizeof(int), count * sizeof(int));
+		}
+		
+		consumed += count;
+	}
+	
+	std::vector<Imath::V2f> uvs(uvsCount);
+	if(uvsCount){
+		std::memcpy(&uvs[0], data + pointsBytes + countsBytes + indicesBytes, uvsBytes);
+	}
+	
+	swapBuild(points, faces, uvs);
+	
+	return true;
+}
+
+bool Geo::isHashable(){
+	return true;
+}
+
+hashUtils::Hash Geo::hash(){
+	hashUtils::Hash hash = hashUtils::hashVector(_points);
+	hash = hashUtils::hashVector(_rawUvs, hash);
+	hash = hashUtils::hashValue(_overrideVerticesNormals, hash);
+	if(_overrideVerticesNormals){
+		hash = hashUtils::hashVector(_verticesNormals, hash);
+	}
+	
+	for(int i = 0; i < _rawFaces.size(); ++i){
+		hash = hashUtils::hashVector(_rawFaces[i], hash);
+	}
+	
+	return hash;
+}
@@ -35,12 +35,14 @@
 
 #include <map>
 #include <vector>
+#include <boost/shared_ptr.hpp>
 #include <ImathVec.h>
 
 #include "Value.h"
 
 namespace coral{
 class Geo;
+class GeoBvh;
 class Face;
 class Edge;
 class Vertex;
@@ -178,6 +180,10 @@ public:
 	void copy(const Geo *other);
 	void build(const std::vector<Imath::V3f> &points, const std::vector<std::vector<int> > &faces);
 	void build(const std::vector<Imath::V3f> &points, const std::vector<std::vector<int> > &faces, const std::vector<Imath::V2f> &uvs);
+	
+	//! Same as build() but the arrays are swapped in rather than copied, they are left empty.
+	void swapBuild(std::vector<Imath::V3f> &points, std::vector<std::vector<int> > &faces);
+	void swapBuild(std::vector<Imath::V3f> &points, std::vector<std::vector<int> > &faces, std::vector<Imath::V2f> &uvs);
 	const std::vector<Imath::V3f> &points();
 	int pointsCount() const;
 	const std::vector<Imath::V2f> &rawUvs();
@@ -205,6 +211,17 @@ public:
 	const std::vector<Vertex*> &vertices();
 	const std::vector<Edge*> &edges();
 	const std::vector<Face*> &faces();
+	
+	//! Triangle hierarchy for closest point and ray queries, built on first use and kept until the topology changes.
+	//! When only the points move it's refitted rather than rebuilt, copies of this Geo share it until their points move.
+	const GeoBvh &bvh();
+	size_t sizeInBytes();
+	
+	//! Saves the points, faces and uvs, the rest is rebuilt on demand after readBlob().
+	std::string writeBlob();
+	bool readBlob(const std::string &filename, const std::string &description);
+	bool isHashable();
+	hashUtils::Hash hash();
 
 private:
 	void computeVertexPerFaceNormals(std::vector<Imath::V3f> &vertexPerFaceNormals);
@@ -217,6 +234,8 @@ private:
 	bool _verticesNormalsDirty;
 	bool _alignmentDataDirty;
 	bool _overrideVerticesNormals;
+	bool _bvhDirty;
+	bool _bvhPointsDirty;
 
 	std::vector<std::vector<int> > _rawFaces;
 	std::vector<Face> _faces;
@@ -237,6 +256,8 @@ private:
 	std::vector<int> _vertexIdOffset;
 	std::vector<std::vector<int> > _vertexFaces;
 	
+	boost::shared_ptr<GeoBvh> _bvh;
+	
 	#ifdef CORAL_PARALLEL_TBB
 		tbb::mutex _localMutex;
 	#endif
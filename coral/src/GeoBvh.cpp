@@ -0,0 +1,523 @@
+// <license>
+// Copyright (C) 2011 Andrea Interguglielmi, All rights reserved.
+// This file is part of the coral repository downloaded from http://code.google.com/p/coral-repo.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// 
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+// 
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+// IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// </license>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "GeoBvh.h"
+#include "coreParallelAlgos.h"
+#include "spatialQueryUtils.h"
+
+using namespace coral;
+using namespace spatialQueryUtils;
+
+namespace{
+	// ranges this small become leaves
+	const int leafSize = 4;
+	
+	// median splits keep the hierarchy within 32 levels for any int number of triangles,
+	// traversals hold at most one pending node per level.
+	const int maxStackSize = 128;
+	
+	struct BuildEntry{
+		GeoBvhTriangle triangle;
+		Imath::V3f centroid;
+	};
+	
+	class CentroidLess{
+	public:
+		CentroidLess(int axis): _axis(axis){
+		}
+		
+		bool operator() (const BuildEntry &a, const BuildEntry &b) const{
+			return a.centroid[_axis] < b.centroid[_axis];
+		}
+		
+	private:
+		int _axis;
+	};
+	
+	void extendBy(Imath::V3f &min, Imath::V3f &max, const Imath::V3f &point){
+		for(int axis = 0; axis < 3; ++axis){
+			if(point[axis] < min[axis]){
+				min[axis] = point[axis];
+			}
+			if(point[axis] > max[axis]){
+				max[axis] = point[axis];
+			}
+		}
+	}
+	
+	int buildNode(std::vector<GeoBvhNode> &nodes, BuildEntry *entries, int begin, int end){
+		int node = nodes.size();
+		nodes.push_back(GeoBvhNode());
+		
+		if(end - begin <= leafSize){
+			nodes[node].first = begin;
+			nodes[node].count = end - begin;
+			return node;
+		}
+		
+		// median split on the axis along which the centroids spread the most
+		Imath::V3f min = entries[begin].centroid;
+		Imath::V3f max = min;
+		for(int i = begin + 1; i < end; ++i){
+			extendBy(min, max, entries[i].centroid);
+		}
+		
+		Imath::V3f extent = max - min;
+		int axis = 0;
+		if(extent.y > extent[axis]){
+			axis = 1;
+		}
+		if(extent.z > extent[axis]){
+			axis = 2;
+		}
+		
+		int middle = begin + (end - begin) / 2;
+		std::nth_element(entries + begin, entries + middle, entries + end, CentroidLess(axis));
+		
+		buildNode(nodes, entries, begin, middle);
+		int second = buildNode(nodes, entries, middle, end);
+		
+		nodes[node].first = second;
+		nodes[node].count = 0;
+		
+		return node;
+	}
+	
+	float boxDistance2(const GeoBvhNode &node, const Imath::V3f &point){
+		float distance2 = 0.0;
+		for(int axis = 0; axis < 3; ++axis){
+			float gap = 0.0;
+			if(point[axis] < node.min[axis]){
+				gap = node.min[axis] - point[axis];
+			}
+			else if(point[axis] > node.max[axis]){
+				gap = point[axis] - node.max[axis];
+			}
+			
+			distance2 += gap * gap;
+		}
+		
+		return distance2;
+	}
+	
+	// closest point on triangle abc to point, from Ericson's Real-Time Collision Detection, 5.1.5
+	Imath::V3f closestPointOnTriangle(const Imath::V3f &point, const Imath::V3f &a, const Imath::V3f &b, const Imath::V3f &c, Imath::V3f &barycentric){
+		Imath::V3f ab = b - a;
+		Imath::V3f ac = c - a;
+		Imath::V3f ap = point - a;
+		float d1 = ab.dot(ap);
+		float d2 = ac.dot(ap);
+		if(d1 <= 0.0 && d2 <= 0.0){
+			barycentric.setValue(1.0, 0.0, 0.0);
+			return a;
+		}
+		
+		Imath::V3f bp = point - b;
+		float d3 = ab.dot(bp);
+		float d4 = ac.dot(bp);
+		if(d3 >= 0.0 && d4 <= d3){
+			barycentric.setValue(0.0, 1.0, 0.0);
+			return b;
+		}
+		
+		float vc = d1 * d4 - d3 * d2;
+		if(vc <= 0.0 && d1 >= 0.0 && d3 <= 0.0){
+			float v = d1 / (d1 - d3);
+			barycentric.setValue(1.0 - v, v, 0.0);
+			return a + ab * v;
+		}
+		
+		Imath::V3f cp = point - c;
+		float d5 = ab.dot(cp);
+		float d6 = ac.dot(cp);
+		if(d6 >= 0.0 && d5 <= d6){
+			barycentric.setValue(0.0, 0.0, 1.0);
+			return c;
+		}
+		
+		float vb = d5 * d2 - d1 * d6;
+		if(vb <= 0.0 && d2 >= 0.0 && d6 <= 0.0){
+			float w = d2 / (d2 - d6);
+			barycentric.setValue(1.0 - w, 0.0, w);
+			return a + ac * w;
+		}
+		
+		float va = d3 * d6 - d5 * d4;
+		if(va <= 0.0 && (d4 - d3) >= 0.0 && (d5 - d6) >= 0.0){
+			float w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+			barycentric.setValue(0.0, 1.0 - w, w);
+			return b + (c - b) * w;
+		}
+		
+		// degenerate triangles that fell through the edge regions
+		float sum = va + vb + vc;
+		if(sum <= 0.0){
+			barycentric.setValue(1.0, 0.0, 0.0);
+			return a;
+		}
+		
+		float v = vb / sum;
+		float w = vc / sum;
+		barycentric.setValue(1.0 - v - w, v, w);
+		return a + ab * v + ac * w;
+	}
+	
+	// Moller-Trumbore, hits both sides, t is in units of direction
+	bool intersectTriangle(const Imath::V3f &origin, const Imath::V3f &direction, const Imath::V3f &a, const Imath::V3f &b, const Imath::V3f &c, float &t, float &u, float &v){
+		Imath::V3f edge1 = b - a;
+		Imath::V3f edge2 = c - a;
+		Imath::V3f p = direction.cross(edge2);
+		float determinant = edge1.dot(p);
+		if(determinant == 0.0){
+			return false;
+		}
+		
+		float invDeterminant = 1.0 / determinant;
+		Imath::V3f toOrigin = origin - a;
+		u = toOrigin.dot(p) * invDeterminant;
+		if(u < 0.0 || u > 1.0){
+			return false;
+		}
+		
+		Imath::V3f q = toOrigin.cross(edge1);
+		v = direction.dot(q) * invDeterminant;
+		if(v < 0.0 || u + v > 1.0){
+			return false;
+		}
+		
+		t = edge2.dot(q) * invDeterminant;
+		return t >= 0.0;
+	}
+	
+	// distance along the ray at which it enters the box of node, false if it misses it before maxDistance
+	bool intersectBox(const GeoBvhNode &node, const Imath::V3f &origin, const Imath::V3f &invDirection, float maxDistance, float &distance){
+		float near = 0.0;
+		float far = maxDistance;
+		for(int axis = 0; axis < 3; ++axis){
+			float t1 = (node.min[axis] - origin[axis]) * invDirection[axis];
+			float t2 = (node.max[axis] - origin[axis]) * invDirection[axis];
+			if(t1 > t2){
+				std::swap(t1, t2);
+			}
+			
+			near = std::max(near, t1);
+			far = std::min(far, t2);
+			if(near > far){
+				return false;
+			}
+		}
+		
+		distance = near;
+		return true;
+	}
+	
+	class ClosestPointsBody{
+	public:
+		ClosestPointsBody(const GeoBvh &bvh, const Imath::V3f *queries, GeoBvhHit *hits): 
+			_bvh(bvh), _queries(queries), _hits(hits){
+		}
+		
+		void operator() (unsigned int begin, unsigned int end) const{
+			for(unsigned int i = begin; i < end; ++i){
+				_bvh.closestPoint(_queries[i], _hits[i]);
+			}
+		}
+		
+	private:
+		const GeoBvh &_bvh;
+		const Imath::V3f *_queries;
+		GeoBvhHit *_hits;
+	};
+	
+	class IntersectRaysBody{
+	public:
+		IntersectRaysBody(const GeoBvh &bvh, const Imath::V3f *origins, const Imath::V3f *directions, unsigned int directionsCount, float maxDistance, GeoBvhHit *hits): 
+			_bvh(bvh), _origins(origins), _directions(directions), _directionsCount(directionsCount), _maxDistance(maxDistance), _hits(hits){
+		}
+		
+		void operator() (unsigned int begin, unsigned int end) const{
+			for(unsigned int i = begin; i < end; ++i){
+				const Imath::V3f &direction = _directions[std::min(i, _directionsCount - 1)];
+				_bvh.intersectRay(_origins[i], direction, _maxDistance, _hits[i]);
+			}
+		}
+		
+	private:
+		const GeoBvh &_bvh;
+		const Imath::V3f *_origins;
+		const Imath::V3f *_directions;
+		unsigned int _directionsCount;
+		float _maxDistance;
+		GeoBvhHit *_hits;
+	};
+}
+
+GeoBvh::GeoBvh(){
+}
+
+void GeoBvh::build(const std::vector<Imath::V3f> &points, const std::vector<std::vector<int> > &faces){
+	int pointsCount = points.size();
+	
+	// polygons are split in fans around their first point, faces pointing outside the points are left out
+	std::vector<BuildEntry> entries;
+	for(int f = 0; f < faces.size(); ++f){
+		const std::vector<int> &face = faces[f];
+		bool valid = true;
+		for(int i = 0; i < face.size(); ++i){
+			if(face[i] < 0 || face[i] >= pointsCount){
+				valid = false;
+				break;
+			}
+		}
+		
+		if(!valid){
+			continue;
+		}
+		
+		for(int i = 1; i + 1 < (int)face.size(); ++i){
+			BuildEntry entry;
+			entry.triangle.points[0] = face[0];
+			entry.triangle.points[1] = face[i];
+			entry.triangle.points[2] = face[i + 1];
+			entry.triangle.face = f;
+			entry.centroid = (points[face[0]] + points[face[i]] + points[face[i + 1]]) / 3.0;
+			entries.push_back(entry);
+		}
+	}
+	
+	_nodes.clear();
+	if(entries.size()){
+		_nodes.reserve(2 * (entries.size() / leafSize + 1));
+		buildNode(_nodes, &entries[0], 0, entries.size());
+	}
+	
+	_triangles.resize(entries.size());
+	for(int i = 0; i < entries.size(); ++i){
+		_triangles[i] = entries[i].triangle;
+	}
+	
+	// the boxes are filled by the same pass that refits them
+	_points.clear();
+	refit(points);
+}
+
+void GeoBvh::refit(const std::vector<Imath::V3f> &points){
+	if(_points.size() && _points.size() != points.size()){
+		return;
+	}
+	
+	_points = points;
+	
+	// children always come after their parent, walking backwards refits them first
+	for(int i = (int)_nodes.size() - 1; i >= 0; --i){
+		GeoBvhNode &node = _nodes[i];
+		if(node.count){
+			const GeoBvhTriangle &firstTriangle = _triangles[node.first];
+			node.min = _points[firstTriangle.points[0]];
+			node.max = node.min;
+			for(int t = node.first; t < node.first + node.count; ++t){
+				const GeoBvhTriangle &triangle = _triangles[t];
+				extendBy(node.min, node.max, _points[triangle.points[0]]);
+				extendBy(node.min, node.max, _points[triangle.points[1]]);
+				extendBy(node.min, node.max, _points[triangle.points[2]]);
+			}
+		}
+		else{
+			const GeoBvhNode &first = _nodes[i + 1];
+			const GeoBvhNode &second = _nodes[node.first];
+			node.min = first.min;
+			node.max = first.max;
+			extendBy(node.min, node.max, second.min);
+			extendBy(node.min, node.max, second.max);
+		}
+	}
+}
+
+unsigned int GeoBvh::trianglesCount() const{
+	return _triangles.size();
+}
+
+size_t GeoBvh::sizeInBytes() const{
+	return _points.size() * sizeof(Imath::V3f) + _triangles.size() * sizeof(GeoBvhTriangle) + _nodes.size() * sizeof(GeoBvhNode);
+}
+
+bool GeoBvh::closestPoint(const Imath::V3f &point, GeoBvhHit &hit) const{
+	hit = GeoBvhHit();
+	if(_nodes.empty()){
+		return false;
+	}
+	
+	float best2 = std::numeric_limits<float>::max();
+	int stack[maxStackSize];
+	int stackSize = 0;
+	stack[stackSize++] = 0;
+	
+	while(stackSize){
+		const GeoBvhNode &node = _nodes[stack[--stackSize]];
+		if(boxDistance2(node, point) > best2){
+			continue;
+		}
+		
+		if(node.count){
+			for(int t = node.first; t < node.first + node.count; ++t){
+				const GeoBvhTriangle &triangle = _triangles[t];
+				Imath::V3f barycentric;
+				Imath::V3f closest = closestPointOnTriangle(point, _points[triangle.points[0]], _points[triangle.points[1]], _points[triangle.points[2]], barycentric);
+				
+				float distance2 = (closest - point).length2();
+				if(distance2 < best2 || (distance2 == best2 && triangle.face < hit.face)){
+					best2 = distance2;
+					hit.face = triangle.face;
+					hit.trianglePoints[0] = triangle.points[0];
+					hit.trianglePoints[1] = triangle.points[1];
+					hit.trianglePoints[2] = triangle.points[2];
+					hit.point = closest;
+					hit.barycentric = barycentric;
+				}
+			}
+			
+			continue;
+		}
+		
+		// the nearest child is pushed last so it's visited first
+		int first = &node - &_nodes[0] + 1;
+		int second = node.first;
+		float firstDistance2 = boxDistance2(_nodes[first], point);
+		float secondDistance2 = boxDistance2(_nodes[second], point);
+		if(firstDistance2 < secondDistance2){
+			std::swap(first, second);
+			std::swap(firstDistance2, secondDistance2);
+		}
+		
+		if(firstDistance2 <= best2){
+			stack[stackSize++] = first;
+		}
+		
+		if(secondDistance2 <= best2){
+			stack[stackSize++] = second;
+		}
+	}
+	
+	hit.distance = std::sqrt(best2);
+	return true;
+}
+
+bool GeoBvh::intersectRay(const Imath::V3f &origin, const Imath::V3f &direction, float maxDistance, GeoBvhHit &hit) const{
+	hit = GeoBvhHit();
+	if(_nodes.empty()){
+		return false;
+	}
+	
+	if(maxDistance <= 0.0){
+		maxDistance = std::numeric_limits<float>::max();
+	}
+	
+	// a zero component gives an infinite inverse, the slabs of that axis then either contain the ray or never do
+	Imath::V3f invDirection(1.0 / direction.x, 1.0 / direction.y, 1.0 / direction.z);
+	
+	float best = maxDistance;
+	int stack[maxStackSize];
+	int stackSize = 0;
+	
+	float distance;
+	stack[stackSize++] = 0;
+	
+	while(stackSize){
+		const GeoBvhNode &node = _nodes[stack[--stackSize]];
+		if(!intersectBox(node, origin, invDirection, best, distance)){
+			continue;
+		}
+		
+		if(node.count){
+			for(int t = node.first; t < node.first + node.count; ++t){
+				const GeoBvhTriangle &triangle = _triangles[t];
+				float triangleDistance, u, v;
+				if(intersectTriangle(origin, direction, _points[triangle.points[0]], _points[triangle.points[1]], _points[triangle.points[2]], triangleDistance, u, v)){
+					if(triangleDistance < best || (triangleDistance == best && (hit.face == -1 || triangle.face < hit.face))){
+						best = triangleDistance;
+						hit.face = triangle.face;
+						hit.trianglePoints[0] = triangle.points[0];
+						hit.trianglePoints[1] = triangle.points[1];
+						hit.trianglePoints[2] = triangle.points[2];
+						hit.barycentric.setValue(1.0 - u - v, u, v);
+					}
+				}
+			}
+			
+			continue;
+		}
+		
+		int first = &node - &_nodes[0] + 1;
+		int second = node.first;
+		float firstDistance, secondDistance;
+		bool firstHit = intersectBox(_nodes[first], origin, invDirection, best, firstDistance);
+		bool secondHit = intersectBox(_nodes[second], origin, invDirection, best, secondDistance);
+		if(firstHit && secondHit){
+			if(firstDistance < secondDistance){
+				std::swap(first, second);
+			}
+			
+			stack[stackSize++] = first;
+			stack[stackSize++] = second;
+		}
+		else if(firstHit){
+			stack[stackSize++] = first;
+		}
+		else if(secondHit){
+			stack[stackSize++] = second;
+		}
+	}
+	
+	if(hit.face == -1){
+		return false;
+	}
+	
+	hit.distance = best;
+	hit.point = origin + direction * best;
+	return true;
+}
+
+void GeoBvh::closestPoints(const Imath::V3f *queries, unsigned int queriesCount, GeoBvhHit *hits) const{
+	parallelFor(queriesCount, queriesGrainSize, ClosestPointsBody(*this, queries, hits));
+}
+
+void GeoBvh::intersectRays(const Imath::V3f *origins, unsigned int raysCount, const Imath::V3f *directions, unsigned int directionsCount, float maxDistance, GeoBvhHit *hits) const{
+	if(directionsCount == 0){
+		for(unsigned int i = 0; i < raysCount; ++i){
+			hits[i] = GeoBvhHit();
+		}
+		
+		return;
+	}
+	
+	parallelFor(raysCount, queriesGrainSize, IntersectRaysBody(*this, origins, directions, directionsCount, maxDistance, hits));
+}
@@ -0,0 +1,104 @@
+// <license>
+// Copyright (C) 2011 Andrea Interguglielmi, All rights reserved.
+// This file is part of the coral repository downloaded from http://code.google.com/p/coral-repo.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// 
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+// 
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+// IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// </license>
+
+#ifndef CORAL_GEOBVH_H
+#define CORAL_GEOBVH_H
+
+#include <vector>
+#include <ImathVec.h>
+#include "coralDefinitions.h"
+
+namespace coral{
+
+//! Where a query landed on a Geo, face is -1 if nothing was found.
+//! Polygons are split in triangle fans, barycentric weights the three points of the triangle that was found
+//! and trianglePoints are their ids in the points of the Geo.
+struct GeoBvhHit{
+	GeoBvhHit(): face(-1), distance(0.0){
+		trianglePoints[0] = -1;
+		trianglePoints[1] = -1;
+		trianglePoints[2] = -1;
+	}
+	
+	int face;
+	int trianglePoints[3];
+	Imath::V3f point;
+	Imath::V3f barycentric;
+	float distance;
+};
+
+struct GeoBvhTriangle{
+	int points[3];
+	int face;
+};
+
+//! A leaf holds count triangles starting at first,
+//! an inner node has count 0, its first child is the node right after it and the second is the node at first.
+struct GeoBvhNode{
+	Imath::V3f min;
+	Imath::V3f max;
+	int first;
+	int count;
+};
+
+//! Bounding volume hierarchy over the triangles of a Geo, stored as a flat array of nodes in depth first order.
+//! When only the points move the boxes are refitted in a single pass instead of rebuilding the hierarchy.
+//! Queries never modify the hierarchy and can run from any number of threads at once.
+class CORAL_EXPORT GeoBvh{
+public:
+	GeoBvh();
+	
+	//! Splits the faces in triangles and builds the hierarchy in O(n log n).
+	void build(const std::vector<Imath::V3f> &points, const std::vector<std::vector<int> > &faces);
+	
+	//! Moves the points keeping the hierarchy, points must match the ones given to build().
+	void refit(const std::vector<Imath::V3f> &points);
+	unsigned int trianglesCount() const;
+	size_t sizeInBytes() const;
+	
+	//! Closest point on the surface to point, returns false if there are no triangles.
+	bool closestPoint(const Imath::V3f &point, GeoBvhHit &hit) const;
+	
+	//! Closest intersection of the ray with the surface within maxDistance, both sides of the triangles are hit.
+	//! distance is measured in units of direction, which doesn't need to be normalized, a maxDistance of 0 or less means no limit.
+	bool intersectRay(const Imath::V3f &origin, const Imath::V3f &direction, float maxDistance, GeoBvhHit &hit) const;
+	
+	// batched queries, they run in parallel and write one hit per query.
+	// directions holds one direction per ray, or fewer in which case the last direction is used for the remaining rays.
+	void closestPoints(const Imath::V3f *queries, unsigned int queriesCount, GeoBvhHit *hits) const;
+	void intersectRays(const Imath::V3f *origins, unsigned int raysCount, const Imath::V3f *directions, unsigned int directionsCount, float maxDistance, GeoBvhHit *hits) const;
+	
+private:
+	std::vector<Imath::V3f> _points;
+	std::vector<GeoBvhTriangle> _triangles;
+	std::vector<GeoBvhNode> _nodes;
+};
+
+}
+
+#endif
@@ -0,0 +1,565 @@
+// <license>
+// Copyright (C) 2011 Andrea Interguglielmi, All rights reserved.
+// This file is part of the coral repository downloaded from http://code.google.com/p/coral-repo.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// 
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+// 
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+// IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// </license>
+
+#include <cmath>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "HashGrid.h"
+#include "hashUtils.h"
+#include "coreParallelAlgos.h"
+#include "spatialQueryUtils.h"
+
+namespace coral{
+
+struct HashGridCell{
+	int x;
+	int y;
+	int z;
+	
+	bool operator== (const HashGridCell &other) const{
+		return x == other.x && y == other.y && z == other.z;
+	}
+	
+	bool operator< (const HashGridCell &other) const{
+		if(z != other.z){
+			return z < other.z;
+		}
+		if(y != other.y){
+			return y < other.y;
+		}
+		
+		return x < other.x;
+	}
+};
+
+//! The points sorted by cell, the points of cell c are in [cellStarts[c], cellStarts[c + 1]).
+//! Only occupied cells are stored, table maps them by hash with open addressing, empty slots hold -1.
+class HashGridCells{
+public:
+	HashGridCells(): requestedCellSize(0.0), cellSize(0.0), invCellSize(0.0), mask(0){
+		lowCell.x = lowCell.y = lowCell.z = 0;
+		highCell = lowCell;
+		cellStarts.assign(1, 0);
+		table.assign(1, -1);
+	}
+	
+	float requestedCellSize;
+	float cellSize;
+	float invCellSize;
+	
+	//! Bounds of the occupied cells, queries never need to look outside of them.
+	HashGridCell lowCell;
+	HashGridCell highCell;
+	unsigned int mask;
+	std::vector<HashGridCell> cells;
+	std::vector<int> cellStarts;
+	std::vector<int> table;
+	std::vector<Imath::V3f> points;
+	std::vector<int> indices;
+};
+
+}
+
+using namespace coral;
+using namespace spatialQueryUtils;
+
+namespace{
+	// the cell size of a grid is raised until the cells of all its points are within this many cells of the origin,
+	// an int then holds any cell coordinate and the cells next to it.
+	const double maxCellCoordinate = 536870912.0;
+	
+	// relative to the magnitude of the query, well above float rounding
+	const float boxPadding = 1.0e-5;
+	
+	// only for the indexed points, build keeps their cell coordinates within maxCellCoordinate.
+	// Points that aren't finite only exist in a single cell grid, where they multiply the null invCellSize to NaN.
+	int cellCoordinate(float value, float invCellSize){
+		double coordinate = std::floor(double(value) * invCellSize);
+		if(coordinate != coordinate){
+			return 0;
+		}
+		
+		return int(coordinate);
+	}
+	
+	HashGridCell cellOf(const Imath::V3f &point, float invCellSize){
+		HashGridCell cell;
+		cell.x = cellCoordinate(point.x, invCellSize);
+		cell.y = cellCoordinate(point.y, invCellSize);
+		cell.z = cellCoordinate(point.z, invCellSize);
+		
+		return cell;
+	}
+	
+	// the cell of a query point may be arbitrarily far, there are no points beyond the occupied cells though
+	int clampedCellCoordinate(float value, float invCellSize, int low, int high){
+		double coordinate = std::floor(double(value) * invCellSize);
+		if(!(coordinate >= low)){
+			return low;
+		}
+		if(coordinate > high){
+			return high;
+		}
+		
+		return int(coordinate);
+	}
+	
+	HashGridCell clampedCellOf(const HashGridCells &cells, const Imath::V3f &point){
+		HashGridCell cell;
+		cell.x = clampedCellCoordinate(point.x, cells.invCellSize, cells.lowCell.x, cells.highCell.x);
+		cell.y = clampedCellCoordinate(point.y, cells.invCellSize, cells.lowCell.y, cells.highCell.y);
+		cell.z = clampedCellCoordinate(point.z, cells.invCellSize, cells.lowCell.z, cells.highCell.z);
+		
+		return cell;
+	}
+	
+	unsigned int bucketOf(const HashGridCell &cell, unsigned int mask){
+		return ((unsigned int)cell.x * 73856093u ^ (unsigned int)cell.y * 19349663u ^ (unsigned int)cell.z * 83492791u) & mask;
+	}
+	
+	int findCell(const HashGridCells &cells, const HashGridCell &cell){
+		unsigned int slot = bucketOf(cell, cells.mask);
+		while(cells.table[slot] != -1){
+			int id = cells.table[slot];
+			if(cells.cells[id] == cell){
+				return id;
+			}
+			
+			slot = (slot + 1) & cells.mask;
+		}
+		
+		return -1;
+	}
+	
+	// distance from value to the span of cell along one axis, a grid with no cell size has a single cell spanning everything
+	float cellGap(float value, int cell, float cellSize){
+		if(cellSize == 0.0){
+			return 0.0;
+		}
+		
+		float low = cell * cellSize;
+		if(value < low){
+			return low - value;
+		}
+		
+		float high = low + cellSize;
+		if(value > high){
+			return value - high;
+		}
+		
+		return 0.0;
+	}
+	
+	template<class Visitor>
+	void visitCell(const HashGridCells &cells, int id, const Imath::V3f &point, float range2, int skip, Visitor &visitor){
+		const Imath::V3f *points = &cells.points[0];
+		int end = cells.cellStarts[id + 1];
+		for(int i = cells.cellStarts[id]; i < end; ++i){
+			if(i != skip && (points[i] - point).length2() <= range2){
+				visitor(i);
+			}
+		}
+	}
+	
+	// calls visitor with the sorted position of every point within range of point, except the one at skip
+	template<class Visitor>
+	void visitPointsInRange(const HashGridCells &cells, const Imath::V3f &point, float range, int skip, Visitor &visitor){
+		float range2 = range * range;
+		float cellSize = cells.cellSize;
+		
+		// the box of cells is padded so that rounding can't leave out a point right at the range
+		float magnitude = std::max(std::fabs(point.x), std::max(std::fabs(point.y), std::fabs(point.z)));
+		float extent = range + (range + magnitude) * boxPadding;
+		float extent2 = extent * extent;
+		HashGridCell low = clampedCellOf(cells, point - Imath::V3f(extent));
+		HashGridCell high = clampedCellOf(cells, point + Imath::V3f(extent));
+		
+		// a range much larger than the cells would look up more cells than there are occupied ones
+		int cellsCount = cells.cells.size();
+		double boxCells = (double(high.x) - low.x + 1.0) * (double(high.y) - low.y + 1.0) * (double(high.z) - low.z + 1.0);
+		if(boxCells >= cellsCount){
+			for(int id = 0; id < cellsCount; ++id){
+				const HashGridCell &cell = cells.cells[id];
+				float gapX = cellGap(point.x, cell.x, cellSize);
+				float gapY = cellGap(point.y, cell.y, cellSize);
+				float gapZ = cellGap(point.z, cell.z, cellSize);
+				if(gapX * gapX + gapY * gapY + gapZ * gapZ <= extent2){
+					visitCell(cells, id, point, range2, skip, visitor);
+				}
+			}
+			
+			return;
+		}
+		
+		// cells entirely out of range are skipped without being looked up
+		HashGridCell cell;
+		for(cell.z = low.z; cell.z <= high.z; ++cell.z){
+			float gapZ = cellGap(point.z, cell.z, cellSize);
+			float gap2Z = gapZ * gapZ;
+			
+			for(cell.y = low.y; cell.y <= high.y; ++cell.y){
+				float gapY = cellGap(point.y, cell.y, cellSize);
+				float gap2ZY = gap2Z + gapY * gapY;
+				if(gap2ZY > extent2){
+					continue;
+				}
+				
+				for(cell.x = low.x; cell.x <= high.x; ++cell.x){
+					float gapX = cellGap(point.x, cell.x, cellSize);
+					if(gap2ZY + gapX * gapX > extent2){
+						continue;
+					}
+					
+					int id = findCell(cells, cell);
+					if(id != -1){
+						visitCell(cells, id, point, range2, skip, visitor);
+					}
+				}
+			}
+		}
+	}
+	
+	struct BuildEntry{
+		HashGridCell cell;
+		int index;
+		
+		bool operator< (const BuildEntry &other) const{
+			if(cell == other.cell){
+				return index < other.index;
+			}
+			
+			return cell < other.cell;
+		}
+	};
+	
+	class BuildEntriesBody{
+	public:
+		BuildEntriesBody(const Imath::V3f *points, float invCellSize, BuildEntry *entries): 
+			_points(points), _invCellSize(invCellSize), _entries(entries){
+		}
+		
+		void operator() (unsigned int begin, unsigned int end) const{
+			for(unsigned int i = begin; i < end; ++i){
+				_entries[i].cell = cellOf(_points[i], _invCellSize);
+				_entries[i].index = i;
+			}
+		}
+		
+	private:
+		const Imath::V3f *_points;
+		float _invCellSize;
+		BuildEntry *_entries;
+	};
+	
+	class CountPointsInRangeBody{
+	public:
+		CountPointsInRangeBody(const HashGridCells &cells, const Imath::V3f *queries, const float *ranges, unsigned int rangesCount, int *counts): 
+			_cells(cells), _queries(queries), _ranges(ranges), _rangesCount(rangesCount), _counts(counts){
+		}
+		
+		void operator() (unsigned int begin, unsigned int end) const{
+			for(unsigned int i = begin; i < end; ++i){
+				CountVisitor visitor;
+				visitPointsInRange(_cells, _queries[i], queryRange(_ranges, _rangesCount, i), -1, visitor);
+				_counts[i] = visitor.count;
+			}
+		}
+		
+	private:
+		const HashGridCells &_cells;
+		const Imath::V3f *_queries;
+		const float *_ranges;
+		unsigned int _rangesCount;
+		int *_counts;
+	};
+	
+	class PointsInRangeBody{
+	public:
+		PointsInRangeBody(const HashGridCells &cells, const Imath::V3f *queries, const float *ranges, unsigned int rangesCount, const int *offsets, int *results): 
+			_cells(cells), _queries(queries), _ranges(ranges), _rangesCount(rangesCount), _offsets(offsets), _results(results){
+		}
+		
+		void operator() (unsigned int begin, unsigned int end) const{
+			for(unsigned int i = begin; i < end; ++i){
+				WriteVisitor visitor(&_cells.indices[0], _results + _offsets[i]);
+				visitPointsInRange(_cells, _queries[i], queryRange(_ranges, _rangesCount, i), -1, visitor);
+			}
+		}
+		
+	private:
+		const HashGridCells &_cells;
+		const Imath::V3f *_queries;
+		const float *_ranges;
+		unsigned int _rangesCount;
+		const int *_offsets;
+		int *_results;
+	};
+	
+	// pairs are found walking the points in cell order, consecutive points then look up the same cells
+	class CountPairsInRangeBody{
+	public:
+		CountPairsInRangeBody(const HashGridCells &cells, float range, int *counts): 
+			_cells(cells), _range(range), _counts(counts){
+		}
+		
+		void operator() (unsigned int begin, unsigned int end) const{
+			for(unsigned int i = begin; i < end; ++i){
+				CountVisitor visitor;
+				visitPointsInRange(_cells, _cells.points[i], _range, i, visitor);
+				_counts[_cells.indices[i]] = visitor.count;
+			}
+		}
+		
+	private:
+		const HashGridCells &_cells;
+		float _range;
+		int *_counts;
+	};
+	
+	class PairsInRangeBody{
+	public:
+		PairsInRangeBody(const HashGridCells &cells, float range, const int *offsets, int *results): 
+			_cells(cells), _range(range), _offsets(offsets), _results(results){
+		}
+		
+		void operator() (unsigned int begin, unsigned int end) const{
+			for(unsigned int i = begin; i < end; ++i){
+				WriteVisitor visitor(&_cells.indices[0], _results + _offsets[_cells.indices[i]]);
+				visitPointsInRange(_cells, _cells.points[i], _range, i, visitor);
+			}
+		}
+		
+	private:
+		const HashGridCells &_cells;
+		float _range;
+		const int *_offsets;
+		int *_results;
+	};
+}
+
+HashGrid::HashGrid():
+	_points(new std::vector<Imath::V3f>()),
+	_cells(new HashGridCells()),
+	_hash(hashUtils::hashValue(0.0f, hashUtils::hashVector(std::vector<Imath::V3f>()))){
+}
+
+void HashGrid::copy(const Value *other){
+	const HashGrid *otherGrid = dynamic_cast<const HashGrid*>(other);
+	if(otherGrid){
+		_points = otherGrid->_points;
+		_cells = otherGrid->_cells;
+		_hash = otherGrid->_hash;
+	}
+}
+
+bool HashGrid::build(const std::vector<Imath::V3f> &points, float cellSize){
+	if(!(cellSize > 0.0)){
+		cellSize = 0.0;
+	}
+	
+	if(_cells->requestedCellSize == cellSize && _points->size() == points.size()){
+		if(points.empty() || memcmp(&(*_points)[0], &points[0], points.size() * sizeof(Imath::V3f)) == 0){
+			return false;
+		}
+	}
+	
+	int size = points.size();
+	
+	// cells too small for the extent of the points would overflow their coordinates, the smallest size that fits is used instead
+	float gridCellSize = cellSize;
+	if(gridCellSize > 0.0){
+		float magnitude = 0.0;
+		bool finite = true;
+		for(int i = 0; i < size && finite; ++i){
+			for(int axis = 0; axis < 3; ++axis){
+				float value = std::fabs(points[i][axis]);
+				if(!(value <= std::numeric_limits<float>::max())){
+					finite = false;
+				}
+				else if(value > magnitude){
+					magnitude = value;
+				}
+			}
+		}
+		
+		if(!finite){
+			gridCellSize = 0.0;
+		}
+		else if(magnitude / gridCellSize > maxCellCoordinate / 2.0){
+			gridCellSize = float(magnitude / (maxCellCoordinate / 2.0));
+		}
+	}
+	
+	float invCellSize = 0.0;
+	if(gridCellSize > 0.0){
+		invCellSize = 1.0 / gridCellSize;
+	}
+	
+	// the cells may be shared with copies, they are replaced rather than rebuilt in place
+	boost::shared_ptr<std::vector<Imath::V3f> > newPoints(new std::vector<Imath::V3f>(points));
+	boost::shared_ptr<HashGridCells> cells(new HashGridCells());
+	cells->requestedCellSize = cellSize;
+	cells->cellSize = gridCellSize;
+	cells->invCellSize = invCellSize;
+	cells->points.resize(size);
+	cells->indices.resize(size);
+	cells->cellStarts.clear();
+	
+	// sorting by cell stores each cell as one run of points, and neighbouring cells close to each other
+	std::vector<BuildEntry> entries(size);
+	if(size){
+		parallelFor(size, BuildEntriesBody(&points[0], invCellSize, &entries[0]));
+	}
+	std::sort(entries.begin(), entries.end());
+	
+	for(int i = 0; i < size; ++i){
+		if(i == 0 || !(entries[i].cell == entries[i - 1].cell)){
+			cells->cells.push_back(entries[i].cell);
+			cells->cellStarts.push_back(i);
+		}
+		
+		cells->points[i] = points[entries[i].index];
+		cells->indices[i] = entries[i].index;
+	}
+	cells->cellStarts.push_back(size);
+	
+	for(unsigned int id = 0; id < cells->cells.size(); ++id){
+		const HashGridCell &cell = cells->cells[id];
+		if(id == 0){
+			cells->lowCell = cell;
+			cells->highCell = cell;
+		}
+		else{
+			cells->lowCell.x = std::min(cells->lowCell.x, cell.x);
+			cells->lowCell.y = std::min(cells->lowCell.y, cell.y);
+			cells->lowCell.z = std::min(cells->lowCell.z, cell.z);
+			cells->highCell.x = std::max(cells->highCell.x, cell.x);
+			cells->highCell.y = std::max(cells->highCell.y, cell.y);
+			cells->highCell.z = std::max(cells->highCell.z, cell.z);
+		}
+	}
+	
+	// twice as many slots as cells keeps the probe sequences short
+	unsigned int cellsCount = cells->cells.size();
+	unsigned int slotsCount = 1;
+	while(slotsCount < cellsCount * 2){
+		slotsCount *= 2;
+	}
+	
+	cells->mask = slotsCount - 1;
+	cells->table.assign(slotsCount, -1);
+	for(unsigned int id = 0; id < cellsCount; ++id){
+		unsigned int slot = bucketOf(cells->cells[id], cells->mask);
+		while(cells->table[slot] != -1){
+			slot = (slot + 1) & cells->mask;
+		}
+		
+		cells->table[slot] = id;
+	}
+	
+	_points = newPoints;
+	_cells = cells;
+	_hash = hashUtils::hashValue(cellSize, hashUtils::hashVector(points));
+	
+	return true;
+}
+
+const std::vector<Imath::V3f> &HashGrid::points(){
+	return *_points;
+}
+
+unsigned int HashGrid::size(){
+	return _points->size();
+}
+
+float HashGrid::cellSize(){
+	return _cells->cellSize;
+}
+
+void HashGrid::pointsInRange(const Imath::V3f &point, float range, std::vector<int> &indices){
+	indices.clear();
+	if(_cells->points.empty()){
+		return;
+	}
+	
+	AppendVisitor visitor(&_cells->indices[0], indices);
+	visitPointsInRange(*_cells, point, range, -1, visitor);
+}
+
+void HashGrid::pointsInRange(const Imath::V3f *queries, unsigned int queriesCount, const float *ranges, unsigned int rangesCount, std::vector<int> &offsets, std::vector<int> &results){
+	offsets.assign(queriesCount + 1, 0);
+	results.clear();
+	if(queriesCount == 0 || rangesCount == 0 || _cells->points.empty()){
+		return;
+	}
+	
+	parallelFor(queriesCount, queriesGrainSize, CountPointsInRangeBody(*_cells, queries, ranges, rangesCount, &offsets[1]));
+	accumulateOffsets(offsets);
+	
+	results.resize(offsets[queriesCount]);
+	if(results.size()){
+		parallelFor(queriesCount, queriesGrainSize, PointsInRangeBody(*_cells, queries, ranges, rangesCount, &offsets[0], &results[0]));
+	}
+}
+
+void HashGrid::pairsInRange(float range, std::vector<int> &offsets, std::vector<int> &results){
+	unsigned int size = _cells->points.size();
+	offsets.assign(size + 1, 0);
+	results.clear();
+	if(size == 0){
+		return;
+	}
+	
+	if(range < 0.0){
+		range = 0.0;
+	}
+	
+	parallelFor(size, queriesGrainSize, CountPairsInRangeBody(*_cells, range, &offsets[1]));
+	accumulateOffsets(offsets);
+	
+	results.resize(offsets[size]);
+	if(results.size()){
+		parallelFor(size, queriesGrainSize, PairsInRangeBody(*_cells, range, &offsets[0], &results[0]));
+	}
+}
+
+size_t HashGrid::sizeInBytes(){
+	size_t size = _points->size();
+	return size * (2 * sizeof(Imath::V3f) + sizeof(int)) + 
+		_cells->cells.size() * (sizeof(HashGridCell) + sizeof(int)) + _cells->table.size() * sizeof(int);
+}
+
+bool HashGrid::isHashable(){
+	return true;
+}
+
+hashUtils::Hash HashGrid::hash(){
+	return _hash;
+}
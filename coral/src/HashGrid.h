@@ -0,0 +1,88 @@
+// <license>
+// Copyright (C) 2011 Andrea Interguglielmi, All rights reserved.
+// This file is part of the coral repository downloaded from http://code.google.com/p/coral-repo.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// 
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+// 
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+// IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// </license>
+
+#ifndef CORAL_HASHGRID_H
+#define CORAL_HASHGRID_H
+
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include <ImathVec.h>
+#include "Value.h"
+
+namespace coral{
+
+class HashGridCells;
+
+//! Uniform grid of cubic cells over a set of points, stored as a spatial hash so that only occupied cells take memory.
+//! Meant for fixed radius queries where the radius is known in advance: with a cell size close to the radius
+//! a query only visits the 27 cells around it, no matter how many points there are.
+//! Built once by a BuildHashGrid node and shared by any number of query nodes, like SpatialIndex.
+//! Results are the indices of the points in the array the grid was built from.
+class CORAL_EXPORT HashGrid: public Value{
+public:
+	HashGrid();
+	
+	//! Shares the cells of other, no data is copied.
+	void copy(const Value *other);
+	
+	//! Sorts the given points into cells of cellSize, the grid is left untouched if they are the same points and cell size already indexed.
+	//! A cellSize that is not positive puts all the points in a single cell, one too small for the extent of the points
+	//! (more than 2^28 cells from the origin) is raised to the smallest size that fits, see cellSize().
+	//! Returns true if the grid was rebuilt.
+	bool build(const std::vector<Imath::V3f> &points, float cellSize);
+	const std::vector<Imath::V3f> &points();
+	unsigned int size();
+	
+	//! The size of the cells actually used, which can be larger than the one given to build.
+	float cellSize();
+	
+	//! Fills indices with the points within range of point, in no particular order.
+	void pointsInRange(const Imath::V3f &point, float range, std::vector<int> &indices);
+	
+	//! Finds the points within range of each query in parallel.
+	//! ranges holds one range per query, or fewer in which case the last range is used for the remaining queries.
+	//! The points found for query i are written to results starting at offsets[i], offsets gets queriesCount + 1 elements.
+	void pointsInRange(const Imath::V3f *queries, unsigned int queriesCount, const float *ranges, unsigned int rangesCount, std::vector<int> &offsets, std::vector<int> &results);
+	
+	//! Finds, for each indexed point, the other indexed points within range of it, in parallel.
+	//! The neighbours of point i are written to results starting at offsets[i], offsets gets size() + 1 elements.
+	void pairsInRange(float range, std::vector<int> &offsets, std::vector<int> &results);
+	
+	size_t sizeInBytes();
+	bool isHashable();
+	hashUtils::Hash hash();
+	
+private:
+	boost::shared_ptr<std::vector<Imath::V3f> > _points;
+	boost::shared_ptr<HashGridCells> _cells;
+	hashUtils::Hash _hash;
+};
+
+}
+
+#endif
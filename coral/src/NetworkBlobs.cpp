@@ -0,0 +1,224 @@
+// <license>
+// Copyright (C) 2011 Andrea Interguglielmi, All rights reserved.
+// This file is part of the coral repository downloaded from http://code.google.com/p/coral-repo.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// 
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+// 
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+// IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// </license>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include "NetworkBlobs.h"
+#include "ChunkedArray.h"
+#include "hashUtils.h"
+
+using namespace coral;
+
+namespace{
+	std::string _filename;
+	std::string _saveId;
+	std::ofstream _file;
+	bool _saving = false;
+	bool _fileCreated = false;
+	std::size_t _position = 0;
+	std::size_t _blobThreshold = 4096;
+	
+	const char _magic[8] = {'C', 'O', 'R', 'A', 'L', 'B', 'L', 'B'};
+	
+	enum{
+		saveIdLength = 16
+	};
+	
+	// ids only need to tell the saves of a network apart, 
+	// the clock and a counter are hashed with the address of a fresh allocation to tell apart processes saving at the same time.
+	std::string newSaveId(const std::string &filename){
+		static unsigned int saves = 0;
+		
+		boost::posix_time::ptime now = boost::posix_time::microsec_clock::universal_time();
+		hashUtils::Hash hash = hashUtils::hashValue((now - boost::posix_time::ptime(boost::gregorian::date(1970, 1, 1))).total_microseconds());
+		hash = hashUtils::hashValue(++saves, hash);
+		hash = hashUtils::hashString(filename, hash);
+		
+		char *allocation = new char;
+		hash = hashUtils::hashValue(allocation, hash);
+		delete allocation;
+		
+		hash = hashUtils::mixWord(hash);
+		
+		static const char digits[] = "0123456789abcdef";
+		std::string id(saveIdLength, '0');
+		for(int i = 0; i < saveIdLength; ++i){
+			id[i] = digits[(hash >> (i * 4)) & 15];
+		}
+		
+		return id;
+	}
+	
+	std::string readHeader(std::ifstream &file){
+		char magic[sizeof(_magic)];
+		unsigned int fileVersion = 0;
+		char id[saveIdLength];
+		file.read(magic, sizeof(magic));
+		file.read((char*)&fileVersion, sizeof(fileVersion));
+		file.read(id, sizeof(id));
+		
+		if(file.good() && std::memcmp(magic, _magic, sizeof(_magic)) == 0 && fileVersion == NetworkBlobs::version){
+			return std::string(id, sizeof(id));
+		}
+		
+		return std::string();
+	}
+}
+
+bool NetworkBlobs::beginSave(const std::string &filename){
+	if(_saving){
+		return false;
+	}
+	
+	_saveId = newSaveId(filename);
+	
+	std::string::size_type separator = filename.find_last_of("/\\");
+	std::string::size_type extension = filename.find_last_of('.');
+	if(extension == std::string::npos || (separator != std::string::npos && extension < separator)){
+		_filename = filename + "." + _saveId;
+	}
+	else{
+		_filename = filename.substr(0, extension) + "." + _saveId + filename.substr(extension);
+	}
+	
+	_saving = true;
+	_fileCreated = false;
+	_position = 0;
+	
+	return true;
+}
+
+bool NetworkBlobs::endSave(){
+	if(!_saving){
+		return false;
+	}
+	
+	_saving = false;
+	if(!_fileCreated){
+		return true;
+	}
+	
+	bool success = _file.is_open() && _file.good();
+	_file.close();
+	
+	// no script will reference a partial file
+	if(!success){
+		std::remove(_filename.c_str());
+	}
+	
+	return success;
+}
+
+bool NetworkBlobs::isSaving(){
+	return _saving;
+}
+
+std::string NetworkBlobs::saveId(){
+	return _saveId;
+}
+
+std::string NetworkBlobs::blobFilename(){
+	std::string::size_type separator = _filename.find_last_of("/\\");
+	if(separator == std::string::npos){
+		return _filename;
+	}
+	
+	return _filename.substr(separator + 1);
+}
+
+std::size_t NetworkBlobs::blobThreshold(){
+	return _blobThreshold;
+}
+
+void NetworkBlobs::setBlobThreshold(std::size_t bytes){
+	_blobThreshold = bytes;
+}
+
+std::size_t NetworkBlobs::beginBlob(){
+	static const char padding[blobAlignment] = {0};
+	
+	if(!_fileCreated){
+		_fileCreated = true;
+		_file.clear();
+		_file.open(_filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+		
+		unsigned int fileVersion = version;
+		write(_magic, sizeof(_magic));
+		write(&fileVersion, sizeof(fileVersion));
+		write(_saveId.data(), saveIdLength);
+	}
+	
+	std::size_t misalignment = _position % blobAlignment;
+	if(misalignment){
+		write(padding, blobAlignment - misalignment);
+	}
+	
+	return _position;
+}
+
+void NetworkBlobs::write(const void *data, std::size_t size){
+	if(size){
+		_file.write((const char*)data, size);
+		_position += size;
+	}
+}
+
+std::string NetworkBlobs::fileId(const std::string &filename){
+	std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+	if(!file.is_open()){
+		return std::string();
+	}
+	
+	return readHeader(file);
+}
+
+bool NetworkBlobs::contains(const std::string &filename, std::size_t offset, std::size_t size){
+	std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+	if(!file.is_open() || readHeader(file).empty()){
+		return false;
+	}
+	
+	file.seekg(0, std::ios::end);
+	std::size_t fileSize = file.tellg();
+	
+	// blobs never overlap the header
+	return offset >= blobAlignment && offset <= fileSize && size <= fileSize - offset;
+}
+
+boost::shared_ptr<Chunk> NetworkBlobs::map(const std::string &filename, std::size_t offset, std::size_t size){
+	if(!contains(filename, offset, size)){
+		return boost::shared_ptr<Chunk>();
+	}
+	
+	MappedFileChunkSource source(filename);
+	
+	return source.mapBytes(offset, size);
+}
@@ -0,0 +1,91 @@
+// <license>
+// Copyright (C) 2011 Andrea Interguglielmi, All rights reserved.
+// This file is part of the coral repository downloaded from http://code.google.com/p/coral-repo.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// 
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+// 
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+// IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// </license>
+
+#ifndef CORAL_NETWORKBLOBS_H
+#define CORAL_NETWORKBLOBS_H
+
+#include <string>
+#include <cstddef>
+#include <boost/shared_ptr.hpp>
+
+#include "coralDefinitions.h"
+
+namespace coral{
+
+class Chunk;
+
+//! Binary sidecar file storing the large values of a saved network.
+//! While a save is in progress Attribute::asScript() hands the values bigger than blobThreshold() to Value::writeBlob(), 
+//! the save script then only references the blobs with a SetAttributeBlob command and Value::readBlob() adopts them at load time.
+//! Blobs are aligned to blobAlignment bytes so that they can be memory mapped in place.
+//! The file starts with a header of blobAlignment bytes holding a magic number, the format version and the id of the save, 
+//! loading checks it before mapping anything.
+//! Every save writes a new file named after its id, so the file of a loaded network is never overwritten while its blobs are mapped.
+class CORAL_EXPORT NetworkBlobs{
+public:
+	enum{
+		blobAlignment = 64,
+		version = 2
+	};
+	
+	//! Starts a save with a new saveId(), blobs go to filename with the id inserted before the extension, 
+	//! e.g. network.blobs becomes network.<saveId>.blobs.
+	//! The file is only created by the first beginBlob(), a network without large values gets no blob file.
+	static bool beginSave(const std::string &filename);
+	
+	//! Ends the save started by beginSave(), returns false if the blob file couldn't be written, it is then removed.
+	static bool endSave();
+	static bool isSaving();
+	
+	//! Id of the current or last save, written in the header of its blob file and in the save script referencing it.
+	static std::string saveId();
+	
+	//! Name of the blob file of the current or last save without its directory, as referenced by the save script.
+	static std::string blobFilename();
+	
+	//! Returns the save id stored in the header of filename, or an empty string if it isn't a valid blob file.
+	static std::string fileId(const std::string &filename);
+	
+	//! Values smaller than this number of bytes are still saved as strings.
+	static std::size_t blobThreshold();
+	static void setBlobThreshold(std::size_t bytes);
+	
+	//! Starts a new blob in the file being saved and returns its offset, the data of the blob is then appended with write().
+	static std::size_t beginBlob();
+	static void write(const void *data, std::size_t size);
+	
+	//! Returns true if filename is a blob file with a valid header that holds the size bytes starting at offset.
+	static bool contains(const std::string &filename, std::size_t offset, std::size_t size);
+	
+	//! Maps size bytes of a blob file starting at offset, returns NULL if contains() is false for this range.
+	static boost::shared_ptr<Chunk> map(const std::string &filename, std::size_t offset, std::size_t size);
+};
+
+}
+
+#endif
@@ -26,19 +26,21 @@
 // SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // </license>
 
-#include <sys/stat.h>
+#ifdef CORAL_PARALLEL_TBB
+	#include <tbb/task_group.h>
+	#include <tbb/atomic.h>
+	#include "coreParallelAlgos.h"
+#endif
 
-#include <boost/graph/adjacency_list.hpp>
-#include <boost/graph/graph_traits.hpp>
-#include <boost/graph/subgraph.hpp>
-#include <boost/graph/depth_first_search.hpp>
-#include <boost/graph/reverse_graph.hpp>
-#include <boost/graph/topological_sort.hpp>
+#include <sys/stat.h>
+#include <stdexcept>
 
 #include "NetworkManager.h"
+#include "DependencyGraph.h"
 #include "Node.h"
 #include "Attribute.h"
 #include "ErrorObject.h"
+#include "EvaluationContext.h"
 #include "containerUtils.h"
 #include "stringUtils.h"
 
@@ -50,14 +52,62 @@
 
 using namespace coral;
 
-typedef boost::adjacency_list<boost::vecS, boost::vecS, boost::bidirectionalS> Graph;
-typedef boost::graph_traits<Graph>::vertex_descriptor GraphVertex;
-
-Graph _graph;
+namespace{
+	// objects live in a dense table indexed by the low bits of their id, the high bits hold the generation of the slot.
+	// A slot's generation is bumped each time it's freed, so that ids of deleted objects never resolve to the object reusing it,
+	// a slot whose generation ran out is retired rather than wrapped around.
+	// Slot indices double as vertex ids in _graph.
+	const int objectSlotBits = 24;
+	const int objectSlotMask = (1 << objectSlotBits) - 1;
+	const int objectGenerationMask = 127; // ids stay positive ints.
+	
+	struct ObjectSlot{
+		Object *object;
+		int generation;
+	};
+	
+	std::vector<ObjectSlot> _objectSlots;
+	std::vector<int> _freeObjectSlots;
+	int _objectCount = 0;
+	
+	inline int slotFromId(int id){
+		return id & objectSlotMask;
+	}
+	
+	inline Object *objectAtSlot(int slot){
+		Object *object = 0;
+		if(slot < _objectSlots.size()){
+			object = _objectSlots[slot].object;
+		}
+		
+		return object;
+	}
+	
+	DependencyGraph _graph;
+	
+	void attributesToSlots(const std::vector<Attribute*> &attributes, std::vector<int> &slots){
+		slots.resize(attributes.size());
+		for(int i = 0; i < attributes.size(); ++i){
+			slots[i] = slotFromId(attributes[i]->id());
+		}
+	}
+	
+	void slotsToAttributes(const std::vector<int> &slots, std::vector<Attribute*> &attributes){
+		attributes.resize(slots.size());
+		for(int i = 0; i < slots.size(); ++i){
+			attributes[i] = (Attribute*)objectAtSlot(slots[i]);
+		}
+	}
+}
 
-int NetworkManager::_nextAvailableId = 0;
-std::map<int, Object *> NetworkManager::_objectsById;
 std::vector<std::string> NetworkManager::_searchPaths;
+int NetworkManager::_batchDepth = 0;
+std::vector<int> NetworkManager::_batchedEdgeSources;
+std::vector<int> NetworkManager::_batchedEdgeDestinations;
+std::vector<std::pair<int, int> > NetworkManager::_batchedConnections;
+std::vector<std::pair<int, int> > NetworkManager::_failedBatchConnections;
+std::map<int, bool> NetworkManager::_batchedSpecializations;
+std::set<int> NetworkManager::_batchedDirty;
 
 namespace {
 	int fileExist(const std::string &filename){
@@ -66,57 +116,34 @@ namespace {
 	}
 }
 
-class DownstreamVisitor : public boost::default_dfs_visitor{
-public:
-	void discover_vertex(GraphVertex v, const Graph& g){
-		Attribute *attr = (Attribute*)NetworkManager::findObjectById(v);
-		
-		collectedAttributes->push_back(attr);
-	}
-	
-	std::vector<Attribute*> *collectedAttributes;
-};
-
-class UpstreamVisitor : public boost::default_dfs_visitor{
-public:
-	void finish_vertex(GraphVertex v, const boost::reverse_graph<Graph>& g){
-		Attribute *attr = (Attribute*)NetworkManager::findObjectById(v);
-		collectedAttributes->push_back(attr);
-	}
-	
-	std::vector<Attribute*> *collectedAttributes;
-};
-
 void NetworkManager::getDownstreamChain(Attribute *attribute, std::vector<Attribute*> &downstreamChain){
-	downstreamChain.clear();
+	std::vector<Attribute*> attributes(1, attribute);
+	getDownstreamChain(attributes, downstreamChain);
+}
+
+void NetworkManager::getDownstreamChain(const std::vector<Attribute*> &attributes, std::vector<Attribute*> &downstreamChain){
+	std::vector<int> slots;
+	attributesToSlots(attributes, slots);
 	
-	int nvertices = boost::num_vertices(_graph);
+	std::vector<int> collectedSlots;
+	_graph.collectDownstream(slots, collectedSlots);
 	
-	if(nvertices){
-		DownstreamVisitor visitor;
-		visitor.collectedAttributes = &downstreamChain;
-		
-
-		std::vector<boost::default_color_type> color_map(nvertices);
-		boost::depth_first_visit(_graph, boost::vertex(attribute->id(), _graph), visitor, 
-			boost::make_iterator_property_map(color_map.begin(), boost::get(boost::vertex_index, _graph), color_map[0]));
-	}
+	slotsToAttributes(collectedSlots, downstreamChain);
 }
 
 void NetworkManager::getUpstreamChain(Attribute *attribute, std::vector<Attribute*> &upstreamChain){
-	upstreamChain.clear();
+	std::vector<Attribute*> attributes(1, attribute);
+	getUpstreamChain(attributes, upstreamChain);
+}
+
+void NetworkManager::getUpstreamChain(const std::vector<Attribute*> &attributes, std::vector<Attribute*> &upstreamChain){
+	std::vector<int> slots;
+	attributesToSlots(attributes, slots);
 	
-	int nvertices = boost::num_vertices(_graph);
+	std::vector<int> collectedSlots;
+	_graph.collectUpstream(slots, collectedSlots);
 	
-	if(nvertices){
-		UpstreamVisitor visitor;
-		visitor.collectedAttributes = &upstreamChain;
-		
-		std::vector<boost::default_color_type> color_map(nvertices);
-		boost::reverse_graph<Graph> reverseGraph(_graph);
-		boost::depth_first_visit(reverseGraph, boost::vertex(attribute->id(), _graph), visitor, 
-			boost::make_iterator_property_map(color_map.begin(), boost::get(boost::vertex_index, _graph), color_map[0]));
-	}
+	slotsToAttributes(collectedSlots, upstreamChain);
 }
 
 void NetworkManager::collectParentNodeConnectedInputs(Attribute *attribute, Node *parentNode, std::vector<Attribute*> &attributes){
@@ -131,97 +158,350 @@ void NetworkManager::collectParentNodeConnectedInputs(Attribute *attribute, Node
 	}
 }
 
-void NetworkManager::getCleanChain(Attribute *attribute, std::map<int, std::vector<Attribute*> > &cleanChain, std::map<int, std::vector<Attribute*> > &affectedInputs){
-	Node *startContainerNode = attribute->parent();
-	if(startContainerNode){
-		startContainerNode = startContainerNode->parent();
-	}
-
+void NetworkManager::getCleanChain(Attribute *attribute, std::vector<CleanTask> &cleanChain){
 	std::vector<Attribute*> attributes;
 	getUpstreamChain(attribute, attributes);
 	
 	cleanChain.clear();
-	affectedInputs.clear();
 	
-	int nvertices = boost::num_vertices(_graph);
-	std::vector<int> attrDependencyOrder(nvertices, 0);
-	
-	// sort the chain in parallel slices
-	std::vector<Node*> processedNodes;
-	int offset = 0;
+	// attributes come sorted upstream first, for each one we collect the closest tasks feeding it,
+	// so that every output only waits on the outputs it really depends on rather than on a whole level of the chain.
+	std::map<int, std::vector<int> > feedingTasks;
+	std::map<Node*, int> lastNodeTask;
+	std::vector<int> sourceSlots;
 	for(int i = 0; i < attributes.size(); ++i){
 		Attribute *attr = attributes[i];
-		int attrId = attr->id();
+		int attrSlot = slotFromId(attr->id());
 		
-		if(in_degree(attrId, _graph) > 0){
-			Graph::in_edge_iterator j, j_end;
-			int maxdist = 0;
-			
-			for(boost::tie(j, j_end) = boost::in_edges(attrId, _graph); j != j_end; ++j){
-				maxdist = std::max(attrDependencyOrder[source(*j, _graph)], maxdist);
+		std::vector<int> &feeding = feedingTasks[attrSlot];
+		
+		_graph.collectSources(attrSlot, sourceSlots);
+		for(int j = 0; j < sourceSlots.size(); ++j){
+			std::vector<int> &sourceFeeding = feedingTasks[sourceSlots[j]];
+			for(int k = 0; k < sourceFeeding.size(); ++k){
+				containerUtils::addUniqueElementInContainer(sourceFeeding[k], feeding);
 			}
-			
-			attrDependencyOrder[attrId] = maxdist + 1;
 		}
 		
 		if(attr->isOutput()){
 			Node *parentNode = attr->parent();
 			if(parentNode){
-				Node *containerNode = parentNode->parent();
-
-				if(containerUtils::elementInContainer(parentNode, processedNodes)){ // make sure the same node doesn't fall in the same slice more than once.
-					offset++;
+				int taskId = cleanChain.size();
+				
+				CleanTask task;
+				task.attribute = attr;
+				task.dependencies = 0;
+				
+				std::vector<int> dependencies = feeding;
+				
+				std::map<Node*, int>::iterator lastTask = lastNodeTask.find(parentNode);
+				if(lastTask != lastNodeTask.end()){ // make sure the same node is never updated by two tasks at once.
+					containerUtils::addUniqueElementInContainer(lastTask->second, dependencies);
 				}
-
-				int dependencyOrder = attrDependencyOrder[attrId] + offset;
-				std::vector<Attribute*> &slice = cleanChain[dependencyOrder];
-				slice.push_back(attr);
 				
-				processedNodes.push_back(parentNode);
+				for(int k = 0; k < dependencies.size(); ++k){
+					cleanChain[dependencies[k]].successors.push_back(taskId);
+					task.dependencies++;
+				}
 				
-				std::vector<Attribute*> &inputs = affectedInputs[attr->id()];
-				collectParentNodeConnectedInputs(attr, parentNode, inputs);
+				cleanChain.push_back(task);
+				lastNodeTask[parentNode] = taskId;
+				
+				feeding.clear();
+				feeding.push_back(taskId);
 			}
 		}
 	}
 }
 
+void NetworkManager::runCleanChain(std::vector<CleanTask> &cleanChain, EvaluationContext *context){
+	#ifdef CORAL_PARALLEL_TBB
+		std::vector<tbb::atomic<int> > dependencies(cleanChain.size());
+		for(int i = 0; i < cleanChain.size(); ++i){
+			dependencies[i] = cleanChain[i].dependencies;
+		}
+		
+		tbb::task_group taskGroup;
+		for(int i = 0; i < cleanChain.size(); ++i){
+			if(cleanChain[i].dependencies == 0){
+				taskGroup.run(attribute_cleanTask(&cleanChain, &dependencies, &taskGroup, context, i));
+			}
+		}
+		
+		taskGroup.wait();
+	#else
+		// tasks are stored upstream first, so walking them in order already respects every dependency.
+		for(int i = 0; i < cleanChain.size(); ++i){
+			cleanChain[i].attribute->cleanSelf();
+		}
+	#endif
+}
+
+void NetworkManager::invalidateEvaluationChains(const std::vector<Attribute*> &sourceAttributes, const std::vector<Attribute*> &destinationAttributes){
+	// an edge only changes what gets dirtied from upstream of its source and what gets cleaned from downstream of its destination,
+	// chains in this region are flagged and rebuilt the next time they are used, so that a batch of edits costs one rebuild.
+	std::vector<Attribute*> attributes;
+	getUpstreamChain(sourceAttributes, attributes);
+	for(int i = 0; i < attributes.size(); ++i){
+		Attribute *attr = attributes[i];
+		if(attr){
+			attr->_dirtyChainStale = true;
+		}
+	}
+	
+	getDownstreamChain(destinationAttributes, attributes);
+	for(int i = 0; i < attributes.size(); ++i){
+		Attribute *attr = attributes[i];
+		if(attr){
+			attr->_cleanChainStale = true;
+			attr->_inputsToCleanStale = true;
+		}
+	}
+}
 
 void NetworkManager::addEdge(Attribute *attributeA, Attribute *attributeB){
-	boost::add_edge(attributeA->id(), attributeB->id(), _graph);
+	_graph.addEdge(slotFromId(attributeA->id()), slotFromId(attributeB->id()));
+	
+	if(_batchDepth){
+		_batchedEdgeSources.push_back(attributeA->id());
+		_batchedEdgeDestinations.push_back(attributeB->id());
+	}
+	else{
+		invalidateEvaluationChains(std::vector<Attribute*>(1, attributeA), std::vector<Attribute*>(1, attributeB));
+	}
 }
 
 void NetworkManager::removeEdge(Attribute *attributeA, Attribute *attributeB){
-	boost::remove_edge(attributeA->id(), attributeB->id(), _graph);
+	_graph.removeEdge(slotFromId(attributeA->id()), slotFromId(attributeB->id()));
+	
+	if(_batchDepth){
+		_batchedEdgeSources.push_back(attributeA->id());
+		_batchedEdgeDestinations.push_back(attributeB->id());
+	}
+	else{
+		invalidateEvaluationChains(std::vector<Attribute*>(1, attributeA), std::vector<Attribute*>(1, attributeB));
+	}
+}
+
+void NetworkManager::beginBatch(){
+	if(_batchDepth == 0){
+		_failedBatchConnections.clear();
+	}
+	
+	_batchDepth += 1;
+}
+
+bool NetworkManager::commitBatch(){
+	if(_batchDepth > 0){
+		_batchDepth -= 1;
+		
+		if(_batchDepth == 0){
+			flushBatch();
+			
+			return _failedBatchConnections.empty();
+		}
+	}
+	
+	return true;
+}
+
+const std::vector<std::pair<int, int> > &NetworkManager::failedBatchConnections(){
+	return _failedBatchConnections;
+}
+
+bool NetworkManager::isBatching(){
+	return _batchDepth > 0;
+}
+
+void NetworkManager::batchSpecializationUpdate(Attribute *attribute, bool reset){
+	std::map<int, bool>::iterator it = _batchedSpecializations.find(attribute->id());
+	if(it != _batchedSpecializations.end()){
+		it->second = it->second || reset;
+	}
+	else{
+		_batchedSpecializations[attribute->id()] = reset;
+	}
+}
+
+void NetworkManager::batchDirty(Attribute *attribute){
+	_batchedDirty.insert(attribute->id());
+}
+
+void NetworkManager::flushBatchedEdges(){
+	if(_batchedEdgeSources.size()){
+		// objects deleted while batching are simply skipped, their ids are looked up again here.
+		std::vector<Attribute*> sourceAttributes;
+		std::vector<Attribute*> destinationAttributes;
+		for(int i = 0; i < _batchedEdgeSources.size(); ++i){
+			Attribute *source = (Attribute*)findObjectById(_batchedEdgeSources[i]);
+			if(source){
+				sourceAttributes.push_back(source);
+			}
+			
+			Attribute *destination = (Attribute*)findObjectById(_batchedEdgeDestinations[i]);
+			if(destination){
+				destinationAttributes.push_back(destination);
+			}
+		}
+		
+		_batchedEdgeSources.clear();
+		_batchedEdgeDestinations.clear();
+		
+		invalidateEvaluationChains(sourceAttributes, destinationAttributes);
+	}
+}
+
+void NetworkManager::flushBatch(){
+	// edits made while flushing, like specializations dirtying their attributes, must take effect straight away.
+	int batchDepth = _batchDepth;
+	_batchDepth = 0;
+	
+	flushBatchedEdges();
+	
+	// solve specializations once per connected branch, branches asking for a reset go first
+	// so that the ones that don't can be skipped when already covered.
+	std::map<int, bool> batchedSpecializations;
+	batchedSpecializations.swap(_batchedSpecializations);
+	
+	std::set<int> solvedIds;
+	std::set<int> failedIds;
+	for(int pass = 0; pass < 2; ++pass){
+		bool reset = pass == 0;
+		
+		std::map<int, bool>::iterator it = batchedSpecializations.begin();
+		for(; it != batchedSpecializations.end(); ++it){
+			if(it->second == reset && solvedIds.find(it->first) == solvedIds.end()){
+				Attribute *attribute = (Attribute*)findObjectById(it->first);
+				if(attribute && !attribute->isDeleted()){
+					std::set<int> branchIds;
+					branchIds.insert(it->first);
+					
+					bool success = attribute->updateBranchSpecializations(reset, &branchIds);
+					
+					solvedIds.insert(branchIds.begin(), branchIds.end());
+					if(!success){
+						failedIds.insert(branchIds.begin(), branchIds.end());
+					}
+				}
+			}
+		}
+	}
+	
+	// connect() already reported these connections as successful, the ones landing in a failed branch are reported by commitBatch().
+	// Connections whose attributes were deleted later in the batch are gone, there is nothing left to report.
+	for(int i = 0; i < _batchedConnections.size(); ++i){
+		const std::pair<int, int> &connection = _batchedConnections[i];
+		if(failedIds.find(connection.first) != failedIds.end() || failedIds.find(connection.second) != failedIds.end()){
+			Attribute *source = (Attribute*)findObjectById(connection.first);
+			Attribute *destination = (Attribute*)findObjectById(connection.second);
+			if(source && !source->isDeleted() && destination && !destination->isDeleted()){
+				_failedBatchConnections.push_back(connection);
+			}
+		}
+	}
+	
+	_batchedConnections.clear();
+	
+	// dirty everything downstream of the batched attributes in a single walk.
+	std::vector<Attribute*> dirtiedAttributes;
+	std::set<int>::iterator dirtyIt = _batchedDirty.begin();
+	for(; dirtyIt != _batchedDirty.end(); ++dirtyIt){
+		Attribute *attribute = (Attribute*)findObjectById(*dirtyIt);
+		if(attribute){
+			attribute->markEdited();
+			dirtiedAttributes.push_back(attribute);
+		}
+	}
+	
+	_batchedDirty.clear();
+	
+	std::vector<Attribute*> dirtyChain;
+	getDownstreamChain(dirtiedAttributes, dirtyChain);
+	for(int i = 0; i < dirtyChain.size(); ++i){
+		Attribute *attr = dirtyChain[i];
+		if(attr){
+			attr->dirtySelf();
+		}
+	}
+	
+	for(int i = 0; i < dirtiedAttributes.size(); ++i){
+		dirtiedAttributes[i]->processDirtyingDoneCallbackQueue();
+	}
+	
+	_batchDepth = batchDepth;
 }
 
 int NetworkManager::useNextAvailableId(){
-	_nextAvailableId += 1;
+	if(_objectSlots.empty()){
+		// slot 0 is never handed out, so that no object gets 0 as id.
+		ObjectSlot reserved;
+		reserved.object = 0;
+		reserved.generation = 0;
+		_objectSlots.push_back(reserved);
+	}
+	
+	int slot;
+	if(_freeObjectSlots.size()){
+		slot = _freeObjectSlots.back();
+		_freeObjectSlots.pop_back();
+	}
+	else{
+		if(_objectSlots.size() > objectSlotMask){
+			throw std::runtime_error("coral: out of object ids, too many objects have been created.");
+		}
+		
+		slot = _objectSlots.size();
+		
+		ObjectSlot newSlot;
+		newSlot.object = 0;
+		newSlot.generation = 0;
+		_objectSlots.push_back(newSlot);
+	}
 	
-	return _nextAvailableId;
+	return (_objectSlots[slot].generation << objectSlotBits) | slot;
 }
 
 void NetworkManager::storeObject(int id, Object *object){
-	_objectsById[id] = object;
+	int slot = slotFromId(id);
+	if(slot < _objectSlots.size() && _objectSlots[slot].object == 0){
+		_objectSlots[slot].object = object;
+		_objectCount += 1;
+	}
 }
 
 void NetworkManager::removeObject(int id){
-	std::map<int, Object *>::iterator it = _objectsById.find(id);
-	if(it != _objectsById.end()){
-		_objectsById.erase(it);
+	if(findObjectById(id)){
+		int slot = slotFromId(id);
+		
+		// whoever reuses this slot must not inherit edges left behind by the previous owner.
+		_graph.clearVertex(slot);
+		
+		ObjectSlot &objectSlot = _objectSlots[slot];
+		objectSlot.object = 0;
+		_objectCount -= 1;
+		
+		if(objectSlot.generation < objectGenerationMask){
+			objectSlot.generation += 1;
+			_freeObjectSlots.push_back(slot);
+		}
 	}
 }
 
 int NetworkManager::objectCount(){
-	return (int)_objectsById.size();
+	return _objectCount;
 }
 
 Object *NetworkManager::findObjectById(int id){
 	Object *foundObject = 0;
 	
-	std::map<int, Object *>::iterator it = _objectsById.find(id);
-	if(it != _objectsById.end()){
-		foundObject = _objectsById[id];
+	if(id > 0){
+		int slot = slotFromId(id);
+		if(slot < _objectSlots.size()){
+			ObjectSlot &objectSlot = _objectSlots[slot];
+			if(objectSlot.generation == (id >> objectSlotBits)){
+				foundObject = objectSlot.object;
+			}
+		}
 	}
 	
 	return foundObject;
@@ -336,6 +616,10 @@ bool NetworkManager::connect(Attribute *sourceAttribute, Attribute *destinationA
 	
 	if(allowConnection(sourceAttribute, destinationAttribute, errorObject)){
 		success = sourceAttribute->connectTo(destinationAttribute, errorObject);
+		
+		if(_batchDepth){
+			_batchedConnections.push_back(std::make_pair(sourceAttribute->id(), destinationAttribute->id()));
+		}
 	}
 
 	errorObject->removeReference();
@@ -33,6 +33,7 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <set>
 #include "coralDefinitions.h"
 
 namespace coral{
@@ -41,6 +42,8 @@ class Object;
 class Attribute;
 class Node;
 class ErrorObject;
+struct CleanTask;
+class EvaluationContext;
 
 //! In charge of managing lifetime and connections of each Object in the network.
 class CORAL_EXPORT NetworkManager{
@@ -51,10 +54,27 @@ public:
 	static bool connect(Attribute *sourceAttribute, Attribute *destinationAttribute, ErrorObject *errorObject = 0);
 	static bool isCycle(Attribute *sourceAttribute, Attribute *destinationAttribute);
 	static void getDownstreamChain(Attribute *attribute, std::vector<Attribute*> &downstreamChain);
+	static void getDownstreamChain(const std::vector<Attribute*> &attributes, std::vector<Attribute*> &downstreamChain);
 	static void getUpstreamChain(Attribute *attribute, std::vector<Attribute*> &upstreamChain);
+	static void getUpstreamChain(const std::vector<Attribute*> &attributes, std::vector<Attribute*> &upstreamChain);
 	static std::string resolveFilename(const std::string &filename);
 	static void addSearchPath(const std::string &path);
 	static void removeSearchPath(const std::string &path);
+	
+	//! Starts recording edits instead of applying their side effects, used when loading whole networks.
+	//! Specialization solving, evaluation chain caching and dirty propagation are deferred
+	//! and run once per connected branch when the outermost batch is committed.
+	//! Batches can be nested.
+	static void beginBatch();
+	
+	//! Ends a batch started with beginBatch(), the outermost commit applies all the recorded edits at once.
+	//! Connections reported successful by connect() while batching are only specialized here,
+	//! returns false if some of them failed, see failedBatchConnections().
+	static bool commitBatch();
+	static bool isBatching();
+	
+	//! Ids of the source and destination attributes of the connections made during the last batch whose branch failed to specialize.
+	static const std::vector<std::pair<int, int> > &failedBatchConnections();
 
 private:
 	friend class Object;
@@ -66,12 +86,23 @@ private:
 	static void removeObject(int id);
 	static void addEdge(Attribute *attributeA, Attribute *attributeB);
 	static void removeEdge(Attribute *attributeA, Attribute *attributeB);
-	static void getCleanChain(Attribute *attribute, std::map<int, std::vector<Attribute*> > &cleanChain, std::map<int, std::vector<Attribute*> > &affectedInputs);
+	static void getCleanChain(Attribute *attribute, std::vector<CleanTask> &cleanChain);
+	static void invalidateEvaluationChains(const std::vector<Attribute*> &sourceAttributes, const std::vector<Attribute*> &destinationAttributes);
+	static void runCleanChain(std::vector<CleanTask> &cleanChain, EvaluationContext *context);
 	static void collectParentNodeConnectedInputs(Attribute *attribute, Node *parentNode, std::vector<Attribute*> &attributes);
+	static void batchSpecializationUpdate(Attribute *attribute, bool reset);
+	static void batchDirty(Attribute *attribute);
+	static void flushBatchedEdges();
+	static void flushBatch();
 
-	static int _nextAvailableId;
-	static std::map<int, Object *> _objectsById;
 	static std::vector<std::string> _searchPaths;
+	static int _batchDepth;
+	static std::vector<int> _batchedEdgeSources;
+	static std::vector<int> _batchedEdgeDestinations;
+	static std::vector<std::pair<int, int> > _batchedConnections;
+	static std::vector<std::pair<int, int> > _failedBatchConnections;
+	static std::map<int, bool> _batchedSpecializations;
+	static std::set<int> _batchedDirty;
 };
 
 }
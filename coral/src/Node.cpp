@@ -34,6 +34,7 @@
 #include <boost/date_time/posix_time/posix_time.hpp>
 
 #include "Node.h"
+#include "Profiler.h"
 #include "Attribute.h"
 #include "NetworkManager.h"
 #include "containerUtils.h"
@@ -71,6 +72,8 @@ Node::Node(const std::string &name, Node *parent):
 	NestedObject(name, parent),
 	_isInvalid(false),
 	_updateEnabled(true),
+	_memoized(false),
+	_earlyCutoff(false),
 	_computeTimeSeconds(0),
 	_computeTimeMilliseconds(0),
 	_computeTimeTicks(0),
@@ -123,6 +126,30 @@ bool Node::updateEnabled(){
 	return _updateEnabled;
 }
 
+void Node::setMemoized(bool value){
+	if(value != _memoized){
+		_memoized = value;
+		
+		// outputs updated while not memoized don't match the input hashes kept so far.
+		for(int i = 0; i < _outputAttributes.size(); ++i){
+			_outputAttributes[i]->_inputHashesValid = false;
+			_outputAttributes[i]->_valueHashValid = false;
+		}
+	}
+}
+
+bool Node::memoized(){
+	return _memoized;
+}
+
+void Node::setEarlyCutoff(bool value){
+	_earlyCutoff = value;
+}
+
+bool Node::earlyCutoff(){
+	return _earlyCutoff || _memoized;
+}
+
 bool Node::containsNode(Node *node){
 	return containerUtils::elementInContainer(node, _nodes);
 }
@@ -221,11 +248,21 @@ void Node::doUpdate(Attribute *attribute){
 	_computeTimeSeconds = enlapsed.length().total_seconds();
 	_computeTimeMilliseconds = enlapsed.length().total_milliseconds() % 1000;
 	_computeTimeTicks = enlapsed.length().ticks();
+	
+	if(Profiler::isEnabled()){
+		Profiler::recordNodeUpdate(this, attribute, startTime, endTime);
+	}
 }
 
 void Node::updateSlice(Attribute *attribute, unsigned int slice){
 }
 
+void Node::updateSlices(Attribute *attribute, unsigned int beginSlice, unsigned int endSlice){
+	for(unsigned int i = beginSlice; i < endSlice; ++i){
+		updateSlice(attribute, i);
+	}
+}
+
 void Node::update(Attribute *attribute){
 	// std::cout << "Node.update " << name() << std::endl;
 	if(_slicer){ // this node is nested in a slicer node such as the ForLoop node and this node is supposed to be sliced
@@ -244,9 +281,7 @@ void Node::update(Attribute *attribute){
 		#ifdef CORAL_PARALLEL_TBB
 			tbb::parallel_for(tbb::blocked_range<size_t>(0, _slices), node_parallelUpdate(this, attribute));
 		#else
-			for(int i = 0; i < _slices; ++i){
-				updateSlice(attribute, i);
-			}
+			updateSlices(attribute, 0, _slices);
 		#endif
 	}
 	else{
@@ -756,6 +791,18 @@ void Node::catchAttributeDirtied(Attribute *attribute, bool value){
 	}
 }
 
+void Node::setAttributeUnchanged(Attribute *attribute){
+	if(containerUtils::elementInContainer((NestedObject*)attribute, _objects)){
+		attribute->_valueUnchanged = true;
+	}
+}
+
+void Node::catchAttributeUnchanged(Attribute *attribute, bool value){
+	if(containerUtils::elementInContainer(attribute, attributes())){
+		attribute->setCatchUnchanged(value);
+	}
+}
+
 void Node::attributeDirtied(Attribute *attribute){
 }
 
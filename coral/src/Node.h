@@ -71,6 +71,14 @@ public:
 	bool isValid();
 	std::string invalidityMessage();
 	bool updateEnabled();
+	
+	//! A memoized node skips the update of an output when the inputs affecting it hash the same as the last time it was updated,
+	//! only meant for nodes whose outputs depend on nothing else than their inputs. Nodes under a slicer are always updated.
+	void setMemoized(bool value);
+	bool memoized();
+	
+	//! Indicates if this node was declared as safe for early cutoff, see setEarlyCutoff(). Memoized nodes also get early cutoff.
+	bool earlyCutoff();
 	int computeTimeTicks();
 	int computeTimeMilliseconds();
 	int computeTimeSeconds();
@@ -118,6 +126,10 @@ public:
 	virtual void addDynamicAttribute(Attribute *attribute);
 	virtual void removeDynamicAttribute(Attribute *attribute);
 	virtual void updateSlice(Attribute *attribute, unsigned int slice);
+	
+	//! Invoked by update with contiguous ranges of slices [beginSlice, endSlice), by default it calls updateSlice for each of them.
+	//! Nodes that can process many slices at once override this method to avoid paying one virtual call per slice.
+	virtual void updateSlices(Attribute *attribute, unsigned int beginSlice, unsigned int endSlice);
 
 	//! This method is invoked before updateSlice if there is a change in the number of slices imposed by the slicer.
 	//! Overriding this method is often handy when a node has some internal data that needs to be sliced accordingly. 
@@ -148,6 +160,18 @@ protected:
 	void setSpecializationPreset(const std::string &presetName, Attribute *attribute, const std::string &specialization);
 	//! This sets an attribute to call attributeDirtied when it gets changed
 	void catchAttributeDirtied(Attribute *attribute, bool value = true);
+	
+	//! Called from update() to report that the value of an output attribute didn't change,
+	//! attributes depending on it only through this output will then be considered clean without being updated.
+	void setAttributeUnchanged(Attribute *attribute);
+	
+	//! This sets an output attribute to compare its value against the previous one after each update
+	//! and to report it as unchanged automatically, it only works for hashable values.
+	void catchAttributeUnchanged(Attribute *attribute, bool value = true);
+	
+	//! Declares this node's outputs as depending on nothing else than its inputs, this value is false by default.
+	//! An output of such a node is considered clean without being updated when none of its inputs changed since its last update.
+	void setEarlyCutoff(bool value = true);
 
 	//! In order for this node to be nested under a slicer node, such as a ForLoop node, it has to be declared as sliceable(true).
 	//! Once a node is declared as sliceable the updateSlice(attribute, slice) method needs to be overridden instead of the usual update(attribute) method.
@@ -162,6 +186,7 @@ private:
 	friend class NetworkManager;
 	friend class Attribute;
 	friend class node_parallelUpdate;
+	friend class node_isolatedUpdate;
 	
 	std::string saveContentRecursive(bool thisIsRoot);
 	std::string saveNodeConnectionsScript(Node *node);
@@ -177,6 +202,8 @@ private:
 	std::map<std::string, std::map<int, std::string> > _specializationPresets; // _specializationPresets["presetName"][attr->id()] = "Int"
 	bool _isInvalid;
 	bool _updateEnabled;
+	bool _memoized;
+	bool _earlyCutoff;
 	std::string _invalidityMessage;
 	int _computeTimeSeconds;
 	int _computeTimeMilliseconds;
@@ -76,6 +76,18 @@ public:
 	static void _catchAttributeDirtied(Node &self, Attribute *attribute, bool value){
 		self.catchAttributeDirtied(attribute, value);
 	}
+	
+	static void _setAttributeUnchanged(Node &self, Attribute *attribute){
+		self.setAttributeUnchanged(attribute);
+	}
+	
+	static void _catchAttributeUnchanged(Node &self, Attribute *attribute, bool value){
+		self.catchAttributeUnchanged(attribute, value);
+	}
+	
+	static void _setEarlyCutoff(Node &self, bool value){
+		self.setEarlyCutoff(value);
+	}
 
 	static void _setSliceable(Node &self, bool value){
 		self.setSliceable(value);
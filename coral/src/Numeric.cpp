@@ -26,13 +26,288 @@
 // SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // </license>
 
+#include <cstring>
 #include <ImathMatrixAlgo.h>
 
 #include "Numeric.h"
 #include "stringUtils.h"
+#include "hashUtils.h"
+#include "NetworkBlobs.h"
 
 using namespace coral;
 
+namespace{
+	template<class T>
+	size_t slicedSizeInBytes(const std::vector<SharedVector<T> > &slicedValues){
+		size_t bytes = 0;
+		for(int i = 0; i < slicedValues.size(); ++i){
+			if(slicedValues[i].chunked()){
+				bytes += slicedValues[i].chunked()->residentBytes();
+			}
+			else{
+				bytes += slicedValues[i].size() * sizeof(T);
+			}
+		}
+		
+		return bytes;
+	}
+	
+	template<class T>
+	hashUtils::Hash slicedHash(const std::vector<SharedVector<T> > &slicedValues, hashUtils::Hash hash){
+		for(int i = 0; i < slicedValues.size(); ++i){
+			if(slicedValues[i].chunked()){
+				hash = slicedValues[i].chunked()->hash(hash);
+			}
+			else{
+				hash = hashUtils::hashVector(slicedValues[i].read(), hash);
+			}
+		}
+		
+		return hash;
+	}
+	
+	template<class T>
+	void shareSlicedValues(std::vector<SharedVector<T> > &slicedValues, unsigned int slice, const std::vector<SharedVector<T> > &sourceSlicedValues, unsigned int sourceSlice){
+		if(slice < slicedValues.size() && sourceSlicedValues.size()){
+			if(sourceSlice >= sourceSlicedValues.size()){
+				sourceSlice = sourceSlicedValues.size() - 1;
+			}
+			
+			slicedValues[slice] = sourceSlicedValues[sourceSlice];
+		}
+	}
+	
+	// reads a single element of a chunked slice without materializing it, clamped like the contiguous accessors
+	template<class T>
+	bool chunkedValueAt(const SharedVector<T> &values, unsigned int id, T &value){
+		const boost::shared_ptr<ChunkedArray> &chunked = values.chunked();
+		if(!chunked || chunked->size() == 0){
+			return false;
+		}
+		
+		if(id >= chunked->size()){
+			id = chunked->size() - 1;
+		}
+		
+		value = chunked->valueAt<T>(id);
+		
+		return true;
+	}
+	
+	template<class T>
+	void writeValuesBlob(const SharedVector<T> &values){
+		const boost::shared_ptr<ChunkedArray> &chunked = values.chunked();
+		if(chunked){
+			for(unsigned int i = 0; i < chunked->chunks(); ++i){
+				boost::shared_ptr<Chunk> chunk = chunked->chunk(i);
+				NetworkBlobs::write(chunk->data(), std::size_t(chunked->chunkCount(i)) * sizeof(T));
+			}
+		}
+		else if(values.size()){
+			NetworkBlobs::write(&values.read()[0], values.size() * sizeof(T));
+		}
+	}
+	
+	template<class T>
+	void adoptChunkedValues(std::vector<SharedVector<T> > &slicedValues, const boost::shared_ptr<ChunkedArray> &values){
+		slicedValues.resize(1);
+		slicedValues[0].setChunked(values);
+	}
+	
+	// Text form of the values used by sliceAsString and setFromString: scalars are comma separated, 
+	// the components of the other types are comma separated within parenthesis, with a line break every 20 values.
+	// Both directions work in a single pass without temporary strings.
+	template<class T>
+	struct TextComponents{
+		typedef float Component;
+		enum{count = sizeof(T) / sizeof(float)};
+	};
+	
+	template<>
+	struct TextComponents<int>{
+		typedef int Component;
+		enum{count = 1};
+	};
+	
+	void appendComponent(std::string &str, int value){
+		stringUtils::appendInt(str, value);
+	}
+	
+	void appendComponent(std::string &str, float value){
+		stringUtils::appendFloat(str, value);
+	}
+	
+	bool scanComponent(const char *&str, int &value){
+		return stringUtils::scanInt(str, value);
+	}
+	
+	bool scanComponent(const char *&str, float &value){
+		return stringUtils::scanFloat(str, value);
+	}
+	
+	// Imath types store their components contiguously in the order they are written: 
+	// x y z for V3f, r g b a for Color4f, r x y z for Quatf and the rows of M44f.
+	template<class T>
+	const typename TextComponents<T>::Component *components(const T &value){
+		return (const typename TextComponents<T>::Component*)&value;
+	}
+	
+	template<class T>
+	void appendValues(std::string &str, const std::vector<T> &values){
+		const int count = TextComponents<T>::count;
+		
+		int size = values.size();
+		for(int i = 0; i < size; ++i){
+			const typename TextComponents<T>::Component *valueComponents = components(values[i]);
+			
+			if(count > 1){
+				str += '(';
+			}
+			
+			for(int j = 0; j < count; ++j){
+				appendComponent(str, valueComponents[j]);
+				if(j < count - 1){
+					str += ',';
+				}
+			}
+			
+			if(count > 1){
+				str += ')';
+			}
+			
+			if(i < size - 1){
+				str += ',';
+			}
+			
+			if(i % 20 == 19){
+				str += '\n';
+			}
+		}
+	}
+	
+	bool isValueSeparator(char character){
+		return character == ',' || character == '(' || character == ')' || isspace(character);
+	}
+	
+	// groups with the wrong number of components and tokens that are not numbers are skipped
+	template<class T>
+	void scanValues(const char *str, const char *end, std::vector<T> &values){
+		typedef typename TextComponents<T>::Component Component;
+		const int count = TextComponents<T>::count;
+		
+		T value;
+		Component *valueComponents = (Component*)&value;
+		int scanned = 0;
+		
+		while(str < end){
+			char character = *str;
+			if(character == '('){
+				scanned = 0;
+				++str;
+			}
+			else if(character == ')'){
+				if(scanned == count){
+					values.push_back(value);
+				}
+				
+				scanned = 0;
+				++str;
+			}
+			else if(isValueSeparator(character)){
+				++str;
+			}
+			else{
+				const char *next = str;
+				Component component;
+				if(scanComponent(next, component) && next <= end && (next == end || isValueSeparator(*next))){
+					if(count == 1){
+						valueComponents[0] = component;
+						values.push_back(value);
+					}
+					else{
+						if(scanned < count){
+							valueComponents[scanned] = component;
+						}
+						
+						scanned += 1;
+					}
+					
+					str = next;
+				}
+				else{
+					while(str < end && !isValueSeparator(*str)){
+						++str;
+					}
+				}
+			}
+		}
+	}
+	
+	template<class T>
+	void scanSlicedValues(const char *str, const char *end, std::vector<SharedVector<T> > &slicedValues){
+		slicedValues.resize(1);
+		slicedValues[0].clear();
+		
+		scanValues(str, end, slicedValues[0].write());
+	}
+	
+	template<class T>
+	const void *sharedSliceData(std::vector<SharedVector<T> > &slicedValues, unsigned int slice, boost::shared_ptr<void> &handle){
+		if(slice >= slicedValues.size()){
+			return 0;
+		}
+		
+		SharedVector<T> &values = slicedValues[slice];
+		const std::vector<T> &data = values.read();
+		
+		// the handle is just another owner of the buffer, copy on write keeps it untouched by later edits of the slice
+		handle.reset(new SharedVector<T>(values));
+		
+		if(data.empty()){
+			return 0;
+		}
+		
+		return &data[0];
+	}
+	
+	template<class T>
+	void copySliceData(std::vector<SharedVector<T> > &slicedValues, unsigned int slice, const void *data, unsigned int size){
+		if(slice >= slicedValues.size()){
+			return;
+		}
+		
+		slicedValues[slice].clear();
+		std::vector<T> &values = slicedValues[slice].write();
+		values.resize(size);
+		if(size){
+			memcpy(&values[0], data, size * sizeof(T));
+		}
+	}
+	
+	unsigned int elementSize(Numeric::Type type){
+		if(type == Numeric::numericTypeInt || type == Numeric::numericTypeIntArray){
+			return sizeof(int);
+		}
+		else if(type == Numeric::numericTypeFloat || type == Numeric::numericTypeFloatArray){
+			return sizeof(float);
+		}
+		else if(type == Numeric::numericTypeVec3 || type == Numeric::numericTypeVec3Array){
+			return sizeof(Imath::V3f);
+		}
+		else if(type == Numeric::numericTypeCol4 || type == Numeric::numericTypeCol4Array){
+			return sizeof(Imath::Color4f);
+		}
+		else if(type == Numeric::numericTypeQuat || type == Numeric::numericTypeQuatArray){
+			return sizeof(Imath::Quatf);
+		}
+		else if(type == Numeric::numericTypeMatrix44 || type == Numeric::numericTypeMatrix44Array){
+			return sizeof(Imath::M44f);
+		}
+		
+		return 0;
+	}
+}
+
 Numeric::Numeric():
 	_type(numericTypeAny),
 	_isArray(false),
@@ -40,27 +315,27 @@ Numeric::Numeric():
 	
 	_intValuesSliced.resize(1);
 	_intValuesSliced[0].resize(1);
-	_intValuesSliced[0][0] = 0;
+	_intValuesSliced[0].write()[0] = 0;
 
 	_floatValuesSliced.resize(1);
 	_floatValuesSliced[0].resize(1);
-	_floatValuesSliced[0][0] = 0.0;
+	_floatValuesSliced[0].write()[0] = 0.0;
 
 	_vec3ValuesSliced.resize(1);
 	_vec3ValuesSliced[0].resize(1);
-	_vec3ValuesSliced[0][0] = Imath::V3f(0.0, 0.0, 0.0);
+	_vec3ValuesSliced[0].write()[0] = Imath::V3f(0.0, 0.0, 0.0);
 
 	_quatValuesSliced.resize(1);
 	_quatValuesSliced[0].resize(1);
-	_quatValuesSliced[0][0] = Imath::Quatf(0.0, 0.0, 0.0, 1.0);
+	_quatValuesSliced[0].write()[0] = Imath::Quatf(0.0, 0.0, 0.0, 1.0);
 
 	_matrix44ValuesSliced.resize(1);
 	_matrix44ValuesSliced[0].resize(1);
-	_matrix44ValuesSliced[0][0] = Imath::identity44f;
+	_matrix44ValuesSliced[0].write()[0] = Imath::identity44f;
 
 	_col4ValuesSliced.resize(1);
 	_col4ValuesSliced[0].resize(1);
-	_col4ValuesSliced[0][0] = Imath::Color4f(1.0, 1.0, 1.0, 1.0);
+	_col4ValuesSliced[0].write()[0] = Imath::Color4f(1.0, 1.0, 1.0, 1.0);
 }
 
 void Numeric::copy(const Value *other){
@@ -268,27 +543,27 @@ void Numeric::setMatrix44ValueAt(unsigned int id, const Imath::M44f &value){
 }
 
 const std::vector<int> &Numeric::intValues(){
-	return _intValuesSliced[0];
+	return _intValuesSliced[0].read();
 }
 
 const std::vector<float> &Numeric::floatValues(){
-	return _floatValuesSliced[0];
+	return _floatValuesSliced[0].read();
 }
 
 const std::vector<Imath::V3f> &Numeric::vec3Values(){
-	return _vec3ValuesSliced[0];
+	return _vec3ValuesSliced[0].read();
 }
 
 const std::vector<Imath::Color4f> &Numeric::col4Values(){
-	return _col4ValuesSliced[0];
+	return _col4ValuesSliced[0].read();
 }
 
 const std::vector<Imath::Quatf> &Numeric::quatValues(){
-	return _quatValuesSliced[0];
+	return _quatValuesSliced[0].read();
 }
 
 const std::vector<Imath::M44f> &Numeric::matrix44Values(){
-	return _matrix44ValuesSliced[0];
+	return _matrix44ValuesSliced[0].read();
 }
 
 int Numeric::intValueAt(unsigned int id){
@@ -343,124 +618,33 @@ std::string Numeric::sliceAsString(unsigned int slice){
 	std::string script;
 
 	if(_type != numericTypeAny){
-		std::ostringstream stream;
-		
 		if(slice >= _slices){
 			slice = _slices - 1;
 		}
-
+		
+		script += "[";
+		
 		if(_type == numericTypeInt || _type == numericTypeIntArray){
-			for(int i = 0; i < _intValuesSliced[slice].size(); ++i){
-				stream << _intValuesSliced[slice][i];
-				
-				if(i < _intValuesSliced[slice].size() - 1){
-					stream << ",";
-				}
-				
-				if(i % 20 == 19)
-					stream << "\n";
-			}
+			appendValues(script, _intValuesSliced[slice].read());
 		}
 		else if(_type == numericTypeFloat || _type == numericTypeFloatArray){
-			for(int i = 0; i < _floatValuesSliced[slice].size(); ++i){
-				stream << _floatValuesSliced[slice][i];
-				
-				if(i < _floatValuesSliced[slice].size() - 1){
-					stream << ",";
-				}
-				
-				if(i % 20 == 19)
-					stream << "\n";
-			}
+			appendValues(script, _floatValuesSliced[slice].read());
 		}
 		else if(_type == numericTypeVec3 || _type == numericTypeVec3Array){
-			for(int i = 0; i < _vec3ValuesSliced[slice].size(); ++i){
-				stream << "(";
-				Imath::V3f *vec = &_vec3ValuesSliced[slice][i];
-
-				stream << vec->x << ",";
-				stream << vec->y << ",";
-				stream << vec->z << ")";
-				
-				if(i < _vec3ValuesSliced[slice].size() - 1){
-					stream << ",";
-				}
-				
-				if(i % 20 == 19)
-					stream << "\n";
-			}
+			appendValues(script, _vec3ValuesSliced[slice].read());
 		}
 		else if(_type == numericTypeCol4 || _type == numericTypeCol4Array){
-			for(int i = 0; i < _col4ValuesSliced[slice].size(); ++i){
-				stream << "(";
-				Imath::Color4f *col = &_col4ValuesSliced[slice][i];
-
-				stream << col->r << ",";
-				stream << col->g << ",";
-				stream << col->b << ",";
-				stream << col->a << ")";
-
-				if(i < _col4ValuesSliced[slice].size() - 1){
-					stream << ",";
-				}
-
-				if(i % 20 == 19)
-					stream << "\n";
-			}
+			appendValues(script, _col4ValuesSliced[slice].read());
 		}
 		else if(_type == numericTypeQuat || _type == numericTypeQuatArray){
-			for(int i = 0; i < _quatValuesSliced[slice].size(); ++i){
-				stream << "(";
-				Imath::Quatf *quat = &_quatValuesSliced[slice][i];
-
-				stream << quat->r << ",";
-				stream << quat->v.x << ",";
-				stream << quat->v.y << ",";
-				stream << quat->v.z << ")";
-
-				if(i < _quatValuesSliced[slice].size() - 1){
-					stream << ",";
-				}
-
-				if(i % 20 == 19)
-					stream << "\n";
-			}
+			appendValues(script, _quatValuesSliced[slice].read());
 		}
 		else if(_type == numericTypeMatrix44 || _type == numericTypeMatrix44Array){
-			for(int i = 0; i < _matrix44ValuesSliced[slice].size(); ++i){
-				stream << "(";
-				Imath::M44f *mat = &_matrix44ValuesSliced[slice][i];
-				
-				stream << mat->x[0][0] << ",";
-				stream << mat->x[0][1] << ",";
-				stream << mat->x[0][2] << ",";
-				stream << mat->x[0][3] << ",";
-				stream << mat->x[1][0] << ",";
-				stream << mat->x[1][1] << ",";
-				stream << mat->x[1][2] << ",";
-				stream << mat->x[1][3] << ",";
-				stream << mat->x[2][0] << ",";
-				stream << mat->x[2][1] << ",";
-				stream << mat->x[2][2] << ",";
-				stream << mat->x[2][3] << ",";
-				stream << mat->x[3][0] << ",";
-				stream << mat->x[3][1] << ",";
-				stream << mat->x[3][2] << ",";
-				stream << mat->x[3][3] << ")";
-				
-				if(i < _matrix44ValuesSliced.size() - 1){
-					stream << ",";
-				}
-				
-				if(i % 20 == 19)
-					stream << "\n";
-			}
+			appendValues(script, _matrix44ValuesSliced[slice].read());
 		}
 		
-		std::ostringstream type;
-		type << _type;
-		
-		script = "[" + stream.str() + "] " + type.str();
+		script += "] ";
+		stringUtils::appendInt(script, int(_type));
 	}
 	
 	return script;
@@ -471,133 +655,127 @@ std::string Numeric::asString(){
 }
 
 void Numeric::setFromString(const std::string &value){
-	std::string tmp = stringUtils::replace(value, "\n", "");
-	std::vector<std::string> fields;
-	stringUtils::split(tmp, fields, " ");
-	
-	if(fields.size() == 2){
-		std::string valuesStr = stringUtils::strip(fields[0], "[]");
-		Numeric::Type type = Numeric::Type(stringUtils::parseInt(fields[1]));
-		
-		if(type == Numeric::numericTypeInt || type == Numeric::numericTypeIntArray){
-			_intValuesSliced.resize(1);
-			_intValuesSliced[0].clear();
-
-			std::vector<std::string> values;
-			stringUtils::split(valuesStr, values, ",");
-			for(int i = 0; i < values.size(); ++i){
-				int value = stringUtils::parseInt(values[i]);
-				_intValuesSliced[0].push_back(value);
-			}
-		}
-		else if(type == Numeric::numericTypeFloat || type == Numeric::numericTypeFloatArray){
-			_floatValuesSliced.resize(1);
-			_floatValuesSliced[0].clear();
-
-			std::vector<std::string> values;
-			stringUtils::split(valuesStr, values, ",");
-			for(int i = 0; i < values.size(); ++i){
-				float value = stringUtils::parseFloat(values[i]);
-				_floatValuesSliced[0].push_back(value);
-			}
+	// the values are between brackets and followed by the type, see sliceAsString
+	std::string::size_type valuesBegin = value.find('[');
+	std::string::size_type valuesEnd = value.rfind(']');
+	if(valuesBegin == std::string::npos || valuesEnd == std::string::npos || valuesEnd < valuesBegin){
+		valuesBegin = std::string::npos;
+		valuesEnd = value.find_last_of(" ");
+		if(valuesEnd == std::string::npos){
+			return;
 		}
-		else if(type == Numeric::numericTypeVec3 || type == Numeric::numericTypeVec3Array){
-			_vec3ValuesSliced.resize(1);
-			_vec3ValuesSliced[0].clear();
-			
-			std::vector<std::string> values;
-			stringUtils::split(valuesStr, values, "),(");
-
-			for(int i = 0; i < values.size(); ++i){
-				std::string numericValuesStr = stringUtils::strip(values[i], "()");
-				std::vector<std::string> numericValues;
-				stringUtils::split(numericValuesStr, numericValues, ",");
-				
-				if(numericValues.size() == 3){
-					float x = stringUtils::parseFloat(numericValues[0]);
-					float y = stringUtils::parseFloat(numericValues[1]);
-					float z = stringUtils::parseFloat(numericValues[2]);
-					
-					Imath::V3f vec(x, y, z);
-					_vec3ValuesSliced[0].push_back(vec);
-				}
-			}
-		}
-		else if(type == Numeric::numericTypeQuat || type == Numeric::numericTypeQuatArray){
-			_quatValuesSliced.resize(1);
-			_quatValuesSliced[0].clear();
-
-			std::vector<std::string> values;
-			stringUtils::split(valuesStr, values, "),(");
-
-			for(int i = 0; i < values.size(); ++i){
-				std::string numericValuesStr = stringUtils::strip(values[i], "()");
-				std::vector<std::string> numericValues;
-				stringUtils::split(numericValuesStr, numericValues, ",");
-
-				if(numericValues.size() == 4){
-					float r = stringUtils::parseFloat(numericValues[0]);
-					float x = stringUtils::parseFloat(numericValues[1]);
-					float y = stringUtils::parseFloat(numericValues[2]);
-					float z = stringUtils::parseFloat(numericValues[3]);
+	}
+	
+	const char *str = value.c_str();
+	const char *typeStr = str + valuesEnd + 1;
+	int typeId = 0;
+	if(!stringUtils::scanInt(typeStr, typeId)){
+		return;
+	}
+	
+	const char *begin = valuesBegin == std::string::npos ? str : str + valuesBegin + 1;
+	const char *end = str + valuesEnd;
+	
+	Numeric::Type type = Numeric::Type(typeId);
+	if(type == Numeric::numericTypeInt || type == Numeric::numericTypeIntArray){
+		scanSlicedValues(begin, end, _intValuesSliced);
+	}
+	else if(type == Numeric::numericTypeFloat || type == Numeric::numericTypeFloatArray){
+		scanSlicedValues(begin, end, _floatValuesSliced);
+	}
+	else if(type == Numeric::numericTypeVec3 || type == Numeric::numericTypeVec3Array){
+		scanSlicedValues(begin, end, _vec3ValuesSliced);
+	}
+	else if(type == Numeric::numericTypeQuat || type == Numeric::numericTypeQuatArray){
+		scanSlicedValues(begin, end, _quatValuesSliced);
+	}
+	else if(type == Numeric::numericTypeMatrix44 || type == Numeric::numericTypeMatrix44Array){
+		scanSlicedValues(begin, end, _matrix44ValuesSliced);
+	}
+	else if(type == Numeric::numericTypeCol4 || type == Numeric::numericTypeCol4Array){
+		scanSlicedValues(begin, end, _col4ValuesSliced);
+	}
+}
 
-					Imath::Quatf vec(r, x, y, z);
-					_quatValuesSliced[0].push_back(vec);
-				}
-			}
-		}
-		else if(type == Numeric::numericTypeMatrix44 || type == Numeric::numericTypeMatrix44Array){
-			_matrix44ValuesSliced.resize(1);
-			_matrix44ValuesSliced[0].clear();
-			
-			std::vector<std::string> values;
-			stringUtils::split(valuesStr, values, "),(");
-			
-			for(int i = 0; i < values.size(); ++i){
-				std::string numericValuesStr = stringUtils::strip(values[i], "()");
-				std::vector<std::string> numericValues;
-				stringUtils::split(numericValuesStr, numericValues, ",");
-				
-				if(numericValues.size() == 16){
-					Imath::M44f matrix(
-						stringUtils::parseFloat(numericValues[0]), stringUtils::parseFloat(numericValues[1]), stringUtils::parseFloat(numericValues[2]), stringUtils::parseFloat(numericValues[3]), 
-						stringUtils::parseFloat(numericValues[4]), stringUtils::parseFloat(numericValues[5]), stringUtils::parseFloat(numericValues[6]), stringUtils::parseFloat(numericValues[7]), 
-						stringUtils::parseFloat(numericValues[8]), stringUtils::parseFloat(numericValues[9]), stringUtils::parseFloat(numericValues[10]), stringUtils::parseFloat(numericValues[11]), 
-						stringUtils::parseFloat(numericValues[12]), stringUtils::parseFloat(numericValues[13]), stringUtils::parseFloat(numericValues[14]), stringUtils::parseFloat(numericValues[15]));
-					
-					_matrix44ValuesSliced[0].push_back(matrix);
-				}
-			}
-		}
-		else if(type == Numeric::numericTypeCol4 || type == Numeric::numericTypeCol4Array){
-			_col4ValuesSliced.resize(1);
-			_col4ValuesSliced[0].clear();
-			
-			std::vector<std::string> values;
-			stringUtils::split(valuesStr, values, "),(");
+std::string Numeric::writeBlob(){
+	if(_type == numericTypeAny || !NetworkBlobs::isSaving()){
+		return "";
+	}
+	
+	std::size_t offset = NetworkBlobs::beginBlob();
+	
+	if(_type == numericTypeInt || _type == numericTypeIntArray){
+		writeValuesBlob(_intValuesSliced[0]);
+	}
+	else if(_type == numericTypeFloat || _type == numericTypeFloatArray){
+		writeValuesBlob(_floatValuesSliced[0]);
+	}
+	else if(_type == numericTypeVec3 || _type == numericTypeVec3Array){
+		writeValuesBlob(_vec3ValuesSliced[0]);
+	}
+	else if(_type == numericTypeCol4 || _type == numericTypeCol4Array){
+		writeValuesBlob(_col4ValuesSliced[0]);
+	}
+	else if(_type == numericTypeQuat || _type == numericTypeQuatArray){
+		writeValuesBlob(_quatValuesSliced[0]);
+	}
+	else if(_type == numericTypeMatrix44 || _type == numericTypeMatrix44Array){
+		writeValuesBlob(_matrix44ValuesSliced[0]);
+	}
+	
+	std::ostringstream description;
+	description << offset << " " << sizeSlice(0) << " " << int(_type);
+	
+	return description.str();
+}
 
-			for(int i = 0; i < values.size(); ++i){
-				std::string numericValuesStr = stringUtils::strip(values[i], "()");
-				std::vector<std::string> numericValues;
-				stringUtils::split(numericValuesStr, numericValues, ",");
-				
-				if(numericValues.size() == 4){
-					float r = stringUtils::parseFloat(numericValues[0]);
-					float g = stringUtils::parseFloat(numericValues[1]);
-					float b = stringUtils::parseFloat(numericValues[2]);
-					float a = stringUtils::parseFloat(numericValues[3]);
-					
-					Imath::Color4f col(r, g, b, a);
-					_col4ValuesSliced[0].push_back(col);
-				}
-			}
-		}
+bool Numeric::readBlob(const std::string &filename, const std::string &description){
+	std::istringstream fields(description);
+	std::size_t offset = 0;
+	unsigned int size = 0;
+	int typeId = 0;
+	fields >> offset >> size >> typeId;
+	
+	Numeric::Type type = Numeric::Type(typeId);
+	unsigned int typeSize = elementSize(type);
+	if(fields.fail() || typeSize == 0){
+		return false;
+	}
+	
+	// the values are only mapped lazily, a bad file has to be caught now rather than on first access.
+	if(!NetworkBlobs::contains(filename, offset, std::size_t(size) * typeSize)){
+		return false;
 	}
+	
+	boost::shared_ptr<ChunkSource> source(new MappedFileChunkSource(filename, offset));
+	boost::shared_ptr<ChunkedArray> values(new ChunkedArray(source, size, typeSize));
+	
+	// like setFromString, the type of the blob picks the values to restore
+	if(type == numericTypeInt || type == numericTypeIntArray){
+		adoptChunkedValues(_intValuesSliced, values);
+	}
+	else if(type == numericTypeFloat || type == numericTypeFloatArray){
+		adoptChunkedValues(_floatValuesSliced, values);
+	}
+	else if(type == numericTypeVec3 || type == numericTypeVec3Array){
+		adoptChunkedValues(_vec3ValuesSliced, values);
+	}
+	else if(type == numericTypeCol4 || type == numericTypeCol4Array){
+		adoptChunkedValues(_col4ValuesSliced, values);
+	}
+	else if(type == numericTypeQuat || type == numericTypeQuatArray){
+		adoptChunkedValues(_quatValuesSliced, values);
+	}
+	else if(type == numericTypeMatrix44 || type == numericTypeMatrix44Array){
+		adoptChunkedValues(_matrix44ValuesSliced, values);
+	}
+	
+	return true;
 }
 
 void Numeric::setIntValueAtSlice(unsigned int slice, unsigned int id, int value){
 	if(slice < _intValuesSliced.size()){
-		std::vector<int> &slicevec = _intValuesSliced[slice];
+		std::vector<int> &slicevec = _intValuesSliced[slice].write();
 		if(id < slicevec.size()){
 			slicevec[id] = value;
 		}
@@ -606,7 +784,7 @@ void Numeric::setIntValueAtSlice(unsigned int slice, unsigned int id, int value)
 
 void Numeric::setFloatValueAtSlice(unsigned int slice, unsigned int id, float value){
 	if(slice < _floatValuesSliced.size()){
-		std::vector<float> &slicevec = _floatValuesSliced[slice];
+		std::vector<float> &slicevec = _floatValuesSliced[slice].write();
 		if(id < slicevec.size()){
 			slicevec[id] = value;
 		}
@@ -615,7 +793,7 @@ void Numeric::setFloatValueAtSlice(unsigned int slice, unsigned int id, float va
 
 void Numeric::setVec3ValueAtSlice(unsigned int slice, unsigned int id, const Imath::V3f &value){
 	if(slice < _vec3ValuesSliced.size()){
-		std::vector<Imath::V3f> &slicevec = _vec3ValuesSliced[slice];
+		std::vector<Imath::V3f> &slicevec = _vec3ValuesSliced[slice].write();
 		if(id < slicevec.size()){
 			slicevec[id] = value;
 		}
@@ -624,7 +802,7 @@ void Numeric::setVec3ValueAtSlice(unsigned int slice, unsigned int id, const Ima
 
 void Numeric::setMatrix44ValueAtSlice(unsigned int slice, unsigned int id, const Imath::M44f &value){
 	if(slice < _matrix44ValuesSliced.size()){
-		std::vector<Imath::M44f> &slicevec = _matrix44ValuesSliced[slice];
+		std::vector<Imath::M44f> &slicevec = _matrix44ValuesSliced[slice].write();
 		if(id < slicevec.size()){
 			slicevec[id] = value;
 		}
@@ -633,7 +811,7 @@ void Numeric::setMatrix44ValueAtSlice(unsigned int slice, unsigned int id, const
 
 void Numeric::setCol4ValueAtSlice(unsigned int slice, unsigned int id, const Imath::Color4f &value){
 	if(slice < _col4ValuesSliced.size()){
-		std::vector<Imath::Color4f> &slicevec = _col4ValuesSliced[slice];
+		std::vector<Imath::Color4f> &slicevec = _col4ValuesSliced[slice].write();
 		if(id < slicevec.size()){
 			slicevec[id] = value;
 		}
@@ -642,7 +820,7 @@ void Numeric::setCol4ValueAtSlice(unsigned int slice, unsigned int id, const Ima
 
 void Numeric::setQuatValueAtSlice(unsigned int slice, unsigned int id, const Imath::Quatf &value){
 	if(slice < _quatValuesSliced.size()){
-		std::vector<Imath::Quatf> &slicevec = _quatValuesSliced[slice];
+		std::vector<Imath::Quatf> &slicevec = _quatValuesSliced[slice].write();
 		if(id < slicevec.size()){
 			slicevec[id] = value;
 		}
@@ -654,7 +832,12 @@ int Numeric::intValueAtSlice(unsigned int slice, unsigned int id){
 		slice = _intValuesSliced.size() - 1;
 	}
 
-	std::vector<int> &slicevec = _intValuesSliced[slice];
+	int chunkedValue;
+	if(chunkedValueAt(_intValuesSliced[slice], id, chunkedValue)){
+		return chunkedValue;
+	}
+	
+	const std::vector<int> &slicevec = _intValuesSliced[slice].read();
 
 	int size = slicevec.size();
 	if(id < size){
@@ -672,7 +855,12 @@ float Numeric::floatValueAtSlice(unsigned int slice, unsigned int id){
 		slice = _floatValuesSliced.size() - 1;
 	}
 
-	std::vector<float> &slicevec = _floatValuesSliced[slice];
+	float chunkedValue;
+	if(chunkedValueAt(_floatValuesSliced[slice], id, chunkedValue)){
+		return chunkedValue;
+	}
+	
+	const std::vector<float> &slicevec = _floatValuesSliced[slice].read();
 
 	int size = slicevec.size();
 	if(id < size){
@@ -690,7 +878,12 @@ Imath::V3f Numeric::vec3ValueAtSlice(unsigned int slice, unsigned int id){
 		slice = _vec3ValuesSliced.size() - 1;
 	}
 
-	std::vector<Imath::V3f> &slicevec = _vec3ValuesSliced[slice];
+	Imath::V3f chunkedValue;
+	if(chunkedValueAt(_vec3ValuesSliced[slice], id, chunkedValue)){
+		return chunkedValue;
+	}
+	
+	const std::vector<Imath::V3f> &slicevec = _vec3ValuesSliced[slice].read();
 
 	int size = slicevec.size();
 	if(id < size){
@@ -708,7 +901,12 @@ Imath::Color4f Numeric::col4ValueAtSlice(unsigned int slice, unsigned int id){
 		slice = _col4ValuesSliced.size() - 1;
 	}
 
-	std::vector<Imath::Color4f> &slicevec = _col4ValuesSliced[slice];
+	Imath::Color4f chunkedValue;
+	if(chunkedValueAt(_col4ValuesSliced[slice], id, chunkedValue)){
+		return chunkedValue;
+	}
+	
+	const std::vector<Imath::Color4f> &slicevec = _col4ValuesSliced[slice].read();
 
 	int size = slicevec.size();
 	if(id < size){
@@ -726,7 +924,12 @@ Imath::Quatf Numeric::quatValueAtSlice(unsigned int slice, unsigned int id){
 		slice = _quatValuesSliced.size() - 1;
 	}
 
-	std::vector<Imath::Quatf> &slicevec = _quatValuesSliced[slice];
+	Imath::Quatf chunkedValue;
+	if(chunkedValueAt(_quatValuesSliced[slice], id, chunkedValue)){
+		return chunkedValue;
+	}
+	
+	const std::vector<Imath::Quatf> &slicevec = _quatValuesSliced[slice].read();
 
 	int size = slicevec.size();
 	if(id < size){
@@ -744,7 +947,12 @@ Imath::M44f Numeric::matrix44ValueAtSlice(unsigned int slice, unsigned int id){
 		slice = _matrix44ValuesSliced.size() - 1;
 	}
 
-	std::vector<Imath::M44f> &slicevec = _matrix44ValuesSliced[slice];
+	Imath::M44f chunkedValue;
+	if(chunkedValueAt(_matrix44ValuesSliced[slice], id, chunkedValue)){
+		return chunkedValue;
+	}
+	
+	const std::vector<Imath::M44f> &slicevec = _matrix44ValuesSliced[slice].read();
 
 	int size = slicevec.size();
 	if(id < size){
@@ -759,37 +967,264 @@ Imath::M44f Numeric::matrix44ValueAtSlice(unsigned int slice, unsigned int id){
 
 void Numeric::setIntValuesSlice(unsigned int slice, const std::vector<int> &values){
 	if(slice < _intValuesSliced.size()){
-		_intValuesSliced[slice] = values;
+		_intValuesSliced[slice].set(values);
 	}
 }
 
 void Numeric::setFloatValuesSlice(unsigned int slice, const std::vector<float> &values){
 	if(slice < _floatValuesSliced.size()){
-		_floatValuesSliced[slice] = values;
+		_floatValuesSliced[slice].set(values);
 	}
 }
 
 void Numeric::setVec3ValuesSlice(unsigned int slice, const std::vector<Imath::V3f> &values){
 	if(slice < _vec3ValuesSliced.size()){
-		_vec3ValuesSliced[slice] = values;
+		_vec3ValuesSliced[slice].set(values);
 	}
 }
 
 void Numeric::setQuatValuesSlice(unsigned int slice, const std::vector<Imath::Quatf> &values){
 	if(slice < _quatValuesSliced.size()){
-		_quatValuesSliced[slice] = values;
+		_quatValuesSliced[slice].set(values);
 	}
 }
 
 void Numeric::setCol4ValuesSlice(unsigned int slice, const std::vector<Imath::Color4f> &values){
 	if(slice < _col4ValuesSliced.size()){
-		_col4ValuesSliced[slice] = values;
+		_col4ValuesSliced[slice].set(values);
 	}
 }
 
 void Numeric::setMatrix44ValuesSlice(unsigned int slice, const std::vector<Imath::M44f> &values){
 	if(slice < _matrix44ValuesSliced.size()){
-		_matrix44ValuesSliced[slice] = values;
+		_matrix44ValuesSliced[slice].set(values);
+	}
+}
+
+void Numeric::swapIntValuesSlice(unsigned int slice, std::vector<int> &values){
+	if(slice < _intValuesSliced.size()){
+		_intValuesSliced[slice].swap(values);
+	}
+}
+
+void Numeric::swapFloatValuesSlice(unsigned int slice, std::vector<float> &values){
+	if(slice < _floatValuesSliced.size()){
+		_floatValuesSliced[slice].swap(values);
+	}
+}
+
+void Numeric::swapVec3ValuesSlice(unsigned int slice, std::vector<Imath::V3f> &values){
+	if(slice < _vec3ValuesSliced.size()){
+		_vec3ValuesSliced[slice].swap(values);
+	}
+}
+
+void Numeric::swapMatrix44ValuesSlice(unsigned int slice, std::vector<Imath::M44f> &values){
+	if(slice < _matrix44ValuesSliced.size()){
+		_matrix44ValuesSliced[slice].swap(values);
+	}
+}
+
+void Numeric::swapCol4ValuesSlice(unsigned int slice, std::vector<Imath::Color4f> &values){
+	if(slice < _col4ValuesSliced.size()){
+		_col4ValuesSliced[slice].swap(values);
+	}
+}
+
+void Numeric::swapQuatValuesSlice(unsigned int slice, std::vector<Imath::Quatf> &values){
+	if(slice < _quatValuesSliced.size()){
+		_quatValuesSliced[slice].swap(values);
+	}
+}
+
+std::vector<int> &Numeric::mutableIntValuesSlice(unsigned int slice){
+	if(slice >= _intValuesSliced.size()){
+		slice = _intValuesSliced.size() - 1;
+	}
+
+	return _intValuesSliced[slice].write();
+}
+
+std::vector<float> &Numeric::mutableFloatValuesSlice(unsigned int slice){
+	if(slice >= _floatValuesSliced.size()){
+		slice = _floatValuesSliced.size() - 1;
+	}
+
+	return _floatValuesSliced[slice].write();
+}
+
+std::vector<Imath::V3f> &Numeric::mutableVec3ValuesSlice(unsigned int slice){
+	if(slice >= _vec3ValuesSliced.size()){
+		slice = _vec3ValuesSliced.size() - 1;
+	}
+
+	return _vec3ValuesSliced[slice].write();
+}
+
+std::vector<Imath::M44f> &Numeric::mutableMatrix44ValuesSlice(unsigned int slice){
+	if(slice >= _matrix44ValuesSliced.size()){
+		slice = _matrix44ValuesSliced.size() - 1;
+	}
+
+	return _matrix44ValuesSliced[slice].write();
+}
+
+std::vector<Imath::Color4f> &Numeric::mutableCol4ValuesSlice(unsigned int slice){
+	if(slice >= _col4ValuesSliced.size()){
+		slice = _col4ValuesSliced.size() - 1;
+	}
+
+	return _col4ValuesSliced[slice].write();
+}
+
+std::vector<Imath::Quatf> &Numeric::mutableQuatValuesSlice(unsigned int slice){
+	if(slice >= _quatValuesSliced.size()){
+		slice = _quatValuesSliced.size() - 1;
+	}
+
+	return _quatValuesSliced[slice].write();
+}
+
+void Numeric::shareSlice(unsigned int slice, Numeric *source, unsigned int sourceSlice){
+	Type type = _type;
+	if(type == numericTypeAny){
+		type = source->_type;
+	}
+	
+	if(type == numericTypeInt || type == numericTypeIntArray){
+		shareSlicedValues(_intValuesSliced, slice, source->_intValuesSliced, sourceSlice);
+	}
+	else if(type == numericTypeFloat || type == numericTypeFloatArray){
+		shareSlicedValues(_floatValuesSliced, slice, source->_floatValuesSliced, sourceSlice);
+	}
+	else if(type == numericTypeVec3 || type == numericTypeVec3Array){
+		shareSlicedValues(_vec3ValuesSliced, slice, source->_vec3ValuesSliced, sourceSlice);
+	}
+	else if(type == numericTypeCol4 || type == numericTypeCol4Array){
+		shareSlicedValues(_col4ValuesSliced, slice, source->_col4ValuesSliced, sourceSlice);
+	}
+	else if(type == numericTypeQuat || type == numericTypeQuatArray){
+		shareSlicedValues(_quatValuesSliced, slice, source->_quatValuesSliced, sourceSlice);
+	}
+	else if(type == numericTypeMatrix44 || type == numericTypeMatrix44Array){
+		shareSlicedValues(_matrix44ValuesSliced, slice, source->_matrix44ValuesSliced, sourceSlice);
+	}
+}
+
+void Numeric::setChunkedValuesSlice(unsigned int slice, const boost::shared_ptr<ChunkedArray> &values){
+	if(values && values->elementSize() != elementSize(_type)){
+		return;
+	}
+	
+	if((_type == numericTypeInt || _type == numericTypeIntArray) && slice < _intValuesSliced.size()){
+		_intValuesSliced[slice].setChunked(values);
+	}
+	else if((_type == numericTypeFloat || _type == numericTypeFloatArray) && slice < _floatValuesSliced.size()){
+		_floatValuesSliced[slice].setChunked(values);
+	}
+	else if((_type == numericTypeVec3 || _type == numericTypeVec3Array) && slice < _vec3ValuesSliced.size()){
+		_vec3ValuesSliced[slice].setChunked(values);
+	}
+	else if((_type == numericTypeCol4 || _type == numericTypeCol4Array) && slice < _col4ValuesSliced.size()){
+		_col4ValuesSliced[slice].setChunked(values);
+	}
+	else if((_type == numericTypeQuat || _type == numericTypeQuatArray) && slice < _quatValuesSliced.size()){
+		_quatValuesSliced[slice].setChunked(values);
+	}
+	else if((_type == numericTypeMatrix44 || _type == numericTypeMatrix44Array) && slice < _matrix44ValuesSliced.size()){
+		_matrix44ValuesSliced[slice].setChunked(values);
+	}
+}
+
+boost::shared_ptr<ChunkedArray> Numeric::chunkedValuesSlice(unsigned int slice){
+	if(slice >= _slices){
+		slice = _slices - 1;
+	}
+	
+	if((_type == numericTypeInt || _type == numericTypeIntArray) && slice < _intValuesSliced.size()){
+		return _intValuesSliced[slice].chunked();
+	}
+	else if((_type == numericTypeFloat || _type == numericTypeFloatArray) && slice < _floatValuesSliced.size()){
+		return _floatValuesSliced[slice].chunked();
+	}
+	else if((_type == numericTypeVec3 || _type == numericTypeVec3Array) && slice < _vec3ValuesSliced.size()){
+		return _vec3ValuesSliced[slice].chunked();
+	}
+	else if((_type == numericTypeCol4 || _type == numericTypeCol4Array) && slice < _col4ValuesSliced.size()){
+		return _col4ValuesSliced[slice].chunked();
+	}
+	else if((_type == numericTypeQuat || _type == numericTypeQuatArray) && slice < _quatValuesSliced.size()){
+		return _quatValuesSliced[slice].chunked();
+	}
+	else if((_type == numericTypeMatrix44 || _type == numericTypeMatrix44Array) && slice < _matrix44ValuesSliced.size()){
+		return _matrix44ValuesSliced[slice].chunked();
+	}
+	
+	return boost::shared_ptr<ChunkedArray>();
+}
+
+bool Numeric::mapFileValuesSlice(unsigned int slice, const std::string &filename, unsigned int chunkSize){
+	unsigned int typeSize = elementSize(_type);
+	if(typeSize == 0){
+		return false;
+	}
+	
+	boost::shared_ptr<MappedFileChunkSource> source(new MappedFileChunkSource(filename));
+	if(source->fileSize() == 0){
+		return false;
+	}
+	
+	unsigned int size = source->fileSize() / typeSize;
+	setChunkedValuesSlice(slice, boost::shared_ptr<ChunkedArray>(new ChunkedArray(source, size, typeSize, chunkSize)));
+	
+	return true;
+}
+
+const void *Numeric::sliceData(unsigned int slice, boost::shared_ptr<void> &handle){
+	if(slice >= _slices){
+		slice = _slices - 1;
+	}
+	
+	if(_type == numericTypeInt || _type == numericTypeIntArray){
+		return sharedSliceData(_intValuesSliced, slice, handle);
+	}
+	else if(_type == numericTypeFloat || _type == numericTypeFloatArray){
+		return sharedSliceData(_floatValuesSliced, slice, handle);
+	}
+	else if(_type == numericTypeVec3 || _type == numericTypeVec3Array){
+		return sharedSliceData(_vec3ValuesSliced, slice, handle);
+	}
+	else if(_type == numericTypeCol4 || _type == numericTypeCol4Array){
+		return sharedSliceData(_col4ValuesSliced, slice, handle);
+	}
+	else if(_type == numericTypeQuat || _type == numericTypeQuatArray){
+		return sharedSliceData(_quatValuesSliced, slice, handle);
+	}
+	else if(_type == numericTypeMatrix44 || _type == numericTypeMatrix44Array){
+		return sharedSliceData(_matrix44ValuesSliced, slice, handle);
+	}
+	
+	return 0;
+}
+
+void Numeric::setSliceData(unsigned int slice, const void *data, unsigned int size){
+	if(_type == numericTypeInt || _type == numericTypeIntArray){
+		copySliceData(_intValuesSliced, slice, data, size);
+	}
+	else if(_type == numericTypeFloat || _type == numericTypeFloatArray){
+		copySliceData(_floatValuesSliced, slice, data, size);
+	}
+	else if(_type == numericTypeVec3 || _type == numericTypeVec3Array){
+		copySliceData(_vec3ValuesSliced, slice, data, size);
+	}
+	else if(_type == numericTypeCol4 || _type == numericTypeCol4Array){
+		copySliceData(_col4ValuesSliced, slice, data, size);
+	}
+	else if(_type == numericTypeQuat || _type == numericTypeQuatArray){
+		copySliceData(_quatValuesSliced, slice, data, size);
+	}
+	else if(_type == numericTypeMatrix44 || _type == numericTypeMatrix44Array){
+		copySliceData(_matrix44ValuesSliced, slice, data, size);
 	}
 }
 
@@ -798,7 +1233,7 @@ const std::vector<int> &Numeric::intValuesSlice(unsigned int slice){
 		slice = _intValuesSliced.size() - 1;
 	}
 
-	return _intValuesSliced[slice];
+	return _intValuesSliced[slice].read();
 }
 
 const std::vector<float> &Numeric::floatValuesSlice(unsigned int slice){
@@ -806,7 +1241,7 @@ const std::vector<float> &Numeric::floatValuesSlice(unsigned int slice){
 		slice = _floatValuesSliced.size() - 1;
 	}
 
-	return _floatValuesSliced[slice];
+	return _floatValuesSliced[slice].read();
 }
 
 const std::vector<Imath::V3f> &Numeric::vec3ValuesSlice(unsigned int slice){
@@ -814,7 +1249,7 @@ const std::vector<Imath::V3f> &Numeric::vec3ValuesSlice(unsigned int slice){
 		slice = _vec3ValuesSliced.size() - 1;
 	}
 
-	return _vec3ValuesSliced[slice];
+	return _vec3ValuesSliced[slice].read();
 }
 
 const std::vector<Imath::Color4f> &Numeric::col4ValuesSlice(unsigned int slice){
@@ -822,7 +1257,7 @@ const std::vector<Imath::Color4f> &Numeric::col4ValuesSlice(unsigned int slice){
 		slice = _col4ValuesSliced.size() - 1;
 	}
 
-	return _col4ValuesSliced[slice];
+	return _col4ValuesSliced[slice].read();
 }
 
 const std::vector<Imath::Quatf> &Numeric::quatValuesSlice(unsigned int slice){
@@ -830,7 +1265,7 @@ const std::vector<Imath::Quatf> &Numeric::quatValuesSlice(unsigned int slice){
 		slice = _quatValuesSliced.size() - 1;
 	}
 
-	return _quatValuesSliced[slice];
+	return _quatValuesSliced[slice].read();
 }
 
 const std::vector<Imath::M44f> &Numeric::matrix44ValuesSlice(unsigned int slice){
@@ -838,7 +1273,7 @@ const std::vector<Imath::M44f> &Numeric::matrix44ValuesSlice(unsigned int slice)
 		slice = _matrix44ValuesSliced.size() - 1;
 	}
 
-	return _matrix44ValuesSliced[slice];
+	return _matrix44ValuesSliced[slice].read();
 }
 
 void Numeric::resizeSlices(unsigned int slices){
@@ -850,7 +1285,7 @@ void Numeric::resizeSlices(unsigned int slices){
 		if(_type == numericTypeInt){
 			_intValuesSliced.resize(slices);
 			for(int i = 0; i < slices; ++i){
-				std::vector<int> &slicevec = _intValuesSliced[i];
+				SharedVector<int> &slicevec = _intValuesSliced[i];
 				if(!slicevec.size()){
 					slicevec.resize(1);
 				}
@@ -862,7 +1297,7 @@ void Numeric::resizeSlices(unsigned int slices){
 		else if(_type == numericTypeFloat){
 			_floatValuesSliced.resize(slices);
 			for(int i = 0; i < slices; ++i){
-				std::vector<float> &slicevec = _floatValuesSliced[i];
+				SharedVector<float> &slicevec = _floatValuesSliced[i];
 				if(!slicevec.size()){
 					slicevec.resize(1);
 				}
@@ -874,7 +1309,7 @@ void Numeric::resizeSlices(unsigned int slices){
 		else if(_type == numericTypeVec3){
 			_vec3ValuesSliced.resize(slices);
 			for(int i = 0; i < slices; ++i){
-				std::vector<Imath::V3f> &slicevec = _vec3ValuesSliced[i];
+				SharedVector<Imath::V3f> &slicevec = _vec3ValuesSliced[i];
 				if(!slicevec.size()){
 					slicevec.resize(1);
 				}
@@ -886,7 +1321,7 @@ void Numeric::resizeSlices(unsigned int slices){
 		else if(_type == numericTypeQuat){
 			_quatValuesSliced.resize(slices);
 			for(int i = 0; i < slices; ++i){
-				std::vector<Imath::Quatf> &slicevec = _quatValuesSliced[i];
+				SharedVector<Imath::Quatf> &slicevec = _quatValuesSliced[i];
 				if(!slicevec.size()){
 					slicevec.resize(1);
 				}
@@ -898,7 +1333,7 @@ void Numeric::resizeSlices(unsigned int slices){
 		else if(_type == numericTypeMatrix44){
 			_matrix44ValuesSliced.resize(slices);
 			for(int i = 0; i < slices; ++i){
-				std::vector<Imath::M44f> &slicevec = _matrix44ValuesSliced[i];
+				SharedVector<Imath::M44f> &slicevec = _matrix44ValuesSliced[i];
 				if(!slicevec.size()){
 					slicevec.resize(1);
 				}
@@ -910,7 +1345,7 @@ void Numeric::resizeSlices(unsigned int slices){
 		else if(_type == numericTypeCol4){
 			_col4ValuesSliced.resize(slices);
 			for(int i = 0; i < slices; ++i){
-				std::vector<Imath::Color4f> &slicevec = _col4ValuesSliced[i];
+				SharedVector<Imath::Color4f> &slicevec = _col4ValuesSliced[i];
 				if(!slicevec.size()){
 					slicevec.resize(1);
 				}
@@ -923,3 +1358,42 @@ void Numeric::resizeSlices(unsigned int slices){
 		_slices = slices;
 	}
 }
+
+size_t Numeric::sizeInBytes(){
+	return slicedSizeInBytes(_intValuesSliced) + 
+		slicedSizeInBytes(_floatValuesSliced) + 
+		slicedSizeInBytes(_vec3ValuesSliced) + 
+		slicedSizeInBytes(_col4ValuesSliced) + 
+		slicedSizeInBytes(_matrix44ValuesSliced) + 
+		slicedSizeInBytes(_quatValuesSliced);
+}
+
+bool Numeric::isHashable(){
+	return true;
+}
+
+hashUtils::Hash Numeric::hash(){
+	hashUtils::Hash hash = hashUtils::hashValue((int)_type);
+	hash = hashUtils::hashValue(_slices, hash);
+	
+	if(_type == numericTypeInt || _type == numericTypeIntArray){
+		hash = slicedHash(_intValuesSliced, hash);
+	}
+	else if(_type == numericTypeFloat || _type == numericTypeFloatArray){
+		hash = slicedHash(_floatValuesSliced, hash);
+	}
+	else if(_type == numericTypeVec3 || _type == numericTypeVec3Array){
+		hash = slicedHash(_vec3ValuesSliced, hash);
+	}
+	else if(_type == numericTypeCol4 || _type == numericTypeCol4Array){
+		hash = slicedHash(_col4ValuesSliced, hash);
+	}
+	else if(_type == numericTypeQuat || _type == numericTypeQuatArray){
+		hash = slicedHash(_quatValuesSliced, hash);
+	}
+	else if(_type == numericTypeMatrix44 || _type == numericTypeMatrix44Array){
+		hash = slicedHash(_matrix44ValuesSliced, hash);
+	}
+	
+	return hash;
+}
@@ -40,6 +40,7 @@
 #include <ImathQuat.h>
 
 #include "Value.h"
+#include "SharedVector.h"
 
 namespace coral{
 
@@ -99,6 +100,12 @@ public:
 	bool isArrayType(Numeric::Type type);
 	std::string asString();
 	void setFromString(const std::string &value);
+	
+	//! Saves the values of the first slice like asString() does, chunked values are streamed chunk by chunk.
+	std::string writeBlob();
+	
+	//! The values are memory mapped from the blob file, see setChunkedValuesSlice.
+	bool readBlob(const std::string &filename, const std::string &description);
 
 	unsigned int sizeSlice(unsigned int slice);
 	void resizeSlice(unsigned int slices, unsigned int newSize);
@@ -122,23 +129,69 @@ public:
 	void setMatrix44ValuesSlice(unsigned int slice, const std::vector<Imath::M44f> &values);
 	void setCol4ValuesSlice(unsigned int slice, const std::vector<Imath::Color4f> &values);
 	void setQuatValuesSlice(unsigned int slice, const std::vector<Imath::Quatf> &values);
+	
+	//! Hands the values over to the slice without copying them, values is left with the previous content of the slice or empty.
+	//! Use these instead of setXValuesSlice when the values were built by the node in a local vector.
+	void swapIntValuesSlice(unsigned int slice, std::vector<int> &values);
+	void swapFloatValuesSlice(unsigned int slice, std::vector<float> &values);
+	void swapVec3ValuesSlice(unsigned int slice, std::vector<Imath::V3f> &values);
+	void swapMatrix44ValuesSlice(unsigned int slice, std::vector<Imath::M44f> &values);
+	void swapCol4ValuesSlice(unsigned int slice, std::vector<Imath::Color4f> &values);
+	void swapQuatValuesSlice(unsigned int slice, std::vector<Imath::Quatf> &values);
+	
+	//! Gives direct access to the values of a slice so they can be built in place, the slice is unshared first if needed.
+	//! The returned reference is invalidated by any other call modifying this Numeric.
+	std::vector<int> &mutableIntValuesSlice(unsigned int slice);
+	std::vector<float> &mutableFloatValuesSlice(unsigned int slice);
+	std::vector<Imath::V3f> &mutableVec3ValuesSlice(unsigned int slice);
+	std::vector<Imath::M44f> &mutableMatrix44ValuesSlice(unsigned int slice);
+	std::vector<Imath::Color4f> &mutableCol4ValuesSlice(unsigned int slice);
+	std::vector<Imath::Quatf> &mutableQuatValuesSlice(unsigned int slice);
 	const std::vector<int> &intValuesSlice(unsigned int slice);
 	const std::vector<float> &floatValuesSlice(unsigned int slice);
 	const std::vector<Imath::V3f> &vec3ValuesSlice(unsigned int slice);
 	const std::vector<Imath::M44f> &matrix44ValuesSlice(unsigned int slice);
 	const std::vector<Imath::Quatf> &quatValuesSlice(unsigned int slice);
 	const std::vector<Imath::Color4f> &col4ValuesSlice(unsigned int slice);
+	
+	//! Makes the given slice refer to the values of sourceSlice in source, no data is copied until either side is modified.
+	//! The values shared are the ones of this Numeric type, or the ones of the source type when this Numeric is still untyped.
+	//! Prefer this over setXValuesSlice(slice, source->xValuesSlice(sourceSlice)) when passing values through a node.
+	void shareSlice(unsigned int slice, Numeric *source, unsigned int sourceSlice);
+	
+	//! Backs a slice with a ChunkedArray holding elements of the type of this Numeric, chunks are only loaded when accessed.
+	//! The xValuesSlice accessors keep working on chunked slices by materializing them, chunk aware code should use chunkedValuesSlice instead.
+	void setChunkedValuesSlice(unsigned int slice, const boost::shared_ptr<ChunkedArray> &values);
+	
+	//! The ChunkedArray backing a slice, null when the slice holds plain values.
+	boost::shared_ptr<ChunkedArray> chunkedValuesSlice(unsigned int slice);
+	
+	//! Backs a slice with the raw elements of a binary file, memory mapped one chunk at a time.
+	//! Returns false if the file can't be opened or this Numeric has no type yet.
+	bool mapFileValuesSlice(unsigned int slice, const std::string &filename, unsigned int chunkSize = ChunkedArray::defaultChunkSize);
+	
+	//! Address of the contiguous elements of a slice, used to hand them out without copying.
+	//! handle keeps that memory alive and unchanged after this Numeric is modified or destroyed.
+	//! The memory may be shared with other Numerics and must not be written, use setSliceData to change the values.
+	//! Returns 0 when the slice is empty.
+	const void *sliceData(unsigned int slice, boost::shared_ptr<void> &handle);
+	
+	//! Replaces the values of a slice with a copy of size raw elements of the type of this Numeric.
+	void setSliceData(unsigned int slice, const void *data, unsigned int size);
 	std::string sliceAsString(unsigned int slice);
+	size_t sizeInBytes();
+	bool isHashable();
+	hashUtils::Hash hash();
 
 private:
 	friend class NumericOperation;
 	
-	std::vector<std::vector<int> > _intValuesSliced;
-	std::vector<std::vector<float> > _floatValuesSliced;
-	std::vector<std::vector<Imath::V3f> > _vec3ValuesSliced;
-	std::vector<std::vector<Imath::Color4f> > _col4ValuesSliced;
-	std::vector<std::vector<Imath::M44f> > _matrix44ValuesSliced;
-	std::vector<std::vector<Imath::Quatf> > _quatValuesSliced;
+	std::vector<SharedVector<int> > _intValuesSliced;
+	std::vector<SharedVector<float> > _floatValuesSliced;
+	std::vector<SharedVector<Imath::V3f> > _vec3ValuesSliced;
+	std::vector<SharedVector<Imath::Color4f> > _col4ValuesSliced;
+	std::vector<SharedVector<Imath::M44f> > _matrix44ValuesSliced;
+	std::vector<SharedVector<Imath::Quatf> > _quatValuesSliced;
 	bool _isArray;
 	Type _type;	
 	unsigned int _slices;
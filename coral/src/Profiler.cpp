@@ -0,0 +1,249 @@
+// <license>
+// Copyright (C) 2011 Andrea Interguglielmi, All rights reserved.
+// This file is part of the coral repository downloaded from http://code.google.com/p/coral-repo.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// 
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+// 
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+// IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// </license>
+
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <sstream>
+#include <fstream>
+#include <iomanip>
+
+#ifdef CORAL_PARALLEL_TBB
+	#include <tbb/mutex.h>
+	#include <tbb/atomic.h>
+	#include <tbb/enumerable_thread_specific.h>
+#endif
+
+#include "Profiler.h"
+#include "Node.h"
+#include "Attribute.h"
+#include "Value.h"
+
+using namespace coral;
+
+namespace {
+	struct ProfilerEvent{
+		int nodeId;
+		std::string nodeName;
+		std::string attributeName;
+		long long startTime; // microseconds since the profiler was started
+		long long duration;
+		int thread;
+		unsigned int slices;
+		size_t bytes;
+	};
+	
+	std::vector<ProfilerEvent> _events;
+	boost::posix_time::ptime _startTime = boost::posix_time::microsec_clock::universal_time();
+	
+	#ifdef CORAL_PARALLEL_TBB
+		tbb::mutex _eventsMutex;
+		
+		// threads are numbered in the order they first record something, to keep trace rows readable.
+		tbb::atomic<int> _nextThread;
+		tbb::enumerable_thread_specific<int> _threads(-1);
+	#endif
+	
+	int currentThread(){
+		#ifdef CORAL_PARALLEL_TBB
+			int &thread = _threads.local();
+			if(thread == -1){
+				thread = _nextThread.fetch_and_increment();
+			}
+			
+			return thread;
+		#else
+			return 0;
+		#endif
+	}
+	
+	std::string escapeJson(const std::string &str){
+		std::string escaped;
+		for(int i = 0; i < str.size(); ++i){
+			char c = str[i];
+			if(c == '"' || c == '\\'){
+				escaped += '\\';
+			}
+			
+			escaped += c;
+		}
+		
+		return escaped;
+	}
+	
+	struct NodeTimes{
+		std::string nodeName;
+		std::vector<long long> durations;
+		long long total;
+	};
+	
+	bool compareTotals(const NodeTimes *a, const NodeTimes *b){
+		return a->total > b->total;
+	}
+}
+
+bool Profiler::_enabled = false;
+
+void Profiler::setEnabled(bool value){
+	if(value && !_enabled){
+		clear();
+	}
+	
+	_enabled = value;
+}
+
+bool Profiler::isEnabled(){
+	return _enabled;
+}
+
+void Profiler::clear(){
+	#ifdef CORAL_PARALLEL_TBB
+		tbb::mutex::scoped_lock lock(_eventsMutex);
+	#endif
+	
+	_events.clear();
+	_startTime = boost::posix_time::microsec_clock::universal_time();
+}
+
+int Profiler::eventCount(){
+	#ifdef CORAL_PARALLEL_TBB
+		tbb::mutex::scoped_lock lock(_eventsMutex);
+	#endif
+	
+	return _events.size();
+}
+
+void Profiler::recordNodeUpdate(Node *node, Attribute *attribute, const boost::posix_time::ptime &startTime, const boost::posix_time::ptime &endTime){
+	ProfilerEvent event;
+	event.nodeId = node->id();
+	event.nodeName = node->fullName();
+	event.attributeName = attribute ? attribute->name() : "";
+	event.duration = (endTime - startTime).total_microseconds();
+	event.thread = currentThread();
+	event.slices = node->slices();
+	event.bytes = 0;
+	
+	const std::vector<Attribute*> &outputs = node->outputAttributes();
+	for(int i = 0; i < outputs.size(); ++i){
+		Value *value = outputs[i]->outValue();
+		if(value){
+			event.bytes += value->sizeInBytes();
+		}
+	}
+	
+	#ifdef CORAL_PARALLEL_TBB
+		tbb::mutex::scoped_lock lock(_eventsMutex);
+	#endif
+	
+	event.startTime = (startTime - _startTime).total_microseconds();
+	_events.push_back(event);
+}
+
+std::string Profiler::chromeTrace(){
+	#ifdef CORAL_PARALLEL_TBB
+		tbb::mutex::scoped_lock lock(_eventsMutex);
+	#endif
+	
+	std::ostringstream trace;
+	trace << "{\"traceEvents\":[";
+	for(int i = 0; i < _events.size(); ++i){
+		const ProfilerEvent &event = _events[i];
+		if(i > 0){
+			trace << ",";
+		}
+		
+		trace << "\n{\"name\":\"" << escapeJson(event.nodeName) << "\",\"cat\":\"node\",\"ph\":\"X\"";
+		trace << ",\"ts\":" << event.startTime << ",\"dur\":" << event.duration;
+		trace << ",\"pid\":0,\"tid\":" << event.thread;
+		trace << ",\"args\":{\"attribute\":\"" << escapeJson(event.attributeName) << "\",\"slices\":" << event.slices << ",\"bytes\":" << event.bytes << "}}";
+	}
+	trace << "\n],\"displayTimeUnit\":\"ms\"}\n";
+	
+	return trace.str();
+}
+
+bool Profiler::saveChromeTrace(const std::string &filename){
+	std::ofstream file(filename.c_str());
+	if(!file){
+		return false;
+	}
+	
+	file << chromeTrace();
+	
+	return file.good();
+}
+
+std::string Profiler::aggregateTable(){
+	std::map<int, NodeTimes> nodeTimes;
+	
+	{
+		#ifdef CORAL_PARALLEL_TBB
+			tbb::mutex::scoped_lock lock(_eventsMutex);
+		#endif
+		
+		for(int i = 0; i < _events.size(); ++i){
+			const ProfilerEvent &event = _events[i];
+			NodeTimes &times = nodeTimes[event.nodeId];
+			times.nodeName = event.nodeName;
+			times.durations.push_back(event.duration);
+		}
+	}
+	
+	std::vector<NodeTimes*> sortedTimes;
+	for(std::map<int, NodeTimes>::iterator it = nodeTimes.begin(); it != nodeTimes.end(); ++it){
+		NodeTimes &times = it->second;
+		times.total = 0;
+		for(int i = 0; i < times.durations.size(); ++i){
+			times.total += times.durations[i];
+		}
+		
+		std::sort(times.durations.begin(), times.durations.end());
+		sortedTimes.push_back(&times);
+	}
+	
+	std::sort(sortedTimes.begin(), sortedTimes.end(), compareTotals);
+	
+	std::ostringstream table;
+	table << std::fixed << std::setprecision(3);
+	table << std::left << std::setw(48) << "node" << std::right;
+	table << std::setw(10) << "count" << std::setw(14) << "total ms" << std::setw(14) << "mean ms" << std::setw(14) << "p95 ms" << "\n";
+	
+	for(int i = 0; i < sortedTimes.size(); ++i){
+		NodeTimes *times = sortedTimes[i];
+		int count = times->durations.size();
+		int p95Index = std::max(0, (int)((count * 95 + 99) / 100) - 1);
+		
+		table << std::left << std::setw(48) << times->nodeName << std::right;
+		table << std::setw(10) << count;
+		table << std::setw(14) << times->total / 1000.0;
+		table << std::setw(14) << times->total / 1000.0 / count;
+		table << std::setw(14) << times->durations[p95Index] / 1000.0 << "\n";
+	}
+	
+	return table.str();
+}
@@ -0,0 +1,73 @@
+// <license>
+// Copyright (C) 2011 Andrea Interguglielmi, All rights reserved.
+// This file is part of the coral repository downloaded from http://code.google.com/p/coral-repo.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// 
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+// 
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+// IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// </license>
+
+#ifndef CORAL_PROFILER_H
+#define CORAL_PROFILER_H
+
+#include <string>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include "coralDefinitions.h"
+
+namespace coral{
+class Node;
+class Attribute;
+
+//! Records every node update while enabled, to find out where the time of an evaluation goes.
+//
+//! For each update it keeps start and end time, the thread that ran it, the number of slices and the bytes held by the node's outputs.
+//! Recorded updates can be exported in the Chrome trace event format, to be loaded in chrome://tracing, 
+//! or summarized per node as count, total, mean and 95th percentile time.
+class CORAL_EXPORT Profiler{
+public:
+	//! Starting the profiler discards anything recorded so far.
+	static void setEnabled(bool value);
+	static bool isEnabled();
+	static void clear();
+	static int eventCount();
+	
+	//! Returns the recorded updates as Chrome trace event JSON.
+	static std::string chromeTrace();
+	
+	//! Writes chromeTrace() to filename, returns false if the file can't be written.
+	static bool saveChromeTrace(const std::string &filename);
+	
+	//! Returns a table of count, total, mean and p95 update time of each node, in milliseconds and sorted by total time.
+	static std::string aggregateTable();
+
+private:
+	friend class Node;
+	
+	static void recordNodeUpdate(Node *node, Attribute *attribute, const boost::posix_time::ptime &startTime, const boost::posix_time::ptime &endTime);
+	
+	static bool _enabled;
+};
+
+}
+
+#endif
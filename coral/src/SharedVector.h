@@ -0,0 +1,172 @@
+// <license>
+// Copyright (C) 2011 Andrea Interguglielmi, All rights reserved.
+// This file is part of the coral repository downloaded from http://code.google.com/p/coral-repo.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// 
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+// 
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+// IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// </license>
+
+#ifndef CORAL_SHAREDVECTOR_H
+#define CORAL_SHAREDVECTOR_H
+
+#include <vector>
+#include <boost/shared_ptr.hpp>
+
+#include "ChunkedArray.h"
+
+namespace coral{
+
+//! A std::vector shared between copies with copy-on-write semantics.
+//! Copying a SharedVector only shares the buffer, the buffer is duplicated by write() when more than one owner is holding it.
+//! The content can also be backed by a ChunkedArray, read() then materializes it and write() turns it into a plain buffer.
+//! As with a plain buffer, the reference returned by read() stays valid until this SharedVector is modified, 
+//! after that only if the content wasn't shared.
+template<class T>
+class SharedVector{
+public:
+	SharedVector():
+		_data(new std::vector<T>()){
+	}
+	
+	const std::vector<T> &read() const{
+		if(_chunked){
+			return _chunked->values<T>(_materialized);
+		}
+		
+		return *_data;
+	}
+	
+	//! Returns a buffer owned by this SharedVector alone, only call this when the content is actually going to be modified.
+	std::vector<T> &write(){
+		if(_chunked && !_materialized){
+			// the chunks are copied straight into the new buffer, no contiguous copy is made on the way.
+			std::vector<T> *values = new std::vector<T>(_chunked->size());
+			if(!values->empty()){
+				_chunked->read(0, values->size(), (char*)&(*values)[0]);
+			}
+			
+			_chunked.reset();
+			_data.reset(values);
+		}
+		
+		releaseChunked();
+		if(!_data.unique()){
+			_data.reset(new std::vector<T>(*_data));
+		}
+		
+		return *_data;
+	}
+	
+	//! Replaces the content, a shared buffer is released rather than copied first.
+	void set(const std::vector<T> &values){
+		releaseChunked();
+		if(_data.unique()){
+			*_data = values;
+		}
+		else{
+			_data.reset(new std::vector<T>(values));
+		}
+	}
+	
+	//! Swaps the content with values, values is left with the previous content or empty if that was shared.
+	void swap(std::vector<T> &values){
+		releaseChunked();
+		if(!_data.unique()){
+			_data.reset(new std::vector<T>());
+		}
+		
+		_data->swap(values);
+	}
+	
+	void resize(unsigned int size){
+		if(_chunked && !_materialized){
+			// only the elements that are kept get loaded
+			std::vector<T> *values = new std::vector<T>(size);
+			if(size){
+				_chunked->read(0, size, (char*)&(*values)[0]);
+			}
+			
+			_chunked.reset();
+			_data.reset(values);
+		}
+		else if(_chunked || _data->size() != size){
+			write().resize(size);
+		}
+	}
+	
+	void clear(){
+		releaseChunked();
+		if(_data.unique()){
+			_data->clear();
+		}
+		else{
+			_data.reset(new std::vector<T>());
+		}
+	}
+	
+	bool isShared() const{
+		return _chunked || !_data.unique();
+	}
+	
+	//! Number of elements, doesn't materialize a chunked content.
+	unsigned int size() const{
+		if(_chunked){
+			return _chunked->size();
+		}
+		
+		return _data->size();
+	}
+	
+	//! The ChunkedArray backing the content, null when the content is a plain buffer.
+	const boost::shared_ptr<ChunkedArray> &chunked() const{
+		return _chunked;
+	}
+	
+	//! Backs the content with the given ChunkedArray, its element size must be sizeof(T).
+	void setChunked(const boost::shared_ptr<ChunkedArray> &chunked){
+		clear();
+		_chunked = chunked;
+	}
+	
+private:
+	boost::shared_ptr<std::vector<T> > _data;
+	boost::shared_ptr<ChunkedArray> _chunked;
+	
+	// contiguous copy of the chunked content handed out by read(), filled under the lock of the ChunkedArray.
+	mutable boost::shared_ptr<void> _materialized;
+	
+	// once materialized, the copy becomes the plain buffer so that the references returned by read() keep pointing at the content.
+	// it's only modified in place if nothing else holds it, like any other shared buffer.
+	void releaseChunked(){
+		if(_materialized){
+			_data = boost::static_pointer_cast<std::vector<T> >(_materialized);
+			_materialized.reset();
+		}
+		
+		_chunked.reset();
+	}
+};
+
+}
+
+#endif
@@ -0,0 +1,100 @@
+// <license>
+// Copyright (C) 2011 Andrea Interguglielmi, All rights reserved.
+// This file is part of the coral repository downloaded from http://code.google.com/p/coral-repo.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// 
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+// 
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+// IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// </license>
+
+#include <cstring>
+
+#include "SpatialIndex.h"
+#include "hashUtils.h"
+
+using namespace coral;
+
+SpatialIndex::SpatialIndex():
+	_points(new std::vector<Imath::V3f>()),
+	_tree(new FlatKdTree()),
+	_hash(hashUtils::hashVector(std::vector<Imath::V3f>())){
+}
+
+void SpatialIndex::copy(const Value *other){
+	const SpatialIndex *otherIndex = dynamic_cast<const SpatialIndex*>(other);
+	if(otherIndex){
+		_points = otherIndex->_points;
+		_tree = otherIndex->_tree;
+		_hash = otherIndex->_hash;
+	}
+}
+
+bool SpatialIndex::build(const std::vector<Imath::V3f> &points){
+	if(_points->size() == points.size()){
+		if(points.empty() || memcmp(&(*_points)[0], &points[0], points.size() * sizeof(Imath::V3f)) == 0){
+			return false;
+		}
+	}
+	
+	// copies made by copy() keep the old tree alive, the new one is built aside
+	boost::shared_ptr<std::vector<Imath::V3f> > newPoints(new std::vector<Imath::V3f>(points));
+	boost::shared_ptr<FlatKdTree> tree(new FlatKdTree());
+	tree->build(points);
+	
+	_points = newPoints;
+	_tree = tree;
+	_hash = hashUtils::hashVector(points);
+	
+	return true;
+}
+
+const std::vector<Imath::V3f> &SpatialIndex::points(){
+	return *_points;
+}
+
+unsigned int SpatialIndex::size(){
+	return _points->size();
+}
+
+const FlatKdTree &SpatialIndex::tree(){
+	return *_tree;
+}
+
+void SpatialIndex::pointsInRange(const Imath::V3f &point, float range, std::vector<int> &indices){
+	_tree->pointsInRange(point, range, indices);
+}
+
+int SpatialIndex::nearestPoint(const Imath::V3f &point){
+	return _tree->nearestPoint(point);
+}
+
+size_t SpatialIndex::sizeInBytes(){
+	return _points->size() * sizeof(Imath::V3f) + _tree->sizeInBytes();
+}
+
+bool SpatialIndex::isHashable(){
+	return true;
+}
+
+hashUtils::Hash SpatialIndex::hash(){
+	return _hash;
+}
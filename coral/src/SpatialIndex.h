@@ -0,0 +1,76 @@
+// <license>
+// Copyright (C) 2011 Andrea Interguglielmi, All rights reserved.
+// This file is part of the coral repository downloaded from http://code.google.com/p/coral-repo.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// 
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+// 
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+// IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// </license>
+
+#ifndef CORAL_SPATIALINDEX_H
+#define CORAL_SPATIALINDEX_H
+
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include <ImathVec.h>
+#include "Value.h"
+#include "FlatKdTree.h"
+
+namespace coral{
+
+//! Kd-tree over a set of points, built once by a BuildSpatialIndex node and shared by any number of query nodes.
+//! The tree is never modified after it's built, queries can run from all slices and threads at once.
+class CORAL_EXPORT SpatialIndex: public Value{
+public:
+	SpatialIndex();
+	
+	//! Shares the tree of other, no data is copied.
+	void copy(const Value *other);
+	
+	//! Indexes the given points, the tree is left untouched if they are the same points already indexed.
+	//! Returns true if the tree was rebuilt.
+	bool build(const std::vector<Imath::V3f> &points);
+	const std::vector<Imath::V3f> &points();
+	unsigned int size();
+	
+	//! The tree itself, for batched queries.
+	const FlatKdTree &tree();
+	
+	//! Fills indices with the points within range of point, in no particular order.
+	void pointsInRange(const Imath::V3f &point, float range, std::vector<int> &indices);
+	
+	//! Index of the point closest to point, -1 if the index is empty.
+	int nearestPoint(const Imath::V3f &point);
+	
+	size_t sizeInBytes();
+	bool isHashable();
+	hashUtils::Hash hash();
+	
+private:
+	boost::shared_ptr<std::vector<Imath::V3f> > _points;
+	boost::shared_ptr<FlatKdTree> _tree;
+	hashUtils::Hash _hash;
+};
+
+}
+
+#endif
@@ -26,7 +26,13 @@
 // SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // </license>
 
+#include <cstring>
+#include <sstream>
+
 #include "StringAttribute.h"
+#include "hashUtils.h"
+#include "NetworkBlobs.h"
+#include "ChunkedArray.h"
 
 using namespace coral;
 String::String():
@@ -182,6 +188,89 @@ void String::setFromString(const std::string &value)
 	}
 }
 
+// the blob holds the length of each string of the first slice followed by their characters
+std::string String::writeBlob(){
+	if(!NetworkBlobs::isSaving()){
+		return "";
+	}
+	
+	const std::vector<std::string> &values = _stringValuesSliced[0];
+	std::vector<unsigned int> lengths(values.size());
+	std::size_t characters = 0;
+	for(int i = 0; i < values.size(); ++i){
+		lengths[i] = values[i].size();
+		characters += values[i].size();
+	}
+	
+	std::size_t offset = NetworkBlobs::beginBlob();
+	if(lengths.size()){
+		NetworkBlobs::write(&lengths[0], lengths.size() * sizeof(unsigned int));
+	}
+	
+	for(int i = 0; i < values.size(); ++i){
+		NetworkBlobs::write(values[i].data(), values[i].size());
+	}
+	
+	std::ostringstream description;
+	description << offset << " " << values.size() << " " << characters << " " << int(_type);
+	
+	return description.str();
+}
+
+bool String::readBlob(const std::string &filename, const std::string &description){
+	std::istringstream fields(description);
+	std::size_t offset = 0;
+	unsigned int size = 0;
+	std::size_t characters = 0;
+	int typeId = 0;
+	fields >> offset >> size >> characters >> typeId;
+	if(fields.fail() || typeId <= stringTypeAny || typeId > pathTypeArray){
+		return false;
+	}
+	
+	std::size_t lengthsBytes = std::size_t(size) * sizeof(unsigned int);
+	boost::shared_ptr<Chunk> blob = NetworkBlobs::map(filename, offset, lengthsBytes + characters);
+	if(!blob){
+		return false;
+	}
+	
+	std::vector<unsigned int> lengths(size);
+	if(size){
+		std::memcpy(&lengths[0], blob->data(), lengthsBytes);
+	}
+	
+	std::vector<std::string> values(size);
+	const char *data = blob->data() + lengthsBytes;
+	std::size_t consumed = 0;
+	for(int i = 0; i < size; ++i){
+		std::size_t length = lengths[i];
+		if(consumed + length > characters){
+			break;
+		}
+		
+		values[i].assign(data + consumed, length);
+		consumed += length;
+	}
+	
+	// the saved type tells strings from paths and single values from arrays.
+	setType(String::Type(typeId));
+	_stringValuesSliced[0].swap(values);
+	
+	return true;
+}
+
+size_t String::sizeInBytes(){
+	size_t bytes = 0;
+	for(int i = 0; i < _stringValuesSliced.size(); ++i){
+		const std::vector<std::string> &values = _stringValuesSliced[i];
+		for(int j = 0; j < values.size(); ++j){
+			bytes += values[j].size();
+		}
+	}
+	
+	return bytes;
+}
+
 void String::setStringValueAtSlice(unsigned int slice, unsigned int id, std::string& value){
 	if (slice < _stringValuesSliced.size()){
 		std::vector<std::string> &slicevec = _stringValuesSliced[slice];
@@ -231,6 +320,19 @@ void String::setPathValuesSlice(unsigned int slice, const std::vector<std::strin
 	setStringValuesSlice(slice, values);
 }
 
+void String::swapStringValuesSlice(unsigned int slice, std::vector<std::string> &values){
+	if (slice < _stringValuesSliced.size()){
+		_stringValuesSliced[slice].swap(values);
+	}
+}
+
+std::vector<std::string> &String::mutableStringValuesSlice(unsigned int slice){
+	if (slice >= _stringValuesSliced.size()){
+		slice = _stringValuesSliced.size() - 1;
+	}
+	return _stringValuesSliced[slice];
+}
+
 const std::vector<std::string> &String::stringValuesSlice(unsigned int slice){
 	if(slice >= _stringValuesSliced.size()){
 		slice = _stringValuesSliced.size() - 1;
@@ -369,3 +471,20 @@ std::string StringAttribute::shortDebugInfo(){
 	}
 	return info;
 }
+
+bool String::isHashable(){
+	return true;
+}
+
+hashUtils::Hash String::hash(){
+	hashUtils::Hash hash = hashUtils::hashValue((int)_type);
+	for(int i = 0; i < _stringValuesSliced.size(); ++i){
+		const std::vector<std::string> &values = _stringValuesSliced[i];
+		hash = hashUtils::hashValue((unsigned int)values.size(), hash);
+		for(int j = 0; j < values.size(); ++j){
+			hash = hashUtils::hashString(values[j], hash);
+		}
+	}
+	
+	return hash;
+}
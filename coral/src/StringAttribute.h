@@ -52,6 +52,11 @@ namespace coral{
 		std::string asScript();
 		std::string sliceAsString(unsigned int slice);
 		void setFromString(const std::string &value);
+		std::string writeBlob();
+		bool readBlob(const std::string &filename, const std::string &description);
+		size_t sizeInBytes();
+		bool isHashable();
+		hashUtils::Hash hash();
 		void setType(String::Type type);
 		String::Type type();
 		bool isArray();
@@ -72,6 +77,12 @@ namespace coral{
 		void setPathValueAtSlice(unsigned int slice, unsigned int id, std::string& value);
 		void setStringValuesSlice(unsigned int slice, const std::vector<std::string> &values);
 		void setPathValuesSlice(unsigned int slice, const std::vector<std::string> &values);
+		
+		//! Hands the values over to the slice without copying them, values is left with the previous content of the slice.
+		void swapStringValuesSlice(unsigned int slice, std::vector<std::string> &values);
+		
+		//! Gives direct access to the values of a slice so they can be built in place.
+		std::vector<std::string> &mutableStringValuesSlice(unsigned int slice);
 
 		const std::string stringValueAt(unsigned int id);
 		const std::string pathValueAt(unsigned int id);
@@ -29,7 +29,8 @@
 
 using namespace coral;
 
-Value::Value(){
+Value::Value():
+	_version(0){
 }
 
 Value::~Value(){
@@ -42,8 +43,36 @@ std::string Value::asString(){
 void Value::setFromString(const std::string &value){
 }
 
+std::string Value::writeBlob(){
+	return "";
+}
+
+bool Value::readBlob(const std::string &filename, const std::string &description){
+	return false;
+}
+
 void Value::copy(const Value *other){
 }
 
 void Value::resizeSlices(unsigned int slices){
 }
+
+size_t Value::sizeInBytes(){
+	return 0;
+}
+
+bool Value::isHashable(){
+	return false;
+}
+
+hashUtils::Hash Value::hash(){
+	return 0;
+}
+
+unsigned int Value::version(){
+	return _version;
+}
+
+void Value::incrementVersion(){
+	_version += 1;
+}
@@ -31,6 +31,7 @@
 
 #include <string>
 #include "Object.h"
+#include "hashUtils.h"
 
 namespace coral{
 
@@ -43,7 +44,32 @@ public:
 	virtual void copy(const Value *other);
 	virtual std::string asString();
 	virtual void setFromString(const std::string &value);
+	
+	//! Saves the content of this value as a blob of the network being saved, see NetworkBlobs.
+	//! Returns the description of the blob passed back to readBlob(), or an empty string if this value has no binary form.
+	virtual std::string writeBlob();
+	
+	//! Restores the content saved by writeBlob() from the given blob file without parsing it.
+	//! Returns false and leaves the value untouched if the description is invalid or the blob is not in the file.
+	virtual bool readBlob(const std::string &filename, const std::string &description);
 	virtual void resizeSlices(unsigned int slices);
+	
+	//! Approximate number of bytes held by the data of this value, used by the Profiler to report how much data a node produced.
+	virtual size_t sizeInBytes();
+	
+	//! Returns true if this value reimplements hash(), values that don't are never considered unchanged by memoized nodes.
+	virtual bool isHashable();
+	
+	//! Hash of the content of this value, memoized nodes compare the hashes of their inputs to skip updates that would produce the same outputs.
+	virtual hashUtils::Hash hash();
+	
+	//! Stamp incremented every time this value is edited or recomputed to something different,
+	//! attributes compare the stamps of their inputs to find out whether they need to be updated at all.
+	unsigned int version();
+	void incrementVersion();
+
+private:
+	unsigned int _version;
 
 };
 
@@ -43,4 +43,11 @@
 	#endif
 #endif
 
+// SSE2 is part of every x86-64 target, define CORAL_NO_SIMD to build the scalar code paths only.
+#ifndef CORAL_NO_SIMD
+	#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+		#define CORAL_SIMD_SSE
+	#endif
+#endif
+
 #endif
@@ -29,48 +29,156 @@
 #ifndef CORAL_COREPARALLELALGOS_H
 #define CORAL_COREPARALLELALGOS_H
 
+#include "coralDefinitions.h"
+
 #ifdef CORAL_PARALLEL_TBB
 
 #include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_group.h>
+#include <tbb/atomic.h>
+#include <tbb/task_arena.h>
 #include <vector>
 #include "Attribute.h"
 #include "Node.h"
+#include "EvaluationContext.h"
+
+#endif // tbb
 
 namespace coral{
+
+//! Arrays with fewer elements than this threshold are processed by parallelFor on the calling thread.
+CORAL_EXPORT unsigned int parallelThreshold();
+CORAL_EXPORT void setParallelThreshold(unsigned int elements);
+
+//! Granularity parallelFor splits its ranges at: chunks of this size or less are never split further.
+//! It is not a maximum, TBB may stop splitting earlier and hand bigger chunks to a task.
+CORAL_EXPORT unsigned int parallelGrainSize();
+CORAL_EXPORT void setParallelGrainSize(unsigned int elements);
+
+#ifdef CORAL_PARALLEL_TBB
+
+template<class Body>
+class parallelFor_body{
+public:
+	parallelFor_body(const Body &body): _body(body){
+	}
+	
+	void operator() (const tbb::blocked_range<unsigned int> &r) const{
+		_body(r.begin(), r.end());
+	}
+
+private:
+	const Body &_body;
+};
+
+#endif // tbb
+
+//! Splits the range [0, size) in contiguous chunks, split down to parallelGrainSize() elements at the finest, 
+//! and calls body(begin, end) for each of them. Bodies must not rely on the size of the chunks they get.
+//! Chunks might run concurrently so the body must only write to the elements of its own chunk.
+//! Ranges below parallelThreshold() or builds without TBB run body(0, size) on the calling thread.
+//! Calls nested in a parallel slice update or in a clean chain task run in the same arena as their caller and share its workers.
+template<class Body>
+void parallelFor(unsigned int size, const Body &body){
+	#ifdef CORAL_PARALLEL_TBB
+		if(size >= parallelThreshold() && size > parallelGrainSize()){
+			tbb::parallel_for(tbb::blocked_range<unsigned int>(0, size, parallelGrainSize()), parallelFor_body<Body>(body));
+			return;
+		}
+	#endif
 	
-class attribute_parallelClean{
+	if(size){
+		body(0, size);
+	}
+}
+
+//! Same as parallelFor() but split down to grainSize elements and with no threshold,
+//! for bodies so heavy per element that even short ranges are worth splitting, like spatial queries.
+template<class Body>
+void parallelFor(unsigned int size, unsigned int grainSize, const Body &body){
+	#ifdef CORAL_PARALLEL_TBB
+		if(size > grainSize){
+			tbb::parallel_for(tbb::blocked_range<unsigned int>(0, size, grainSize), parallelFor_body<Body>(body));
+			return;
+		}
+	#endif
+	
+	if(size){
+		body(0, size);
+	}
+}
+
+#ifdef CORAL_PARALLEL_TBB
+	
+class attribute_cleanTask{
 public:
-	attribute_parallelClean(std::vector<Attribute*> *cleanChain): _cleanChain(cleanChain){ 
+	attribute_cleanTask(std::vector<CleanTask> *cleanChain, std::vector<tbb::atomic<int> > *dependencies, tbb::task_group *taskGroup, EvaluationContext *context, int task): 
+		_cleanChain(cleanChain), _dependencies(dependencies), _taskGroup(taskGroup), _context(context), _task(task){ 
 	}
 	
-	void operator() (const tbb::blocked_range<size_t> &r) const{
-		for(size_t i = r.begin(); i != r.end(); ++i){
-			_cleanChain->at(i)->cleanSelf();
+	void operator() () const{
+		// the task might run on any worker thread, nested pulls from the node's update must find the right context.
+		EvaluationContext *previousContext = EvaluationContext::setCurrent(_context);
+		
+		CleanTask &cleanTask = _cleanChain->at(_task);
+		cleanTask.attribute->cleanSelf();
+		
+		EvaluationContext::setCurrent(previousContext);
+		
+		// release the waiting tasks, the last dependency to complete is in charge of spawning the successor.
+		for(int i = 0; i < cleanTask.successors.size(); ++i){
+			int successor = cleanTask.successors[i];
+			if(--_dependencies->at(successor) == 0){
+				_taskGroup->run(attribute_cleanTask(_cleanChain, _dependencies, _taskGroup, _context, successor));
+			}
 		}
 	}
 
 private:
-	std::vector<Attribute*> *_cleanChain;
+	std::vector<CleanTask> *_cleanChain;
+	std::vector<tbb::atomic<int> > *_dependencies;
+	tbb::task_group *_taskGroup;
+	EvaluationContext *_context;
+	int _task;
 };
 
 class node_parallelUpdate{
 public:
 	node_parallelUpdate(Node *node, Attribute* attribute): _node(node), _attribute(attribute){ 
+		_context = EvaluationContext::current();
 	}
 	
 	void operator() (const tbb::blocked_range<size_t> &r) const{
-		for(size_t i = r.begin(); i != r.end(); ++i){
-			_node->updateSlice(_attribute, i);
-		}
+		EvaluationContext *previousContext = EvaluationContext::setCurrent(_context);
+		
+		_node->updateSlices(_attribute, r.begin(), r.end());
+		
+		EvaluationContext::setCurrent(previousContext);
 	}
 
 private:
 	Node *_node;
 	Attribute *_attribute;
+	EvaluationContext *_context;
 };
 
-}
+class node_isolatedUpdate{
+public:
+	node_isolatedUpdate(Node *node, Attribute* attribute): _node(node), _attribute(attribute){ 
+	}
+	
+	void operator() () const{
+		_node->doUpdate(_attribute);
+	}
+
+private:
+	Node *_node;
+	Attribute *_attribute;
+};
 
 #endif // tbb
 
+}
+
 #endif
@@ -0,0 +1,100 @@
+// <license>
+// Copyright (C) 2011 Andrea Interguglielmi, All rights reserved.
+// This file is part of the coral repository downloaded from http://code.google.com/p/coral-repo.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// 
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+// 
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+// IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// </license>
+
+#ifndef CORAL_HASHUTILS_H
+#define CORAL_HASHUTILS_H
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <cstring>
+
+//! 64 bit hashing of raw memory, used by Value::hash() to summarize the content of a value.
+//
+//! Memory is folded in FNV-1a fashion eight bytes at a time, each word is mixed first so that every bit reaches the whole hash.
+//! There's no finalization step, hashing a buffer in pieces gives the same hash as hashing it at once
+//! as long as every piece but the last one is a multiple of eight bytes.
+namespace hashUtils{
+	typedef unsigned long long Hash;
+	
+	const Hash hashSeed = 14695981039346656037ULL;
+	const Hash hashPrime = 1099511628211ULL;
+	
+	inline Hash mixWord(Hash word){
+		word ^= word >> 33;
+		word *= 0xff51afd7ed558ccdULL;
+		word ^= word >> 33;
+		word *= 0xc4ceb9fe1a85ec53ULL;
+		word ^= word >> 33;
+		
+		return word;
+	}
+	
+	inline Hash hashBytes(const void *data, std::size_t size, Hash hash = hashSeed){
+		const unsigned char *bytes = (const unsigned char*)data;
+		
+		std::size_t wordsEnd = size - size % sizeof(Hash);
+		for(std::size_t i = 0; i < wordsEnd; i += sizeof(Hash)){
+			Hash word;
+			memcpy(&word, bytes + i, sizeof(Hash));
+			
+			hash ^= mixWord(word);
+			hash *= hashPrime;
+		}
+		
+		for(std::size_t i = wordsEnd; i < size; ++i){
+			hash ^= bytes[i];
+			hash *= hashPrime;
+		}
+		
+		return hash;
+	}
+	
+	template<class T>
+	Hash hashValue(const T &value, Hash hash = hashSeed){
+		return hashBytes(&value, sizeof(T), hash);
+	}
+	
+	//! Only meant for vectors of plain data, the size is hashed too so that empty vectors change the hash.
+	template<class T>
+	Hash hashVector(const std::vector<T> &values, Hash hash = hashSeed){
+		hash = hashValue((unsigned int)values.size(), hash);
+		if(values.size()){
+			hash = hashBytes(&values[0], values.size() * sizeof(T), hash);
+		}
+		
+		return hash;
+	}
+	
+	inline Hash hashString(const std::string &str, Hash hash = hashSeed){
+		hash = hashValue((unsigned int)str.size(), hash);
+		return hashBytes(str.data(), str.size(), hash);
+	}
+}
+
+#endif
@@ -31,6 +31,8 @@
 
 #include <boost/python.hpp>
 #include <vector>
+#include <cstring>
+#include <boost/shared_ptr.hpp>
 #include "PythonDataCollector.h"
 #include "Node.h"
 
@@ -214,6 +216,180 @@ namespace pythonWrapperUtils{
 		return _common__init__impl<WrappedType>(self);
 	}
 	
+	// buffer protocol
+	
+	//! Python object exporting memory owned by C++ through the buffer protocol, handle keeps that memory alive.
+	struct BufferViewOwner{
+		PyObject_HEAD
+		boost::shared_ptr<void> *handle;
+		const void *data;
+		Py_ssize_t len;
+		Py_ssize_t itemSize;
+		const char *format;
+		int ndim;
+		Py_ssize_t shape[3];
+		Py_ssize_t strides[3];
+	};
+	
+	inline void bufferViewOwnerDealloc(PyObject *object){
+		delete reinterpret_cast<BufferViewOwner*>(object)->handle;
+		PyObject_Del(object);
+	}
+	
+	inline int bufferViewOwnerGetBuffer(PyObject *object, Py_buffer *view, int flags){
+		BufferViewOwner *owner = reinterpret_cast<BufferViewOwner*>(object);
+		if((flags & PyBUF_WRITABLE) == PyBUF_WRITABLE){
+			PyErr_SetString(PyExc_BufferError, "buffer is read-only");
+			return -1;
+		}
+		
+		Py_INCREF(object);
+		view->obj = object;
+		view->buf = const_cast<void*>(owner->data);
+		view->len = owner->len;
+		view->readonly = 1;
+		view->itemsize = owner->itemSize;
+		view->format = (flags & PyBUF_FORMAT) == PyBUF_FORMAT ? const_cast<char*>(owner->format) : 0;
+		view->ndim = owner->ndim;
+		view->shape = (flags & PyBUF_ND) == PyBUF_ND ? owner->shape : 0;
+		view->strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? owner->strides : 0;
+		view->suboffsets = 0;
+		view->internal = 0;
+		
+		return 0;
+	}
+	
+	inline PyTypeObject *bufferViewOwnerType(){
+		static PyTypeObject type;
+		static PyBufferProcs bufferProcs;
+		static bool ready = false;
+		
+		if(!ready){
+			Py_REFCNT(&type) = 1;
+			type.tp_name = "coral.BufferViewOwner";
+			type.tp_basicsize = sizeof(BufferViewOwner);
+			type.tp_dealloc = bufferViewOwnerDealloc;
+			type.tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_NEWBUFFER;
+			bufferProcs.bf_getbuffer = bufferViewOwnerGetBuffer;
+			type.tp_as_buffer = &bufferProcs;
+			
+			if(PyType_Ready(&type) < 0){
+				boost::python::throw_error_already_set();
+			}
+			
+			ready = true;
+		}
+		
+		return &type;
+	}
+	
+	//! Wraps size elements, each made of rows x columns scalars of the given struct format, in a memoryview without copying them.
+	//! NumPy arrays built from the view share its memory, handle keeps that memory alive for as long as the view or any of those arrays exist.
+	//! The view is read only, the memory may be shared by several values.
+	inline boost::python::object bufferView(const void *data, unsigned int size, unsigned int rows, unsigned int columns, const char *format, Py_ssize_t scalarSize, const boost::shared_ptr<void> &handle){
+		static double emptyData = 0.0;
+		if(!data){
+			data = &emptyData;
+			size = 0;
+		}
+		
+		BufferViewOwner *owner = PyObject_New(BufferViewOwner, bufferViewOwnerType());
+		if(!owner){
+			boost::python::throw_error_already_set();
+		}
+		
+		owner->handle = new boost::shared_ptr<void>(handle);
+		owner->data = data;
+		owner->itemSize = scalarSize;
+		owner->format = format;
+		owner->ndim = rows * columns == 1 ? 1 : (rows == 1 ? 2 : 3);
+		owner->shape[0] = size;
+		owner->shape[1] = rows == 1 ? columns : rows;
+		owner->shape[2] = columns;
+		owner->strides[0] = rows * columns * scalarSize;
+		owner->strides[1] = rows == 1 ? scalarSize : columns * scalarSize;
+		owner->strides[2] = scalarSize;
+		owner->len = owner->strides[0] * size;
+		
+		// the view holds its own reference to the owner
+		boost::python::object ownerObject(boost::python::handle<>(reinterpret_cast<PyObject*>(owner)));
+		
+		return boost::python::object(boost::python::handle<>(PyMemoryView_FromObject(ownerObject.ptr())));
+	}
+	
+	//! Contiguous memory exposed by a Python object, NumPy arrays and memoryviews through the new buffer protocol, str and array.array through the old one.
+	class ContiguousBuffer{
+	public:
+		ContiguousBuffer(boost::python::object object):
+			_data(0),
+			_size(0),
+			_itemSize(1),
+			_format(0),
+			_hasView(false){
+			
+			if(PyObject_CheckBuffer(object.ptr())){
+				if(PyObject_GetBuffer(object.ptr(), &_view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) == -1){
+					boost::python::throw_error_already_set();
+				}
+				
+				_hasView = true;
+				_data = _view.buf;
+				_size = _view.len;
+				_itemSize = _view.itemsize;
+				_format = _view.format;
+			}
+			else if(PyObject_AsReadBuffer(object.ptr(), &_data, &_size) == -1){
+				boost::python::throw_error_already_set();
+			}
+		}
+		
+		~ContiguousBuffer(){
+			if(_hasView){
+				PyBuffer_Release(&_view);
+			}
+		}
+		
+		const void *data(){
+			return _data;
+		}
+		
+		//! Size in bytes.
+		Py_ssize_t size(){
+			return _size;
+		}
+		
+		//! Raises a Python exception unless the buffer holds whole elements of elementSize bytes made of scalars of the given struct format.
+		//! Buffers of raw bytes are always accepted.
+		void check(char scalarFormat, Py_ssize_t scalarSize, Py_ssize_t elementSize){
+			if(_format){
+				const char *format = _format;
+				if(*format == '@' || *format == '=' || *format == '<'){
+					format++;
+				}
+				
+				bool rawBytes = *format == 'B' || *format == 'b' || *format == 'c';
+				bool sameKind = *format == scalarFormat || (scalarFormat == 'i' && *format == 'l');
+				if(!rawBytes && (!sameKind || format[1] != '\0' || _itemSize != scalarSize)){
+					PyErr_SetString(PyExc_TypeError, "buffer format doesn't match the type of the values");
+					boost::python::throw_error_already_set();
+				}
+			}
+			
+			if(_size % elementSize){
+				PyErr_SetString(PyExc_ValueError, "buffer size is not a multiple of the size of the values");
+				boost::python::throw_error_already_set();
+			}
+		}
+		
+	private:
+		const void *_data;
+		Py_ssize_t _size;
+		Py_ssize_t _itemSize;
+		const char *_format;
+		bool _hasView;
+		Py_buffer _view;
+	};
+	
 	// simplified wrappers
 	template<class WrappedType, class BaseClass>
 	boost::python::class_<WrappedType, boost::shared_ptr<WrappedType>, boost::python::bases<BaseClass>, boost::noncopyable>
@@ -0,0 +1,523 @@
+// <license>
+// Copyright (C) 2011 Andrea Interguglielmi, All rights reserved.
+// This file is part of the coral repository downloaded from http://code.google.com/p/coral-repo.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// 
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+// 
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+// IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// </license>
+
+#include <limits>
+
+#ifdef CORAL_PARALLEL_TBB
+	#include <tbb/atomic.h>
+#endif
+
+#include "simdUtils.h"
+
+#ifdef CORAL_SIMD_SSE
+	#include <emmintrin.h>
+	
+	// kernels for instruction sets above SSE2 are compiled with per function target attributes and only called once the cpu is checked,
+	// older compilers without that support stay on SSE2.
+	#if defined(_MSC_VER) && _MSC_VER >= 1910
+		#include <intrin.h>
+		#include <immintrin.h>
+		#define CORAL_SIMD_DISPATCH
+		#define CORAL_SIMD_TARGET(isa)
+	#elif defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 5)
+		#include <immintrin.h>
+		#define CORAL_SIMD_DISPATCH
+		#define CORAL_SIMD_TARGET(isa) __attribute__((target(isa)))
+	#endif
+#endif
+
+namespace{
+	typedef void (*FloatArraysKernel)(const float*, const float*, float*, int);
+	typedef void (*FloatArrayScalarKernel)(const float*, float, float*, int);
+	typedef void (*IntArraysKernel)(const int*, const int*, int*, int);
+	typedef void (*IntArrayScalarKernel)(const int*, int, int*, int);
+	
+	struct Kernels{
+		FloatArraysKernel floatArrays[4];
+		FloatArrayScalarKernel floatArrayScalar[4];
+		IntArraysKernel intArrays[4];
+		IntArrayScalarKernel intArrayScalar[4];
+	};
+	
+	#define SCALAR_KERNELS(type, typeName, operationName, sign) \
+		void operationName##typeName##Arrays_scalar(const type *valuesA, const type *valuesB, type *result, int size){ \
+			for(int i = 0; i < size; ++i){ \
+				result[i] = valuesA[i] sign valuesB[i]; \
+			} \
+		} \
+		void operationName##typeName##ArrayScalar_scalar(const type *values, type scalar, type *result, int size){ \
+			for(int i = 0; i < size; ++i){ \
+				result[i] = values[i] sign scalar; \
+			} \
+		}
+	
+	// the leftover values past the last full register run the scalar expression, 
+	// element wise operations round the same way in both paths so the results are identical.
+	#define VECTOR_KERNELS(isa, target, type, typeName, operationName, sign, width, registerType, load, store, set1, operation) \
+		target void operationName##typeName##Arrays_##isa(const type *valuesA, const type *valuesB, type *result, int size){ \
+			int i = 0; \
+			for(; i + width <= size; i += width){ \
+				store(result + i, operation(load(valuesA + i), load(valuesB + i))); \
+			} \
+			for(; i < size; ++i){ \
+				result[i] = valuesA[i] sign valuesB[i]; \
+			} \
+		} \
+		target void operationName##typeName##ArrayScalar_##isa(const type *values, type scalar, type *result, int size){ \
+			registerType scalars = set1(scalar); \
+			int i = 0; \
+			for(; i + width <= size; i += width){ \
+				store(result + i, operation(load(values + i), scalars)); \
+			} \
+			for(; i < size; ++i){ \
+				result[i] = values[i] sign scalar; \
+			} \
+		}
+	
+	#define KERNELS_ROW(floatIsa, intIsa, intMulIsa) \
+		{ \
+			{addFloatArrays_##floatIsa, subFloatArrays_##floatIsa, mulFloatArrays_##floatIsa, divFloatArrays_##floatIsa}, \
+			{addFloatArrayScalar_##floatIsa, subFloatArrayScalar_##floatIsa, mulFloatArrayScalar_##floatIsa, divFloatArrayScalar_##floatIsa}, \
+			{addIntArrays_##intIsa, subIntArrays_##intIsa, mulIntArrays_##intMulIsa, divIntArrays_scalar}, \
+			{addIntArrayScalar_##intIsa, subIntArrayScalar_##intIsa, mulIntArrayScalar_##intMulIsa, divIntArrayScalar_scalar} \
+		}
+	
+	SCALAR_KERNELS(float, Float, add, +)
+	SCALAR_KERNELS(float, Float, sub, -)
+	SCALAR_KERNELS(float, Float, mul, *)
+	SCALAR_KERNELS(float, Float, div, /)
+	SCALAR_KERNELS(int, Int, add, +)
+	SCALAR_KERNELS(int, Int, sub, -)
+	SCALAR_KERNELS(int, Int, mul, *)
+	SCALAR_KERNELS(int, Int, div, /)
+	
+#ifdef CORAL_SIMD_SSE
+	inline __m128 loadFloats_sse2(const float *values){
+		return _mm_loadu_ps(values);
+	}
+	
+	inline void storeFloats_sse2(float *values, __m128 lanes){
+		_mm_storeu_ps(values, lanes);
+	}
+	
+	inline __m128i loadInts_sse2(const int *values){
+		return _mm_loadu_si128((const __m128i*)values);
+	}
+	
+	inline void storeInts_sse2(int *values, __m128i lanes){
+		_mm_storeu_si128((__m128i*)values, lanes);
+	}
+	
+	VECTOR_KERNELS(sse2, , float, Float, add, +, 4, __m128, loadFloats_sse2, storeFloats_sse2, _mm_set1_ps, _mm_add_ps)
+	VECTOR_KERNELS(sse2, , float, Float, sub, -, 4, __m128, loadFloats_sse2, storeFloats_sse2, _mm_set1_ps, _mm_sub_ps)
+	VECTOR_KERNELS(sse2, , float, Float, mul, *, 4, __m128, loadFloats_sse2, storeFloats_sse2, _mm_set1_ps, _mm_mul_ps)
+	VECTOR_KERNELS(sse2, , float, Float, div, /, 4, __m128, loadFloats_sse2, storeFloats_sse2, _mm_set1_ps, _mm_div_ps)
+	VECTOR_KERNELS(sse2, , int, Int, add, +, 4, __m128i, loadInts_sse2, storeInts_sse2, _mm_set1_epi32, _mm_add_epi32)
+	VECTOR_KERNELS(sse2, , int, Int, sub, -, 4, __m128i, loadInts_sse2, storeInts_sse2, _mm_set1_epi32, _mm_sub_epi32)
+	
+#ifdef CORAL_SIMD_DISPATCH
+	// 32 bit integer multiplication arrived with SSE4.1
+	VECTOR_KERNELS(sse42, CORAL_SIMD_TARGET("sse4.2"), int, Int, mul, *, 4, __m128i, loadInts_sse2, storeInts_sse2, _mm_set1_epi32, _mm_mullo_epi32)
+	
+	CORAL_SIMD_TARGET("avx2") inline __m256 loadFloats_avx2(const float *values){
+		return _mm256_loadu_ps(values);
+	}
+	
+	CORAL_SIMD_TARGET("avx2") inline void storeFloats_avx2(float *values, __m256 lanes){
+		_mm256_storeu_ps(values, lanes);
+	}
+	
+	CORAL_SIMD_TARGET("avx2") inline __m256i loadInts_avx2(const int *values){
+		return _mm256_loadu_si256((const __m256i*)values);
+	}
+	
+	CORAL_SIMD_TARGET("avx2") inline void storeInts_avx2(int *values, __m256i lanes){
+		_mm256_storeu_si256((__m256i*)values, lanes);
+	}
+	
+	VECTOR_KERNELS(avx2, CORAL_SIMD_TARGET("avx2"), float, Float, add, +, 8, __m256, loadFloats_avx2, storeFloats_avx2, _mm256_set1_ps, _mm256_add_ps)
+	VECTOR_KERNELS(avx2, CORAL_SIMD_TARGET("avx2"), float, Float, sub, -, 8, __m256, loadFloats_avx2, storeFloats_avx2, _mm256_set1_ps, _mm256_sub_ps)
+	VECTOR_KERNELS(avx2, CORAL_SIMD_TARGET("avx2"), float, Float, mul, *, 8, __m256, loadFloats_avx2, storeFloats_avx2, _mm256_set1_ps, _mm256_mul_ps)
+	VECTOR_KERNELS(avx2, CORAL_SIMD_TARGET("avx2"), float, Float, div, /, 8, __m256, loadFloats_avx2, storeFloats_avx2, _mm256_set1_ps, _mm256_div_ps)
+	VECTOR_KERNELS(avx2, CORAL_SIMD_TARGET("avx2"), int, Int, add, +, 8, __m256i, loadInts_avx2, storeInts_avx2, _mm256_set1_epi32, _mm256_add_epi32)
+	VECTOR_KERNELS(avx2, CORAL_SIMD_TARGET("avx2"), int, Int, sub, -, 8, __m256i, loadInts_avx2, storeInts_avx2, _mm256_set1_epi32, _mm256_sub_epi32)
+	VECTOR_KERNELS(avx2, CORAL_SIMD_TARGET("avx2"), int, Int, mul, *, 8, __m256i, loadInts_avx2, storeInts_avx2, _mm256_set1_epi32, _mm256_mullo_epi32)
+	
+	CORAL_SIMD_TARGET("avx512f") inline __m512 loadFloats_avx512(const float *values){
+		return _mm512_loadu_ps(values);
+	}
+	
+	CORAL_SIMD_TARGET("avx512f") inline void storeFloats_avx512(float *values, __m512 lanes){
+		_mm512_storeu_ps(values, lanes);
+	}
+	
+	CORAL_SIMD_TARGET("avx512f") inline __m512i loadInts_avx512(const int *values){
+		return _mm512_loadu_si512((const void*)values);
+	}
+	
+	CORAL_SIMD_TARGET("avx512f") inline void storeInts_avx512(int *values, __m512i lanes){
+		_mm512_storeu_si512((void*)values, lanes);
+	}
+	
+	VECTOR_KERNELS(avx512, CORAL_SIMD_TARGET("avx512f"), float, Float, add, +, 16, __m512, loadFloats_avx512, storeFloats_avx512, _mm512_set1_ps, _mm512_add_ps)
+	VECTOR_KERNELS(avx512, CORAL_SIMD_TARGET("avx512f"), float, Float, sub, -, 16, __m512, loadFloats_avx512, storeFloats_avx512, _mm512_set1_ps, _mm512_sub_ps)
+	VECTOR_KERNELS(avx512, CORAL_SIMD_TARGET("avx512f"), float, Float, mul, *, 16, __m512, loadFloats_avx512, storeFloats_avx512, _mm512_set1_ps, _mm512_mul_ps)
+	VECTOR_KERNELS(avx512, CORAL_SIMD_TARGET("avx512f"), float, Float, div, /, 16, __m512, loadFloats_avx512, storeFloats_avx512, _mm512_set1_ps, _mm512_div_ps)
+	VECTOR_KERNELS(avx512, CORAL_SIMD_TARGET("avx512f"), int, Int, add, +, 16, __m512i, loadInts_avx512, storeInts_avx512, _mm512_set1_epi32, _mm512_add_epi32)
+	VECTOR_KERNELS(avx512, CORAL_SIMD_TARGET("avx512f"), int, Int, sub, -, 16, __m512i, loadInts_avx512, storeInts_avx512, _mm512_set1_epi32, _mm512_sub_epi32)
+	VECTOR_KERNELS(avx512, CORAL_SIMD_TARGET("avx512f"), int, Int, mul, *, 16, __m512i, loadInts_avx512, storeInts_avx512, _mm512_set1_epi32, _mm512_mullo_epi32)
+#endif
+#endif
+	
+	// indexed by simdUtils::InstructionSet, rows this build can't run are filled with the scalar kernels and never selected.
+	Kernels kernels[] = {
+		KERNELS_ROW(scalar, scalar, scalar),
+	#ifdef CORAL_SIMD_SSE
+		KERNELS_ROW(sse2, sse2, scalar),
+	#else
+		KERNELS_ROW(scalar, scalar, scalar),
+	#endif
+	#ifdef CORAL_SIMD_DISPATCH
+		KERNELS_ROW(sse2, sse2, sse42),
+		KERNELS_ROW(avx2, avx2, avx2),
+		KERNELS_ROW(avx512, avx512, avx512)
+	#else
+		KERNELS_ROW(scalar, scalar, scalar),
+		KERNELS_ROW(scalar, scalar, scalar),
+		KERNELS_ROW(scalar, scalar, scalar)
+	#endif
+	};
+	
+	simdUtils::InstructionSet detectInstructionSet(){
+	#if defined(CORAL_SIMD_DISPATCH) && defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 0);
+		int maxLeaf = info[0];
+		
+		__cpuid(info, 1);
+		bool sse42 = (info[2] & (1 << 20)) != 0;
+		bool osAvx = false;
+		bool osAvx512 = false;
+		if((info[2] & (1 << 27)) && (info[2] & (1 << 28))){
+			// the os must save the ymm and zmm registers on context switches
+			unsigned long long xcr0 = _xgetbv(0);
+			osAvx = (xcr0 & 0x6) == 0x6;
+			osAvx512 = (xcr0 & 0xe6) == 0xe6;
+		}
+		
+		bool avx2 = false;
+		bool avx512 = false;
+		if(maxLeaf >= 7){
+			__cpuidex(info, 7, 0);
+			avx2 = osAvx && (info[1] & (1 << 5));
+			avx512 = osAvx512 && (info[1] & (1 << 16));
+		}
+		
+		if(avx512){
+			return simdUtils::instructionSetAVX512;
+		}
+		else if(avx2){
+			return simdUtils::instructionSetAVX2;
+		}
+		else if(sse42){
+			return simdUtils::instructionSetSSE42;
+		}
+		
+		return simdUtils::instructionSetSSE2;
+	#elif defined(CORAL_SIMD_DISPATCH)
+		__builtin_cpu_init();
+		if(__builtin_cpu_supports("avx512f")){
+			return simdUtils::instructionSetAVX512;
+		}
+		else if(__builtin_cpu_supports("avx2")){
+			return simdUtils::instructionSetAVX2;
+		}
+		else if(__builtin_cpu_supports("sse4.2")){
+			return simdUtils::instructionSetSSE42;
+		}
+		
+		return simdUtils::instructionSetSSE2;
+	#elif defined(CORAL_SIMD_SSE)
+		return simdUtils::instructionSetSSE2;
+	#else
+		return simdUtils::instructionSetScalar;
+	#endif
+	}
+	
+	// detected on first use, static constructors of other files may already run kernels.
+	simdUtils::InstructionSet detectedInstructionSet(){
+		static simdUtils::InstructionSet supported = detectInstructionSet();
+		return supported;
+	}
+	
+	// the instruction set plus one, zero until setInstructionSet is called and the supported set is used.
+	// static storage is zero filled before any constructor runs and the value can be changed while kernels run on other threads.
+	#ifdef CORAL_PARALLEL_TBB
+		tbb::atomic<int> _instructionSetChoice;
+	#else
+		int _instructionSetChoice = 0;
+	#endif
+	
+	inline simdUtils::InstructionSet currentInstructionSet(){
+		int choice = _instructionSetChoice;
+		if(choice == 0){
+			return detectedInstructionSet();
+		}
+		
+		return simdUtils::InstructionSet(choice - 1);
+	}
+	
+#ifdef CORAL_SIMD_SSE
+	// the SSE2 vec3 kernels below are skipped entirely when the scalar code is requested.
+	inline int sseSize(int size){
+		if(currentInstructionSet() == simdUtils::instructionSetScalar){
+			return 0;
+		}
+		
+		return size;
+	}
+	
+	// x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3  ->  x0 x1 x2 x3 | y0 y1 y2 y3 | z0 z1 z2 z3
+	inline void loadVec3Lanes(const Imath::V3f *values, __m128 &x, __m128 &y, __m128 &z){
+		const float *data = &values[0].x;
+		__m128 a = _mm_loadu_ps(data);
+		__m128 b = _mm_loadu_ps(data + 4);
+		__m128 c = _mm_loadu_ps(data + 8);
+		
+		__m128 x2y2z2x3 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 0, 3, 2));
+		__m128 y0z0y1z1 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 0, 2, 1));
+		__m128 x2y2y3z3 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(3, 2, 3, 2));
+		
+		x = _mm_shuffle_ps(a, x2y2z2x3, _MM_SHUFFLE(3, 0, 3, 0));
+		y = _mm_shuffle_ps(y0z0y1z1, x2y2y3z3, _MM_SHUFFLE(2, 1, 2, 0));
+		z = _mm_shuffle_ps(y0z0y1z1, c, _MM_SHUFFLE(3, 0, 3, 1));
+	}
+	
+	// inverse of loadVec3Lanes
+	inline void storeVec3Lanes(__m128 x, __m128 y, __m128 z, Imath::V3f *values){
+		__m128 x0y0x1y1 = _mm_unpacklo_ps(x, y);
+		__m128 x2y2x3y3 = _mm_unpackhi_ps(x, y);
+		
+		__m128 z0z0x1x1 = _mm_shuffle_ps(z, x0y0x1y1, _MM_SHUFFLE(2, 2, 0, 0));
+		__m128 y1y1z1z1 = _mm_shuffle_ps(x0y0x1y1, z, _MM_SHUFFLE(1, 1, 3, 3));
+		__m128 z2z2x3x3 = _mm_shuffle_ps(z, x2y2x3y3, _MM_SHUFFLE(2, 2, 2, 2));
+		__m128 y3y3z3z3 = _mm_shuffle_ps(x2y2x3y3, z, _MM_SHUFFLE(3, 3, 3, 3));
+		
+		float *data = &values[0].x;
+		_mm_storeu_ps(data, _mm_shuffle_ps(x0y0x1y1, z0z0x1x1, _MM_SHUFFLE(2, 0, 1, 0)));
+		_mm_storeu_ps(data + 4, _mm_shuffle_ps(y1y1z1z1, x2y2x3y3, _MM_SHUFFLE(1, 0, 2, 0)));
+		_mm_storeu_ps(data + 8, _mm_shuffle_ps(z2z2x3x3, y3y3z3z3, _MM_SHUFFLE(2, 0, 2, 0)));
+	}
+	
+	// same operation order as Imath::Vec3::dot so that results match bit for bit.
+	inline __m128 dotLanes(__m128 xA, __m128 yA, __m128 zA, __m128 xB, __m128 yB, __m128 zB){
+		return _mm_add_ps(_mm_add_ps(_mm_mul_ps(xA, xB), _mm_mul_ps(yA, yB)), _mm_mul_ps(zA, zB));
+	}
+	
+	// Imath::Vec3::length switches to a slower and more accurate formula for squared lengths this small.
+	inline bool anyTinyLength(__m128 length2){
+		return _mm_movemask_ps(_mm_cmplt_ps(length2, _mm_set1_ps(2.0f * std::numeric_limits<float>::min()))) != 0;
+	}
+	
+	// one column of Imath's vec3 * matrix44, same operation order.
+	inline __m128 transformLanes(__m128 x, __m128 y, __m128 z, const __m128 matrix[4][4], int column){
+		return _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, matrix[0][column]), _mm_mul_ps(y, matrix[1][column])), _mm_mul_ps(z, matrix[2][column])), matrix[3][column]);
+	}
+#endif
+}
+
+namespace simdUtils{
+
+bool enabled(){
+	return currentInstructionSet() != instructionSetScalar;
+}
+
+InstructionSet supportedInstructionSet(){
+	return detectedInstructionSet();
+}
+
+InstructionSet instructionSet(){
+	return currentInstructionSet();
+}
+
+void setInstructionSet(InstructionSet instructionSet){
+	InstructionSet supported = detectedInstructionSet();
+	if(instructionSet > supported){
+		instructionSet = supported;
+	}
+	else if(instructionSet < instructionSetScalar){
+		instructionSet = instructionSetScalar;
+	}
+	
+	_instructionSetChoice = int(instructionSet) + 1;
+}
+
+void floatArrays(Operation operation, const float *valuesA, const float *valuesB, float *result, int size){
+	kernels[currentInstructionSet()].floatArrays[operation](valuesA, valuesB, result, size);
+}
+
+void floatArrayScalar(Operation operation, const float *values, float scalar, float *result, int size){
+	kernels[currentInstructionSet()].floatArrayScalar[operation](values, scalar, result, size);
+}
+
+void intArrays(Operation operation, const int *valuesA, const int *valuesB, int *result, int size){
+	kernels[currentInstructionSet()].intArrays[operation](valuesA, valuesB, result, size);
+}
+
+void intArrayScalar(Operation operation, const int *values, int scalar, int *result, int size){
+	kernels[currentInstructionSet()].intArrayScalar[operation](values, scalar, result, size);
+}
+
+void vec3MulMatrix44(const Imath::V3f *values, const Imath::M44f &matrix, Imath::V3f *result, int size){
+	int i = 0;
+	
+	#ifdef CORAL_SIMD_SSE
+		int vectorizedSize = sseSize(size);
+		if(vectorizedSize >= 4){
+			__m128 matrixLanes[4][4];
+			for(int row = 0; row < 4; ++row){
+				for(int column = 0; column < 4; ++column){
+					matrixLanes[row][column] = _mm_set1_ps(matrix[row][column]);
+				}
+			}
+			
+			for(; i + 4 <= vectorizedSize; i += 4){
+				__m128 x, y, z;
+				loadVec3Lanes(values + i, x, y, z);
+				
+				__m128 w = transformLanes(x, y, z, matrixLanes, 3);
+				storeVec3Lanes(
+					_mm_div_ps(transformLanes(x, y, z, matrixLanes, 0), w), 
+					_mm_div_ps(transformLanes(x, y, z, matrixLanes, 1), w), 
+					_mm_div_ps(transformLanes(x, y, z, matrixLanes, 2), w), 
+					result + i);
+			}
+		}
+	#endif
+	
+	for(; i < size; ++i){
+		result[i] = values[i] * matrix;
+	}
+}
+
+void vec3Length(const Imath::V3f *values, float *result, int size){
+	int i = 0;
+	
+	#ifdef CORAL_SIMD_SSE
+		int vectorizedSize = sseSize(size);
+		for(; i + 4 <= vectorizedSize; i += 4){
+			__m128 x, y, z;
+			loadVec3Lanes(values + i, x, y, z);
+			
+			__m128 length2 = dotLanes(x, y, z, x, y, z);
+			if(anyTinyLength(length2)){
+				for(int j = i; j < i + 4; ++j){
+					result[j] = values[j].length();
+				}
+			}
+			else{
+				_mm_storeu_ps(result + i, _mm_sqrt_ps(length2));
+			}
+		}
+	#endif
+	
+	for(; i < size; ++i){
+		result[i] = values[i].length();
+	}
+}
+
+void vec3Normalize(const Imath::V3f *values, Imath::V3f *result, int size){
+	int i = 0;
+	
+	#ifdef CORAL_SIMD_SSE
+		int vectorizedSize = sseSize(size);
+		for(; i + 4 <= vectorizedSize; i += 4){
+			__m128 x, y, z;
+			loadVec3Lanes(values + i, x, y, z);
+			
+			__m128 length2 = dotLanes(x, y, z, x, y, z);
+			if(anyTinyLength(length2)){
+				for(int j = i; j < i + 4; ++j){
+					result[j] = values[j].normalized();
+				}
+			}
+			else{
+				__m128 length = _mm_sqrt_ps(length2);
+				storeVec3Lanes(_mm_div_ps(x, length), _mm_div_ps(y, length), _mm_div_ps(z, length), result + i);
+			}
+		}
+	#endif
+	
+	for(; i < size; ++i){
+		result[i] = values[i].normalized();
+	}
+}
+
+void vec3Dot(const Imath::V3f *valuesA, const Imath::V3f *valuesB, float *result, int size){
+	int i = 0;
+	
+	#ifdef CORAL_SIMD_SSE
+		int vectorizedSize = sseSize(size);
+		for(; i + 4 <= vectorizedSize; i += 4){
+			__m128 xA, yA, zA, xB, yB, zB;
+			loadVec3Lanes(valuesA + i, xA, yA, zA);
+			loadVec3Lanes(valuesB + i, xB, yB, zB);
+			
+			_mm_storeu_ps(result + i, dotLanes(xA, yA, zA, xB, yB, zB));
+		}
+	#endif
+	
+	for(; i < size; ++i){
+		result[i] = valuesA[i].dot(valuesB[i]);
+	}
+}
+
+void vec3Cross(const Imath::V3f *valuesA, const Imath::V3f *valuesB, Imath::V3f *result, int size){
+	int i = 0;
+	
+	#ifdef CORAL_SIMD_SSE
+		int vectorizedSize = sseSize(size);
+		for(; i + 4 <= vectorizedSize; i += 4){
+			__m128 xA, yA, zA, xB, yB, zB;
+			loadVec3Lanes(valuesA + i, xA, yA, zA);
+			loadVec3Lanes(valuesB + i, xB, yB, zB);
+			
+			storeVec3Lanes(
+				_mm_sub_ps(_mm_mul_ps(yA, zB), _mm_mul_ps(zA, yB)), 
+				_mm_sub_ps(_mm_mul_ps(zA, xB), _mm_mul_ps(xA, zB)), 
+				_mm_sub_ps(_mm_mul_ps(xA, yB), _mm_mul_ps(yA, xB)), 
+				result + i);
+		}
+	#endif
+	
+	for(; i < size; ++i){
+		result[i] = valuesA[i].cross(valuesB[i]);
+	}
+}
+
+}
@@ -0,0 +1,82 @@
+// <license>
+// Copyright (C) 2011 Andrea Interguglielmi, All rights reserved.
+// This file is part of the coral repository downloaded from http://code.google.com/p/coral-repo.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// 
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+// 
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+// IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// </license>
+
+#ifndef CORAL_SIMDUTILS_H
+#define CORAL_SIMDUTILS_H
+
+#include <ImathVec.h>
+#include <ImathMatrix.h>
+
+#include "coralDefinitions.h"
+
+//! Vectorized kernels for arrays of Imath values.
+//! Vec3 arrays stay stored as packed xyz triplets, the kernels transpose four of them at a time to x, y and z lanes in registers,
+//! compute on the lanes and transpose the results back, so they run directly on the values held by Numeric without any conversion.
+//! All kernels produce the same results as the equivalent Imath methods or scalar loops.
+//! The array kernels are compiled for several instruction sets and the best one supported by the running cpu is picked at runtime.
+namespace simdUtils{
+	enum InstructionSet{
+		instructionSetScalar = 0,
+		instructionSetSSE2,
+		instructionSetSSE42,
+		instructionSetAVX2,
+		instructionSetAVX512
+	};
+	
+	enum Operation{
+		operationAdd = 0,
+		operationSub,
+		operationMul,
+		operationDiv
+	};
+	
+	bool enabled();
+	
+	//! The best instruction set supported by both this build and the running cpu.
+	InstructionSet supportedInstructionSet();
+	InstructionSet instructionSet();
+	
+	//! Restricts the kernels to the given instruction set, requests above supportedInstructionSet() are clamped.
+	//! instructionSetScalar runs the plain loops, useful to compare results.
+	void setInstructionSet(InstructionSet instructionSet);
+	
+	void floatArrays(Operation operation, const float *valuesA, const float *valuesB, float *result, int size);
+	void floatArrayScalar(Operation operation, const float *values, float scalar, float *result, int size);
+	
+	//! Integer division has no vector instruction, operationDiv always runs the scalar loop.
+	void intArrays(Operation operation, const int *valuesA, const int *valuesB, int *result, int size);
+	void intArrayScalar(Operation operation, const int *values, int scalar, int *result, int size);
+	
+	void vec3MulMatrix44(const Imath::V3f *values, const Imath::M44f &matrix, Imath::V3f *result, int size);
+	void vec3Length(const Imath::V3f *values, float *result, int size);
+	void vec3Normalize(const Imath::V3f *values, Imath::V3f *result, int size);
+	void vec3Dot(const Imath::V3f *valuesA, const Imath::V3f *valuesB, float *result, int size);
+	void vec3Cross(const Imath::V3f *valuesA, const Imath::V3f *valuesB, Imath::V3f *result, int size);
+}
+
+#endif
@@ -0,0 +1,107 @@
+// <license>
+// Copyright (C) 2011 Andrea Interguglielmi, All rights reserved.
+// This file is part of the coral repository downloaded from http://code.google.com/p/coral-repo.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// 
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+// 
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+// IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// </license>
+
+#ifndef CORAL_SPATIALQUERYUTILS_H
+#define CORAL_SPATIALQUERYUTILS_H
+
+#include <vector>
+
+//! Helpers shared by the batched queries of the spatial structures (FlatKdTree, HashGrid, GeoBvh).
+//
+//! Batched range queries run in two passes: every query is counted first, accumulateOffsets() turns the counts into
+//! the first row of each query, then each query writes its own rows in parallel.
+namespace spatialQueryUtils{
+	//! Grain of the parallelFor calls running one query per element, queries are much heavier than numeric elements.
+	const unsigned int queriesGrainSize = 64;
+	
+	//! Range of a query, the last range is repeated when there are fewer ranges than queries and negative ranges are clamped to 0.
+	inline float queryRange(const float *ranges, unsigned int rangesCount, unsigned int query){
+		if(query >= rangesCount){
+			query = rangesCount - 1;
+		}
+		
+		float range = ranges[query];
+		if(range < 0.0){
+			range = 0.0;
+		}
+		
+		return range;
+	}
+	
+	//! Turns the counts stored from offsets[1] on into the running offsets of the rows of each query, offsets[0] is 0.
+	inline void accumulateOffsets(std::vector<int> &offsets){
+		for(unsigned int i = 1; i < offsets.size(); ++i){
+			offsets[i] += offsets[i - 1];
+		}
+	}
+	
+	//! Visitors get the position of each point found in the sorted order of the structure, indices maps it back to the input order.
+	class CountVisitor{
+	public:
+		CountVisitor(): count(0){
+		}
+		
+		void operator() (int i){
+			count++;
+		}
+		
+		unsigned int count;
+	};
+	
+	class WriteVisitor{
+	public:
+		WriteVisitor(const int *indices, int *results): count(0), _indices(indices), _results(results){
+		}
+		
+		void operator() (int i){
+			_results[count++] = _indices[i];
+		}
+		
+		unsigned int count;
+		
+	private:
+		const int *_indices;
+		int *_results;
+	};
+	
+	class AppendVisitor{
+	public:
+		AppendVisitor(const int *indices, std::vector<int> &results): _indices(indices), _results(results){
+		}
+		
+		void operator() (int i){
+			_results.push_back(_indices[i]);
+		}
+		
+	private:
+		const int *_indices;
+		std::vector<int> &_results;
+	};
+}
+
+#endif
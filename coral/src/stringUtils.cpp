@@ -33,10 +33,18 @@
 
 #include <ctype.h>
 #include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <limits.h>
+#include <locale.h>
 #include <algorithm>
 #include <boost/lexical_cast.hpp>
 #include "stringUtils.h"
 
+#ifdef __APPLE__
+	#include <xlocale.h>
+#endif
+
 
 namespace stringUtils
 {
@@ -1064,7 +1072,7 @@ namespace stringUtils
 	}
 	
 	std::string intToString(int value){
-		char buffer[sizeof(int)];
+		char buffer[16];
 		sprintf(buffer, "%i", value);
 		
 		std::string str(buffer);
@@ -1072,12 +1080,270 @@ namespace stringUtils
 	}
 	
 	std::string floatToString(float value){
-		char buffer[sizeof(float)];
+		char buffer[64];
 		sprintf(buffer, "%f", value);
 		
 		std::string str(buffer);
 		return str;
 	}
+	
+	void appendInt(std::string &str, int value){
+		char buffer[16];
+		int length = sprintf(buffer, "%d", value);
+		
+		str.append(buffer, length);
+	}
+	
+	namespace{
+		// Networks are saved and loaded with '.' as the decimal point whatever LC_NUMERIC says,
+		// the UI calls setlocale(LC_ALL, "") and strtof/sprintf would follow it.
+		#ifdef _WIN32
+			_locale_t classicLocale(){
+				static _locale_t locale = _create_locale(LC_ALL, "C");
+				return locale;
+			}
+			
+			float parseClassicFloat(const char *str, char **end){
+				return _strtof_l(str, end, classicLocale());
+			}
+		#else
+			locale_t classicLocale(){
+				static locale_t locale = newlocale(LC_ALL_MASK, "C", (locale_t)0);
+				return locale;
+			}
+			
+			float parseClassicFloat(const char *str, char **end){
+				return strtof_l(str, end, classicLocale());
+			}
+		#endif
+		
+		// there is no portable sprintf taking a locale, the decimal point of the current one is swapped back to '.'
+		int formatClassicFloat(char *buffer, int precision, float value){
+			int length = sprintf(buffer, "%.*g", precision, value);
+			
+			const char *decimalPoint = localeconv()->decimal_point;
+			int pointLength = int(strlen(decimalPoint));
+			if(pointLength == 0 || (pointLength == 1 && decimalPoint[0] == '.')){
+				return length;
+			}
+			
+			char *point = strstr(buffer, decimalPoint);
+			if(point){
+				*point = '.';
+				memmove(point + 1, point + pointLength, length - (point - buffer) - pointLength + 1);
+				length -= pointLength - 1;
+			}
+			
+			return length;
+		}
+		
+		double scaleByPowerOfTen(double value, int exponent){
+			static const double powersOfTen[] = {
+				1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9,
+				1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19,
+				1e20, 1e21, 1e22, 1e23, 1e24, 1e25, 1e26, 1e27, 1e28, 1e29,
+				1e30, 1e31, 1e32, 1e33, 1e34, 1e35, 1e36, 1e37, 1e38, 1e39,
+				1e40, 1e41, 1e42, 1e43, 1e44, 1e45, 1e46, 1e47, 1e48, 1e49,
+				1e50, 1e51, 1e52, 1e53, 1e54, 1e55, 1e56, 1e57, 1e58, 1e59,
+				1e60
+			};
+			
+			if(exponent < 0){
+				return value / powersOfTen[-exponent];
+			}
+			
+			return value * powersOfTen[exponent];
+		}
+		
+		// 9 significant digits always round trip a float, the first precision that does is the shortest
+		int formatFloatSlow(char *buffer, float value){
+			int length = 0;
+			for(int precision = 1; precision <= 9; ++precision){
+				length = formatClassicFloat(buffer, precision, value);
+				if(parseClassicFloat(buffer, 0) == value){
+					break;
+				}
+			}
+			
+			return length;
+		}
+		
+		// Finds the shortest decimal that rounds back to value with double arithmetic rather than printing and parsing
+		// every candidate, the rare candidates too close to the rounding boundary to be trusted go through formatFloatSlow.
+		int formatFloat(char *buffer, float value){
+			if(value != value || value - value != 0.0f){
+				return sprintf(buffer, "%g", value);
+			}
+			
+			char *current = buffer;
+			if(value < 0.0f || (value == 0.0f && 1.0f / value < 0.0f)){
+				*current++ = '-';
+			}
+			
+			double magnitude = fabs(double(value));
+			if(magnitude == 0.0){
+				*current++ = '0';
+				return current - buffer;
+			}
+			
+			int binaryExponent = 0;
+			double mantissa = frexp(magnitude, &binaryExponent);
+			int ulpExponent = binaryExponent - 24;
+			if(ulpExponent < -149){
+				ulpExponent = -149;
+			}
+			
+			double halfUlp = ldexp(1.0, ulpExponent - 1);
+			
+			// the float below a power of two is closer than the one above
+			double halfUlpBelow = halfUlp;
+			if(mantissa == 0.5 && ulpExponent > -149){
+				halfUlpBelow = halfUlp * 0.5;
+			}
+			
+			int magnitudeExponent = int(floor(log10(magnitude)));
+			if(magnitude < scaleByPowerOfTen(1.0, magnitudeExponent)){
+				magnitudeExponent -= 1;
+			}
+			else if(magnitude >= scaleByPowerOfTen(1.0, magnitudeExponent + 1)){
+				magnitudeExponent += 1;
+			}
+			
+			unsigned int digits = 0;
+			int decimalExponent = 0;
+			int precision = 1;
+			for(; precision <= 9; ++precision){
+				decimalExponent = magnitudeExponent;
+				double rounded = floor(scaleByPowerOfTen(magnitude, precision - 1 - decimalExponent) + 0.5);
+				
+				// rounding up carried to the next power of ten
+				if(rounded >= scaleByPowerOfTen(1.0, precision)){
+					rounded = scaleByPowerOfTen(1.0, precision - 1);
+					decimalExponent += 1;
+				}
+				
+				double candidate = scaleByPowerOfTen(rounded, decimalExponent - precision + 1);
+				double limit = candidate < magnitude ? halfUlpBelow : halfUlp;
+				double error = fabs(candidate - magnitude);
+				if(fabs(error - limit) <= limit * (1.0 / 1048576.0)){
+					return formatFloatSlow(buffer, value);
+				}
+				
+				if(error < limit){
+					digits = (unsigned int)rounded;
+					break;
+				}
+			}
+			
+			if(precision > 9){
+				return formatFloatSlow(buffer, value);
+			}
+			
+			char digitChars[10];
+			int digitsCount = 0;
+			for(int i = precision - 1; i >= 0; --i){
+				digitChars[i] = char('0' + digits % 10);
+				digits /= 10;
+			}
+			
+			digitsCount = precision;
+			while(digitsCount > 1 && digitChars[digitsCount - 1] == '0'){
+				digitsCount -= 1;
+			}
+			
+			// same layout as printf's %.9g
+			if(decimalExponent < -4 || decimalExponent >= 9){
+				*current++ = digitChars[0];
+				if(digitsCount > 1){
+					*current++ = '.';
+					for(int i = 1; i < digitsCount; ++i){
+						*current++ = digitChars[i];
+					}
+				}
+				
+				current += sprintf(current, "e%c%02d", decimalExponent < 0 ? '-' : '+', decimalExponent < 0 ? -decimalExponent : decimalExponent);
+			}
+			else if(decimalExponent < 0){
+				*current++ = '0';
+				*current++ = '.';
+				for(int i = 0; i < -decimalExponent - 1; ++i){
+					*current++ = '0';
+				}
+				
+				for(int i = 0; i < digitsCount; ++i){
+					*current++ = digitChars[i];
+				}
+			}
+			else{
+				for(int i = 0; i <= decimalExponent; ++i){
+					*current++ = i < digitsCount ? digitChars[i] : '0';
+				}
+				
+				if(digitsCount > decimalExponent + 1){
+					*current++ = '.';
+					for(int i = decimalExponent + 1; i < digitsCount; ++i){
+						*current++ = digitChars[i];
+					}
+				}
+			}
+			
+			return current - buffer;
+		}
+	}
+	
+	void appendFloat(std::string &str, float value){
+		char buffer[32];
+		int length = formatFloat(buffer, value);
+		
+		str.append(buffer, length);
+	}
+	
+	bool scanInt(const char *&str, int &value){
+		const char *current = str;
+		while(*current == ' ' || (*current >= '\t' && *current <= '\r')){
+			current++;
+		}
+		
+		bool negative = *current == '-';
+		if(*current == '-' || *current == '+'){
+			current++;
+		}
+		
+		if(*current < '0' || *current > '9'){
+			return false;
+		}
+		
+		// -INT_MIN doesn't fit an int, the magnitude is accumulated unsigned
+		unsigned int limit = negative ? unsigned(INT_MAX) + 1 : unsigned(INT_MAX);
+		unsigned int magnitude = 0;
+		while(*current >= '0' && *current <= '9'){
+			unsigned int digit = *current - '0';
+			if(magnitude > (limit - digit) / 10){
+				return false;
+			}
+			
+			magnitude = magnitude * 10 + digit;
+			current++;
+		}
+		
+		value = negative ? -int(magnitude - 1) - 1 : int(magnitude);
+		str = current;
+		
+		return true;
+	}
+	
+	bool scanFloat(const char *&str, float &value){
+		char *end = 0;
+		float parsed = parseClassicFloat(str, &end);
+		if(end == str){
+			return false;
+		}
+		
+		value = parsed;
+		str = end;
+		
+		return true;
+	}
 }
 
 
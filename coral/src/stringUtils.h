@@ -289,6 +289,18 @@ namespace stringUtils
 	CORAL_EXPORT std::string intToString(int value);
 	CORAL_EXPORT std::string floatToString(float value);
 	
+	//! Appends value to str, these don't create any temporary string.
+	CORAL_EXPORT void appendInt(std::string &str, int value);
+	
+	//! Appends the shortest representation of value that parses back to the exact same float.
+	CORAL_EXPORT void appendFloat(std::string &str, float value);
+	
+	//! Parses the number starting at str and moves str past it, leading whitespace is skipped.
+	//! Returns false and leaves str untouched if no number is found there or an int would overflow, str must be null terminated.
+	//! Both always use '.' as the decimal point, whatever the current C locale is.
+	CORAL_EXPORT bool scanInt(const char *&str, int &value);
+	CORAL_EXPORT bool scanFloat(const char *&str, float &value);
+	
 	template <class T>
 	std::string vectorToString(const std::vector<T> &vec){
 		std::ostringstream stream;
@@ -0,0 +1,152 @@
+// <license>
+// Copyright (C) 2011 Andrea Interguglielmi, All rights reserved.
+// This file is part of the coral repository downloaded from http://code.google.com/p/coral-repo.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// 
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+// 
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+// IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// </license>
+
+// Times FlatKdTree against the kd_* API of kdtree.h, built as its own program by the spatialIndexBenchmark alias of SConstruct:
+//     spatialIndexBenchmark [pointsCount] [queriesCount]
+
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <ImathVec.h>
+
+#include "kdtree.h"
+#include "../src/FlatKdTree.h"
+
+namespace coralTests{
+	double secondsSince(const boost::posix_time::ptime &startTime){
+		return (boost::posix_time::microsec_clock::universal_time() - startTime).total_microseconds() / 1000000.0;
+	}
+	
+	//! Times FlatKdTree against the kd_* API of kdtree.h on pointsCount random points in a unit cube:
+	//! building the tree, queriesCount range queries finding about 32 neighbours each and queriesCount nearest point queries.
+	//! Both trees must find the same number of neighbours.
+	void spatialIndexBenchmark(unsigned int pointsCount, unsigned int queriesCount){
+		std::srand(0);
+		
+		std::vector<Imath::V3f> points(pointsCount);
+		for(unsigned int i = 0; i < pointsCount; ++i){
+			points[i] = Imath::V3f(std::rand() / float(RAND_MAX), std::rand() / float(RAND_MAX), std::rand() / float(RAND_MAX));
+		}
+		
+		std::vector<Imath::V3f> queries(queriesCount);
+		for(unsigned int i = 0; i < queriesCount; ++i){
+			queries[i] = points[std::rand() % pointsCount];
+		}
+		
+		float range = std::pow(32.0 / (pointsCount * 4.18879), 1.0 / 3.0);
+		
+		// kd_* API
+		boost::posix_time::ptime startTime = boost::posix_time::microsec_clock::universal_time();
+		
+		std::vector<int> indices(pointsCount);
+		kdtree *tree = kd_create(3);
+		for(unsigned int i = 0; i < pointsCount; ++i){
+			indices[i] = i;
+			kd_insert3f(tree, points[i].x, points[i].y, points[i].z, &indices[i]);
+		}
+		
+		double kdBuild = secondsSince(startTime);
+		startTime = boost::posix_time::microsec_clock::universal_time();
+		
+		std::vector<int> kdResults;
+		unsigned int kdFound = 0;
+		for(unsigned int i = 0; i < queriesCount; ++i){
+			kdres *res = kd_nearest_range3f(tree, queries[i].x, queries[i].y, queries[i].z, range);
+			kdResults.clear();
+			while(!kd_res_end(res)){
+				kdResults.push_back(*(int*)kd_res_item_data(res));
+				kd_res_next(res);
+			}
+			
+			kdFound += kdResults.size();
+			kd_res_free(res);
+		}
+		
+		double kdRange = secondsSince(startTime);
+		startTime = boost::posix_time::microsec_clock::universal_time();
+		
+		for(unsigned int i = 0; i < queriesCount; ++i){
+			kdres *res = kd_nearest3f(tree, queries[i].x, queries[i].y, queries[i].z);
+			kd_res_free(res);
+		}
+		
+		double kdNearest = secondsSince(startTime);
+		kd_free(tree);
+		
+		// FlatKdTree
+		startTime = boost::posix_time::microsec_clock::universal_time();
+		
+		coral::FlatKdTree flatTree;
+		flatTree.build(points);
+		
+		double flatBuild = secondsSince(startTime);
+		startTime = boost::posix_time::microsec_clock::universal_time();
+		
+		std::vector<int> offsets;
+		std::vector<int> flatResults;
+		flatTree.pointsInRange(&queries[0], queriesCount, &range, 1, offsets, flatResults);
+		
+		double flatRange = secondsSince(startTime);
+		startTime = boost::posix_time::microsec_clock::universal_time();
+		
+		std::vector<int> nearest(queriesCount);
+		flatTree.nearestPoints(&queries[0], queriesCount, &nearest[0]);
+		
+		double flatNearest = secondsSince(startTime);
+		
+		std::cout << "* spatial index benchmark: " << pointsCount << " points, " << queriesCount << " queries" << std::endl;
+		std::cout << std::fixed << std::setprecision(4);
+		std::cout << "  " << std::setw(10) << "" << std::setw(12) << "build" << std::setw(12) << "range" << std::setw(12) << "nearest" << std::endl;
+		std::cout << "  " << std::setw(10) << "kdtree" << std::setw(12) << kdBuild << std::setw(12) << kdRange << std::setw(12) << kdNearest << std::endl;
+		std::cout << "  " << std::setw(10) << "FlatKdTree" << std::setw(12) << flatBuild << std::setw(12) << flatRange << std::setw(12) << flatNearest << std::endl;
+		std::cout << "  neighbours found: " << kdFound << " kdtree, " << flatResults.size() << " FlatKdTree" << std::endl;
+	}
+}
+
+int main(int argc, char **argv){
+	unsigned int pointsCount = 100000;
+	unsigned int queriesCount = 100000;
+	if(argc > 1){
+		pointsCount = std::atoi(argv[1]);
+	}
+	if(argc > 2){
+		queriesCount = std::atoi(argv[2]);
+	}
+	
+	if(pointsCount == 0 || queriesCount == 0){
+		std::cerr << "usage: spatialIndexBenchmark [pointsCount] [queriesCount]" << std::endl;
+		return 1;
+	}
+	
+	coralTests::spatialIndexBenchmark(pointsCount, queriesCount);
+	
+	return 0;
+}
@@ -91,6 +91,22 @@ class GeoAttributeUi(AttributeUi):
         return QtGui.QColor(200, 200, 250)
 
 
+class SpatialIndexAttributeUi(AttributeUi):
+    def __init__(self, coralAttribute, parentNodeUi):
+        AttributeUi.__init__(self, coralAttribute, parentNodeUi)
+        
+    def hooksColor(self, specialization):
+        return QtGui.QColor(250, 210, 160)
+
+
+class HashGridAttributeUi(AttributeUi):
+    def __init__(self, coralAttribute, parentNodeUi):
+        AttributeUi.__init__(self, coralAttribute, parentNodeUi)
+        
+    def hooksColor(self, specialization):
+        return QtGui.QColor(230, 180, 140)
+
+
 class NumericAttributeUi(AttributeUi):
     typeColor = {
         "Any": QtGui.QColor(255, 255, 95),
@@ -867,6 +883,8 @@ def loadPluginUi():
 
     plugin.registerAttributeUi("GeoInstanceArrayAttribute", GeoInstanceArrayAttributeUi)
     plugin.registerAttributeUi("GeoAttribute", GeoAttributeUi)
+    plugin.registerAttributeUi("SpatialIndexAttribute", SpatialIndexAttributeUi)
+    plugin.registerAttributeUi("HashGridAttribute", HashGridAttributeUi)
     plugin.registerAttributeUi("NumericAttribute", NumericAttributeUi)
     plugin.registerAttributeUi("PassThroughAttribute", PassThroughAttributeUi)
     plugin.registerAttributeUi("GeoAttribute", GeoAttributeUi)
@@ -885,6 +903,7 @@ def loadPluginUi():
     plugin.registerInspectorWidget("BoolAttribute", BoolAttributeInspectorWidget)
     plugin.registerInspectorWidget("BuildArray", BuildArrayInspectorWidget)
     plugin.registerInspectorWidget("BuildArray (String)", BuildArrayStringInspectorWidget)
+    plugin.registerInspectorWidget("Expression", BuildArrayInspectorWidget)
     plugin.registerInspectorWidget("Regex", RegexNodeInspectorWidget)
     plugin.registerInspectorWidget("Time", TimeNodeInspectorWidget)
     plugin.registerInspectorWidget("EnumAttribute", EnumAttributeInspectorWidget)